@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <iostream>
 #include <string_view>
 #include <vector>
@@ -31,7 +32,7 @@ static int RunValidateJson(const char *json_path)
     return 0;
 }
 
-static int RunBuild(const char *json_path, const char *output_path)
+static int RunBuild(const char *json_path, const char *output_path, std::uint32_t sample_rate)
 {
     const decl_audio::compiler::CompileResult compile_result =
         decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
@@ -43,7 +44,7 @@ static int RunBuild(const char *json_path, const char *output_path)
     }
 
     const decl_audio::assets::LoadResult asset_result =
-        decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        decl_audio::assets::LoadAssetBank(compile_result.bank, json_path, sample_rate);
 
     if (asset_result.HasErrors())
     {
@@ -74,7 +75,7 @@ int main(int argc, char **argv)
     {
         std::cerr << "Usage:\n"
                   << "  Decl_Audio.Validator validate <behavior-bank.json>\n"
-                  << "  Decl_Audio.Validator build    <behavior-bank.json> <output.dacbank>\n";
+                  << "  Decl_Audio.Validator build    <behavior-bank.json> <output.dacbank> [sample-rate]\n";
         return 1;
     }
 
@@ -92,17 +93,26 @@ int main(int argc, char **argv)
 
     if (subcommand == "build")
     {
-        if (argc != 4)
+        if (argc != 4 && argc != 5)
         {
-            std::cerr << "Usage: Decl_Audio.Validator build <behavior-bank.json> <output.dacbank>\n";
+            std::cerr << "Usage: Decl_Audio.Validator build <behavior-bank.json> <output.dacbank> [sample-rate]\n";
             return 1;
         }
-        return RunBuild(argv[2], argv[3]);
+
+        // Assets are converted to the target device rate at build time, so the
+        // engine loads the bank without resampling.
+        const unsigned long sample_rate = argc == 5 ? std::strtoul(argv[4], nullptr, 10) : decl_audio::assets::kDefaultSampleRate;
+        if (sample_rate == 0 || sample_rate > 384000)
+        {
+            std::cerr << "Invalid sample rate '" << argv[4] << "'\n";
+            return 1;
+        }
+        return RunBuild(argv[2], argv[3], static_cast<std::uint32_t>(sample_rate));
     }
 
     std::cerr << "Unknown subcommand '" << subcommand << "'\n"
               << "Usage:\n"
               << "  Decl_Audio.Validator validate <behavior-bank.json>\n"
-              << "  Decl_Audio.Validator build    <behavior-bank.json> <output.dacbank>\n";
+              << "  Decl_Audio.Validator build    <behavior-bank.json> <output.dacbank> [sample-rate]\n";
     return 1;
 }
@@ -0,0 +1,11 @@
+#include <iostream>
+
+void RunMixKernelBenchmarks();
+
+// Microbenchmarks for audio-thread hot paths. Not part of ctest: numbers are
+// machine-dependent and only meaningful in a Release build.
+int main()
+{
+    RunMixKernelBenchmarks();
+    return 0;
+}
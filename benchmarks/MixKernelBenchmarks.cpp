@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "../src/core/CpuFeatures.hpp"
+#include "../src/playback/BiquadFilter.hpp"
+#include "../src/playback/MasterLimiter.hpp"
+#include "../src/playback/MixBus.hpp"
+#include "../src/playback/MixKernels.hpp"
+
+namespace
+{
+    using decl_audio::SimdLevel;
+    using decl_audio::playback::BiquadKernel;
+    using decl_audio::playback::GetMixKernels;
+    using decl_audio::playback::MasterLimiter;
+    using decl_audio::playback::EnvelopedMixKernel;
+    using decl_audio::playback::FramePeakKernel;
+    using decl_audio::playback::MixGains;
+    using decl_audio::playback::MixKernel;
+    using decl_audio::playback::RampedMixKernel;
+    using decl_audio::playback::SpectrumMacKernel;
+
+    // One render block per call, the same shape RenderVoice hands the kernels.
+    constexpr std::uint32_t kBlockFrames = 512;
+    constexpr std::uint32_t kIterations = 200000;
+
+    template <typename Kernel>
+    double MeasureFramesPerSecond(const Kernel kernel, const std::uint32_t source_channels)
+    {
+        std::vector<float> source(static_cast<std::size_t>(kBlockFrames) * source_channels, 0.25f);
+        std::vector<float> envelope(kBlockFrames, 0.75f);
+        decl_audio::playback::MixBus bus(2, kBlockFrames);
+        bus.Clear(kBlockFrames);
+        const MixGains gains{0.5f, 0.25f};
+        decl_audio::compiler::CompiledFilter filter;
+        filter.type = decl_audio::compiler::FilterType::LowPass;
+        const decl_audio::playback::BiquadCoefficients coefficients = decl_audio::playback::DesignBiquad(filter, 2000.0f, 48000);
+        decl_audio::playback::BiquadState states[2]{};
+        std::vector<float> spectrum_sums(static_cast<std::size_t>(kBlockFrames) * 2, 0.0f);
+
+        auto run = [&]()
+        {
+            if constexpr (std::is_same_v<Kernel, BiquadKernel>)
+            {
+                // Filters the bus in place; `source_channels` is the channel count.
+                float *channels[2] = {bus.Channel(0), bus.Channel(1)};
+                kernel(channels, source_channels, kBlockFrames, coefficients, states);
+            }
+            else if constexpr (std::is_same_v<Kernel, SpectrumMacKernel>)
+            {
+                // One partition product of the convolution reverb: a frame
+                // here is a complex bin (`source` holds a stereo block's
+                // worth of floats, so pass 2).
+                kernel(source.data(), source.data(), spectrum_sums.data(), kBlockFrames);
+            }
+            else if constexpr (std::is_same_v<Kernel, FramePeakKernel>)
+            {
+                // A duck's trigger detection over the bus; `source_channels`
+                // is the channel count.
+                const float *channels[2] = {bus.Channel(0), bus.Channel(1)};
+                kernel(channels, source_channels, kBlockFrames, envelope.data());
+            }
+            else if constexpr (std::is_same_v<Kernel, MasterLimiter *>)
+            {
+                // The master limiter over a fresh block of the mix (the copy
+                // in is part of the figure); `source_channels` must be 2.
+                std::copy(source.begin(), source.begin() + kBlockFrames, bus.Channel(0));
+                std::copy(source.begin() + kBlockFrames, source.end(), bus.Channel(1));
+                float *channels[2] = {bus.Channel(0), bus.Channel(1)};
+                (void)kernel->Process(channels, kBlockFrames);
+            }
+            else if constexpr (std::is_same_v<Kernel, RampedMixKernel>)
+            {
+                kernel(source.data(), bus.Channel(0), bus.Channel(1), kBlockFrames, gains, MixGains{1.0e-4f, -1.0e-4f}, nullptr);
+            }
+            else if constexpr (std::is_same_v<Kernel, EnvelopedMixKernel>)
+            {
+                kernel(source.data(), bus.Channel(0), bus.Channel(1), kBlockFrames, gains, envelope.data());
+            }
+            else
+            {
+                kernel(source.data(), bus.Channel(0), bus.Channel(1), kBlockFrames, gains);
+            }
+        };
+
+        // Warm caches and let the clock settle before timing.
+        for (std::uint32_t i = 0; i < kIterations / 10; ++i)
+        {
+            run();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < kIterations; ++i)
+        {
+            run();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        // Keep the accumulation observable so the loop is not elided.
+        volatile float sink = bus.Channel(0)[0];
+        (void)sink;
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        return static_cast<double>(kBlockFrames) * kIterations / seconds;
+    }
+
+    template <typename Kernel>
+    void Report(const char *name, const Kernel kernel, const std::uint32_t source_channels)
+    {
+        std::cout << "   " << name << ' ' << std::right << std::setw(8) << std::fixed << std::setprecision(1)
+                  << MeasureFramesPerSecond(kernel, source_channels) / 1.0e6 << " Mframes/s";
+    }
+} // namespace
+
+void RunMixKernelBenchmarks()
+{
+    const SimdLevel detected = decl_audio::DetectSimdLevel();
+    std::cout << "Mix kernels (" << kBlockFrames << "-frame blocks, detected " << decl_audio::SimdLevelName(detected) << ")\n";
+
+    for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2})
+    {
+        if (level > detected)
+        {
+            continue;
+        }
+
+        const auto &kernels = GetMixKernels(level);
+        std::cout << "  " << std::left << std::setw(7) << decl_audio::SimdLevelName(level);
+        Report("mono", kernels.mono_to_stereo, 1);
+        Report("stereo", kernels.stereo_to_stereo, 2);
+        Report("mono+env", kernels.mono_to_stereo_enveloped, 1);
+        Report("stereo+env", kernels.stereo_to_stereo_enveloped, 2);
+        Report("mono+ramp", kernels.mono_to_stereo_ramped, 1);
+        Report("stereo+ramp", kernels.stereo_to_stereo_ramped, 2);
+        Report("biquad1", kernels.biquad, 1);
+        Report("biquad2", kernels.biquad, 2);
+        Report("cmac", kernels.spectrum_mac, 2);
+        Report("peak2", kernels.frame_peak, 2);
+        // 5 ms of lookahead at 48 kHz, over a 0.25 mix: under the ceiling
+        // the limiter only delays; under a 0.125 ceiling it reduces every
+        // frame.
+        MasterLimiter idle_limiter(kernels, 2, kBlockFrames, 240, 4800, 1.0f);
+        MasterLimiter reducing_limiter(kernels, 2, kBlockFrames, 240, 4800, 0.125f);
+        Report("limit", &idle_limiter, 2);
+        Report("limit+gr", &reducing_limiter, 2);
+        std::cout << '\n';
+    }
+}
@@ -29,18 +29,49 @@ extern "C"
         DECL_AUDIO_BACKEND_PLATFORM_DEFAULT = 1
     } DeclAudioBackend;
 
+    // What happens when a sound starts while max_instances are already playing.
+    typedef enum DeclAudioStealPolicy
+    {
+        DECL_AUDIO_STEAL_NONE = 0,     // treat it as a bug and terminate
+        DECL_AUDIO_STEAL_QUIETEST = 1, // fade out the quietest instance
+        DECL_AUDIO_STEAL_OLDEST = 2,   // fade out the oldest instance
+        DECL_AUDIO_STEAL_PRIORITY = 3  // fade out the lowest authored priority (oldest first on ties)
+    } DeclAudioStealPolicy;
+
     typedef struct DeclAudioLogMessage
     {
         uint32_t length;
         char message[DECL_AUDIO_LOG_MESSAGE_MAX_LENGTH];
     } DeclAudioLogMessage;
 
+    // Runtime counters published by the audio thread once per rendered block.
+    typedef struct DeclAudioMetrics
+    {
+        uint32_t active_instance_count;
+        // instances out of audible range whose voices advance without mixing
+        uint32_t virtual_instance_count;
+        // instances faded out to make room for new ones, since engine creation
+        uint32_t instance_steal_count;
+        // device callbacks the render-ahead queue ran dry in (render-ahead only)
+        uint32_t fifo_underrun_count;
+        // reads of a streamed asset that outran its voice's ring and played
+        // silence, since engine creation
+        uint32_t stream_underrun_count;
+        // the master limiter's deepest gain reduction in the last rendered
+        // block, in dB (0 when it did nothing or is off)
+        float limiter_gain_reduction_db;
+        // reverb partitions played without their tail because the background
+        // thread had not finished it in time, since engine creation
+        uint32_t reverb_late_tail_count;
+    } DeclAudioMetrics;
+
     typedef struct EngineConfig
     {
         // todo: add bankpath to config.
 
         // device-facing settings
         uint32_t sample_rate;
+        // 1, 2, 4 (quad), 6 (5.1) or 8 (7.1), in the standard WAVE channel order
         uint32_t output_channel_count;
         uint32_t callback_frame_count;
 
@@ -56,6 +87,71 @@ extern "C"
         uint32_t max_program_concurrent_voices;
         uint32_t max_program_parameter_slot_count;
 
+        // render threading - extra threads that help the device callback mix
+        // instances. 0 mixes everything on the callback thread. Output is
+        // bit-identical for every value.
+        uint32_t render_worker_count;
+
+        // gain smoothing - frames over which volume, blend-parameter and spatial
+        // gain changes ramp linearly instead of stepping. 0 steps at the next
+        // render block. At most one second (sample_rate frames).
+        uint32_t gain_ramp_frames;
+
+        // capacity overflow - how a new instance makes room at max_instances
+        DeclAudioStealPolicy steal_policy;
+
+        // render quantum - the mix always runs in blocks of exactly this many
+        // frames, whatever period the device asks for; a partial quantum left at
+        // the end of a callback is played out first in the next one. 0 mixes
+        // each callback as delivered. At most max_block_frames.
+        uint32_t render_quantum_frames;
+
+        // render-ahead - a dedicated high-priority thread mixes this many frames
+        // ahead of the device into a queue the callback only copies from, so a
+        // slow mix costs queue depth instead of a dropout (and adds that much
+        // latency). 0 mixes inside the device callback. The thread mixes in
+        // blocks of render_quantum_frames, or max_block_frames without a
+        // quantum, and both render_ahead_frames and the headroom must fit one
+        // such block. The queue holds render_ahead_frames +
+        // render_ahead_headroom_frames.
+        uint32_t render_ahead_frames;
+        uint32_t render_ahead_headroom_frames;
+
+        // disk streaming - voices playing assets authored with "stream": true
+        // read past a resident head from disk, through a background I/O thread
+        // that keeps a ring per voice stream_prefetch_frames ahead. At most
+        // stream_voice_count such voices stream at once; further ones play
+        // their head and then silence. 0 (the default) starts no I/O thread,
+        // so streamed voices play only their head. The head is
+        // stream_prefetch_frames long, so a voice starts without waiting.
+        uint32_t stream_voice_count;
+        uint32_t stream_prefetch_frames;
+
+        // mix buses - how many distinct buses loaded banks may declare between
+        // them. Bus mix buffers are allocated once for this many; a bank that
+        // would need more is rejected.
+        uint32_t max_bus_count;
+
+        // convolution reverb - at most max_reverb_bus_count buses (up to 32)
+        // may carry an impulse response, each at most max_impulse_frames
+        // long; their convolution state is allocated once for that. 0 (the
+        // default) rejects reverb buses and starts no reverb thread. Reverb
+        // buses add reverb_partition_frames of latency to their wet signal
+        // (a power of two, 64 to 4096); smaller partitions cost more CPU.
+        uint32_t max_reverb_bus_count;
+        uint32_t reverb_partition_frames;
+        uint32_t max_impulse_frames;
+
+        // master limiter - holds the output under master_limiter_ceiling_db
+        // (finite, at most 0), looking master_limiter_lookahead_frames ahead
+        // so each peak is met by a smooth gain reduction; the output lags by
+        // that much. 0 turns the limiter off. Lookahead is at most 50 ms
+        // (sample_rate / 20 frames); the release time constant, at most one
+        // second (sample_rate frames).
+        uint32_t master_limiter_lookahead_frames;
+        uint32_t master_limiter_release_frames;
+        float master_limiter_ceiling_db;
+
         DeclAudioBackend backend;
     } EngineConfig;
 
@@ -73,7 +169,19 @@ extern "C"
     // audio is live. No-op if no matching active bank is loaded.
     DECL_AUDIO_API void UnloadBank(DeclAudioEngine *engine, const char *bank_path);
     DECL_AUDIO_API void Update(DeclAudioEngine *engine);
+    // Frames the audio thread has rendered since the engine was created - the
+    // audio clock frame the next rendered block starts at.
+    DECL_AUDIO_API uint64_t GetAudioClock(DeclAudioEngine *engine);
+    // Update(), with the playback changes it produces (instance starts and stops,
+    // volume/parameter/position changes) scheduled to land on audio clock frame
+    // `audio_frame` rather than at the start of the next block. A frame already
+    // rendered applies at the next block, exactly like Update(). Later updates
+    // are not held back by it, but changes to one instance keep their call
+    // order. Frames more than one second (sample_rate frames) ahead of the audio
+    // clock are clamped to it.
+    DECL_AUDIO_API void UpdateAt(DeclAudioEngine *engine, uint64_t audio_frame);
     DECL_AUDIO_API bool TryDequeueLog(DeclAudioEngine *engine, DeclAudioLogMessage *out_message);
+    DECL_AUDIO_API bool GetAudioMetrics(DeclAudioEngine *engine, DeclAudioMetrics *out_metrics);
 
     DECL_AUDIO_API void SetTag(DeclAudioEngine *engine, const char *entity_id, const char *tag);
     DECL_AUDIO_API void RemoveTag(DeclAudioEngine *engine, const char *entity_id, const char *tag);
@@ -82,6 +190,12 @@ extern "C"
 
     DECL_AUDIO_API void SetPosition(DeclAudioEngine *engine, const char *entityId, float x, float y, float z);
     DECL_AUDIO_API void SetListenerPosition(DeclAudioEngine *engine, float x, float y, float z);
+    // Orientations are quaternions with the scalar part first (a + bi + cj + dk).
+    // The identity faces +z with +x to the right and +y up; panning follows the
+    // listener's facing. Zero quaternions are taken as the identity.
+    DECL_AUDIO_API void SetListenerTransform(DeclAudioEngine *engine, float x, float y, float z, float a, float b, float c, float d);
+    DECL_AUDIO_API void SetTransform(DeclAudioEngine *engine, const char *entityId, float x, float y, float z, float a, float b, float c, float d);
+    DECL_AUDIO_API void SetQuatValue(DeclAudioEngine *engine, const char *entityId, const char *key, float a, float b, float c, float d);
     DECL_AUDIO_API void SetTransientTag(DeclAudioEngine *engine, const char *entity_id, const char *tag);
 
     DECL_AUDIO_API void SetGlobalTag(DeclAudioEngine *engine, const char *tag);
@@ -89,11 +203,9 @@ extern "C"
     DECL_AUDIO_API void SetGlobalValue(DeclAudioEngine *engine, const char *parameter, float value);
 
     DECL_AUDIO_API void SetMasterGain(DeclAudioEngine *engine, float gain);
-
-    // Future typed setters.
-
-    DECL_AUDIO_API void SetQuatValue(DeclAudioEngine *engine, const char *entityId, const char *key, float a, float b, float c, float d);
-    DECL_AUDIO_API void SetTransform(DeclAudioEngine *engine, const char *entityId, float x, float y, float z, float a, float b, float c, float d);
+    // Scales the named mix bus (on top of its authored volume) and everything
+    // routed through it. May be set before a bank declaring the bus loads.
+    DECL_AUDIO_API void SetBusVolume(DeclAudioEngine *engine, const char *bus, float volume);
 
 #ifdef __cplusplus
 }
@@ -12,6 +12,14 @@ public enum DeclAudioBackend : uint
     PlatformDefault = 1,
 }
 
+public enum DeclAudioStealPolicy : uint
+{
+    None = 0,
+    Quietest = 1,
+    Oldest = 2,
+    Priority = 3,
+}
+
 [StructLayout(LayoutKind.Sequential)]
 public struct EngineConfig
 {
@@ -29,9 +37,54 @@ public struct EngineConfig
     public uint MaxProgramConcurrentVoices;
     public uint MaxProgramParameterSlotCount;
 
+    // render threading (0 = mix on the device callback thread only)
+    public uint RenderWorkerCount;
+
+    // gain smoothing (0 = step changes at the next render block)
+    public uint GainRampFrames;
+
+    // capacity overflow (which instance fades out to make room)
+    public DeclAudioStealPolicy StealPolicy;
+
+    // fixed mix block size (0 = mix each device callback as delivered)
+    public uint RenderQuantumFrames;
+
+    // render-ahead queue (0 = mix inside the device callback)
+    public uint RenderAheadFrames;
+    public uint RenderAheadHeadroomFrames;
+
+    // disk streaming (0 voices = no I/O thread)
+    public uint StreamVoiceCount;
+    public uint StreamPrefetchFrames;
+
+    // mix buses (distinct buses all loaded banks may declare)
+    public uint MaxBusCount;
+
+    // convolution reverb (buses with an impulse response)
+    public uint MaxReverbBusCount;
+    public uint ReverbPartitionFrames;
+    public uint MaxImpulseFrames;
+
+    // master limiter (0 lookahead = off; output lags by the lookahead)
+    public uint MasterLimiterLookaheadFrames;
+    public uint MasterLimiterReleaseFrames;
+    public float MasterLimiterCeilingDb;
+
     public DeclAudioBackend Backend;
 }
 
+[StructLayout(LayoutKind.Sequential)]
+public struct AudioMetrics
+{
+    public uint ActiveInstanceCount;
+    public uint VirtualInstanceCount;
+    public uint InstanceStealCount;
+    public uint FifoUnderrunCount;
+    public uint StreamUnderrunCount;
+    public float LimiterGainReductionDb;
+    public uint ReverbLateTailCount;
+}
+
 public sealed class AudioEngine : IDisposable
 {
     private IntPtr _handle;
@@ -65,9 +118,21 @@ public sealed class AudioEngine : IDisposable
     public void Update()
         => NativeMethods.Update(_handle);
 
+    public ulong GetAudioClock()
+        => NativeMethods.GetAudioClock(_handle);
+
+    public void UpdateAt(ulong audioFrame)
+        => NativeMethods.UpdateAt(_handle, audioFrame);
+
     public string? TryDequeueLog()
         => NativeMethods.TryDequeueLog(_handle);
 
+    public AudioMetrics GetMetrics()
+    {
+        NativeMethods.GetAudioMetrics(_handle, out AudioMetrics metrics);
+        return metrics;
+    }
+
     public void SetTag(string entityId, string tag)
         => NativeMethods.SetTag(_handle, entityId, tag);
 
@@ -89,6 +154,9 @@ public sealed class AudioEngine : IDisposable
     public void SetListenerPosition(float x, float y, float z)
         => NativeMethods.SetListenerPosition(_handle, x, y, z);
 
+    public void SetListenerTransform(float x, float y, float z, float a, float b, float c, float d)
+        => NativeMethods.SetListenerTransform(_handle, x, y, z, a, b, c, d);
+
     public void SetTransform(string entityId, float x, float y, float z, float a, float b, float c, float d)
         => NativeMethods.SetTransform(_handle, entityId, x, y, z, a, b, c, d);
 
@@ -104,6 +172,9 @@ public sealed class AudioEngine : IDisposable
     public void SetMasterGain(float gain)
         => NativeMethods.SetMasterGain(_handle, gain);
 
+    public void SetBusVolume(string bus, float volume)
+        => NativeMethods.SetBusVolume(_handle, bus, volume);
+
     public void DestroyEntity(string entityId)
         => NativeMethods.DestroyEntity(_handle, entityId);
 
@@ -156,6 +227,12 @@ internal static partial class NativeMethods
     [LibraryImport(Dll)]
     internal static partial void Update(IntPtr engine);
 
+    [LibraryImport(Dll)]
+    internal static partial ulong GetAudioClock(IntPtr engine);
+
+    [LibraryImport(Dll)]
+    internal static partial void UpdateAt(IntPtr engine, ulong audioFrame);
+
     [LibraryImport(Dll, EntryPoint = "TryDequeueLog")]
     [return: MarshalAs(UnmanagedType.I1)]
     private static partial bool TryDequeueLogNative(IntPtr engine, IntPtr outMessage);
@@ -184,6 +261,10 @@ internal static partial class NativeMethods
         }
     }
 
+    [LibraryImport(Dll)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    internal static partial bool GetAudioMetrics(IntPtr engine, out AudioMetrics outMetrics);
+
     [LibraryImport(Dll, StringMarshalling = StringMarshalling.Utf8)]
     internal static partial void SetTag(IntPtr engine, string entityId, string tag);
 
@@ -205,6 +286,9 @@ internal static partial class NativeMethods
     [LibraryImport(Dll)]
     internal static partial void SetListenerPosition(IntPtr engine, float x, float y, float z);
 
+    [LibraryImport(Dll)]
+    internal static partial void SetListenerTransform(IntPtr engine, float x, float y, float z, float a, float b, float c, float d);
+
     [LibraryImport(Dll, StringMarshalling = StringMarshalling.Utf8)]
     internal static partial void SetTransform(IntPtr engine, string entityId, float x, float y, float z, float a, float b, float c, float d);
 
@@ -222,4 +306,7 @@ internal static partial class NativeMethods
 
     [LibraryImport(Dll)]
     internal static partial void SetMasterGain(IntPtr engine, float gain);
+
+    [LibraryImport(Dll, StringMarshalling = StringMarshalling.Utf8)]
+    internal static partial void SetBusVolume(IntPtr engine, string bus, float volume);
 }
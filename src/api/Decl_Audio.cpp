@@ -3,6 +3,7 @@
 #include "../core/Engine.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <new>
 #include <string>
@@ -29,6 +30,25 @@ namespace decl_audio
     inline constexpr std::uint32_t kDefaultMaxProgramNodeCount = 256;
     inline constexpr std::uint32_t kDefaultMaxProgramConcurrentVoices = 64;
     inline constexpr std::uint32_t kDefaultMaxProgramParameterSlotCount = 64;
+    inline constexpr std::uint32_t kDefaultRenderWorkerCount = 0;
+    inline constexpr std::uint32_t kMaxRenderWorkerCount = 64;
+    inline constexpr std::uint32_t kDefaultGainRampFrames = 256;
+    inline constexpr DeclAudioStealPolicy kDefaultStealPolicy = DECL_AUDIO_STEAL_QUIETEST;
+    inline constexpr std::uint32_t kDefaultRenderQuantumFrames = 256;
+    inline constexpr std::uint32_t kDefaultRenderAheadFrames = 0;
+    inline constexpr std::uint32_t kDefaultRenderAheadHeadroomFrames = 1024;
+    inline constexpr std::uint32_t kDefaultStreamVoiceCount = 0;
+    inline constexpr std::uint32_t kDefaultStreamPrefetchFrames = 32768;
+    inline constexpr std::uint32_t kDefaultMaxBusCount = 32;
+    inline constexpr std::uint32_t kDefaultMaxReverbBusCount = 0;
+    inline constexpr std::uint32_t kDefaultReverbPartitionFrames = 256;
+    inline constexpr std::uint32_t kMinReverbPartitionFrames = 64;
+    inline constexpr std::uint32_t kMaxReverbPartitionFrames = 4096;
+    inline constexpr std::uint32_t kMaxReverbBusCount = 32;
+    inline constexpr std::uint32_t kDefaultMaxImpulseFrames = 192000;
+    inline constexpr std::uint32_t kDefaultMasterLimiterLookaheadFrames = 0;
+    inline constexpr std::uint32_t kDefaultMasterLimiterReleaseFrames = 4800;
+    inline constexpr float kDefaultMasterLimiterCeilingDb = -1.0f;
 
     void CopyLogMessage(const std::string &source, DeclAudioLogMessage &destination) noexcept
     {
@@ -55,6 +75,21 @@ extern "C"
         config.max_program_node_count = decl_audio::kDefaultMaxProgramNodeCount;
         config.max_program_concurrent_voices = decl_audio::kDefaultMaxProgramConcurrentVoices;
         config.max_program_parameter_slot_count = decl_audio::kDefaultMaxProgramParameterSlotCount;
+        config.render_worker_count = decl_audio::kDefaultRenderWorkerCount;
+        config.gain_ramp_frames = decl_audio::kDefaultGainRampFrames;
+        config.steal_policy = decl_audio::kDefaultStealPolicy;
+        config.render_quantum_frames = decl_audio::kDefaultRenderQuantumFrames;
+        config.render_ahead_frames = decl_audio::kDefaultRenderAheadFrames;
+        config.render_ahead_headroom_frames = decl_audio::kDefaultRenderAheadHeadroomFrames;
+        config.stream_voice_count = decl_audio::kDefaultStreamVoiceCount;
+        config.stream_prefetch_frames = decl_audio::kDefaultStreamPrefetchFrames;
+        config.max_bus_count = decl_audio::kDefaultMaxBusCount;
+        config.max_reverb_bus_count = decl_audio::kDefaultMaxReverbBusCount;
+        config.reverb_partition_frames = decl_audio::kDefaultReverbPartitionFrames;
+        config.max_impulse_frames = decl_audio::kDefaultMaxImpulseFrames;
+        config.master_limiter_lookahead_frames = decl_audio::kDefaultMasterLimiterLookaheadFrames;
+        config.master_limiter_release_frames = decl_audio::kDefaultMasterLimiterReleaseFrames;
+        config.master_limiter_ceiling_db = decl_audio::kDefaultMasterLimiterCeilingDb;
         config.backend = DECL_AUDIO_BACKEND_PLATFORM_DEFAULT;
         return config;
     }
@@ -65,7 +100,7 @@ extern "C"
     }
     bool ValidateConfig(const EngineConfig *config)
     {
-        if (config->output_channel_count < 1 || config->output_channel_count > 2)
+        if (!decl_audio::playback::IsSupportedOutputChannelCount(config->output_channel_count))
             return false;
         if (config->callback_frame_count == 0)
             return false;
@@ -83,6 +118,38 @@ extern "C"
             return false;
         if (config->max_program_parameter_slot_count == 0)
             return false;
+        if (config->render_worker_count > decl_audio::kMaxRenderWorkerCount)
+            return false;
+        if (config->gain_ramp_frames > config->sample_rate)
+            return false;
+        if (config->steal_policy > DECL_AUDIO_STEAL_PRIORITY)
+            return false;
+        if (config->render_quantum_frames > config->max_block_frames)
+            return false;
+        if (config->render_ahead_frames > 0)
+        {
+            // The render-ahead thread mixes whole blocks of the quantum, or of
+            // the block capacity without one, whatever the device period.
+            const std::uint32_t mix_block_frames = config->render_quantum_frames > 0 ? config->render_quantum_frames : config->max_block_frames;
+            if (config->render_ahead_frames < mix_block_frames || config->render_ahead_headroom_frames < mix_block_frames)
+                return false;
+        }
+        if (config->stream_prefetch_frames == 0)
+            return false;
+        if (config->max_bus_count >= decl_audio::compiler::kMasterBus)
+            return false;
+        if (config->max_reverb_bus_count > decl_audio::kMaxReverbBusCount || config->max_reverb_bus_count > config->max_bus_count)
+            return false;
+        if (config->reverb_partition_frames < decl_audio::kMinReverbPartitionFrames ||
+            config->reverb_partition_frames > decl_audio::kMaxReverbPartitionFrames ||
+            (config->reverb_partition_frames & (config->reverb_partition_frames - 1)) != 0)
+            return false;
+        if (config->master_limiter_lookahead_frames > config->sample_rate / 20)
+            return false;
+        if (config->master_limiter_release_frames > config->sample_rate)
+            return false;
+        if (!std::isfinite(config->master_limiter_ceiling_db) || config->master_limiter_ceiling_db > 0.0f)
+            return false;
         return true;
     }
     bool CreateEngine(const EngineConfig *config, DeclAudioEngine **out_engine)
@@ -146,6 +213,22 @@ extern "C"
         engine->engine.Update();
     }
 
+    uint64_t GetAudioClock(DeclAudioEngine *engine)
+    {
+        if (engine == nullptr)
+            return 0;
+
+        return engine->engine.GetAudioClock();
+    }
+
+    void UpdateAt(DeclAudioEngine *engine, const uint64_t audio_frame)
+    {
+        if (engine == nullptr)
+            return;
+
+        engine->engine.UpdateAt(audio_frame);
+    }
+
     bool TryDequeueLog(DeclAudioEngine *engine, DeclAudioLogMessage *out_message)
     {
         if (engine == nullptr || out_message == nullptr)
@@ -159,6 +242,22 @@ extern "C"
         return true;
     }
 
+    bool GetAudioMetrics(DeclAudioEngine *engine, DeclAudioMetrics *out_metrics)
+    {
+        if (engine == nullptr || out_metrics == nullptr)
+            return false;
+
+        const decl_audio::playback::RuntimeMetrics metrics = engine->engine.GetMetrics();
+        out_metrics->active_instance_count = metrics.active_instance_count;
+        out_metrics->virtual_instance_count = metrics.virtual_instance_count;
+        out_metrics->instance_steal_count = metrics.instance_steal_count;
+        out_metrics->fifo_underrun_count = metrics.fifo_underrun_count;
+        out_metrics->stream_underrun_count = metrics.stream_underrun_count;
+        out_metrics->limiter_gain_reduction_db = metrics.limiter_gain_reduction_db;
+        out_metrics->reverb_late_tail_count = metrics.reverb_late_tail_count;
+        return true;
+    }
+
     void SetTag(DeclAudioEngine *engine, const char *entity_id, const char *tag)
     {
         engine->engine.SetTag(entity_id, tag);
@@ -188,6 +287,21 @@ extern "C"
         engine->engine.SetListenerPosition(x, y, z);
     }
 
+    void SetListenerTransform(DeclAudioEngine *engine, const float x, const float y, const float z, const float a, const float b, const float c, const float d)
+    {
+        engine->engine.SetListenerTransform(Vec3{x, y, z}, Quat{a, b, c, d});
+    }
+
+    void SetTransform(DeclAudioEngine *engine, const char *entityId, const float x, const float y, const float z, const float a, const float b, const float c, const float d)
+    {
+        engine->engine.SetTransform(entityId, Vec3{x, y, z}, Quat{a, b, c, d});
+    }
+
+    void SetQuatValue(DeclAudioEngine *engine, const char *entityId, const char *key, const float a, const float b, const float c, const float d)
+    {
+        engine->engine.SetQuatValue(entityId, key, Quat{a, b, c, d});
+    }
+
     void DestroyEntity(DeclAudioEngine *engine, const char *entity_id)
     {
         engine->engine.DestroyEntity(entity_id);
@@ -210,4 +324,9 @@ extern "C"
     {
         engine->engine.SetMasterGain(gain);
     }
+
+    void SetBusVolume(DeclAudioEngine *engine, const char *bus, const float volume)
+    {
+        engine->engine.SetBusVolume(bus, volume);
+    }
 }
@@ -1,6 +1,9 @@
 #include "pch.h"
 
 #include "AssetBank.hpp"
+#include "AssetStream.hpp"
+#include "Resampler.hpp"
+#include "SampleCodec.hpp"
 #include "../third_party/Miniaudio.hpp"
 
 #include <sstream>
@@ -33,12 +36,31 @@ namespace decl_audio::assets
             return ma_decoder_init_file(narrow_path.c_str(), &config, &decoder);
 #endif
         }
+        [[nodiscard]] const char *FormatName(const compiler::SampleFormat format) noexcept
+        {
+            switch (format)
+            {
+            case compiler::SampleFormat::F32:
+                return "f32";
+            case compiler::SampleFormat::S16:
+                return "s16";
+            case compiler::SampleFormat::ImaAdpcm:
+                return "adpcm";
+            }
+
+            return "?";
+        }
     } // namespace
 
-    LoadResult LoadAssetBank(const compiler::CompiledBank &compiled_bank, const std::filesystem::path &source_path)
+    LoadResult LoadAssetBank(const compiler::CompiledBank &compiled_bank,
+                             const std::filesystem::path &source_path,
+                             const std::uint32_t target_sample_rate,
+                             ResampleCache *cache,
+                             const std::uint32_t stream_head_frames)
     {
         LoadResult result;
-        result.bank.buffers.reserve(compiled_bank.asset_paths.size());
+        std::vector<DecodedBuffer> decoded_buffers;
+        decoded_buffers.reserve(compiled_bank.asset_paths.size());
         result.bank.source_paths.reserve(compiled_bank.asset_paths.size());
 
         for (std::size_t asset_index = 0; asset_index < compiled_bank.asset_paths.size(); ++asset_index)
@@ -54,6 +76,23 @@ namespace decl_audio::assets
                 continue;
             }
 
+            // Decoded straight to the target rate: the tail will be too, by
+            // the same decoder, so head and tail join seamlessly.
+            if (asset_index < compiled_bank.asset_streamed.size() && compiled_bank.asset_streamed[asset_index])
+            {
+                DecodedBuffer streamed_buffer;
+                const std::string error = LoadStreamedAsset(resolved_path, target_sample_rate, stream_head_frames, streamed_buffer);
+                if (!error.empty())
+                {
+                    result.diagnostics.push_back(MakeError(source_str, object_path, error));
+                    continue;
+                }
+
+                decoded_buffers.push_back(std::move(streamed_buffer));
+                result.bank.source_paths.push_back(resolved_path);
+                continue;
+            }
+
             ma_decoder decoder{};
             const ma_result init_result = InitDecoderForFile(resolved_path, decoder);
             if (init_result != MA_SUCCESS)
@@ -87,10 +126,10 @@ namespace decl_audio::assets
                 continue;
             }
 
-            if (sample_rate != kRequiredSampleRate)
+            if (sample_rate == 0)
             {
                 ma_decoder_uninit(&decoder);
-                result.diagnostics.push_back(MakeError(source_str, object_path, "unsupported sample rate " + std::to_string(sample_rate) + " Hz; expected " + std::to_string(kRequiredSampleRate) + " Hz"));
+                result.diagnostics.push_back(MakeError(source_str, object_path, "decoder reported no sample rate for " + resolved_path.string()));
                 continue;
             }
 
@@ -145,10 +184,29 @@ namespace decl_audio::assets
                 continue;
             }
 
-            result.bank.buffers.push_back(std::move(decoded_buffer));
+            decoded_buffers.push_back(std::move(decoded_buffer));
             result.bank.source_paths.push_back(resolved_path);
         }
 
+        // Converted once here rather than per callback, then encoded in the
+        // asset's format; the resolved file identifies the asset to the cache.
+        // Streamed heads were decoded at the target rate already.
+        if (!result.HasErrors())
+        {
+            result.bank.buffers.reserve(decoded_buffers.size());
+            for (std::size_t asset_index = 0; asset_index < decoded_buffers.size(); ++asset_index)
+            {
+                DecodedBuffer &decoded = decoded_buffers[asset_index];
+                const compiler::SampleFormat format = asset_index < compiled_bank.asset_formats.size() ? compiled_bank.asset_formats[asset_index] : compiler::SampleFormat::F32;
+                if (decoded.sample_rate == target_sample_rate)
+                    result.bank.buffers.push_back(std::make_shared<const DecodedBuffer>(EncodeBuffer(std::move(decoded), format)));
+                else if (cache != nullptr)
+                    result.bank.buffers.push_back(cache->Convert(MakeResampleKey(result.bank.source_paths[asset_index]), decoded, target_sample_rate, format));
+                else
+                    result.bank.buffers.push_back(std::make_shared<const DecodedBuffer>(EncodeBuffer(ResampleBuffer(decoded, target_sample_rate), format)));
+            }
+        }
+
         return result;
     }
 
@@ -160,7 +218,7 @@ namespace decl_audio::assets
 
         for (std::size_t asset_index = 0; asset_index < asset_bank.buffers.size(); ++asset_index)
         {
-            const DecodedBuffer &buffer = asset_bank.buffers[asset_index];
+            const DecodedBuffer &buffer = *asset_bank.buffers[asset_index];
             stream << "Asset[" << asset_index << "] "
                    << compiled_bank.GetAssetPath(static_cast<compiler::AssetId>(asset_index))
                    << '\n';
@@ -168,7 +226,14 @@ namespace decl_audio::assets
             stream << "  frames: " << buffer.frame_count << '\n';
             stream << "  channels: " << buffer.channel_count << '\n';
             stream << "  sampleRate: " << buffer.sample_rate << '\n';
-            stream << "  samples: " << buffer.samples.size() << '\n';
+            stream << "  format: " << FormatName(buffer.format) << '\n';
+            stream << "  samples: " << buffer.SampleCount() << '\n';
+            stream << "  residentBytes: " << buffer.ResidentBytes() << '\n';
+            if (buffer.IsStreamed())
+            {
+                stream << "  stream: " << buffer.stream_path.string() << '\n';
+                stream << "  headFrames: " << buffer.HeadFrameCount() << '\n';
+            }
         }
 
         return stream.str();
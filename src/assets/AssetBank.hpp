@@ -5,35 +5,71 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <span>
 #include <string>
 #include <vector>
 
 namespace decl_audio::assets
 {
-    inline constexpr std::uint32_t kRequiredSampleRate = 48000; // todo
+    // The rate assets are converted to when the caller names none; baked banks
+    // built without a rate hold their samples at this rate.
+    inline constexpr std::uint32_t kDefaultSampleRate = 48000;
+    // Frames of a streamed asset kept decoded in memory when the caller names
+    // no length: what a voice plays while its stream opens and fills.
+    inline constexpr std::uint32_t kDefaultStreamHeadFrames = 32768;
 
+    class ResampleCache;
+
+    // An asset's interleaved frames, held in one of the compiler::SampleFormat
+    // layouts: only the vector matching `format` is populated (see
+    // SampleCodec.hpp for the ADPCM block layout). A streamed asset holds
+    // only its head as F32 and names the file the rest is read from.
     struct DecodedBuffer final
     {
         std::vector<float> samples;
+        std::vector<std::int16_t> pcm16;
+        std::vector<std::uint8_t> adpcm;
+        compiler::SampleFormat format = compiler::SampleFormat::F32;
         std::uint64_t frame_count = 0;
         std::uint32_t channel_count = 0;
         std::uint32_t sample_rate = 0;
+        // Set for a streamed asset; `samples` then covers HeadFrameCount() of
+        // its frame_count frames.
+        std::filesystem::path stream_path;
+
+        [[nodiscard]] bool IsStreamed() const noexcept
+        {
+            return !stream_path.empty();
+        }
+
+        [[nodiscard]] std::uint64_t HeadFrameCount() const noexcept
+        {
+            return channel_count != 0 ? samples.size() / channel_count : 0;
+        }
 
         [[nodiscard]] std::size_t SampleCount() const noexcept
         {
-            return samples.size();
+            return static_cast<std::size_t>(frame_count * channel_count);
+        }
+
+        // Bytes of sample storage held in memory.
+        [[nodiscard]] std::size_t ResidentBytes() const noexcept
+        {
+            return samples.size() * sizeof(float) + pcm16.size() * sizeof(std::int16_t) + adpcm.size();
         }
     };
 
+    // Buffers are immutable once loaded and shared: banks converted through
+    // the same ResampleCache entry hold the one copy between them.
     struct AssetBank final
     {
-        std::vector<DecodedBuffer> buffers;
+        std::vector<std::shared_ptr<const DecodedBuffer>> buffers;
         std::vector<std::filesystem::path> source_paths;
 
         [[nodiscard]] const DecodedBuffer &GetBuffer(compiler::AssetId id) const
         {
-            return buffers.at(static_cast<std::size_t>(id));
+            return *buffers.at(static_cast<std::size_t>(id));
         }
 
         [[nodiscard]] const std::filesystem::path &GetSourcePath(compiler::AssetId id) const
@@ -53,6 +89,14 @@ namespace decl_audio::assets
         }
     };
 
-    [[nodiscard]] LoadResult LoadAssetBank(const compiler::CompiledBank &compiled_bank, const std::filesystem::path &source_path);
+    // Decodes every asset of `compiled_bank` and converts any not already at
+    // `target_sample_rate` (see ResampleBuffer), through `cache` when given.
+    // Streamed assets keep only their first `stream_head_frames` frames (see
+    // LoadStreamedAsset).
+    [[nodiscard]] LoadResult LoadAssetBank(const compiler::CompiledBank &compiled_bank,
+                                           const std::filesystem::path &source_path,
+                                           std::uint32_t target_sample_rate = kDefaultSampleRate,
+                                           ResampleCache *cache = nullptr,
+                                           std::uint32_t stream_head_frames = kDefaultStreamHeadFrames);
     [[nodiscard]] std::string DumpAssetBank(const compiler::CompiledBank &compiled_bank, const AssetBank &asset_bank);
 } // namespace decl_audio::assets
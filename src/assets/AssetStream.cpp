@@ -0,0 +1,116 @@
+#include "pch.h"
+
+#include "AssetStream.hpp"
+#include "../third_party/Miniaudio.hpp"
+
+#include <algorithm>
+
+namespace decl_audio::assets
+{
+    AssetStreamReader::AssetStreamReader() = default;
+
+    AssetStreamReader::~AssetStreamReader()
+    {
+        Close();
+    }
+
+    std::string AssetStreamReader::Open(const std::filesystem::path &path, const std::uint32_t output_rate)
+    {
+        Close();
+
+        auto decoder = std::make_unique<ma_decoder>();
+        const ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, output_rate);
+#ifdef _WIN32
+        const ma_result init_result = ma_decoder_init_file_w(path.wstring().c_str(), &config, decoder.get());
+#else
+        const ma_result init_result = ma_decoder_init_file(path.string().c_str(), &config, decoder.get());
+#endif
+        if (init_result != MA_SUCCESS)
+            return "failed to initialize decoder for " + path.string() + "; decoder failed with result " + std::to_string(static_cast<int>(init_result));
+
+        ma_format format = ma_format_unknown;
+        ma_uint32 channels = 0;
+        ma_uint32 sample_rate = 0;
+        ma_uint64 frame_count = 0;
+        std::string error;
+        if (ma_decoder_get_data_format(decoder.get(), &format, &channels, &sample_rate, nullptr, 0) != MA_SUCCESS || format != ma_format_f32)
+            error = "decoder did not produce float samples for " + path.string();
+        else if (channels == 0 || channels > 2)
+            error = "unsupported channel count " + std::to_string(channels) + "; MVP supports mono or stereo assets only";
+        else if (ma_decoder_get_length_in_pcm_frames(decoder.get(), &frame_count) != MA_SUCCESS)
+            error = "failed to query decoded frame count for " + path.string();
+
+        if (!error.empty())
+        {
+            ma_decoder_uninit(decoder.get());
+            return error;
+        }
+
+        decoder_ = std::move(decoder);
+        frame_count_ = frame_count;
+        channel_count_ = channels;
+        return {};
+    }
+
+    void AssetStreamReader::Close() noexcept
+    {
+        if (decoder_ != nullptr)
+        {
+            ma_decoder_uninit(decoder_.get());
+            decoder_.reset();
+        }
+
+        frame_count_ = 0;
+        channel_count_ = 0;
+    }
+
+    bool AssetStreamReader::Seek(const std::uint64_t frame) noexcept
+    {
+        return decoder_ != nullptr && ma_decoder_seek_to_pcm_frame(decoder_.get(), frame) == MA_SUCCESS;
+    }
+
+    std::uint64_t AssetStreamReader::Read(float *output, const std::uint64_t frames) noexcept
+    {
+        std::uint64_t total = 0;
+        while (decoder_ != nullptr && total < frames)
+        {
+            ma_uint64 frames_read = 0;
+            const ma_result result = ma_decoder_read_pcm_frames(decoder_.get(), output + total * channel_count_, frames - total, &frames_read);
+            total += frames_read;
+            if (result != MA_SUCCESS || frames_read == 0)
+                break;
+        }
+
+        return total;
+    }
+
+    std::string LoadStreamedAsset(const std::filesystem::path &path,
+                                  const std::uint32_t output_rate,
+                                  const std::uint32_t head_frames,
+                                  DecodedBuffer &buffer)
+    {
+        AssetStreamReader reader;
+        std::string error = reader.Open(path, output_rate);
+        if (!error.empty())
+            return error;
+
+        // At least one frame stays resident: a loop's wrap reads frame 0 from
+        // the head while the stream is still on the previous pass.
+        const std::uint64_t resident_head = std::max<std::uint32_t>(head_frames, 1);
+        const bool streamed = reader.FrameCount() > resident_head;
+        const std::uint64_t resident_frames = streamed ? resident_head : reader.FrameCount();
+
+        buffer = DecodedBuffer{};
+        buffer.frame_count = reader.FrameCount();
+        buffer.channel_count = reader.ChannelCount();
+        buffer.sample_rate = output_rate;
+        buffer.samples.resize(static_cast<std::size_t>(resident_frames * buffer.channel_count));
+        const std::uint64_t frames_read = reader.Read(buffer.samples.data(), resident_frames);
+        if (frames_read != resident_frames)
+            return "decoder stopped early for " + path.string() + "; expected " + std::to_string(resident_frames) + " frames, got " + std::to_string(frames_read);
+
+        if (streamed)
+            buffer.stream_path = path;
+        return {};
+    }
+} // namespace decl_audio::assets
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "AssetBank.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+struct ma_decoder;
+
+namespace decl_audio::assets
+{
+    // Sequential reader over an audio file that decodes to interleaved floats
+    // at a fixed output rate. The streaming I/O thread owns one per open
+    // stream; LoadStreamedAsset uses one to read an asset's head.
+    class AssetStreamReader final
+    {
+    public:
+        AssetStreamReader();
+        ~AssetStreamReader();
+
+        AssetStreamReader(const AssetStreamReader &) = delete;
+        AssetStreamReader &operator=(const AssetStreamReader &) = delete;
+
+        // Opens `path` decoding at `output_rate`; returns an error message, or
+        // an empty string on success. Closes any file already open.
+        [[nodiscard]] std::string Open(const std::filesystem::path &path, std::uint32_t output_rate);
+        void Close() noexcept;
+
+        [[nodiscard]] bool IsOpen() const noexcept
+        {
+            return decoder_ != nullptr;
+        }
+
+        // In frames at the output rate.
+        [[nodiscard]] std::uint64_t FrameCount() const noexcept
+        {
+            return frame_count_;
+        }
+
+        [[nodiscard]] std::uint32_t ChannelCount() const noexcept
+        {
+            return channel_count_;
+        }
+
+        [[nodiscard]] bool Seek(std::uint64_t frame) noexcept;
+        // Decodes up to `frames` frames; returns how many were read, short at
+        // the end of the file or on a decode error.
+        [[nodiscard]] std::uint64_t Read(float *output, std::uint64_t frames) noexcept;
+
+    private:
+        std::unique_ptr<ma_decoder> decoder_;
+        std::uint64_t frame_count_ = 0;
+        std::uint32_t channel_count_ = 0;
+    };
+
+    // Reads the first `head_frames` frames of the asset at `path`, decoded at
+    // `output_rate`, into `buffer` as a streamed asset. An asset no longer
+    // than its head is read whole and not streamed. Returns an error message,
+    // or an empty string on success.
+    [[nodiscard]] std::string LoadStreamedAsset(const std::filesystem::path &path,
+                                                std::uint32_t output_rate,
+                                                std::uint32_t head_frames,
+                                                DecodedBuffer &buffer);
+} // namespace decl_audio::assets
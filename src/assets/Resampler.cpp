@@ -0,0 +1,236 @@
+#include "pch.h"
+
+#include "Resampler.hpp"
+#include "AssetStream.hpp"
+#include "SampleCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace decl_audio::assets
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        // Filter half-width in zero crossings of the cutoff sinc; with the
+        // Kaiser beta below the stopband sits around -90 dB.
+        constexpr double kZeroCrossings = 16.0;
+        constexpr double kKaiserBeta = 9.0;
+        // Cutoff as a fraction of the lower Nyquist rate, leaving room for the
+        // transition band below it.
+        constexpr double kPassband = 0.95;
+        // Ratios with more phases than this (co-prime rates such as 44101 Hz)
+        // interpolate between neighbouring rows of a kMaxPhases table instead.
+        constexpr std::uint64_t kMaxPhases = 1024;
+
+        [[nodiscard]] double BesselI0(const double x)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            for (int k = 1; k < 64; ++k)
+            {
+                const double factor = x / (2.0 * k);
+                term *= factor * factor;
+                sum += term;
+                if (term < sum * 1e-17)
+                    break;
+            }
+
+            return sum;
+        }
+
+        struct PolyphaseFilter final
+        {
+            std::uint32_t half_taps = 0;
+            std::uint32_t phase_count = 0;
+            // phase_count + 1 rows of 2 * half_taps taps; row r is the filter
+            // for an output instant r / phase_count of a frame past its input
+            // frame, and the extra row closes the interpolation at phase 1.
+            std::vector<float> taps;
+
+            [[nodiscard]] std::uint32_t RowLength() const noexcept
+            {
+                return half_taps * 2;
+            }
+        };
+
+        [[nodiscard]] PolyphaseFilter DesignFilter(const std::uint64_t up, const std::uint64_t down)
+        {
+            // In cycles per input frame; downsampling pulls it under the output
+            // Nyquist rate so nothing above it folds back.
+            const double cutoff = 0.5 * kPassband * std::min(1.0, static_cast<double>(up) / static_cast<double>(down));
+            const double half_width = kZeroCrossings / (2.0 * cutoff);
+            const double window_norm = BesselI0(kKaiserBeta);
+
+            PolyphaseFilter filter;
+            filter.half_taps = static_cast<std::uint32_t>(std::ceil(half_width));
+            filter.phase_count = static_cast<std::uint32_t>(std::min(up, kMaxPhases));
+            filter.taps.resize(static_cast<std::size_t>(filter.phase_count + 1) * filter.RowLength());
+
+            for (std::uint32_t row = 0; row <= filter.phase_count; ++row)
+            {
+                const double phase = static_cast<double>(row) / static_cast<double>(filter.phase_count);
+                float *const row_taps = filter.taps.data() + static_cast<std::size_t>(row) * filter.RowLength();
+                for (std::uint32_t tap = 0; tap < filter.RowLength(); ++tap)
+                {
+                    // Distance from input frame (floor + tap - half_taps + 1) to
+                    // the output instant.
+                    const double t = phase - (static_cast<double>(tap) - static_cast<double>(filter.half_taps) + 1.0);
+                    if (std::fabs(t) >= half_width)
+                    {
+                        row_taps[tap] = 0.0f;
+                        continue;
+                    }
+
+                    const double x = 2.0 * cutoff * t;
+                    const double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+                    const double ratio = t / half_width;
+                    const double window = BesselI0(kKaiserBeta * std::sqrt(1.0 - ratio * ratio)) / window_norm;
+                    row_taps[tap] = static_cast<float>(2.0 * cutoff * sinc * window);
+                }
+            }
+
+            return filter;
+        }
+    } // namespace
+
+    DecodedBuffer ResampleBuffer(const DecodedBuffer &source, const std::uint32_t target_rate)
+    {
+        if (source.sample_rate == target_rate || source.sample_rate == 0 || target_rate == 0)
+            return source;
+
+        // Output frame n sits at input time n * down / up.
+        const std::uint64_t divisor = std::gcd(source.sample_rate, target_rate);
+        const std::uint64_t up = target_rate / divisor;
+        const std::uint64_t down = source.sample_rate / divisor;
+        const PolyphaseFilter filter = DesignFilter(up, down);
+
+        DecodedBuffer output;
+        output.channel_count = source.channel_count;
+        output.sample_rate = target_rate;
+        output.frame_count = (source.frame_count * up + down - 1) / down;
+        output.samples.resize(static_cast<std::size_t>(output.frame_count * output.channel_count));
+
+        const std::int64_t frame_count = static_cast<std::int64_t>(source.frame_count);
+        const std::int64_t half_taps = filter.half_taps;
+        const std::uint32_t channels = source.channel_count;
+        std::vector<double> sums(channels);
+
+        for (std::uint64_t frame = 0; frame < output.frame_count; ++frame)
+        {
+            const std::uint64_t position = frame * down;
+            const std::int64_t input_frame = static_cast<std::int64_t>(position / up);
+            const std::uint64_t phase = (position % up) * filter.phase_count;
+            const float *const row_a = filter.taps.data() + static_cast<std::size_t>(phase / up) * filter.RowLength();
+            const float *const row_b = row_a + filter.RowLength();
+            const float weight = static_cast<float>(static_cast<double>(phase % up) / static_cast<double>(up));
+
+            // Taps whose input frame falls outside the source read silence.
+            const std::int64_t first_tap = std::max<std::int64_t>(0, half_taps - 1 - input_frame);
+            const std::int64_t end_tap = std::min<std::int64_t>(half_taps * 2, frame_count - input_frame + half_taps - 1);
+
+            std::fill(sums.begin(), sums.end(), 0.0);
+            for (std::int64_t tap = first_tap; tap < end_tap; ++tap)
+            {
+                const double coefficient = row_a[tap] + (row_b[tap] - row_a[tap]) * weight;
+                const float *const in = source.samples.data() + static_cast<std::size_t>(input_frame + tap - half_taps + 1) * channels;
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    sums[channel] += coefficient * in[channel];
+            }
+
+            float *const out = output.samples.data() + static_cast<std::size_t>(frame) * channels;
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                out[channel] = static_cast<float>(sums[channel]);
+        }
+
+        return output;
+    }
+
+    std::string MakeResampleKey(const std::filesystem::path &path, const std::string &asset_name)
+    {
+        // A file that cannot be stat'ed keys as empty size and time; it fails
+        // to load before its key matters.
+        std::error_code error;
+        const std::uintmax_t size = std::filesystem::file_size(path, error);
+        const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(path, error);
+
+        std::string key = path.string();
+        if (!asset_name.empty())
+            key += '#' + asset_name;
+        key += '|' + std::to_string(error ? 0 : size) + '|' + std::to_string(error ? 0 : write_time.time_since_epoch().count());
+        return key;
+    }
+
+    std::shared_ptr<const DecodedBuffer> ResampleCache::Convert(const std::string &asset_key,
+                                                                const DecodedBuffer &source,
+                                                                const std::uint32_t target_rate,
+                                                                const compiler::SampleFormat format)
+    {
+        if (source.sample_rate == target_rate)
+            return std::make_shared<const DecodedBuffer>(EncodeBuffer(source, format));
+
+        // Converted under the lock so two loads of one asset filter it once.
+        const std::lock_guard<std::mutex> lock(mutex_);
+        DropExpiredEntries();
+        std::weak_ptr<const DecodedBuffer> &entry = entries_[Key(asset_key, target_rate, format)];
+        std::shared_ptr<const DecodedBuffer> buffer = entry.lock();
+        if (buffer == nullptr)
+        {
+            buffer = std::make_shared<const DecodedBuffer>(EncodeBuffer(ResampleBuffer(source, target_rate), format));
+            entry = buffer;
+        }
+
+        return buffer;
+    }
+
+    std::size_t ResampleCache::EntryCount() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        DropExpiredEntries();
+        return entries_.size();
+    }
+
+    void ResampleCache::DropExpiredEntries() const
+    {
+        std::erase_if(entries_, [](const auto &entry) { return entry.second.expired(); });
+    }
+
+    std::vector<decl_audio::Diagnostic> ConvertAssetBankSampleRate(AssetBank &bank,
+                                                                  const std::vector<std::string> &asset_keys,
+                                                                  const std::uint32_t target_rate,
+                                                                  ResampleCache *cache)
+    {
+        std::vector<decl_audio::Diagnostic> diagnostics;
+        for (std::size_t asset_index = 0; asset_index < bank.buffers.size(); ++asset_index)
+        {
+            std::shared_ptr<const DecodedBuffer> &buffer = bank.buffers[asset_index];
+            if (buffer->sample_rate == target_rate)
+                continue;
+
+            if (buffer->IsStreamed())
+            {
+                const std::filesystem::path stream_path = buffer->stream_path;
+                DecodedBuffer head;
+                const std::string error = LoadStreamedAsset(stream_path, target_rate, static_cast<std::uint32_t>(buffer->HeadFrameCount()), head);
+                if (!error.empty())
+                    diagnostics.push_back(MakeError(stream_path.string(), "asset[" + std::to_string(asset_index) + "]", error));
+                else
+                    buffer = std::make_shared<const DecodedBuffer>(std::move(head));
+                continue;
+            }
+
+            // Compact buffers (from baked banks) convert through floats and are
+            // re-encoded in their own format.
+            const compiler::SampleFormat format = buffer->format;
+            const DecodedBuffer source = DecodeBuffer(*buffer);
+            buffer = cache != nullptr ? cache->Convert(asset_keys[asset_index], source, target_rate, format)
+                                      : std::make_shared<const DecodedBuffer>(EncodeBuffer(ResampleBuffer(source, target_rate), format));
+        }
+
+        return diagnostics;
+    }
+} // namespace decl_audio::assets
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "AssetBank.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace decl_audio::assets
+{
+    // `source` converted to `target_rate` by a polyphase windowed-sinc filter
+    // (Kaiser window, 16 zero crossings each side, cutoff just under the lower
+    // of the two Nyquist rates). The output starts at the same instant and runs
+    // ceil(frames * target / source) frames; samples outside the source read as
+    // silence. A buffer already at `target_rate` is returned unchanged. F32
+    // buffers only; see DecodeBuffer.
+    [[nodiscard]] DecodedBuffer ResampleBuffer(const DecodedBuffer &source, std::uint32_t target_rate);
+
+    // Identifies the contents of `path` to a ResampleCache: the path with the
+    // file's size and last write time, so a rebuilt file misses the cache.
+    // `asset_name`, when given, names one asset stored inside the file.
+    [[nodiscard]] std::string MakeResampleKey(const std::filesystem::path &path, const std::string &asset_name = {});
+
+    // Converted buffers keyed by asset contents (see MakeResampleKey), target
+    // rate and sample format, so an asset shared by several banks is filtered
+    // and stored once. The cache holds no samples itself: an entry lives only
+    // as long as some bank holds its buffer, and expired entries are dropped
+    // on the next lookup. Thread-safe: the async bank loader converts on its
+    // worker.
+    class ResampleCache final
+    {
+    public:
+        // `source` (F32) converted to `target_rate` and encoded as `format`,
+        // shared with any live bank that converted the same asset. Buffers
+        // already at `target_rate` bypass the cache.
+        [[nodiscard]] std::shared_ptr<const DecodedBuffer> Convert(const std::string &asset_key,
+                                                                   const DecodedBuffer &source,
+                                                                   std::uint32_t target_rate,
+                                                                   compiler::SampleFormat format);
+
+        // Entries whose buffer is still held by some bank.
+        [[nodiscard]] std::size_t EntryCount() const;
+
+    private:
+        using Key = std::tuple<std::string, std::uint32_t, compiler::SampleFormat>;
+
+        void DropExpiredEntries() const;
+
+        mutable std::mutex mutex_;
+        mutable std::map<Key, std::weak_ptr<const DecodedBuffer>> entries_;
+    };
+
+    // Converts every buffer in `bank` to `target_rate`, keeping its format.
+    // `asset_keys` (one per buffer) identify the assets to `cache`; without a
+    // cache every buffer is converted directly. Streamed buffers re-read their head from their file
+    // at the new rate instead; a file that no longer opens is an error.
+    [[nodiscard]] std::vector<decl_audio::Diagnostic> ConvertAssetBankSampleRate(AssetBank &bank,
+                                                                                const std::vector<std::string> &asset_keys,
+                                                                                std::uint32_t target_rate,
+                                                                                ResampleCache *cache);
+} // namespace decl_audio::assets
@@ -0,0 +1,248 @@
+#include "pch.h"
+
+#include "SampleCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace decl_audio::assets
+{
+    namespace
+    {
+        constexpr std::int8_t kIndexTable[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+        constexpr std::int16_t kStepTable[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+            50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+            337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+            2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+            15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+        struct AdpcmState final
+        {
+            std::int32_t predictor = 0;
+            std::int32_t index = 0;
+
+            // Applies one 4-bit code, exactly as the decoder does.
+            void Step(const std::uint8_t code) noexcept
+            {
+                const std::int32_t step = kStepTable[index];
+                std::int32_t delta = step >> 3;
+                if (code & 4)
+                    delta += step;
+                if (code & 2)
+                    delta += step >> 1;
+                if (code & 1)
+                    delta += step >> 2;
+
+                predictor = std::clamp(predictor + ((code & 8) ? -delta : delta), -32768, 32767);
+                index = std::clamp(index + kIndexTable[code], 0, 88);
+            }
+
+            [[nodiscard]] std::uint8_t Encode(const std::int32_t sample) noexcept
+            {
+                std::int32_t diff = sample - predictor;
+                std::uint8_t code = 0;
+                if (diff < 0)
+                {
+                    code = 8;
+                    diff = -diff;
+                }
+
+                std::int32_t step = kStepTable[index];
+                for (std::uint8_t bit = 4; bit != 0; bit >>= 1)
+                {
+                    if (diff >= step)
+                    {
+                        code |= bit;
+                        diff -= step;
+                    }
+                    step >>= 1;
+                }
+
+                Step(code);
+                return code;
+            }
+        };
+
+        [[nodiscard]] std::int16_t QuantizeS16(const float sample) noexcept
+        {
+            return static_cast<std::int16_t>(std::clamp<long>(std::lround(sample * 32768.0f), -32768, 32767));
+        }
+
+        // Encodes one channel of a block (`frames` samples, `stride` apart)
+        // starting from step index `index` into `bytes`, when given, and
+        // returns the squared error of what the decoder will reproduce.
+        std::int64_t EncodeAdpcmBlock(const std::int16_t *samples, const std::uint32_t stride, const std::uint64_t frames, const std::int32_t index, std::uint8_t *bytes) noexcept
+        {
+            AdpcmState state;
+            state.predictor = samples[0];
+            state.index = index;
+            if (bytes != nullptr)
+            {
+                bytes[0] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(samples[0]) & 0xFF);
+                bytes[1] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(samples[0]) >> 8);
+                bytes[2] = static_cast<std::uint8_t>(index);
+            }
+
+            std::int64_t error = 0;
+            for (std::uint64_t frame = 1; frame < frames; ++frame)
+            {
+                const std::int32_t sample = samples[frame * stride];
+                const std::uint8_t code = state.Encode(sample);
+                error += static_cast<std::int64_t>(sample - state.predictor) * (sample - state.predictor);
+                if (bytes != nullptr)
+                    bytes[4 + (frame - 1) / 2] |= static_cast<std::uint8_t>(code << (((frame - 1) & 1) * 4));
+            }
+
+            return error;
+        }
+
+        [[nodiscard]] std::uint64_t AdpcmBlockCount(const std::uint64_t frame_count) noexcept
+        {
+            return (frame_count + kAdpcmBlockFrames - 1) / kAdpcmBlockFrames;
+        }
+    } // namespace
+
+    std::size_t AdpcmByteCount(const std::uint64_t frame_count, const std::uint32_t channel_count) noexcept
+    {
+        return static_cast<std::size_t>(AdpcmBlockCount(frame_count) * channel_count * kAdpcmChannelBlockBytes);
+    }
+
+    bool HasConsistentStorage(const DecodedBuffer &buffer) noexcept
+    {
+        const std::uint64_t sample_count = buffer.frame_count * buffer.channel_count;
+        if (buffer.IsStreamed())
+        {
+            return buffer.format == compiler::SampleFormat::F32 && buffer.channel_count != 0 && buffer.samples.size() % buffer.channel_count == 0 &&
+                   buffer.samples.size() < sample_count && buffer.pcm16.empty() && buffer.adpcm.empty();
+        }
+
+        switch (buffer.format)
+        {
+        case compiler::SampleFormat::F32:
+            return buffer.samples.size() == sample_count && buffer.pcm16.empty() && buffer.adpcm.empty();
+        case compiler::SampleFormat::S16:
+            return buffer.pcm16.size() == sample_count && buffer.samples.empty() && buffer.adpcm.empty();
+        case compiler::SampleFormat::ImaAdpcm:
+            return buffer.adpcm.size() == AdpcmByteCount(buffer.frame_count, buffer.channel_count) && buffer.samples.empty() && buffer.pcm16.empty();
+        }
+
+        return false;
+    }
+
+    DecodedBuffer EncodeBuffer(DecodedBuffer buffer, const compiler::SampleFormat format)
+    {
+        if (buffer.format != compiler::SampleFormat::F32 || format == compiler::SampleFormat::F32 || buffer.IsStreamed())
+            return buffer;
+
+        const std::uint32_t channels = buffer.channel_count;
+        if (format == compiler::SampleFormat::S16)
+        {
+            buffer.pcm16.resize(buffer.samples.size());
+            std::transform(buffer.samples.begin(), buffer.samples.end(), buffer.pcm16.begin(), QuantizeS16);
+        }
+        else
+        {
+            // Every header carries its own step index, so each block starts
+            // from whichever index reproduces it best; a fixed start would
+            // spend the first frames of a loud block ramping the step up.
+            std::vector<std::int16_t> quantized(buffer.samples.size());
+            std::transform(buffer.samples.begin(), buffer.samples.end(), quantized.begin(), QuantizeS16);
+
+            buffer.adpcm.assign(AdpcmByteCount(buffer.frame_count, channels), 0);
+            for (std::uint64_t block = 0; block < AdpcmBlockCount(buffer.frame_count); ++block)
+            {
+                const std::uint64_t first_frame = block * kAdpcmBlockFrames;
+                const std::uint64_t block_frames = std::min<std::uint64_t>(kAdpcmBlockFrames, buffer.frame_count - first_frame);
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const std::int16_t *const samples = quantized.data() + static_cast<std::size_t>(first_frame * channels + channel);
+                    std::int32_t best_index = 0;
+                    std::int64_t best_error = EncodeAdpcmBlock(samples, channels, block_frames, 0, nullptr);
+                    for (std::int32_t index = 1; index <= 88 && best_error != 0; ++index)
+                    {
+                        const std::int64_t error = EncodeAdpcmBlock(samples, channels, block_frames, index, nullptr);
+                        if (error < best_error)
+                        {
+                            best_index = index;
+                            best_error = error;
+                        }
+                    }
+
+                    std::uint8_t *const bytes = buffer.adpcm.data() + static_cast<std::size_t>((block * channels + channel) * kAdpcmChannelBlockBytes);
+                    (void)EncodeAdpcmBlock(samples, channels, block_frames, best_index, bytes);
+                }
+            }
+        }
+
+        buffer.format = format;
+        buffer.samples.clear();
+        buffer.samples.shrink_to_fit();
+        return buffer;
+    }
+
+    DecodedBuffer DecodeBuffer(const DecodedBuffer &buffer)
+    {
+        if (buffer.format == compiler::SampleFormat::F32)
+            return buffer;
+
+        DecodedBuffer decoded;
+        decoded.frame_count = buffer.frame_count;
+        decoded.channel_count = buffer.channel_count;
+        decoded.sample_rate = buffer.sample_rate;
+        decoded.samples.resize(buffer.SampleCount());
+        if (buffer.format == compiler::SampleFormat::S16)
+        {
+            std::transform(buffer.pcm16.begin(), buffer.pcm16.end(), decoded.samples.begin(),
+                           [](const std::int16_t sample) { return static_cast<float>(sample) * kS16Scale; });
+        }
+        else
+        {
+            for (std::uint64_t frame = 0; frame < buffer.frame_count; frame += kAdpcmBlockFrames)
+            {
+                const std::uint32_t run = static_cast<std::uint32_t>(std::min<std::uint64_t>(kAdpcmBlockFrames, buffer.frame_count - frame));
+                DecodeAdpcmFrames(buffer, frame, run, decoded.samples.data() + static_cast<std::size_t>(frame * buffer.channel_count));
+            }
+        }
+
+        return decoded;
+    }
+
+    void DecodeAdpcmFrames(const DecodedBuffer &buffer, std::uint64_t first_frame, const std::uint32_t frame_count, float *output) noexcept
+    {
+        const std::uint32_t channels = buffer.channel_count;
+        const std::uint64_t end_frame = first_frame + frame_count;
+        while (first_frame < end_frame)
+        {
+            // Each block decodes from its header up to the last frame wanted,
+            // writing only the frames from `skip` on.
+            const std::uint64_t block = first_frame / kAdpcmBlockFrames;
+            const std::uint32_t skip = static_cast<std::uint32_t>(first_frame % kAdpcmBlockFrames);
+            const std::uint32_t run = static_cast<std::uint32_t>(std::min<std::uint64_t>(kAdpcmBlockFrames - skip, end_frame - first_frame));
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const std::uint8_t *const bytes = buffer.adpcm.data() + static_cast<std::size_t>((block * channels + channel) * kAdpcmChannelBlockBytes);
+                AdpcmState state;
+                state.predictor = static_cast<std::int16_t>(static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8)));
+                state.index = std::min<std::int32_t>(bytes[2], 88);
+
+                float *out = output + channel;
+                for (std::uint32_t frame = 0; frame < skip + run; ++frame)
+                {
+                    if (frame != 0)
+                        state.Step(static_cast<std::uint8_t>((bytes[4 + (frame - 1) / 2] >> (((frame - 1) & 1) * 4)) & 0xF));
+                    if (frame >= skip)
+                    {
+                        *out = static_cast<float>(state.predictor) * kS16Scale;
+                        out += channels;
+                    }
+                }
+            }
+
+            output += static_cast<std::size_t>(run) * channels;
+            first_frame += run;
+        }
+    }
+} // namespace decl_audio::assets
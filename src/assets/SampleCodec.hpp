@@ -0,0 +1,40 @@
+#pragma once
+
+#include "AssetBank.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace decl_audio::assets
+{
+    // IMA ADPCM storage is a run of fixed-size blocks of kAdpcmBlockFrames
+    // frames (the last one padded). Each block holds, per channel in turn, a
+    // 4-byte header (int16 first sample, little-endian, then the step index and
+    // a zero byte) followed by the 4-bit codes of the block's remaining frames,
+    // low nibble first. Blocks decode independently, so a voice can start
+    // reading at any block without decoding what came before it.
+    inline constexpr std::uint32_t kAdpcmBlockFrames = 256;
+    inline constexpr std::uint32_t kAdpcmChannelBlockBytes = 4 + kAdpcmBlockFrames / 2;
+
+    // S16 frames scale by this to float (and back, rounded and clamped).
+    inline constexpr float kS16Scale = 1.0f / 32768.0f;
+
+    [[nodiscard]] std::size_t AdpcmByteCount(std::uint64_t frame_count, std::uint32_t channel_count) noexcept;
+
+    // True when the vector `buffer.format` names holds exactly frame_count
+    // frames (and the others are empty), or a streamed buffer holds a head
+    // shorter than that: what a baked bank must provide before the audio
+    // thread indexes it.
+    [[nodiscard]] bool HasConsistentStorage(const DecodedBuffer &buffer) noexcept;
+
+    // `buffer` (F32) re-encoded as `format`; its float samples are released.
+    // Streamed buffers stay F32.
+    [[nodiscard]] DecodedBuffer EncodeBuffer(DecodedBuffer buffer, compiler::SampleFormat format);
+
+    // `buffer` decoded back to F32, for load-time work such as resampling.
+    [[nodiscard]] DecodedBuffer DecodeBuffer(const DecodedBuffer &buffer);
+
+    // Decodes `frame_count` frames of an ImaAdpcm buffer starting at
+    // `first_frame` into interleaved floats. The run must lie inside the buffer.
+    void DecodeAdpcmFrames(const DecodedBuffer &buffer, std::uint64_t first_frame, std::uint32_t frame_count, float *output) noexcept;
+} // namespace decl_audio::assets
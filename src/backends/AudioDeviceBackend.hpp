@@ -18,6 +18,8 @@ namespace decl_audio::backends
                            std::string &error_message) noexcept = 0;
         virtual void Stop() noexcept = 0;
         [[nodiscard]] virtual bool IsStarted() const noexcept = 0;
+        // Callbacks the render-ahead queue could not fully cover since Start.
+        [[nodiscard]] virtual std::uint32_t UnderrunCount() const noexcept = 0;
     };
 
     [[nodiscard]] std::unique_ptr<AudioDeviceBackend> CreateAudioDeviceBackend(DeclAudioBackend backend);
@@ -1,20 +1,25 @@
 #include "pch.h"
 
 #include "MiniaudioBackend.hpp"
+#include "../playback/RenderAheadStream.hpp"
 #include "../third_party/Miniaudio.hpp"
 
 #include <sstream>
 
 namespace decl_audio::backends
 {
-    struct MiniaudioBackend::Impl final
-    {
-        ma_device device{};
-        bool started = false;
-    };
-
     namespace
     {
+        // What the device callback needs. The runtime mixes planar; this bus is
+        // the one place its output is interleaved for the device. With
+        // render-ahead the stream owns mixing and the callback only copies.
+        struct CallbackContext final
+        {
+            playback::AudioRuntime *runtime = nullptr;
+            playback::MixBus bus;
+            std::unique_ptr<playback::RenderAheadStream> render_ahead;
+        };
+
         [[nodiscard]] std::string FormatMiniaudioError(const ma_result result)
         {
             std::ostringstream stream;
@@ -26,11 +31,37 @@ namespace decl_audio::backends
         {
             (void)input;
 
-            playback::AudioRuntime *runtime = static_cast<playback::AudioRuntime *>(device->pUserData);
-            runtime->Render(static_cast<float *>(output), static_cast<std::uint32_t>(frame_count));
+            CallbackContext *context = static_cast<CallbackContext *>(device->pUserData);
+            float *interleaved = static_cast<float *>(output);
+            if (context->render_ahead != nullptr)
+            {
+                context->render_ahead->Read(interleaved, static_cast<std::uint32_t>(frame_count));
+                return;
+            }
+
+            const std::uint32_t channel_count = context->bus.ChannelCount();
+
+            // periodSizeInFrames is only a hint; split any larger callback into
+            // bus-sized blocks rather than overrunning the bus.
+            std::uint32_t remaining = static_cast<std::uint32_t>(frame_count);
+            while (remaining > 0)
+            {
+                const std::uint32_t block = remaining < context->bus.MaxFrames() ? remaining : context->bus.MaxFrames();
+                context->runtime->Render(context->bus, block);
+                context->bus.InterleaveTo(interleaved, block);
+                interleaved += static_cast<std::size_t>(block) * channel_count;
+                remaining -= block;
+            }
         }
     } // namespace
 
+    struct MiniaudioBackend::Impl final
+    {
+        ma_device device{};
+        CallbackContext callback;
+        bool started = false;
+    };
+
     MiniaudioBackend::MiniaudioBackend()
         : impl_(std::make_unique<Impl>())
     {
@@ -56,11 +87,25 @@ namespace decl_audio::backends
         device_config.sampleRate = config.sample_rate;
         device_config.periodSizeInFrames = config.callback_frame_count;
         device_config.dataCallback = DataCallback;
-        device_config.pUserData = &runtime;
+        device_config.pUserData = &impl_->callback;
+
+        impl_->callback.runtime = &runtime;
+        impl_->callback.bus = playback::MixBus(config.output_channel_count, config.max_block_frames);
+        if (config.render_ahead_frames > 0)
+        {
+            const std::uint32_t block_frames = config.render_quantum_frames > 0 ? config.render_quantum_frames : config.max_block_frames;
+            impl_->callback.render_ahead = std::make_unique<playback::RenderAheadStream>(
+                runtime,
+                config.output_channel_count,
+                block_frames,
+                config.render_ahead_frames,
+                config.render_ahead_headroom_frames);
+        }
 
         const ma_result init_result = ma_device_init(nullptr, &device_config, &impl_->device);
         if (init_result != MA_SUCCESS)
         {
+            impl_->callback.render_ahead.reset();
             error_message = FormatMiniaudioError(init_result);
             return false;
         }
@@ -69,6 +114,7 @@ namespace decl_audio::backends
         if (start_result != MA_SUCCESS)
         {
             ma_device_uninit(&impl_->device);
+            impl_->callback.render_ahead.reset();
             error_message = FormatMiniaudioError(start_result);
             return false;
         }
@@ -84,7 +130,9 @@ namespace decl_audio::backends
             return;
         }
 
+        // The device is gone before the stream: no callback can read it any more.
         ma_device_uninit(&impl_->device);
+        impl_->callback.render_ahead.reset();
         impl_->started = false;
     }
 
@@ -92,4 +140,10 @@ namespace decl_audio::backends
     {
         return impl_->started;
     }
+
+    std::uint32_t MiniaudioBackend::UnderrunCount() const noexcept
+    {
+        const playback::RenderAheadStream *render_ahead = impl_->callback.render_ahead.get();
+        return render_ahead != nullptr ? render_ahead->UnderrunCount() : 0;
+    }
 } // namespace decl_audio::backends
@@ -17,6 +17,7 @@ namespace decl_audio::backends
                    std::string &error_message) noexcept override;
         void Stop() noexcept override;
         [[nodiscard]] bool IsStarted() const noexcept override;
+        [[nodiscard]] std::uint32_t UnderrunCount() const noexcept override;
 
     private:
         struct Impl;
@@ -2,23 +2,25 @@
 
 #include "StubBackend.hpp"
 
-#include <exception>
+#include <algorithm>
 
 namespace decl_audio::backends
 {
-    StubBackend::StubBackend(const std::uint32_t max_block_frames)
-        : max_block_frames_(max_block_frames)
+    StubBackend::StubBackend(const std::uint32_t max_block_frames, const std::uint32_t channel_count)
+        : discard_bus_(channel_count, max_block_frames),
+          max_block_frames_(max_block_frames)
     {
-        discard_buffer_.resize(static_cast<std::size_t>(max_block_frames_) * 2);
     }
 
     void StubBackend::Pump(playback::AudioRuntime &runtime, const std::uint32_t frames) noexcept
     {
-        if (frames > max_block_frames_)
+        // Like a device callback, a long pump is fed through the bus in pieces.
+        std::uint32_t remaining = frames;
+        while (remaining > 0)
         {
-            std::terminate();
+            const std::uint32_t block = std::min(remaining, max_block_frames_);
+            runtime.Render(discard_bus_, block);
+            remaining -= block;
         }
-
-        runtime.Render(discard_buffer_.data(), frames);
     }
 } // namespace decl_audio::backends
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
 
 #include "../playback/AudioRuntime.hpp"
 
@@ -10,12 +9,12 @@ namespace decl_audio::backends
     class StubBackend final
     {
     public:
-        explicit StubBackend(std::uint32_t max_block_frames = 4096);
+        explicit StubBackend(std::uint32_t max_block_frames = 4096, std::uint32_t channel_count = 2);
 
         void Pump(playback::AudioRuntime &runtime, std::uint32_t frames) noexcept;
 
     private:
-        std::vector<float> discard_buffer_;
+        playback::MixBus discard_bus_;
         std::uint32_t max_block_frames_ = 0;
     };
 } // namespace decl_audio::backends
@@ -22,10 +22,18 @@ namespace decl_audio::compiler
         std::vector<std::string> assets;
         std::vector<AuthoringNode> children;
         std::string parameter;
+        std::string pitch_parameter; // leaves: semitones of pitch shift
+        bool stream = false;         // leaves: read the assets from disk while playing
         float volume = 1.0f;
         std::int32_t loop_count = 0;
     };
 
+    struct AuthoringCurvePoint final
+    {
+        float distance = 0.0f;
+        float gain = 0.0f;
+    };
+
     struct AuthoringSpatializationSettings final
     {
         decl_audio::SourceLocation location;
@@ -33,6 +41,44 @@ namespace decl_audio::compiler
         float min_distance = 0.0f;
         float max_distance = 0.0f;
         AttenuationMode attenuation = AttenuationMode::Linear;
+        std::vector<AuthoringCurvePoint> attenuation_curve; // Custom only
+    };
+
+    struct AuthoringFilter final
+    {
+        decl_audio::SourceLocation location;
+        bool enabled = false; // a "filter" object was authored
+        FilterType type = FilterType::LowPass;
+        bool has_cutoff = false;
+        float cutoff = 0.0f;          // Hz
+        std::string cutoff_parameter; // moves the cutoff across cutoffRange instead
+        bool has_cutoff_range = false;
+        float cutoff_from = 0.0f;     // Hz at parameter 0
+        float cutoff_to = 0.0f;       // Hz at parameter 1
+        float q = 0.70710678f;
+        bool has_gain_db = false;
+        float gain_db = 0.0f;
+    };
+
+    struct AuthoringSend final
+    {
+        decl_audio::SourceLocation location;
+        bool enabled = false; // a "send" object was authored
+        std::string bus;
+        float level = 1.0f;
+    };
+
+    // Sidechain ducking: the bus is turned down by up to depth_db while the
+    // envelope of bus `by` is at or above threshold_db.
+    struct AuthoringDuck final
+    {
+        decl_audio::SourceLocation location;
+        bool enabled = false; // a "duck" object was authored
+        std::string by;
+        float depth_db = -12.0f;
+        float threshold_db = -40.0f;
+        float attack_ms = 10.0f;
+        float release_ms = 250.0f;
     };
 
     struct AuthoringBehavior final
@@ -47,10 +93,34 @@ namespace decl_audio::compiler
         StopMode stop_mode = StopMode::Graceful;
         float stop_fade_ms = 50.0f;
         float start_fade_ms = 0.0f;
+        std::int32_t priority = 128; // 0..255; at capacity, lower priorities are stolen first
+        std::string bus;             // empty plays on the master output
+        AuthoringFilter filter;
+        AuthoringSend send;
+    };
+
+    struct AuthoringAssetFormat final
+    {
+        decl_audio::SourceLocation location;
+        std::string asset;
+        SampleFormat format = SampleFormat::F32;
+    };
+
+    struct AuthoringBus final
+    {
+        decl_audio::SourceLocation location;
+        std::string id;
+        std::string parent; // empty for a top-level bus
+        float volume = 1.0f;
+        AuthoringFilter filter;
+        std::string impulse_response; // asset path; empty for a plain bus
+        AuthoringDuck duck;
     };
 
     struct AuthoringDocument final
     {
         std::vector<AuthoringBehavior> behaviors;
+        std::vector<AuthoringAssetFormat> asset_formats;
+        std::vector<AuthoringBus> buses;
     };
 } // namespace decl_audio::compiler
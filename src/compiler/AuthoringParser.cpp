@@ -101,11 +101,322 @@ namespace decl_audio::compiler
 
             if (attenuation_name == "linear")
                 return AttenuationMode::Linear;
+            if (attenuation_name == "inverse")
+                return AttenuationMode::Inverse;
+            if (attenuation_name == "inverseSquare")
+                return AttenuationMode::InverseSquare;
+            if (attenuation_name == "logarithmic")
+                return AttenuationMode::Logarithmic;
+            if (attenuation_name == "custom")
+                return AttenuationMode::Custom;
 
             is_valid = false;
             return AttenuationMode::Linear;
         }
 
+        [[nodiscard]] FilterType ParseFilterType(std::string_view type_name, bool &is_valid)
+        {
+            is_valid = true;
+
+            if (type_name == "lowpass")
+                return FilterType::LowPass;
+            if (type_name == "highpass")
+                return FilterType::HighPass;
+            if (type_name == "lowshelf")
+                return FilterType::LowShelf;
+            if (type_name == "highshelf")
+                return FilterType::HighShelf;
+
+            is_valid = false;
+            return FilterType::LowPass;
+        }
+
+        [[nodiscard]] SampleFormat ParseSampleFormat(std::string_view format_name, bool &is_valid)
+        {
+            is_valid = true;
+
+            if (format_name == "f32")
+                return SampleFormat::F32;
+            if (format_name == "s16")
+                return SampleFormat::S16;
+            if (format_name == "adpcm")
+                return SampleFormat::ImaAdpcm;
+
+            is_valid = false;
+            return SampleFormat::F32;
+        }
+
+        void ParseAssetFormats(const Json &formats_json,
+                               std::string_view source_path,
+                               std::vector<AuthoringAssetFormat> &asset_formats,
+                               std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            if (!formats_json.is_object())
+            {
+                diagnostics.push_back(MakeError(source_path, "assetFormats", "must be an object"));
+                return;
+            }
+
+            for (const auto &[asset, format_json] : formats_json.items())
+            {
+                const std::string field_path = "assetFormats." + asset;
+                if (!format_json.is_string())
+                {
+                    diagnostics.push_back(MakeError(source_path, field_path, "must be a string"));
+                    continue;
+                }
+
+                bool is_valid = false;
+                AuthoringAssetFormat &asset_format = asset_formats.emplace_back();
+                asset_format.location = MakeLocation(source_path, field_path);
+                asset_format.asset = asset;
+                asset_format.format = ParseSampleFormat(format_json.get<std::string>(), is_valid);
+                if (!is_valid)
+                    diagnostics.push_back(MakeError(source_path, field_path, "must be 'f32', 's16' or 'adpcm'"));
+            }
+        }
+
+        AuthoringFilter ParseFilter(const Json &filter_json,
+                                    std::string_view source_path,
+                                    std::string_view field_path,
+                                    std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            AuthoringFilter filter;
+            filter.location = MakeLocation(source_path, field_path);
+            filter.enabled = true;
+
+            if (!filter_json.is_object())
+            {
+                diagnostics.push_back(MakeError(source_path, field_path, "must be an object"));
+                return filter;
+            }
+
+            for (auto it = filter_json.begin(); it != filter_json.end(); ++it)
+            {
+                const std::string key = it.key();
+                if (key != "type" && key != "cutoff" && key != "cutoffParameter" && key != "cutoffRange" && key != "q" && key != "gainDb")
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "is not a supported filter field"));
+            }
+
+            if (!filter_json.contains("type"))
+            {
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".type", "is required"));
+            }
+            else if (!filter_json["type"].is_string())
+            {
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".type", "must be a string"));
+            }
+            else
+            {
+                bool is_valid = false;
+                filter.type = ParseFilterType(filter_json["type"].get<std::string>(), is_valid);
+                if (!is_valid)
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".type", "must be 'lowpass', 'highpass', 'lowshelf' or 'highshelf'"));
+            }
+
+            if (filter_json.contains("cutoff"))
+            {
+                if (!IsNumber(filter_json["cutoff"]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".cutoff", "must be numeric"));
+                else
+                {
+                    filter.has_cutoff = true;
+                    filter.cutoff = filter_json["cutoff"].get<float>();
+                }
+            }
+
+            if (filter_json.contains("cutoffParameter"))
+            {
+                if (!filter_json["cutoffParameter"].is_string())
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".cutoffParameter", "must be a string"));
+                else
+                    filter.cutoff_parameter = filter_json["cutoffParameter"].get<std::string>();
+            }
+
+            if (filter_json.contains("cutoffRange"))
+            {
+                const Json &range_json = filter_json["cutoffRange"];
+                if (!range_json.is_array() || range_json.size() != 2 || !IsNumber(range_json[0]) || !IsNumber(range_json[1]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".cutoffRange", "must be an array of two numbers"));
+                else
+                {
+                    filter.has_cutoff_range = true;
+                    filter.cutoff_from = range_json[0].get<float>();
+                    filter.cutoff_to = range_json[1].get<float>();
+                }
+            }
+
+            if (filter_json.contains("q"))
+            {
+                if (!IsNumber(filter_json["q"]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".q", "must be numeric"));
+                else
+                    filter.q = filter_json["q"].get<float>();
+            }
+
+            if (filter_json.contains("gainDb"))
+            {
+                if (!IsNumber(filter_json["gainDb"]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".gainDb", "must be numeric"));
+                else
+                {
+                    filter.has_gain_db = true;
+                    filter.gain_db = filter_json["gainDb"].get<float>();
+                }
+            }
+
+            return filter;
+        }
+
+        AuthoringSend ParseSend(const Json &send_json,
+                                std::string_view source_path,
+                                std::string_view field_path,
+                                std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            AuthoringSend send;
+            send.location = MakeLocation(source_path, field_path);
+            send.enabled = true;
+
+            if (!send_json.is_object())
+            {
+                diagnostics.push_back(MakeError(source_path, field_path, "must be an object"));
+                return send;
+            }
+
+            for (auto it = send_json.begin(); it != send_json.end(); ++it)
+            {
+                const std::string key = it.key();
+                if (key != "bus" && key != "level")
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "is not a supported send field"));
+            }
+
+            if (!send_json.contains("bus"))
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".bus", "is required"));
+            else if (!send_json["bus"].is_string())
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".bus", "must be a string"));
+            else
+                send.bus = send_json["bus"].get<std::string>();
+
+            if (send_json.contains("level"))
+            {
+                if (!IsNumber(send_json["level"]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".level", "must be numeric"));
+                else
+                    send.level = send_json["level"].get<float>();
+            }
+
+            return send;
+        }
+
+        AuthoringDuck ParseDuck(const Json &duck_json,
+                                std::string_view source_path,
+                                std::string_view field_path,
+                                std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            AuthoringDuck duck;
+            duck.location = MakeLocation(source_path, field_path);
+            duck.enabled = true;
+
+            if (!duck_json.is_object())
+            {
+                diagnostics.push_back(MakeError(source_path, field_path, "must be an object"));
+                return duck;
+            }
+
+            for (auto it = duck_json.begin(); it != duck_json.end(); ++it)
+            {
+                const std::string key = it.key();
+                if (key != "by" && key != "depthDb" && key != "thresholdDb" && key != "attackMs" && key != "releaseMs")
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "is not a supported duck field"));
+            }
+
+            if (!duck_json.contains("by"))
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".by", "is required"));
+            else if (!duck_json["by"].is_string())
+                diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".by", "must be a string"));
+            else
+                duck.by = duck_json["by"].get<std::string>();
+
+            auto parse_number = [&](const char *key, float &out_value)
+            {
+                if (!duck_json.contains(key))
+                    return;
+                if (!IsNumber(duck_json[key]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "must be numeric"));
+                else
+                    out_value = duck_json[key].get<float>();
+            };
+            parse_number("depthDb", duck.depth_db);
+            parse_number("thresholdDb", duck.threshold_db);
+            parse_number("attackMs", duck.attack_ms);
+            parse_number("releaseMs", duck.release_ms);
+
+            return duck;
+        }
+
+        void ParseBuses(const Json &buses_json,
+                        std::string_view source_path,
+                        std::vector<AuthoringBus> &buses,
+                        std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            if (!buses_json.is_array())
+            {
+                diagnostics.push_back(MakeError(source_path, "buses", "must be an array"));
+                return;
+            }
+
+            for (std::size_t i = 0; i < buses_json.size(); ++i)
+            {
+                const Json &bus_json = buses_json[i];
+                const std::string field_path = "buses[" + std::to_string(i) + "]";
+                if (!bus_json.is_object())
+                {
+                    diagnostics.push_back(MakeError(source_path, field_path, "must be an object"));
+                    continue;
+                }
+
+                AuthoringBus &bus = buses.emplace_back();
+                bus.location = MakeLocation(source_path, field_path);
+
+                if (!bus_json.contains("id"))
+                    diagnostics.push_back(MakeError(source_path, field_path + ".id", "is required"));
+                else if (!bus_json["id"].is_string())
+                    diagnostics.push_back(MakeError(source_path, field_path + ".id", "must be a string"));
+                else
+                    bus.id = bus_json["id"].get<std::string>();
+
+                if (bus_json.contains("parent"))
+                {
+                    if (!bus_json["parent"].is_string())
+                        diagnostics.push_back(MakeError(source_path, field_path + ".parent", "must be a string"));
+                    else
+                        bus.parent = bus_json["parent"].get<std::string>();
+                }
+
+                if (bus_json.contains("volume"))
+                {
+                    if (!IsNumber(bus_json["volume"]))
+                        diagnostics.push_back(MakeError(source_path, field_path + ".volume", "must be numeric"));
+                    else
+                        bus.volume = bus_json["volume"].get<float>();
+                }
+
+                if (bus_json.contains("filter"))
+                    bus.filter = ParseFilter(bus_json["filter"], source_path, field_path + ".filter", diagnostics);
+
+                if (bus_json.contains("impulseResponse"))
+                {
+                    if (!bus_json["impulseResponse"].is_string() || bus_json["impulseResponse"].get<std::string>().empty())
+                        diagnostics.push_back(MakeError(source_path, field_path + ".impulseResponse", "must be a non-empty string"));
+                    else
+                        bus.impulse_response = bus_json["impulseResponse"].get<std::string>();
+                }
+
+                if (bus_json.contains("duck"))
+                    bus.duck = ParseDuck(bus_json["duck"], source_path, field_path + ".duck", diagnostics);
+            }
+        }
+
         AuthoringCondition ParseCondition(const Json &condition_json,
                                           std::string_view source_path,
                                           std::string_view field_path,
@@ -228,6 +539,22 @@ namespace decl_audio::compiler
                     node.parameter = container_json["parameter"].get<std::string>();
             }
 
+            if (container_json.contains("pitchParameter"))
+            {
+                if (!container_json["pitchParameter"].is_string())
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".pitchParameter", "must be a string"));
+                else
+                    node.pitch_parameter = container_json["pitchParameter"].get<std::string>();
+            }
+
+            if (container_json.contains("stream"))
+            {
+                if (!container_json["stream"].is_boolean())
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".stream", "must be a boolean"));
+                else
+                    node.stream = container_json["stream"].get<bool>();
+            }
+
             if (container_json.contains("asset"))
             {
                 if (!container_json["asset"].is_string())
@@ -273,6 +600,35 @@ namespace decl_audio::compiler
             return node;
         }
 
+        AuthoringCurvePoint ParseCurvePoint(const Json &point_json,
+                                            std::string_view source_path,
+                                            std::string_view field_path,
+                                            std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            AuthoringCurvePoint point;
+
+            if (!point_json.is_object())
+            {
+                diagnostics.push_back(MakeError(source_path, field_path, "must be an object"));
+                return point;
+            }
+
+            for (const char *key : {"distance", "gain"})
+            {
+                if (!point_json.contains(key))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "is required"));
+                else if (!IsNumber(point_json[key]))
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "must be numeric"));
+            }
+
+            if (point_json.contains("distance") && IsNumber(point_json["distance"]))
+                point.distance = point_json["distance"].get<float>();
+            if (point_json.contains("gain") && IsNumber(point_json["gain"]))
+                point.gain = point_json["gain"].get<float>();
+
+            return point;
+        }
+
         AuthoringSpatializationSettings ParseSpatialization(const Json &spatialization_json,
                                                             std::string_view source_path,
                                                             std::string_view field_path,
@@ -293,7 +649,7 @@ namespace decl_audio::compiler
             for (auto it = spatialization_json.begin(); it != spatialization_json.end(); ++it)
             {
                 const std::string key = it.key();
-                if (key != "minDistance" && key != "maxDistance" && key != "attenuation")
+                if (key != "minDistance" && key != "maxDistance" && key != "attenuation" && key != "attenuationCurve")
                     diagnostics.push_back(MakeError(source_path, std::string(field_path) + "." + key, "is not a supported spatialization field"));
             }
 
@@ -339,6 +695,20 @@ namespace decl_audio::compiler
                     diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".attenuation", "has unsupported attenuation mode"));
             }
 
+            if (spatialization_json.contains("attenuationCurve"))
+            {
+                const Json &curve_json = spatialization_json["attenuationCurve"];
+                if (!curve_json.is_array())
+                {
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".attenuationCurve", "must be an array"));
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < curve_json.size(); ++i)
+                        spatialization.attenuation_curve.push_back(ParseCurvePoint(curve_json[i], source_path, std::string(field_path) + ".attenuationCurve[" + std::to_string(i) + "]", diagnostics));
+                }
+            }
+
             return spatialization;
         }
 
@@ -408,6 +778,28 @@ namespace decl_audio::compiler
                     behavior.start_fade_ms = behavior_json["startFadeMs"].get<float>();
             }
 
+            if (behavior_json.contains("priority"))
+            {
+                if (!behavior_json["priority"].is_number_integer())
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".priority", "must be an integer"));
+                else
+                    behavior.priority = behavior_json["priority"].get<std::int32_t>();
+            }
+
+            if (behavior_json.contains("bus"))
+            {
+                if (!behavior_json["bus"].is_string())
+                    diagnostics.push_back(MakeError(source_path, std::string(field_path) + ".bus", "must be a string"));
+                else
+                    behavior.bus = behavior_json["bus"].get<std::string>();
+            }
+
+            if (behavior_json.contains("filter"))
+                behavior.filter = ParseFilter(behavior_json["filter"], source_path, std::string(field_path) + ".filter", diagnostics);
+
+            if (behavior_json.contains("send"))
+                behavior.send = ParseSend(behavior_json["send"], source_path, std::string(field_path) + ".send", diagnostics);
+
             if (behavior_json.contains("matchConditions"))
             {
                 const Json &conditions_json = behavior_json["matchConditions"];
@@ -468,6 +860,10 @@ namespace decl_audio::compiler
             }
 
             behaviors_json = &root["behaviors"];
+            if (root.contains("assetFormats"))
+                ParseAssetFormats(root["assetFormats"], source_path, result.document.asset_formats, result.diagnostics);
+            if (root.contains("buses"))
+                ParseBuses(root["buses"], source_path, result.document.buses, result.diagnostics);
         }
         else
         {
@@ -51,6 +51,7 @@ namespace decl_audio::compiler
         float min_distance = 0.0f;
         float max_distance = 0.0f;
         AttenuationMode attenuation = AttenuationMode::Linear;
+        std::uint32_t attenuation_curve = 0; // first of kAttenuationCurvePoints in CompiledBank::attenuation_curves
     };
 
     struct CompiledProgram final
@@ -65,8 +66,61 @@ namespace decl_audio::compiler
         std::uint32_t max_concurrent_voices = 0;
         CompiledSpatializationSettings spatialization;
         StopMode stop_mode = StopMode::Immediate;
+        std::uint8_t priority = 128; // instance stealing: lowest priority goes first
+        BusId bus = kMasterBus;
         std::uint32_t stop_fade_frames = 2400; // 50ms at 48kHz
         std::uint32_t start_fade_frames = 0;
+        std::uint32_t filter = kNoFilter; // index into CompiledBank::filters
+        // Reverb send: the program's output, scaled by send_level, also feeds
+        // send_bus (kMasterBus for none), which convolves it.
+        BusId send_bus = kMasterBus;
+        float send_level = 0.0f;
+    };
+
+    // Sidechain ducking of a bus by the bus `by` (kMasterBus for none). An
+    // envelope follower tracks the peak level of `by`'s mix, rising with
+    // attack_ms and falling with release_ms; the ducked bus's gain is scaled
+    // by 1 - (1 - depth) * min(1, envelope / threshold), so it reaches depth
+    // (linear) once the trigger is at threshold (linear peak) or louder.
+    struct CompiledDuck final
+    {
+        BusId by = kMasterBus;
+        float depth = 1.0f;
+        float threshold = 1.0f;
+        float attack_ms = 10.0f;
+        float release_ms = 250.0f;
+
+        [[nodiscard]] friend bool operator==(const CompiledDuck &, const CompiledDuck &) noexcept = default;
+    };
+
+    // A mix bus. Buses are stored parents first, so `parent` (kMasterBus for
+    // a top-level bus) is always lower than the bus's own index. A ducked bus
+    // is likewise stored before the bus that ducks it, so folding from the
+    // back finishes the trigger's mix before the ducked bus needs it.
+    struct CompiledBus final
+    {
+        BusId parent = kMasterBus;
+        float volume = 1.0f;
+        std::uint32_t filter = kNoFilter; // index into CompiledBank::filters
+        // With an impulse response, what reaches the bus is convolved with it
+        // and only the wet signal goes on.
+        AssetId impulse = kNoImpulse;
+        CompiledDuck duck;
+    };
+
+    // A biquad stage on a program's output or a bus. Without a parameter the
+    // cutoff is cutoff_from; with one (programs only) it moves from
+    // cutoff_from at 0 to cutoff_to at 1, evenly in log frequency.
+    struct CompiledFilter final
+    {
+        FilterType type = FilterType::LowPass;
+        std::uint16_t parameter_slot = kInvalidParameterSlot;
+        float cutoff_from = 1000.0f;
+        float cutoff_to = 1000.0f;
+        float q = 0.70710678f;
+        float gain_db = 0.0f; // shelves only
+
+        [[nodiscard]] friend bool operator==(const CompiledFilter &, const CompiledFilter &) noexcept = default;
     };
 
     struct CompiledBank final
@@ -80,12 +134,23 @@ namespace decl_audio::compiler
         std::vector<NodeId> node_children;
         std::vector<AssetId> node_assets;
         std::vector<ParameterId> program_parameters;
+        // Baked attenuation LUTs, kAttenuationCurvePoints each; identical curves
+        // are shared between programs.
+        std::vector<float> attenuation_curves;
+        std::vector<CompiledBus> buses;
+        std::vector<CompiledFilter> filters;
 
         // Per-tag metadata (indexed by TagId)
         std::vector<std::uint8_t> tag_depths;      // number of '.' in the tag name
         std::vector<TagId> tag_group_head;         // canonical TagId for the exclusive namespace group (same first component)
 
         std::vector<std::string> asset_paths;
+        // Authored storage per asset (parallel to asset_paths), applied by
+        // LoadAssetBank. Baked banks record the format with each buffer instead.
+        std::vector<SampleFormat> asset_formats;
+        // Assets a leaf marked "stream" (parallel to asset_paths): LoadAssetBank
+        // keeps only their head in memory. Baked banks record this per buffer.
+        std::vector<bool> asset_streamed;
         std::uint32_t max_program_node_count = 0;
         std::uint32_t max_program_parameter_slot_count = 0;
         std::uint32_t max_program_concurrent_voices = 0;
@@ -95,6 +160,7 @@ namespace decl_audio::compiler
         std::unordered_map<std::string, TagId> tag_name_to_id;
         std::unordered_map<std::string, ParameterId> parameter_name_to_id;
         std::unordered_map<std::string, AssetId> asset_name_to_id;
+        std::unordered_map<std::string, BusId> bus_name_to_id;
 
         [[nodiscard]] const CompiledBehavior &GetBehavior(BehaviorId id) const
         {
@@ -150,6 +216,11 @@ namespace decl_audio::compiler
             return std::span<const ParameterId>(program_parameters).subspan(program.first_parameter, program.parameter_count);
         }
 
+        [[nodiscard]] std::span<const float> GetAttenuationCurve(const CompiledSpatializationSettings &spatialization) const
+        {
+            return std::span<const float>(attenuation_curves).subspan(spatialization.attenuation_curve, kAttenuationCurvePoints);
+        }
+
         [[nodiscard]] const std::string &GetAssetPath(AssetId id) const
         {
             return asset_paths.at(static_cast<std::size_t>(id));
@@ -179,5 +250,10 @@ namespace decl_audio::compiler
         {
             return asset_name_to_id.at(std::string(name));
         }
+
+        [[nodiscard]] BusId GetBusId(std::string_view name) const
+        {
+            return bus_name_to_id.at(std::string(name));
+        }
     };
 } // namespace decl_audio::compiler
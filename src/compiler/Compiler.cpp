@@ -2,6 +2,9 @@
 
 #include "Compiler.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -27,9 +30,195 @@ namespace decl_audio::compiler
             const AssetId id = static_cast<AssetId>(bank.asset_paths.size());
             bank.asset_name_to_id.emplace(asset_name, id);
             bank.asset_paths.push_back(asset_name);
+            bank.asset_formats.push_back(SampleFormat::F32);
+            bank.asset_streamed.push_back(false);
             return id;
         }
 
+        using AttenuationCurve = std::array<float, kAttenuationCurvePoints>;
+
+        // Samples the authored curve at kAttenuationCurvePoints evenly spaced
+        // distances. The inverse laws are tapered, (law(d) - law(max)) /
+        // (1 - law(max)), so every built-in curve runs from 1 at minDistance to
+        // exactly 0 at maxDistance and a source at the edge of its range goes
+        // silent (and virtual) just as a linear one does. Custom curves hold
+        // their first and last gains outside the authored points.
+        [[nodiscard]] AttenuationCurve BakeAttenuationCurve(const AuthoringSpatializationSettings &spatialization)
+        {
+            const double min_distance = spatialization.min_distance;
+            const double max_distance = spatialization.max_distance;
+            const double last = static_cast<double>(kAttenuationCurvePoints - 1);
+            const std::vector<AuthoringCurvePoint> &points = spatialization.attenuation_curve;
+
+            AttenuationCurve curve{};
+            for (std::uint32_t i = 0; i < kAttenuationCurvePoints; ++i)
+            {
+                const double fraction = static_cast<double>(i) / last;
+                const double distance = min_distance + (max_distance - min_distance) * fraction;
+                double gain = 0.0;
+                switch (spatialization.attenuation)
+                {
+                case AttenuationMode::Linear:
+                    gain = 1.0 - fraction;
+                    break;
+                case AttenuationMode::Inverse:
+                {
+                    const double at_max = min_distance / max_distance;
+                    gain = (min_distance / distance - at_max) / (1.0 - at_max);
+                    break;
+                }
+                case AttenuationMode::InverseSquare:
+                {
+                    const double at_max = (min_distance * min_distance) / (max_distance * max_distance);
+                    gain = ((min_distance * min_distance) / (distance * distance) - at_max) / (1.0 - at_max);
+                    break;
+                }
+                case AttenuationMode::Logarithmic:
+                    gain = 1.0 - std::log(distance / min_distance) / std::log(max_distance / min_distance);
+                    break;
+                case AttenuationMode::Custom:
+                {
+                    const auto next = std::find_if(points.begin(), points.end(), [distance](const AuthoringCurvePoint &point)
+                                                   { return point.distance >= distance; });
+                    if (next == points.begin())
+                        gain = points.front().gain;
+                    else if (next == points.end())
+                        gain = points.back().gain;
+                    else
+                    {
+                        const AuthoringCurvePoint &previous = *(next - 1);
+                        const double t = (distance - previous.distance) / (static_cast<double>(next->distance) - previous.distance);
+                        gain = previous.gain + (static_cast<double>(next->gain) - previous.gain) * t;
+                    }
+                    break;
+                }
+                }
+
+                curve[i] = static_cast<float>(std::clamp(gain, 0.0, 1.0));
+            }
+
+            // Land the ends exactly, whatever rounding did on the way.
+            if (spatialization.attenuation != AttenuationMode::Custom)
+            {
+                curve.front() = 1.0f;
+                curve.back() = 0.0f;
+            }
+
+            return curve;
+        }
+
+        // Appends `curve` to the bank's LUT pool unless an identical one is
+        // already there, returning the offset of its first sample.
+        [[nodiscard]] std::uint32_t InternAttenuationCurve(CompiledBank &bank, const AttenuationCurve &curve)
+        {
+            for (std::size_t offset = 0; offset < bank.attenuation_curves.size(); offset += kAttenuationCurvePoints)
+            {
+                if (std::equal(curve.begin(), curve.end(), bank.attenuation_curves.begin() + static_cast<std::ptrdiff_t>(offset)))
+                    return static_cast<std::uint32_t>(offset);
+            }
+
+            const std::uint32_t offset = static_cast<std::uint32_t>(bank.attenuation_curves.size());
+            bank.attenuation_curves.insert(bank.attenuation_curves.end(), curve.begin(), curve.end());
+            return offset;
+        }
+
+        // Checks an authored filter's fields, reporting under `prefix` (the
+        // owning behavior or bus); returns false when it cannot be compiled.
+        // Buses have no entity whose parameters could move their cutoff.
+        [[nodiscard]] bool ValidateFilter(const AuthoringFilter &filter, const std::string &prefix, const bool allow_parameter, std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            const std::size_t error_count = diagnostics.size();
+            const bool bound = !filter.cutoff_parameter.empty();
+
+            if (bound && !allow_parameter)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter cannot bind a cutoffParameter"));
+            if (filter.has_cutoff && bound)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter takes either cutoff or cutoffParameter, not both"));
+            else if (!filter.has_cutoff && !bound)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter needs a cutoff or a cutoffParameter"));
+            if (bound && !filter.has_cutoff_range)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter cutoffParameter needs a cutoffRange"));
+            if (!bound && filter.has_cutoff_range)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter cutoffRange needs a cutoffParameter"));
+
+            if (filter.has_cutoff && !(filter.cutoff > 0.0f))
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter cutoff must be > 0"));
+            if (filter.has_cutoff_range && !(filter.cutoff_from > 0.0f && filter.cutoff_to > 0.0f))
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter cutoffRange must be > 0"));
+            if (!(filter.q > 0.0f))
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter q must be > 0"));
+            if (filter.has_gain_db && filter.type != FilterType::LowShelf && filter.type != FilterType::HighShelf)
+                diagnostics.push_back(MakeError(filter.location, prefix + "filter gainDb only applies to shelf filters"));
+
+            return diagnostics.size() == error_count;
+        }
+
+        // Appends the filter to the bank's pool unless an identical one is
+        // already there, returning its index.
+        [[nodiscard]] std::uint32_t InternFilter(CompiledBank &bank, const AuthoringFilter &filter, const std::uint16_t parameter_slot)
+        {
+            CompiledFilter compiled;
+            compiled.type = filter.type;
+            compiled.parameter_slot = parameter_slot;
+            compiled.cutoff_from = filter.has_cutoff ? filter.cutoff : filter.cutoff_from;
+            compiled.cutoff_to = filter.has_cutoff ? filter.cutoff : filter.cutoff_to;
+            compiled.q = filter.q;
+            compiled.gain_db = filter.gain_db;
+
+            const auto it = std::find(bank.filters.begin(), bank.filters.end(), compiled);
+            if (it != bank.filters.end())
+                return static_cast<std::uint32_t>(it - bank.filters.begin());
+
+            bank.filters.push_back(compiled);
+            return static_cast<std::uint32_t>(bank.filters.size() - 1);
+        }
+
+        // Mode-specific checks on top of the shared range check; returns false
+        // (after reporting) when the curve cannot be baked.
+        [[nodiscard]] bool ValidateAttenuationCurve(const AuthoringBehavior &behavior, std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            const AuthoringSpatializationSettings &spatialization = behavior.spatialization;
+            const std::string prefix = "behavior '" + behavior.id + "' spatialization ";
+            const std::size_t error_count = diagnostics.size();
+
+            if (spatialization.attenuation != AttenuationMode::Custom && !spatialization.attenuation_curve.empty())
+                diagnostics.push_back(MakeError(spatialization.location, prefix + "attenuationCurve requires attenuation 'custom'"));
+
+            switch (spatialization.attenuation)
+            {
+            case AttenuationMode::Inverse:
+            case AttenuationMode::InverseSquare:
+            case AttenuationMode::Logarithmic:
+                if (!(spatialization.min_distance > 0.0f))
+                    diagnostics.push_back(MakeError(spatialization.location, prefix + "minDistance must be > 0 for this attenuation"));
+                break;
+            case AttenuationMode::Custom:
+            {
+                const std::vector<AuthoringCurvePoint> &points = spatialization.attenuation_curve;
+                if (points.size() < 2)
+                {
+                    diagnostics.push_back(MakeError(spatialization.location, prefix + "attenuationCurve needs at least two points"));
+                    break;
+                }
+
+                for (std::size_t i = 0; i < points.size(); ++i)
+                {
+                    if (!(points[i].gain >= 0.0f && points[i].gain <= 1.0f))
+                        diagnostics.push_back(MakeError(spatialization.location, prefix + "attenuationCurve gains must be in [0, 1]"));
+                    if (!(points[i].distance >= spatialization.min_distance && points[i].distance <= spatialization.max_distance))
+                        diagnostics.push_back(MakeError(spatialization.location, prefix + "attenuationCurve distances must lie in [minDistance, maxDistance]"));
+                    if (i > 0 && !(points[i].distance > points[i - 1].distance))
+                        diagnostics.push_back(MakeError(spatialization.location, prefix + "attenuationCurve distances must be strictly increasing"));
+                }
+                break;
+            }
+            case AttenuationMode::Linear:
+                break;
+            }
+
+            return diagnostics.size() == error_count;
+        }
+
         struct ProgramLoweringContext final
         {
             CompiledBank &bank;
@@ -46,21 +235,18 @@ namespace decl_audio::compiler
             }
         };
 
-        [[nodiscard]] std::uint16_t RequireProgramParameterSlot(ProgramLoweringContext &context,
-                                                                const AuthoringNode &authoring_node) noexcept
+        // The program slot for `parameter_name`, allocated on first use. `role`
+        // names the binding in the diagnostic when the parameter is undeclared.
+        [[nodiscard]] std::uint16_t ResolveProgramParameterSlot(ProgramLoweringContext &context,
+                                                                const decl_audio::SourceLocation &location,
+                                                                const std::string &parameter_name,
+                                                                std::string_view role) noexcept
         {
-            if (authoring_node.parameter.empty())
-            {
-                context.Error(authoring_node.location, "blend nodes require a parameter");
-                return kInvalidParameterSlot;
-            }
-
-            const auto parameter_it = context.bank.parameter_name_to_id.find(authoring_node.parameter);
+            const auto parameter_it = context.bank.parameter_name_to_id.find(parameter_name);
             if (parameter_it == context.bank.parameter_name_to_id.end() ||
                 !context.declared_parameter_ids.contains(parameter_it->second))
             {
-                context.Error(authoring_node.location,
-                              "blend node parameter '" + authoring_node.parameter + "' must be declared in behavior.parameters");
+                context.Error(location, std::string(role) + " '" + parameter_name + "' must be declared in behavior.parameters");
                 return kInvalidParameterSlot;
             }
 
@@ -75,15 +261,33 @@ namespace decl_audio::compiler
             return slot;
         }
 
+        [[nodiscard]] std::uint16_t RequireProgramParameterSlot(ProgramLoweringContext &context,
+                                                                const AuthoringNode &authoring_node) noexcept
+        {
+            if (authoring_node.parameter.empty())
+            {
+                context.Error(authoring_node.location, "blend nodes require a parameter");
+                return kInvalidParameterSlot;
+            }
+
+            return ResolveProgramParameterSlot(context, authoring_node.location, authoring_node.parameter, "blend node parameter");
+        }
+
         void ValidateLeafShape(const AuthoringNode &authoring_node,
                                ProgramLoweringContext &context,
-                               std::string_view leaf_name)
+                               std::string_view leaf_name,
+                               NodeId node_id)
         {
             if (!authoring_node.children.empty())
                 context.Error(authoring_node.location, std::string(leaf_name) + " nodes do not allow children");
 
             if (!authoring_node.parameter.empty())
                 context.Error(authoring_node.location, std::string(leaf_name) + " nodes do not allow parameters");
+
+            // A leaf's parameter slot is its pitch binding (blend nodes use the
+            // same field for their weight).
+            if (!authoring_node.pitch_parameter.empty())
+                context.bank.nodes[node_id].parameter_slot = ResolveProgramParameterSlot(context, authoring_node.location, authoring_node.pitch_parameter, "pitchParameter");
         }
 
         void ValidateStructuralShape(const AuthoringNode &authoring_node,
@@ -96,6 +300,12 @@ namespace decl_audio::compiler
 
             if (!parameter_allowed && !authoring_node.parameter.empty())
                 context.Error(authoring_node.location, std::string(node_name) + " nodes do not allow parameters");
+
+            if (!authoring_node.pitch_parameter.empty())
+                context.Error(authoring_node.location, std::string(node_name) + " nodes do not allow pitchParameter");
+
+            if (authoring_node.stream)
+                context.Error(authoring_node.location, std::string(node_name) + " nodes do not allow stream");
         }
 
         [[nodiscard]] std::uint32_t LowerNode(ProgramLoweringContext &context,
@@ -137,7 +347,12 @@ namespace decl_audio::compiler
             {
                 context.bank.nodes[node_id].first_asset = static_cast<std::uint32_t>(context.bank.node_assets.size());
                 for (const std::string &asset_name : authoring_node.assets)
-                    context.bank.node_assets.push_back(InternAsset(context.bank, asset_name));
+                {
+                    const AssetId asset_id = InternAsset(context.bank, asset_name);
+                    context.bank.node_assets.push_back(asset_id);
+                    if (authoring_node.stream)
+                        context.bank.asset_streamed[asset_id] = true;
+                }
                 max_concurrent_voices = 1;
             };
 
@@ -170,7 +385,7 @@ namespace decl_audio::compiler
 
             case NodeType::OneShot:
                 context.bank.nodes[node_id].type = NodeType::OneShot;
-                ValidateLeafShape(authoring_node, context, "oneshot");
+                ValidateLeafShape(authoring_node, context, "oneshot", node_id);
                 if (authoring_node.assets.size() != 1)
                     context.Error(authoring_node.location, "oneshot nodes require exactly one asset");
                 InternNodeAssets();
@@ -178,7 +393,7 @@ namespace decl_audio::compiler
 
             case NodeType::Loop:
                 context.bank.nodes[node_id].type = NodeType::Loop;
-                ValidateLeafShape(authoring_node, context, "loop");
+                ValidateLeafShape(authoring_node, context, "loop", node_id);
                 if (authoring_node.assets.size() != 1)
                     context.Error(authoring_node.location, "loop nodes require exactly one asset");
                 if (authoring_node.loop_count == 0)
@@ -188,7 +403,7 @@ namespace decl_audio::compiler
 
             case NodeType::Random:
                 context.bank.nodes[node_id].type = NodeType::Random;
-                ValidateLeafShape(authoring_node, context, "random");
+                ValidateLeafShape(authoring_node, context, "random", node_id);
                 if (authoring_node.assets.empty())
                     context.Error(authoring_node.location, "random nodes require at least one asset");
                 InternNodeAssets();
@@ -215,12 +430,204 @@ namespace decl_audio::compiler
 
             return max_concurrent_voices;
         }
+
+        // Flattens the authored bus graph into bank.buses, every bus after its
+        // parent and before any bus that ducks it, so the audio thread can fold
+        // buses into their parents in one pass from the back with no recursion.
+        void CompileBuses(const std::vector<AuthoringBus> &authoring_buses, CompiledBank &bank, std::vector<decl_audio::Diagnostic> &diagnostics)
+        {
+            if (authoring_buses.size() >= kMasterBus)
+            {
+                diagnostics.push_back(MakeError(authoring_buses.back().location, "too many buses"));
+                return;
+            }
+
+            std::unordered_map<std::string, std::size_t> name_to_index;
+            bool is_valid = true;
+            for (std::size_t index = 0; index < authoring_buses.size(); ++index)
+            {
+                const AuthoringBus &bus = authoring_buses[index];
+                if (bus.id.empty())
+                {
+                    diagnostics.push_back(MakeError(bus.location, "bus id must not be empty"));
+                    is_valid = false;
+                }
+                else if (!name_to_index.emplace(bus.id, index).second)
+                {
+                    diagnostics.push_back(MakeError(bus.location, "duplicate bus id '" + bus.id + "'"));
+                    is_valid = false;
+                }
+
+                if (!(bus.volume >= 0.0f))
+                {
+                    diagnostics.push_back(MakeError(bus.location, "bus '" + bus.id + "' volume must be >= 0"));
+                    is_valid = false;
+                }
+
+                if (bus.duck.enabled)
+                {
+                    const AuthoringDuck &duck = bus.duck;
+                    if (!(duck.depth_db <= 0.0f) || !std::isfinite(duck.depth_db))
+                    {
+                        diagnostics.push_back(MakeError(duck.location, "bus '" + bus.id + "' duck depthDb must be a finite value <= 0"));
+                        is_valid = false;
+                    }
+                    if (!(duck.threshold_db <= 0.0f) || !std::isfinite(duck.threshold_db))
+                    {
+                        diagnostics.push_back(MakeError(duck.location, "bus '" + bus.id + "' duck thresholdDb must be a finite value <= 0"));
+                        is_valid = false;
+                    }
+                    if (!(duck.attack_ms >= 0.0f) || !(duck.release_ms >= 0.0f) || !std::isfinite(duck.attack_ms) || !std::isfinite(duck.release_ms))
+                    {
+                        diagnostics.push_back(MakeError(duck.location, "bus '" + bus.id + "' duck attackMs and releaseMs must be finite values >= 0"));
+                        is_valid = false;
+                    }
+                }
+            }
+
+            // A bus depends on its parent and on every bus it ducks: both must
+            // be placed first.
+            std::vector<std::vector<std::size_t>> dependencies(authoring_buses.size());
+            for (std::size_t index = 0; index < authoring_buses.size(); ++index)
+            {
+                const AuthoringBus &bus = authoring_buses[index];
+                if (!bus.parent.empty())
+                {
+                    if (!name_to_index.contains(bus.parent))
+                    {
+                        diagnostics.push_back(MakeError(bus.location, "bus '" + bus.id + "' names unknown parent bus '" + bus.parent + "'"));
+                        is_valid = false;
+                    }
+                    else
+                    {
+                        dependencies[index].push_back(name_to_index.at(bus.parent));
+                    }
+                }
+            }
+            for (std::size_t index = 0; index < authoring_buses.size(); ++index)
+            {
+                const AuthoringBus &bus = authoring_buses[index];
+                if (!bus.duck.enabled)
+                    continue;
+
+                const auto trigger = name_to_index.find(bus.duck.by);
+                if (trigger == name_to_index.end())
+                {
+                    diagnostics.push_back(MakeError(bus.duck.location, "bus '" + bus.id + "' is ducked by unknown bus '" + bus.duck.by + "'"));
+                    is_valid = false;
+                }
+                else if (trigger->second == index)
+                {
+                    diagnostics.push_back(MakeError(bus.duck.location, "bus '" + bus.id + "' cannot duck itself"));
+                    is_valid = false;
+                }
+                else
+                {
+                    dependencies[trigger->second].push_back(index);
+                }
+            }
+
+            if (!is_valid)
+                return;
+
+            // Depth-first, in authored order otherwise. Reaching a bus still
+            // being placed is a cycle: through parents alone the bus is its own
+            // ancestor; otherwise some trigger depends on the bus it ducks.
+            enum class Mark : std::uint8_t
+            {
+                Unplaced,
+                Placing,
+                Placed
+            };
+            struct Frame final
+            {
+                std::size_t index = 0;
+                std::size_t next = 0; // next entry of dependencies[index]
+            };
+            std::vector<Mark> marks(authoring_buses.size(), Mark::Unplaced);
+            std::vector<BusId> compiled_ids(authoring_buses.size(), kMasterBus);
+            std::vector<Frame> stack;
+            for (std::size_t start = 0; start < authoring_buses.size(); ++start)
+            {
+                if (marks[start] != Mark::Unplaced)
+                    continue;
+
+                marks[start] = Mark::Placing;
+                stack.push_back({start, 0});
+                while (!stack.empty())
+                {
+                    Frame &frame = stack.back();
+                    if (frame.next < dependencies[frame.index].size())
+                    {
+                        const std::size_t dependency = dependencies[frame.index][frame.next++];
+                        if (marks[dependency] == Mark::Placing)
+                        {
+                            auto cycle = std::find_if(stack.begin(), stack.end(), [&](const Frame &entry)
+                            {
+                                return entry.index == dependency;
+                            });
+                            for (; cycle != stack.end(); ++cycle)
+                            {
+                                // Each bus on the cycle left through entry next - 1;
+                                // entry 0 is its parent, when it has one.
+                                const AuthoringBus &bus = authoring_buses[cycle->index];
+                                if (bus.parent.empty() || cycle->next != 1)
+                                {
+                                    const AuthoringBus &ducked = authoring_buses[dependencies[cycle->index][cycle->next - 1]];
+                                    diagnostics.push_back(MakeError(ducked.duck.location, "bus '" + ducked.id + "' cannot be ducked by '" + bus.id + "', which depends on it"));
+                                    return;
+                                }
+                            }
+
+                            diagnostics.push_back(MakeError(authoring_buses[dependency].location, "bus '" + authoring_buses[dependency].id + "' is its own ancestor"));
+                            return;
+                        }
+                        if (marks[dependency] == Mark::Unplaced)
+                        {
+                            marks[dependency] = Mark::Placing;
+                            stack.push_back({dependency, 0});
+                        }
+                        continue;
+                    }
+
+                    const AuthoringBus &bus = authoring_buses[frame.index];
+                    CompiledBus compiled_bus;
+                    compiled_bus.parent = bus.parent.empty() ? kMasterBus : compiled_ids[name_to_index.at(bus.parent)];
+                    compiled_bus.volume = bus.volume;
+                    if (bus.filter.enabled && ValidateFilter(bus.filter, "bus '" + bus.id + "' ", false, diagnostics))
+                        compiled_bus.filter = InternFilter(bank, bus.filter, kInvalidParameterSlot);
+                    if (!bus.impulse_response.empty())
+                        compiled_bus.impulse = InternAsset(bank, bus.impulse_response);
+                    if (bus.duck.enabled)
+                    {
+                        // The trigger is placed later; its id is filled in below.
+                        compiled_bus.duck.depth = std::pow(10.0f, bus.duck.depth_db / 20.0f);
+                        compiled_bus.duck.threshold = std::pow(10.0f, bus.duck.threshold_db / 20.0f);
+                        compiled_bus.duck.attack_ms = bus.duck.attack_ms;
+                        compiled_bus.duck.release_ms = bus.duck.release_ms;
+                    }
+                    compiled_ids[frame.index] = static_cast<BusId>(bank.buses.size());
+                    bank.bus_name_to_id.emplace(bus.id, compiled_ids[frame.index]);
+                    bank.buses.push_back(compiled_bus);
+                    marks[frame.index] = Mark::Placed;
+                    stack.pop_back();
+                }
+            }
+
+            for (std::size_t index = 0; index < authoring_buses.size(); ++index)
+            {
+                if (authoring_buses[index].duck.enabled)
+                    bank.buses[compiled_ids[index]].duck.by = compiled_ids[name_to_index.at(authoring_buses[index].duck.by)];
+            }
+        }
     } // namespace
 
     CompileResult CompileAuthoringDocument(const AuthoringDocument &document)
     {
         CompileResult result;
 
+        CompileBuses(document.buses, result.bank, result.diagnostics);
+
         for (const AuthoringBehavior &behavior : document.behaviors)
         {
             if (behavior.id.empty())
@@ -323,6 +730,18 @@ namespace decl_audio::compiler
             if (result.bank.nodes[root_node].child_count == 0)
                 result.diagnostics.push_back(MakeError(behavior.location, "behavior '" + behavior.id + "' compiled to an empty program"));
 
+            // Resolved before the parameter list is copied out: a cutoff
+            // binding may be the program's only use of its parameter.
+            std::uint32_t filter = kNoFilter;
+            if (behavior.filter.enabled && ValidateFilter(behavior.filter, "behavior '" + behavior.id + "' ", true, result.diagnostics))
+            {
+                const std::uint16_t cutoff_slot = behavior.filter.cutoff_parameter.empty()
+                                                      ? kInvalidParameterSlot
+                                                      : ResolveProgramParameterSlot(context, behavior.filter.location, behavior.filter.cutoff_parameter, "filter cutoffParameter");
+                if (behavior.filter.cutoff_parameter.empty() || cutoff_slot != kInvalidParameterSlot)
+                    filter = InternFilter(result.bank, behavior.filter, cutoff_slot);
+            }
+
             const std::uint32_t first_parameter = static_cast<std::uint32_t>(result.bank.program_parameters.size());
             result.bank.program_parameters.insert(result.bank.program_parameters.end(),
                                                   context.program_parameters.begin(),
@@ -344,6 +763,37 @@ namespace decl_audio::compiler
             compiled_program.stop_mode = behavior.stop_mode;
             compiled_program.stop_fade_frames = static_cast<std::uint32_t>(behavior.stop_fade_ms * 48000.0f / 1000.0f);
             compiled_program.start_fade_frames = static_cast<std::uint32_t>(behavior.start_fade_ms * 48000.0f / 1000.0f);
+            compiled_program.filter = filter;
+
+            if (behavior.priority < 0 || behavior.priority > 255)
+                result.diagnostics.push_back(MakeError(behavior.location, "behavior '" + behavior.id + "' priority must be in [0, 255]"));
+            else
+                compiled_program.priority = static_cast<std::uint8_t>(behavior.priority);
+
+            if (!behavior.bus.empty())
+            {
+                const auto bus_it = result.bank.bus_name_to_id.find(behavior.bus);
+                if (bus_it == result.bank.bus_name_to_id.end())
+                    result.diagnostics.push_back(MakeError(behavior.location, "behavior '" + behavior.id + "' plays on unknown bus '" + behavior.bus + "'"));
+                else
+                    compiled_program.bus = bus_it->second;
+            }
+
+            if (behavior.send.enabled)
+            {
+                const auto bus_it = result.bank.bus_name_to_id.find(behavior.send.bus);
+                if (bus_it == result.bank.bus_name_to_id.end())
+                    result.diagnostics.push_back(MakeError(behavior.send.location, "behavior '" + behavior.id + "' sends to unknown bus '" + behavior.send.bus + "'"));
+                else if (result.bank.buses[bus_it->second].impulse == kNoImpulse)
+                    result.diagnostics.push_back(MakeError(behavior.send.location, "behavior '" + behavior.id + "' sends to bus '" + behavior.send.bus + "', which has no impulseResponse"));
+                else if (!(behavior.send.level >= 0.0f))
+                    result.diagnostics.push_back(MakeError(behavior.send.location, "behavior '" + behavior.id + "' send level must be >= 0"));
+                else
+                {
+                    compiled_program.send_bus = bus_it->second;
+                    compiled_program.send_level = behavior.send.level;
+                }
+            }
 
             if (compiled_program.spatialization.mode == SpatializationMode::Pan)
             {
@@ -352,6 +802,8 @@ namespace decl_audio::compiler
 
                 if (compiled_program.spatialization.max_distance <= compiled_program.spatialization.min_distance)
                     result.diagnostics.push_back(MakeError(behavior.spatialization.location, "behavior '" + behavior.id + "' spatialization maxDistance must be > minDistance"));
+                else if (compiled_program.spatialization.min_distance >= 0.0f && ValidateAttenuationCurve(behavior, result.diagnostics))
+                    compiled_program.spatialization.attenuation_curve = InternAttenuationCurve(result.bank, BakeAttenuationCurve(behavior.spatialization));
             }
 
             result.bank.max_program_node_count = std::max(result.bank.max_program_node_count, compiled_program.node_count);
@@ -370,6 +822,38 @@ namespace decl_audio::compiler
             result.bank.behaviors.push_back(compiled_behavior);
         }
 
+        // An impulse response is transformed whole at load, so it has to be
+        // resident.
+        for (const auto &[bus_name, bus_id] : result.bank.bus_name_to_id)
+        {
+            const AssetId impulse = result.bank.buses[bus_id].impulse;
+            if (impulse != kNoImpulse && result.bank.asset_streamed[impulse])
+            {
+                const auto bus_it = std::find_if(document.buses.begin(), document.buses.end(), [&](const AuthoringBus &bus) { return bus.id == bus_name; });
+                result.diagnostics.push_back(MakeError(bus_it->location, "bus '" + bus_name + "' impulseResponse '" + result.bank.asset_paths[impulse] + "' is streamed by a program"));
+            }
+        }
+
+        for (const AuthoringAssetFormat &asset_format : document.asset_formats)
+        {
+            const auto asset_it = result.bank.asset_name_to_id.find(asset_format.asset);
+            if (asset_it == result.bank.asset_name_to_id.end())
+            {
+                result.diagnostics.push_back(MakeError(asset_format.location, "assetFormats names '" + asset_format.asset + "', which no program plays"));
+                continue;
+            }
+
+            // Streamed assets are read from disk as floats; only what stays
+            // resident could be compacted.
+            if (result.bank.asset_streamed[asset_it->second] && asset_format.format != SampleFormat::F32)
+            {
+                result.diagnostics.push_back(MakeError(asset_format.location, "assetFormats cannot compact '" + asset_format.asset + "', which is streamed"));
+                continue;
+            }
+
+            result.bank.asset_formats[asset_it->second] = asset_format.format;
+        }
+
         // Build per-tag metadata: depth and exclusive namespace group head.
         // A tag's group is defined by its first component (everything before the first '.').
         // Bare tags (no '.') form their own singleton group.
@@ -53,7 +53,11 @@ namespace decl_audio::compiler
         {
             switch (attenuation)
             {
-            case AttenuationMode::Linear: return "linear";
+            case AttenuationMode::Linear:        return "linear";
+            case AttenuationMode::Inverse:       return "inverse";
+            case AttenuationMode::InverseSquare: return "inverseSquare";
+            case AttenuationMode::Logarithmic:   return "logarithmic";
+            case AttenuationMode::Custom:        return "custom";
             }
             return "<invalid>";
         }
@@ -112,12 +116,14 @@ namespace decl_audio::compiler
             stream << "  stop: mode=" << ToString(program.stop_mode)
                    << " fadeFrames=" << program.stop_fade_frames
                    << " startFadeFrames=" << program.start_fade_frames << '\n';
+            stream << "  priority: " << static_cast<std::uint32_t>(program.priority) << '\n';
             stream << "  spatialization: mode=" << ToString(program.spatialization.mode);
             if (program.spatialization.mode != SpatializationMode::None)
             {
                 stream << " minDistance=" << program.spatialization.min_distance
                        << " maxDistance=" << program.spatialization.max_distance
-                       << " attenuation=" << ToString(program.spatialization.attenuation);
+                       << " attenuation=" << ToString(program.spatialization.attenuation)
+                       << " curve=" << program.spatialization.attenuation_curve;
             }
             stream << '\n';
             stream << "  tags:";
@@ -13,9 +13,16 @@ namespace decl_audio::compiler
     using TagId = std::uint32_t;
     using ParameterId = std::uint32_t;
     using AssetId = std::uint32_t;
+    using BusId = std::uint16_t;
 
     constexpr NodeId kInvalidNodeId = std::numeric_limits<NodeId>::max();
     constexpr std::uint16_t kInvalidParameterSlot = std::numeric_limits<std::uint16_t>::max();
+    // The bus a program without an authored "bus" plays on: the device output.
+    constexpr BusId kMasterBus = std::numeric_limits<BusId>::max();
+    // A program or bus without an authored "filter".
+    constexpr std::uint32_t kNoFilter = std::numeric_limits<std::uint32_t>::max();
+    // A bus without an authored "impulseResponse".
+    constexpr AssetId kNoImpulse = std::numeric_limits<AssetId>::max();
 
     enum class ComparisonOp : std::uint8_t
     {
@@ -32,11 +39,22 @@ namespace decl_audio::compiler
         Pan
     };
 
+    // Distance attenuation curves. Every mode is baked at compile time into an
+    // attenuation LUT over [minDistance, maxDistance]; see kAttenuationCurvePoints.
     enum class AttenuationMode : std::uint8_t
     {
-        Linear
+        Linear,
+        Inverse,       // minDistance / d, tapered to reach 0 at maxDistance
+        InverseSquare, // (minDistance / d)^2, tapered the same way
+        Logarithmic,   // falls linearly with log(d), reaching 0 at maxDistance
+        Custom         // piecewise-linear authored points
     };
 
+    // Samples per baked attenuation curve, evenly spaced from minDistance
+    // (first) to maxDistance (last). The audio thread reads two neighbours and
+    // interpolates, so this is 2^n + 1 to keep the segment index a plain scale.
+    constexpr std::uint32_t kAttenuationCurvePoints = 65;
+
     enum class NodeType : std::uint8_t
     {
         Sequence,
@@ -53,5 +71,24 @@ namespace decl_audio::compiler
         Graceful,  // finish current loop pass, advance sequence normally
     };
 
+    // How an asset's samples are held in memory (and in a baked bank). Compact
+    // formats are decoded a run at a time as voices mix them.
+    enum class SampleFormat : std::uint8_t
+    {
+        F32,      // 32-bit float
+        S16,      // 16-bit PCM, half the memory
+        ImaAdpcm  // 4-bit IMA ADPCM blocks, about an eighth of the memory
+    };
+
+    // Biquad filter responses (the RBJ audio EQ cookbook shapes). Shelves
+    // boost or cut by their gainDb below (low) or above (high) the cutoff.
+    enum class FilterType : std::uint8_t
+    {
+        LowPass,
+        HighPass,
+        LowShelf,
+        HighShelf
+    };
+
     using ContainerType = NodeType;
 } // namespace decl_audio::compiler
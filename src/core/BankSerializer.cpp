@@ -1,13 +1,19 @@
 // No pch.h — this file is shared between the DLL and the Validator (no PCH).
 
 #include "BankSerializer.hpp"
+#include "../assets/SampleCodec.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 using decl_audio::compiler::CompiledBehavior;
@@ -15,17 +21,23 @@ using decl_audio::compiler::CompiledProgram;
 using decl_audio::compiler::CompiledSpatializationSettings;
 using decl_audio::compiler::CompiledNode;
 using decl_audio::compiler::CompiledCondition;
+using decl_audio::compiler::CompiledBus;
+using decl_audio::compiler::CompiledFilter;
 
 static_assert(sizeof(CompiledBehavior) == 28,
     "CompiledBehavior layout changed — update BankSerializer version");
-static_assert(sizeof(CompiledSpatializationSettings) == 16,
+static_assert(sizeof(CompiledSpatializationSettings) == 20,
     "CompiledSpatializationSettings layout changed — update BankSerializer version");
-static_assert(sizeof(CompiledProgram) == 60,
+static_assert(sizeof(CompiledProgram) == 76,
     "CompiledProgram layout changed — update BankSerializer version");
 static_assert(sizeof(CompiledNode) == 36,
     "CompiledNode layout changed — update BankSerializer version");
 static_assert(sizeof(CompiledCondition) == 12,
     "CompiledCondition layout changed — update BankSerializer version");
+static_assert(sizeof(CompiledBus) == 36,
+    "CompiledBus layout changed — update BankSerializer version");
+static_assert(sizeof(CompiledFilter) == 20,
+    "CompiledFilter layout changed — update BankSerializer version");
 
 namespace
 {
@@ -58,7 +70,7 @@ namespace
         template<typename TId>
         void WriteStringMap(const std::unordered_map<std::string, TId> &map)
         {
-            static_assert(sizeof(TId) == sizeof(std::uint32_t));
+            static_assert(sizeof(TId) <= sizeof(std::uint32_t));
             Write(static_cast<std::uint32_t>(map.size()));
             for (const auto &[name, id] : map)
             {
@@ -171,27 +183,16 @@ namespace
                 std::uint32_t id = 0;
                 if (!Read(id, err))
                     return false;
+                if (id > std::numeric_limits<TId>::max())
+                {
+                    err = "string map id " + std::to_string(id) + " is out of range";
+                    return false;
+                }
                 map.emplace(std::move(name), static_cast<TId>(id));
             }
             return true;
         }
 
-        [[nodiscard]] bool ReadBytesInto(void *dst, std::size_t count, std::string &err)
-        {
-            if (cursor_ + count > data_.size())
-            {
-                char buf[128];
-                std::snprintf(buf, sizeof(buf),
-                    "data overruns file (bytes=%zu, offset=%zu, size=%zu)",
-                    count, cursor_, data_.size());
-                err = buf;
-                return false;
-            }
-            std::memcpy(dst, data_.data() + cursor_, count);
-            cursor_ += count;
-            return true;
-        }
-
     private:
         std::vector<std::uint8_t> data_;
         std::size_t cursor_ = 0;
@@ -215,6 +216,7 @@ namespace decl_audio::serialization
         std::vector<Diagnostic> &out_diagnostics)
     {
         BinaryWriter w;
+        const std::filesystem::path bank_directory = std::filesystem::absolute(output_path).parent_path();
 
         w.Write(kBankMagic);
         w.Write(kBankVersion);
@@ -233,22 +235,51 @@ namespace decl_audio::serialization
         w.WritePodVector(bank.program_parameters);
         w.WritePodVector(bank.tag_depths);
         w.WritePodVector(bank.tag_group_head);
+        w.WritePodVector(bank.attenuation_curves);
+        w.WritePodVector(bank.buses);
+        w.WritePodVector(bank.filters);
 
         w.WriteStringMap(bank.behavior_name_to_id);
         w.WriteStringMap(bank.program_name_to_id);
         w.WriteStringMap(bank.tag_name_to_id);
         w.WriteStringMap(bank.parameter_name_to_id);
         w.WriteStringMap(bank.asset_name_to_id);
+        w.WriteStringMap(bank.bus_name_to_id);
 
         w.Write(static_cast<std::uint32_t>(asset_bank.buffers.size()));
-        for (const assets::DecodedBuffer &buf : asset_bank.buffers)
+        for (const std::shared_ptr<const assets::DecodedBuffer> &buffer : asset_bank.buffers)
         {
+            const assets::DecodedBuffer &buf = *buffer;
             w.Write(buf.frame_count);
             w.Write(buf.channel_count);
             w.Write(buf.sample_rate);
-            w.Write(static_cast<std::uint32_t>(buf.samples.size()));
-            if (!buf.samples.empty())
-                w.WriteBytes(buf.samples.data(), buf.samples.size() * sizeof(float));
+            // Compact formats stay compact on disk: only the storage the
+            // format uses is written.
+            w.Write(static_cast<std::uint8_t>(buf.format));
+            switch (buf.format)
+            {
+            case compiler::SampleFormat::F32:
+                w.WritePodVector(buf.samples);
+                break;
+            case compiler::SampleFormat::S16:
+                w.WritePodVector(buf.pcm16);
+                break;
+            case compiler::SampleFormat::ImaAdpcm:
+                w.WritePodVector(buf.adpcm);
+                break;
+            }
+
+            w.Write(static_cast<std::uint8_t>(buf.IsStreamed() ? 1 : 0));
+            if (buf.IsStreamed())
+            {
+                std::error_code ec;
+                std::filesystem::path stream_path = std::filesystem::relative(buf.stream_path, bank_directory, ec);
+                if (ec || stream_path.empty())
+                    stream_path = std::filesystem::absolute(buf.stream_path);
+                const std::string generic_path = stream_path.generic_string();
+                w.Write(static_cast<std::uint32_t>(generic_path.size()));
+                w.WriteBytes(generic_path.data(), generic_path.size());
+            }
         }
 
         return w.FlushToFile(output_path, out_diagnostics);
@@ -365,6 +396,94 @@ namespace decl_audio::serialization
             result.diagnostics.push_back(MakeError(bank_path, err));
             return result;
         }
+        if (!r.ReadPodVector(bank.attenuation_curves, err))
+        {
+            result.diagnostics.push_back(MakeError(bank_path, err));
+            return result;
+        }
+        // The audio thread reads these LUTs unchecked.
+        for (const CompiledProgram &program : bank.programs)
+        {
+            if (program.spatialization.mode != compiler::SpatializationMode::None &&
+                static_cast<std::size_t>(program.spatialization.attenuation_curve) + compiler::kAttenuationCurvePoints > bank.attenuation_curves.size())
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "program attenuation curve is out of range"));
+                return result;
+            }
+        }
+
+        if (!r.ReadPodVector(bank.buses, err))
+        {
+            result.diagnostics.push_back(MakeError(bank_path, err));
+            return result;
+        }
+        // Buses fold into their parents from the back, so every parent must
+        // come first and every trigger after the bus it ducks; programs must
+        // name a bus the bank has.
+        for (std::size_t bus = 0; bus < bank.buses.size(); ++bus)
+        {
+            const compiler::BusId parent = bank.buses[bus].parent;
+            if (bus >= compiler::kMasterBus || (parent != compiler::kMasterBus && parent >= bus))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "bus graph is not in parents-first order"));
+                return result;
+            }
+
+            const compiler::CompiledDuck &duck = bank.buses[bus].duck;
+            if (duck.by != compiler::kMasterBus &&
+                (duck.by <= bus || duck.by >= bank.buses.size() ||
+                 !(duck.depth >= 0.0f && duck.depth <= 1.0f) || !(duck.threshold > 0.0f && duck.threshold <= 1.0f) ||
+                 !(duck.attack_ms >= 0.0f && duck.attack_ms < std::numeric_limits<float>::infinity()) ||
+                 !(duck.release_ms >= 0.0f && duck.release_ms < std::numeric_limits<float>::infinity())))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "bus duck settings are out of range"));
+                return result;
+            }
+        }
+        for (const CompiledProgram &program : bank.programs)
+        {
+            if (program.bus != compiler::kMasterBus && program.bus >= bank.buses.size())
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "program bus is out of range"));
+                return result;
+            }
+        }
+
+        if (!r.ReadPodVector(bank.filters, err))
+        {
+            result.diagnostics.push_back(MakeError(bank_path, err));
+            return result;
+        }
+        // Coefficients are designed from these on the audio thread; a bus
+        // filter has no program whose parameters could move its cutoff.
+        for (const CompiledFilter &filter : bank.filters)
+        {
+            if (filter.type > compiler::FilterType::HighShelf || !(filter.q > 0.0f) || !(filter.cutoff_from > 0.0f) || !(filter.cutoff_to > 0.0f))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "filter settings are out of range"));
+                return result;
+            }
+        }
+        for (const CompiledProgram &program : bank.programs)
+        {
+            if (program.filter == compiler::kNoFilter)
+                continue;
+            if (program.filter >= bank.filters.size() ||
+                (bank.filters[program.filter].parameter_slot != compiler::kInvalidParameterSlot && bank.filters[program.filter].parameter_slot >= program.parameter_count))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "program filter is out of range"));
+                return result;
+            }
+        }
+        for (const CompiledBus &bus : bank.buses)
+        {
+            if (bus.filter != compiler::kNoFilter &&
+                (bus.filter >= bank.filters.size() || bank.filters[bus.filter].parameter_slot != compiler::kInvalidParameterSlot))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "bus filter is out of range"));
+                return result;
+            }
+        }
 
         if (!r.ReadStringMap(bank.behavior_name_to_id, err))
         {
@@ -391,6 +510,43 @@ namespace decl_audio::serialization
             result.diagnostics.push_back(MakeError(bank_path, err));
             return result;
         }
+        if (!r.ReadStringMap(bank.bus_name_to_id, err))
+        {
+            result.diagnostics.push_back(MakeError(bank_path, err));
+            return result;
+        }
+        // Engines merge buses by name, so every bus needs exactly one.
+        std::vector<bool> bus_named(bank.buses.size(), false);
+        for (const auto &[name, bus] : bank.bus_name_to_id)
+        {
+            if (bus >= bus_named.size() || bus_named[bus])
+                break;
+            bus_named[bus] = true;
+        }
+        if (bank.bus_name_to_id.size() != bank.buses.size() || std::find(bus_named.begin(), bus_named.end(), false) != bus_named.end())
+        {
+            result.diagnostics.push_back(MakeError(bank_path, "bus name table does not match the bus graph"));
+            return result;
+        }
+        // A send must reach a bus that convolves; the engine transforms the
+        // impulse response from the asset the bus names.
+        for (const CompiledBus &bus : bank.buses)
+        {
+            if (bus.impulse != compiler::kNoImpulse && bus.impulse >= bank.asset_name_to_id.size())
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "bus impulse response is out of range"));
+                return result;
+            }
+        }
+        for (const CompiledProgram &program : bank.programs)
+        {
+            if (program.send_bus != compiler::kMasterBus &&
+                (program.send_bus >= bank.buses.size() || bank.buses[program.send_bus].impulse == compiler::kNoImpulse || !(program.send_level >= 0.0f)))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "program send is out of range"));
+                return result;
+            }
+        }
 
         std::uint32_t buffer_count = 0;
         if (!r.Read(buffer_count, err))
@@ -398,26 +554,73 @@ namespace decl_audio::serialization
             result.diagnostics.push_back(MakeError(bank_path, err));
             return result;
         }
-        abank.buffers.resize(buffer_count);
-        for (assets::DecodedBuffer &buf : abank.buffers)
+        if (buffer_count != bank.asset_name_to_id.size())
         {
-            std::uint32_t sample_count = 0;
+            result.diagnostics.push_back(MakeError(bank_path, "audio buffer count does not match the asset table"));
+            return result;
+        }
+        abank.buffers.reserve(buffer_count);
+        for (std::uint32_t buffer_index = 0; buffer_index < buffer_count; ++buffer_index)
+        {
+            assets::DecodedBuffer buf;
+            std::uint8_t format = 0;
             if (!r.Read(buf.frame_count, err) ||
                 !r.Read(buf.channel_count, err) ||
                 !r.Read(buf.sample_rate, err) ||
-                !r.Read(sample_count, err))
+                !r.Read(format, err))
             {
                 result.diagnostics.push_back(MakeError(bank_path, err));
                 return result;
             }
-            buf.samples.resize(sample_count);
-            if (sample_count > 0)
+
+            buf.format = static_cast<compiler::SampleFormat>(format);
+            bool read_ok = false;
+            switch (buf.format)
             {
-                if (!r.ReadBytesInto(buf.samples.data(), sample_count * sizeof(float), err))
-                {
-                    result.diagnostics.push_back(MakeError(bank_path, err));
-                    return result;
-                }
+            case compiler::SampleFormat::F32:
+                read_ok = r.ReadPodVector(buf.samples, err);
+                break;
+            case compiler::SampleFormat::S16:
+                read_ok = r.ReadPodVector(buf.pcm16, err);
+                break;
+            case compiler::SampleFormat::ImaAdpcm:
+                read_ok = r.ReadPodVector(buf.adpcm, err);
+                break;
+            default:
+                err = "unknown sample format " + std::to_string(format);
+                break;
+            }
+            std::uint8_t streamed = 0;
+            if (read_ok)
+                read_ok = r.Read(streamed, err);
+            if (read_ok && streamed != 0)
+            {
+                std::vector<char> stream_path;
+                read_ok = r.ReadPodVector(stream_path, err);
+                if (read_ok)
+                    buf.stream_path = (std::filesystem::absolute(bank_path).parent_path() / std::string(stream_path.begin(), stream_path.end())).lexically_normal();
+            }
+            if (!read_ok)
+            {
+                result.diagnostics.push_back(MakeError(bank_path, err));
+                return result;
+            }
+
+            // The audio thread indexes buffers by frame_count; reject storage
+            // that does not cover it.
+            if (!assets::HasConsistentStorage(buf))
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "audio buffer storage does not match its frame count"));
+                return result;
+            }
+            abank.buffers.push_back(std::make_shared<const assets::DecodedBuffer>(std::move(buf)));
+        }
+        for (const CompiledBus &bus : bank.buses)
+        {
+            if (bus.impulse != compiler::kNoImpulse && abank.buffers[bus.impulse]->IsStreamed())
+            {
+                result.diagnostics.push_back(MakeError(bank_path, "bus impulse response is streamed"));
+                return result;
             }
         }
 
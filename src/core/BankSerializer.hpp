@@ -10,7 +10,7 @@
 namespace decl_audio::serialization
 {
     inline constexpr std::uint32_t kBankMagic   = 0xDEC1A0D1u;
-    inline constexpr std::uint32_t kBankVersion = 1u;
+    inline constexpr std::uint32_t kBankVersion = 9u;
 
     struct LoadBankResult final
     {
@@ -29,6 +29,8 @@ namespace decl_audio::serialization
     [[nodiscard]] LoadBankResult LoadBankFromFile(const char *bank_path);
 
     // Serialize a compiled bank and its audio data to a .dacbank binary file.
+    // Streamed assets keep only their head in the bank plus their file's path
+    // relative to it, so the file must travel with the bank.
     // Returns false and appends an Error diagnostic on failure.
     [[nodiscard]] bool WriteBankToFile(
         const char *output_path,
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include "CpuFeatures.hpp"
+
+#if DECL_AUDIO_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace decl_audio
+{
+    SimdLevel DetectSimdLevel() noexcept
+    {
+#if DECL_AUDIO_X86 && defined(_MSC_VER) && !defined(__clang__)
+        int regs[4] = {};
+        __cpuid(regs, 0);
+        const int max_leaf = regs[0];
+
+        __cpuid(regs, 1);
+        const bool has_sse2 = (regs[3] & (1 << 26)) != 0;
+        const bool has_osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool has_avx = (regs[2] & (1 << 28)) != 0;
+        if (!has_sse2)
+        {
+            return SimdLevel::Scalar;
+        }
+
+        // AVX2 needs the OS to save YMM state (XCR0 bits 1 and 2) on top of the CPUID bit.
+        if (max_leaf >= 7 && has_osxsave && has_avx && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(regs, 7, 0);
+            if ((regs[1] & (1 << 5)) != 0)
+            {
+                return SimdLevel::Avx2;
+            }
+        }
+
+        return SimdLevel::Sse2;
+#elif DECL_AUDIO_X86 && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::Avx2;
+        }
+
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SimdLevel::Sse2;
+        }
+
+        return SimdLevel::Scalar;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    const char *SimdLevelName(const SimdLevel level) noexcept
+    {
+        switch (level)
+        {
+        case SimdLevel::Scalar:
+            return "scalar";
+        case SimdLevel::Sse2:
+            return "sse2";
+        case SimdLevel::Avx2:
+            return "avx2";
+        }
+
+        return "unknown";
+    }
+} // namespace decl_audio
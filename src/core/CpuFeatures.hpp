@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-function ISA targeting for kernels that must build without a global
+// -mavx2: GCC/Clang need the target attribute to accept AVX2 intrinsics, MSVC
+// accepts them anywhere. Callers must still gate on DetectSimdLevel().
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DECL_AUDIO_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define DECL_AUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DECL_AUDIO_TARGET_AVX2
+#endif
+#else
+#define DECL_AUDIO_X86 0
+#endif
+
+namespace decl_audio
+{
+    // Ordered: a level implies every level below it.
+    enum class SimdLevel : std::uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    // Queries the CPU (and, for AVX2, OS support for the YMM state). Cheap but
+    // not free - kernel tables cache the result once at startup.
+    [[nodiscard]] SimdLevel DetectSimdLevel() noexcept;
+    [[nodiscard]] const char *SimdLevelName(SimdLevel level) noexcept;
+} // namespace decl_audio
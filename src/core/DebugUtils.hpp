@@ -130,6 +130,8 @@ namespace decl_audio::DebugUtils
         std::cout << "  callback_frame_count: " << config.callback_frame_count << '\n';
         std::cout << "  max_instances: " << config.max_instances << '\n';
         std::cout << "  max_block_frames: " << config.max_block_frames << '\n';
+        std::cout << "  render_quantum_frames: " << config.render_quantum_frames << '\n';
+        std::cout << "  render_ahead_frames: " << config.render_ahead_frames << '\n';
         std::cout << "  backend_started: " << detail::ToString(engine->HasStartedBackend()) << '\n';
         std::cout << "  behaviors_loaded: " << detail::ToString(compiled_bank != nullptr && asset_bank != nullptr) << '\n';
         std::cout << "  load_diagnostic_count: " << engine->GetLoadDiagnostics().size() << '\n';
@@ -206,6 +208,7 @@ namespace decl_audio::DebugUtils
         std::cout << "  max_instances: " << runtime_snapshot.max_instances << '\n';
         std::cout << "  max_block_frames: " << runtime_snapshot.max_block_frames << '\n';
         std::cout << "  active_instance_count: " << runtime_snapshot.active_instance_count << '\n';
+        std::cout << "  virtual_instance_count: " << runtime_snapshot.virtual_instance_count << '\n';
         std::cout << "  pending_audio_commands: <not introspected; commands are applied during render>\n";
 
         std::vector<playback::InstanceDebugSnapshot> instances = runtime_snapshot.instances;
@@ -219,6 +222,7 @@ namespace decl_audio::DebugUtils
             std::cout << "    volume: " << instance.volume << '\n';
             std::cout << "    position: " << detail::FormatVec3(instance.position) << '\n';
             std::cout << "    stop_requested: " << detail::ToString(instance.stop_requested) << '\n';
+            std::cout << "    virtual: " << detail::ToString(instance.is_virtual) << '\n';
             std::cout << "    active_voice_count: " << instance.active_voice_count << '\n';
             std::cout << "    nodes: " << instance.nodes.size() << '\n';
             for (const playback::NodeDebugSnapshot &node : instance.nodes)
@@ -6,14 +6,37 @@
 #include "../compiler/Compiler.hpp"
 #include "../runtime/HostCommands.hpp"
 #include "../core/DebugUtils.hpp"
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <string>
 #include <string_view>
 
 namespace decl_audio
 {
+    namespace
+    {
+        // The reverb thread should finish a partition's tail before the audio
+        // thread plays it, or the partition goes out without it. One mix
+        // block can run several partitions back to back, so the audio thread
+        // sums a block's worth itself (plus one), leaving the thread at least
+        // a block of real time per job. Without a quantum a block is whatever
+        // the device delivers, up to max_block_frames.
+        std::uint32_t ReverbHeadPartitions(const EngineConfig &config) noexcept
+        {
+            const std::uint32_t mix_block_frames = config.render_quantum_frames > 0 ? config.render_quantum_frames : config.max_block_frames;
+            return 1 + (mix_block_frames + config.reverb_partition_frames - 1) / config.reverb_partition_frames;
+        }
+
+        float MasterLimiterCeiling(const EngineConfig &config) noexcept
+        {
+            return static_cast<float>(std::pow(10.0, static_cast<double>(config.master_limiter_ceiling_db) / 20.0));
+        }
+    } // namespace
 
     Engine::Engine(const EngineConfig &config) noexcept
         : host_log_queue_(static_cast<std::size_t>(config.host_queue_capacity)),
+          bus_registry_(config.max_bus_count, config.max_reverb_bus_count, config.reverb_partition_frames, config.max_impulse_frames),
           control_runtime_(vocabulary_, static_cast<std::size_t>(config.host_queue_capacity)),
           audio_runtime_(0xC0FFEEULL,
                          static_cast<std::size_t>(config.max_instances),
@@ -22,7 +45,22 @@ namespace decl_audio
                          static_cast<std::size_t>(config.command_queue_capacity),
                          config.max_program_node_count,
                          config.max_program_concurrent_voices,
-                         config.max_program_parameter_slot_count),
+                         config.max_program_parameter_slot_count,
+                         config.render_worker_count,
+                         config.gain_ramp_frames,
+                         static_cast<playback::StealPolicy>(config.steal_policy),
+                         config.render_quantum_frames,
+                         config.stream_voice_count,
+                         config.stream_prefetch_frames,
+                         config.max_bus_count,
+                         config.sample_rate,
+                         config.max_reverb_bus_count,
+                         config.reverb_partition_frames,
+                         config.max_impulse_frames,
+                         ReverbHeadPartitions(config),
+                         config.master_limiter_lookahead_frames,
+                         config.master_limiter_release_frames,
+                         MasterLimiterCeiling(config)),
           api_version_(DECL_AUDIO_API_VERSION),
           user_data_(nullptr),
           config(config)
@@ -66,7 +104,7 @@ namespace decl_audio
             return false;
         }
 
-        assets::LoadResult asset_result = assets::LoadAssetBank(compile_result.bank, source_path);
+        assets::LoadResult asset_result = assets::LoadAssetBank(compile_result.bank, source_path, config.sample_rate, &resample_cache_, config.stream_prefetch_frames);
         load_diagnostics_.insert(load_diagnostics_.end(), asset_result.diagnostics.begin(), asset_result.diagnostics.end());
         PushDiagnostics(asset_result.diagnostics);
 
@@ -89,6 +127,7 @@ namespace decl_audio
             return true; // already loaded - idempotent, skip reading the file
 
         serialization::LoadBankResult result = serialization::LoadBankFromFile(bank_path);
+        ConvertBankSampleRate(result, bank_path);
         return ConsumeBankResult(std::move(result), bank_path);
     }
 
@@ -121,12 +160,31 @@ namespace decl_audio
                 // beyond the result + ready flag. Diagnostics ride in the result and
                 // are drained by the control thread - never the SPSC host log queue.
                 pending_load_result_ = serialization::LoadBankFromFile(path.c_str());
+                ConvertBankSampleRate(pending_load_result_, path.c_str());
                 load_result_ready_.store(true, std::memory_order_release);
             });
 
         return true;
     }
 
+    void Engine::ConvertBankSampleRate(serialization::LoadBankResult &result, const char *bank_path)
+    {
+        if (result.HasErrors())
+            return;
+
+        // Baked banks carry no source paths; the bank file plus asset name
+        // identifies an asset to the cache instead.
+        std::vector<std::string> asset_keys(result.asset_bank.buffers.size());
+        for (const auto &[asset_name, asset_id] : result.compiled_bank.asset_name_to_id)
+        {
+            if (static_cast<std::size_t>(asset_id) < asset_keys.size())
+                asset_keys[static_cast<std::size_t>(asset_id)] = assets::MakeResampleKey(bank_path, asset_name);
+        }
+
+        const std::vector<Diagnostic> diagnostics = assets::ConvertAssetBankSampleRate(result.asset_bank, asset_keys, config.sample_rate, &resample_cache_);
+        result.diagnostics.insert(result.diagnostics.end(), diagnostics.begin(), diagnostics.end());
+    }
+
     bool Engine::ConsumeBankResult(serialization::LoadBankResult &&result, const char *source_path) noexcept
     {
         load_diagnostics_ = result.diagnostics;
@@ -173,6 +231,15 @@ namespace decl_audio
             return false;
         }
 
+        // Buses are engine-wide; a bank must agree with the ones already loaded.
+        const std::string bus_error = bus_registry_.CheckBank(compiled, assets);
+        if (!bus_error.empty())
+        {
+            const Diagnostic &diag = load_diagnostics_.emplace_back(MakeError(source_path, "bank.buses", bus_error));
+            PushLog("[error] " + FormatSourceLocation(diag.location) + ": " + diag.message);
+            return false;
+        }
+
         // Find a free slot. A retiring/draining bank still occupies its slot, so this
         // can legitimately fail under slot pressure - reject with a diagnostic.
         std::size_t slot = kMaxBanks;
@@ -202,6 +269,21 @@ namespace decl_audio
         // Intern + remap this bank's vocabulary to global ids (content ids stay local).
         vocabulary_.MergeBank(loaded->compiled);
 
+        // Same for bus ids. New buses reach the audio thread ahead of any
+        // instance that plays on them.
+        for (compiler::BusId bus = bus_registry_.MergeBank(loaded->compiled, loaded->assets); bus < bus_registry_.BusCount(); ++bus)
+        {
+            const compiler::CompiledFilter *filter = bus_registry_.Filter(bus);
+            SubmitAudio(playback::AddBusCommand{bus,
+                                                bus_registry_.Parent(bus),
+                                                bus_registry_.Gain(bus),
+                                                filter != nullptr,
+                                                filter != nullptr ? *filter : compiler::CompiledFilter{},
+                                                bus_registry_.Impulse(bus),
+                                                bus_registry_.Duck(bus)},
+                        0);
+        }
+
         // Publish into the audio slot table BEFORE the resolver can emit any
         // CreateInstance for it; the command ring then carries the happens-before.
         audio_runtime_.InstallBank(loaded->id, &loaded->compiled, &loaded->assets);
@@ -245,6 +327,25 @@ namespace decl_audio
     // to be on its own thread in the future i guess...!
     void Engine::Update() noexcept
     {
+        UpdateAt(0);
+    }
+
+    void Engine::UpdateAt(const std::uint64_t audio_frame) noexcept
+    {
+        // The audio thread keeps at most command_queue_capacity commands
+        // waiting for their frames; once that fills, the ring stops draining
+        // until the earliest one is due. Bounding how far ahead they may be
+        // bounds that wait.
+        const std::uint64_t horizon = GetAudioClock() + config.sample_rate;
+        if (audio_frame > horizon)
+        {
+            PushLog("[warning] UpdateAt frame " + std::to_string(audio_frame) + " is more than one second ahead of the audio clock; scheduling it at " +
+                    std::to_string(horizon));
+        }
+        update_frame_ = std::min(audio_frame, horizon);
+
+        FlushAudioOverflow();
+
         PollAsyncLoad(); // wire any finished async load before resolving this tick
 
         control_runtime_.Tick(); // drain control queue
@@ -255,14 +356,28 @@ namespace decl_audio
         Vec3 listener_position;
         if (control_runtime_.ListenerPositionChanged(listener_position))
         {
-            audio_runtime_.Submit(playback::SetListenerPositionCommand{
-                listener_position});
+            SubmitAudio(playback::SetListenerPositionCommand{listener_position}, update_frame_);
+        }
+
+        Quat listener_orientation;
+        if (control_runtime_.ListenerOrientationChanged(listener_orientation))
+        {
+            SubmitAudio(playback::SetListenerOrientationCommand{listener_orientation}, update_frame_);
         }
 
         float master_gain;
         if (control_runtime_.MasterGainChanged(master_gain))
         {
-            audio_runtime_.Submit(playback::SetMasterGainCommand{master_gain});
+            SubmitAudio(playback::SetMasterGainCommand{master_gain}, update_frame_);
+        }
+
+        for (const runtime::SetBusVolumeCommand &command : control_runtime_.TakePendingBusVolumes())
+        {
+            compiler::BusId bus;
+            if (bus_registry_.SetHostVolume(command.bus_name, command.volume, bus))
+            {
+                SubmitAudio(playback::SetBusGainCommand{bus, bus_registry_.Gain(bus)}, update_frame_);
+            }
         }
 
         // World state keeps accumulating from the drained commands regardless of
@@ -277,6 +392,22 @@ namespace decl_audio
         SweepDrainedBanks();
     }
 
+    void Engine::SubmitAudio(const playback::AudioCommand &command, const std::uint64_t at_frame) noexcept
+    {
+        if (!audio_overflow_.empty() || !audio_runtime_.TrySubmit(command, at_frame))
+        {
+            audio_overflow_.push_back(playback::TimedAudioCommand{command, at_frame});
+        }
+    }
+
+    void Engine::FlushAudioOverflow() noexcept
+    {
+        while (!audio_overflow_.empty() && audio_runtime_.TrySubmit(audio_overflow_.front().command, audio_overflow_.front().frame))
+        {
+            audio_overflow_.pop_front();
+        }
+    }
+
     void Engine::ResolveLoadedBanks() noexcept
     {
         runtime::ResolverBankView views[kMaxBanks];
@@ -294,7 +425,7 @@ namespace decl_audio
             std::span<const runtime::ResolverBankView>(views, view_count),
             [this](const playback::AudioCommand &command)
             {
-                audio_runtime_.Submit(command);
+                SubmitAudio(command, update_frame_);
             });
     }
 
@@ -312,7 +443,7 @@ namespace decl_audio
                 // instances in one shot). Then route the retire down the command ring.
                 bank->status = BankStatus::Retiring;
                 behavior_resolver_.DropBank(bank->id);
-                audio_runtime_.Submit(playback::RetireBankCommand{bank->id});
+                SubmitAudio(playback::RetireBankCommand{bank->id}, update_frame_);
                 break; // unload one matching bank per request
             }
         }
@@ -405,17 +536,47 @@ namespace decl_audio
             Vec3{x, y, z}});
     }
 
+    void Engine::SetTransform(const char *entity_id, const Vec3 &position, const Quat &orientation) noexcept
+    {
+        control_runtime_.Submit(runtime::SetEntityTransformCommand{
+            std::string(entity_id),
+            position,
+            orientation});
+    }
+
+    void Engine::SetQuatValue(const char *entity_id, const char *key, const Quat &value) noexcept
+    {
+        control_runtime_.Submit(runtime::SetQuatValueCommand{
+            std::string(entity_id),
+            std::string(key),
+            value});
+    }
+
     void Engine::SetListenerPosition(const float x, const float y, const float z) noexcept
     {
         control_runtime_.Submit(runtime::SetListenerPositionCommand{
             Vec3{x, y, z}});
     }
 
+    void Engine::SetListenerTransform(const Vec3 &position, const Quat &orientation) noexcept
+    {
+        control_runtime_.Submit(runtime::SetListenerTransformCommand{
+            position,
+            orientation});
+    }
+
     void Engine::SetMasterGain(const float gain) noexcept
     {
         control_runtime_.Submit(runtime::SetMasterGainCommand{gain});
     }
 
+    void Engine::SetBusVolume(const char *bus, const float volume) noexcept
+    {
+        control_runtime_.Submit(runtime::SetBusVolumeCommand{
+            std::string(bus),
+            volume});
+    }
+
     void Engine::DestroyEntity(const char *entity_id) noexcept
     {
         control_runtime_.Submit(runtime::DestroyEntityCommand{
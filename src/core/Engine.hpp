@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <span>
 #include <string>
@@ -10,6 +11,7 @@
 
 #include "Decl_Audio/Decl_Audio.h"
 #include "../assets/AssetBank.hpp"
+#include "../assets/Resampler.hpp"
 #include "../backends/AudioDeviceBackend.hpp"
 #include "../compiler/CompiledBank.hpp"
 #include "BankId.hpp"
@@ -18,6 +20,7 @@
 #include "../core/RingBuffer.hpp"
 #include "../playback/AudioRuntime.hpp"
 #include "../runtime/BehaviorResolver.hpp"
+#include "../runtime/BusRegistry.hpp"
 #include "../runtime/ControlRuntime.hpp"
 #include "../runtime/VocabularyRegistry.hpp"
 #include "../runtime/WorldState.hpp"
@@ -45,6 +48,12 @@ namespace decl_audio
         // the bank's instances fade out and the bucket is freed once drained.
         void UnloadBank(const char *bank_path) noexcept;
         void Update() noexcept;
+        // Update(), with every playback change it produces scheduled for audio
+        // clock frame `audio_frame` instead of the next block; later updates
+        // are not held back by it. Frames more than one second (sample_rate
+        // frames) past GetAudioClock() are clamped to that horizon, with a
+        // warning in the log.
+        void UpdateAt(std::uint64_t audio_frame) noexcept;
         void RenderAudioForTesting(float *output, std::uint32_t frames) noexcept;
         [[nodiscard]] bool TryDequeueLog(std::string &message) noexcept;
         void SetTag(const char *entity_id, const char *tag) noexcept;
@@ -55,8 +64,12 @@ namespace decl_audio
         void RemoveGlobalTag(const char *tag) noexcept;
         void SetGlobalValue(const char *param, float value) noexcept;
         void SetPosition(const char *entity_id, float x, float y, float z) noexcept;
+        void SetTransform(const char *entity_id, const Vec3 &position, const Quat &orientation) noexcept;
+        void SetQuatValue(const char *entity_id, const char *key, const Quat &value) noexcept;
         void SetListenerPosition(float x, float y, float z) noexcept;
+        void SetListenerTransform(const Vec3 &position, const Quat &orientation) noexcept;
         void SetMasterGain(float gain) noexcept;
+        void SetBusVolume(const char *bus, float volume) noexcept;
         void DestroyEntity(const char *entity_id) noexcept;
 
         [[nodiscard]] uint32_t GetApiVersion() const noexcept
@@ -77,6 +90,19 @@ namespace decl_audio
         {
             return audio_runtime_.GetDebugSnapshot();
         };
+        [[nodiscard]] playback::RuntimeMetrics GetMetrics() const noexcept
+        {
+            playback::RuntimeMetrics metrics = audio_runtime_.GetMetrics();
+            if (audio_backend_ != nullptr)
+            {
+                metrics.fifo_underrun_count = audio_backend_->UnderrunCount();
+            }
+            return metrics;
+        };
+        [[nodiscard]] std::uint64_t GetAudioClock() const noexcept
+        {
+            return audio_runtime_.GetAudioClock();
+        };
         // Per-bank accessor. Returns nullptr if no live bank occupies that slot/id.
         [[nodiscard]] const LoadedBank *TryGetBank(BankId bank_id) const noexcept
         {
@@ -121,9 +147,10 @@ namespace decl_audio
         [[nodiscard]] bool
         StartConfiguredAudioBackend(const char *source_path) noexcept;
         void StopConfiguredAudioBackend() noexcept;
-        // Intern + remap the bank's vocabulary, install it into a free slot, and make
-        // it resolvable. No backend stop - gapless. Returns false (with a diagnostic)
-        // if the bank exceeds the storage caps or no slot is free.
+        // Intern + remap the bank's vocabulary and buses, install it into a free
+        // slot, and make it resolvable. No backend stop - gapless. Returns false
+        // (with a diagnostic) if the bank exceeds the storage caps, its buses
+        // conflict with loaded ones, or no slot is free.
         bool AddBank(compiler::CompiledBank &&compiled, assets::AssetBank &&assets, const char *source_path) noexcept;
         // Shared tail of the binary-bank load (sync LoadBank + async completion):
         // record diagnostics, then add the bank unless the result errored.
@@ -131,6 +158,12 @@ namespace decl_audio
         // Control-thread side of async loading: if the worker finished, join it and
         // wire the result. No-op when nothing is pending. Called from Update().
         void PollAsyncLoad() noexcept;
+        // Queue a command for the audio thread. The ring can fill (while the
+        // audio side's scheduled commands are at capacity, say); commands that
+        // do not fit wait in audio_overflow_, in order, and FlushAudioOverflow
+        // (at the start of each Update) moves them on as the ring drains.
+        void SubmitAudio(const playback::AudioCommand &command, std::uint64_t at_frame) noexcept;
+        void FlushAudioOverflow() noexcept;
         // Run the resolver over every loaded bank (skipping retiring ones).
         void ResolveLoadedBanks() noexcept;
         // Drain host unload requests: mark the named bank Retiring, drop its
@@ -144,6 +177,9 @@ namespace decl_audio
         // (A Retiring bank with the same path does not count - it is on its way out,
         // so a fresh load brings the content back.)
         [[nodiscard]] bool HasActiveBank(const char *source_path) const noexcept;
+        // Brings a deserialized bank's buffers to the device rate. Safe on the
+        // async load worker: it touches only the (locked) resample cache.
+        void ConvertBankSampleRate(serialization::LoadBankResult &result, const char *bank_path);
         void PushLog(std::string message);
         void PushDiagnostics(std::span<const decl_audio::Diagnostic> diagnostics);
 
@@ -165,11 +201,18 @@ namespace decl_audio
         serialization::LoadBankResult pending_load_result_;
         std::string pending_load_path_;
         std::vector<decl_audio::Diagnostic> load_diagnostics_;
+        // Assets converted to config.sample_rate, shared by every bank load.
+        assets::ResampleCache resample_cache_;
         RingBuffer<std::string> host_log_queue_;
         runtime::VocabularyRegistry vocabulary_;
+        runtime::BusRegistry bus_registry_;
         runtime::ControlRuntime control_runtime_;
         runtime::BehaviorResolver behavior_resolver_;
         playback::AudioRuntime audio_runtime_;
+        // Audio clock frame stamped on the commands the current Update submits
+        // (0 = apply at the next block).
+        std::uint64_t update_frame_ = 0;
+        std::deque<playback::TimedAudioCommand> audio_overflow_;
         uint32_t api_version_;
         void *user_data_;
         EngineConfig config;
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace decl_audio
+{
+    // Fixed-capacity binary min-heap over small integer handles in
+    // [0, capacity), with a handle -> heap position index so any member can be
+    // re-keyed or removed in O(log n), not just the top. Sized once at
+    // construction and never allocates after that. `Key` needs operator<; ties
+    // are broken however the sift happens to leave them, so callers that need
+    // a deterministic order put a tiebreaker in the key.
+    template <typename Key>
+    class IndexedMinHeap final
+    {
+    public:
+        static constexpr std::uint32_t kNotInHeap = std::numeric_limits<std::uint32_t>::max();
+
+        IndexedMinHeap() = default;
+
+        explicit IndexedMinHeap(const std::size_t capacity)
+            : heap_(capacity), keys_(capacity), position_(capacity, kNotInHeap)
+        {
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool Empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] bool Contains(const std::uint32_t handle) const noexcept
+        {
+            return handle < position_.size() && position_[handle] != kNotInHeap;
+        }
+
+        // The handle with the smallest key. The heap must not be empty.
+        [[nodiscard]] std::uint32_t Top() const noexcept
+        {
+            return heap_[0];
+        }
+
+        [[nodiscard]] const Key &KeyOf(const std::uint32_t handle) const noexcept
+        {
+            return keys_[handle];
+        }
+
+        // Returns false (and changes nothing) if `handle` is out of range or
+        // already present.
+        bool Push(const std::uint32_t handle, const Key &key) noexcept
+        {
+            if (handle >= position_.size() || position_[handle] != kNotInHeap)
+            {
+                return false;
+            }
+
+            keys_[handle] = key;
+            heap_[size_] = handle;
+            position_[handle] = static_cast<std::uint32_t>(size_);
+            ++size_;
+            SiftUp(size_ - 1);
+            return true;
+        }
+
+        // Re-keys a present handle and restores heap order. Returns false if
+        // `handle` is not in the heap.
+        bool Update(const std::uint32_t handle, const Key &key) noexcept
+        {
+            if (!Contains(handle))
+            {
+                return false;
+            }
+
+            const bool decreased = key < keys_[handle];
+            keys_[handle] = key;
+            if (decreased)
+            {
+                SiftUp(position_[handle]);
+            }
+            else
+            {
+                SiftDown(position_[handle]);
+            }
+
+            return true;
+        }
+
+        // Returns false if `handle` was not in the heap.
+        bool Erase(const std::uint32_t handle) noexcept
+        {
+            if (!Contains(handle))
+            {
+                return false;
+            }
+
+            const std::size_t hole = position_[handle];
+            position_[handle] = kNotInHeap;
+            --size_;
+            if (hole == size_)
+            {
+                return true;
+            }
+
+            // Move the last member into the hole; it may need to go either way.
+            const std::uint32_t moved = heap_[size_];
+            Place(hole, moved);
+            SiftUp(hole);
+            SiftDown(position_[moved]);
+            return true;
+        }
+
+    private:
+        void Place(const std::size_t index, const std::uint32_t handle) noexcept
+        {
+            heap_[index] = handle;
+            position_[handle] = static_cast<std::uint32_t>(index);
+        }
+
+        void SiftUp(std::size_t index) noexcept
+        {
+            const std::uint32_t handle = heap_[index];
+            while (index > 0)
+            {
+                const std::size_t parent = (index - 1) / 2;
+                if (!(keys_[handle] < keys_[heap_[parent]]))
+                {
+                    break;
+                }
+
+                Place(index, heap_[parent]);
+                index = parent;
+            }
+
+            Place(index, handle);
+        }
+
+        void SiftDown(std::size_t index) noexcept
+        {
+            const std::uint32_t handle = heap_[index];
+            while (true)
+            {
+                std::size_t smallest = 2 * index + 1;
+                if (smallest >= size_)
+                {
+                    break;
+                }
+
+                if (smallest + 1 < size_ && keys_[heap_[smallest + 1]] < keys_[heap_[smallest]])
+                {
+                    ++smallest;
+                }
+
+                if (!(keys_[heap_[smallest]] < keys_[handle]))
+                {
+                    break;
+                }
+
+                Place(index, heap_[smallest]);
+                index = smallest;
+            }
+
+            Place(index, handle);
+        }
+
+        std::vector<std::uint32_t> heap_;     // heap order -> handle
+        std::vector<Key> keys_;               // handle -> key
+        std::vector<std::uint32_t> position_; // handle -> heap order, kNotInHeap if absent
+        std::size_t size_ = 0;
+    };
+} // namespace decl_audio
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <compare>
+#include <cmath>
+
+#include "vec3.hpp"
+
+// Rotation quaternion, scalar part first: (w, x, y, z) is the (a, b, c, d) of
+// the C API setters. The identity orientation faces +z, with +x to the right
+// and +y up.
+struct Quat
+{
+    float w = 1.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    auto operator<=>(const Quat &) const = default;
+
+    // Unit length; a zero quaternion (nothing meaningful to rotate by) becomes
+    // the identity.
+    Quat Normalized() const
+    {
+        const float mag = std::sqrt(w * w + x * x + y * y + z * z);
+        if (mag == 0.f)
+            return Quat{};
+        return {w / mag, x / mag, y / mag, z / mag};
+    }
+
+    // The local axes rotated into the parent frame (unit quaternions only).
+    Vec3 Right() const
+    {
+        return {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y)};
+    }
+    Vec3 Up() const
+    {
+        return {2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)};
+    }
+    Vec3 Forward() const
+    {
+        return {2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y)};
+    }
+};
@@ -3,14 +3,18 @@
 #include <cstdint>
 #include <variant>
 
+#include "../compiler/CompiledBank.hpp"
 #include "../compiler/CompilerTypes.hpp"
 #include "../core/BankId.hpp"
+#include "../core/quat.hpp"
 #include "../core/vec3.hpp"
 
 namespace decl_audio::playback
 {
     using InstanceId = std::uint64_t;
 
+    struct ImpulseResponse;
+
     struct CreateInstanceCommand final
     {
         InstanceId instance_id = 0;
@@ -57,11 +61,41 @@ namespace decl_audio::playback
         Vec3 position{};
     };
 
+    // Unit quaternion (normalized on the control thread).
+    struct SetListenerOrientationCommand final
+    {
+        Quat orientation{};
+    };
+
     struct SetMasterGainCommand final
     {
         float gain = 1.0f;
     };
 
+    // Appends mix bus `bus` to the audio thread's bus array. Buses arrive in id
+    // order with parents first, ahead of any CreateInstance that plays on them.
+    // A filtered bus carries its filter's settings; the audio thread designs
+    // the coefficients for its sample rate. A ducked bus names a trigger with
+    // a higher id, so the trigger arrives after it.
+    struct AddBusCommand final
+    {
+        compiler::BusId bus = 0;
+        compiler::BusId parent = compiler::kMasterBus;
+        float gain = 1.0f;
+        bool filtered = false;
+        compiler::CompiledFilter filter{};
+        // The bus's reverb (null for none), owned by the BusRegistry and alive
+        // as long as the runtime.
+        const ImpulseResponse *impulse = nullptr;
+        compiler::CompiledDuck duck{};
+    };
+
+    struct SetBusGainCommand final
+    {
+        compiler::BusId bus = 0;
+        float gain = 1.0f;
+    };
+
     using AudioCommand = std::variant<
         CreateInstanceCommand,
         SetVolumeCommand,
@@ -70,5 +104,26 @@ namespace decl_audio::playback
         RequestStopCommand,
         RetireBankCommand,
         SetListenerPositionCommand,
-        SetMasterGainCommand>;
+        SetListenerOrientationCommand,
+        SetMasterGainCommand,
+        AddBusCommand,
+        SetBusGainCommand>;
+
+    // A command as it travels the ring: applied at audio clock frame `frame`, or
+    // at the start of the next block if that frame has already been rendered.
+    // Commands due on the same frame apply in submission order, and a command
+    // for an instance never overtakes an earlier one for that instance.
+    struct TimedAudioCommand final
+    {
+        AudioCommand command{};
+        std::uint64_t frame = 0;
+    };
+
+    // A command waiting on the audio side for its frame; `sequence` is its
+    // arrival order, the tiebreak between commands due on one frame.
+    struct ScheduledAudioCommand final
+    {
+        TimedAudioCommand timed;
+        std::uint64_t sequence = 0;
+    };
 } // namespace decl_audio::playback
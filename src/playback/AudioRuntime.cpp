@@ -2,6 +2,9 @@
 
 #include "AudioRuntime.hpp"
 
+#include "../assets/SampleCodec.hpp"
+#include "BiquadFilter.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -12,8 +15,9 @@ namespace decl_audio::playback
     namespace
     {
         constexpr std::size_t kNotFound = std::numeric_limits<std::size_t>::max();
-        constexpr float kQuarterTurn = 0.78539816339744830962f;
         constexpr std::uint16_t kInvalidParameterSlot = std::numeric_limits<std::uint16_t>::max();
+        // Stands in for the curve of an unspatialized instance, whose lane is never read.
+        constexpr std::array<float, compiler::kAttenuationCurvePoints> kPlaceholderCurve{};
 
         [[nodiscard]] std::uint64_t MixSeed64(std::uint64_t value) noexcept
         {
@@ -23,53 +27,94 @@ namespace decl_audio::playback
             return value ^ (value >> 31U);
         }
 
-        struct StereoMixGains final
+        constexpr InstanceId kNoCommandInstance = 0;
+
+        // The instance `command` addresses; kNoCommandInstance for commands
+        // that address none.
+        [[nodiscard]] InstanceId CommandInstanceId(const AudioCommand &command) noexcept
         {
-            float left = 1.0f;
-            float right = 1.0f;
-        };
+            return std::visit(
+                [](const auto &typed_command) -> InstanceId
+                {
+                    if constexpr (requires { typed_command.instance_id; })
+                    {
+                        return typed_command.instance_id;
+                    }
+                    else
+                    {
+                        return kNoCommandInstance;
+                    }
+                },
+                command);
+        }
 
-        [[nodiscard]] StereoMixGains ComputeSpatialMixGains(const compiler::CompiledSpatializationSettings &spatialization,
-                                                            const Vec3 &source_position,
-                                                            const Vec3 &listener_position) noexcept
+        // Heap order for the scheduled commands: earliest frame, then earliest
+        // arrival, on top.
+        [[nodiscard]] bool IsScheduledLater(const ScheduledAudioCommand &a, const ScheduledAudioCommand &b) noexcept
         {
-            if (spatialization.mode == compiler::SpatializationMode::None)
-            {
-                return StereoMixGains{};
-            }
+            return a.timed.frame != b.timed.frame ? a.timed.frame > b.timed.frame : a.sequence > b.sequence;
+        }
 
-            const Vec3 relative = Vec3::subtract(source_position, listener_position);
-            const float distance = relative.magnitude();
+        [[nodiscard]] SpatialListener MakeSpatialListener(const ListenerState &listener) noexcept
+        {
+            return SpatialListener{listener.position, listener.orientation.Right(), listener.orientation.Forward()};
+        }
 
-            float attenuation = 1.0f;
-            switch (spatialization.attenuation)
-            {
-            case compiler::AttenuationMode::Linear:
-                if (distance <= spatialization.min_distance)
-                {
-                    attenuation = 1.0f;
-                }
-                else if (distance >= spatialization.max_distance)
-                {
-                    attenuation = 0.0f;
-                }
-                else
-                {
-                    attenuation = 1.0f - ((distance - spatialization.min_distance) / (spatialization.max_distance - spatialization.min_distance));
-                }
-                break;
-            }
+        // Surround counterpart of the spatial pass's left/right gains for a
+        // spatialized instance: VBAP over the layout's ring by the source's
+        // listener-space direction, scaled by its distance attenuation. Height is
+        // ignored, and a source on the listener's vertical axis pans straight
+        // ahead. Returns the loudest gain.
+        float ComputeSpeakerGains(const SpeakerLayout &layout,
+                                  const float attenuation,
+                                  const float local_x,
+                                  const float local_z,
+                                  const std::span<float> gains) noexcept
+        {
+            const float azimuth = local_x != 0.0f || local_z != 0.0f ? std::atan2(local_x, local_z) : 0.0f;
+            ComputeVbapGains(layout, azimuth, gains);
 
-            float pan = 0.0f;
-            if (distance > 0.0f)
+            float loudest = 0.0f;
+            for (float &gain : gains)
             {
-                pan = std::clamp(relative.x / distance, -1.0f, 1.0f);
+                gain *= attenuation;
+                loudest = std::max(loudest, gain);
             }
 
-            const float angle = (pan + 1.0f) * kQuarterTurn;
-            return StereoMixGains{
-                std::cos(angle) * attenuation,
-                std::sin(angle) * attenuation};
+            return loudest;
+        }
+
+        [[nodiscard]] bool UsesSpeakerPanning(const SpeakerLayout *layout, const compiler::CompiledSpatializationSettings &spatialization) noexcept
+        {
+            return layout != nullptr && spatialization.mode != compiler::SpatializationMode::None;
+        }
+
+        // Pitch parameters clamp to two octaves either way, so rates stay within
+        // [1/4, 4] and a block's resampled reads stay well inside 32-bit offsets.
+        constexpr float kMaxPitchSemitones = 24.0f;
+
+        [[nodiscard]] std::uint64_t GetFixedPosition(const VoiceState &voice) noexcept
+        {
+            return (voice.sample_position << kRateFractionBits) | voice.sample_fraction;
+        }
+
+        void SetFixedPosition(VoiceState &voice, const std::uint64_t position) noexcept
+        {
+            voice.sample_position = position >> kRateFractionBits;
+            voice.sample_fraction = static_cast<std::uint32_t>(position & (kUnityRate - 1));
+        }
+
+        // Output frames a voice stepping by `rate` renders before its position
+        // reaches `target` (both fixed point).
+        [[nodiscard]] std::uint64_t FramesUntil(const std::uint64_t position, const std::uint64_t target, const std::uint32_t rate) noexcept
+        {
+            return target > position ? (target - position + rate - 1) / rate : 0;
+        }
+
+        [[nodiscard]] bool VoiceEndsBefore(const std::span<const VoiceState> voices, const std::uint32_t a, const std::uint32_t b) noexcept
+        {
+            // Ties go to the lower index, which retires voices in slot order.
+            return voices[a].end_frame != voices[b].end_frame ? voices[a].end_frame < voices[b].end_frame : a < b;
         }
     } // namespace
 
@@ -80,27 +125,153 @@ namespace decl_audio::playback
                                const std::size_t command_queue_capacity,
                                const std::uint32_t max_program_node_count,
                                const std::uint32_t max_program_concurrent_voices,
-                               const std::uint32_t max_program_parameter_slot_count)
+                               const std::uint32_t max_program_parameter_slot_count,
+                               const std::uint32_t render_worker_count,
+                               const std::uint32_t gain_ramp_frames,
+                               const StealPolicy steal_policy,
+                               const std::uint32_t render_quantum_frames,
+                               const std::uint32_t stream_voice_count,
+                               const std::uint32_t stream_prefetch_frames,
+                               const std::uint32_t max_bus_count,
+                               const std::uint32_t sample_rate,
+                               const std::uint32_t max_reverb_bus_count,
+                               const std::uint32_t reverb_partition_frames,
+                               const std::uint32_t max_impulse_frames,
+                               const std::uint32_t reverb_head_partitions,
+                               const std::uint32_t limiter_lookahead_frames,
+                               const std::uint32_t limiter_release_frames,
+                               const float limiter_ceiling)
         : commands_(command_queue_capacity),
           root_seed_(root_seed),
           max_instances_(max_instances),
           max_block_frames_(max_block_frames),
           out_channel_count_(out_channel_count),
+          sample_rate_(sample_rate),
+          steal_policy_(steal_policy),
           cap_node_count_(max_program_node_count),
           cap_voice_count_(max_program_concurrent_voices),
-          cap_param_slot_count_(max_program_parameter_slot_count)
+          cap_param_slot_count_(max_program_parameter_slot_count),
+          gain_ramp_frames_(gain_ramp_frames),
+          mix_kernels_(&GetMixKernels()),
+          spatial_kernel_(GetSpatialKernel())
     {
-        instances_.reserve(max_instances_);
-        scratch_.resize(static_cast<std::size_t>(max_block_frames_) * out_channel_count);
+        // Quanta are mixed through the max_block_frames-sized scratch buses.
+        // A chunk's sends are one mask bit per reverb slot.
+        if (render_quantum_frames > max_block_frames_ || !IsSupportedOutputChannelCount(out_channel_count_) || max_bus_count >= compiler::kMasterBus ||
+            max_reverb_bus_count > 32)
+        {
+            std::terminate();
+        }
+
+        speaker_layout_ = FindSurroundLayout(out_channel_count_);
+        scheduled_.reserve(command_queue_capacity);
+
+        render_quantum_frames_ = render_quantum_frames;
+        if (render_quantum_frames_ > 0)
+        {
+            quantum_bus_ = MixBus(out_channel_count, render_quantum_frames_);
+            quantum_read_ = render_quantum_frames_; // nothing carried yet
+        }
+
+        // Steal headroom: enough for a burst of creates at capacity to fade their
+        // victims; beyond it victims are cut without a fade.
+        slice_count_ = max_instances_ + (steal_policy_ != StealPolicy::None ? max_instances_ / 8 + 1 : 0);
+        instances_.reserve(slice_count_);
+        retire_flags_.resize(slice_count_, 0);
+        // One envelope per executor: the callback thread plus each render worker.
+        envelope_.resize(static_cast<std::size_t>(render_worker_count + 1) * max_block_frames_);
+        if (speaker_layout_ != nullptr)
+        {
+            premix_.resize(envelope_.size());
+        }
+        resample_scratch_.resize(envelope_.size() * 2);
+        filter_scratch_.resize(envelope_.size() * 2);
+        // A block at the top rate (4x) reads 4 source frames per output frame,
+        // plus the right neighbour of the last one.
+        decode_scratch_stride_ = (static_cast<std::size_t>(max_block_frames_) * 4 + 2) * 2;
+        decode_scratch_.resize(static_cast<std::size_t>(render_worker_count + 1) * decode_scratch_stride_);
+        for (std::vector<float> *lane : {&spatial_lanes_.position_x, &spatial_lanes_.position_y, &spatial_lanes_.position_z,
+                                         &spatial_lanes_.min_distance, &spatial_lanes_.max_distance, &spatial_lanes_.gain_left,
+                                         &spatial_lanes_.gain_right, &spatial_lanes_.attenuation, &spatial_lanes_.local_x, &spatial_lanes_.local_z})
+        {
+            lane->resize(slice_count_, 0.0f);
+        }
+        spatial_lanes_.attenuation_curve.resize(slice_count_, kPlaceholderCurve.data());
+        interleave_bus_ = MixBus(out_channel_count_, max_block_frames_);
+
+        // Chunk buses exist whether or not there are workers - the serial path
+        // reduces through them too, which is what keeps output independent of
+        // the worker count.
+        const std::size_t max_chunks = (slice_count_ + kInstancesPerChunk - 1) / kInstancesPerChunk;
+        chunk_buses_.reserve(max_chunks > 0 ? max_chunks - 1 : 0);
+        for (std::size_t chunk = 1; chunk < max_chunks; ++chunk)
+        {
+            chunk_buses_.emplace_back(out_channel_count_, max_block_frames_);
+        }
+
+        // Grouping instances by bus adds at most one partial chunk per bus, and
+        // those are the chunks that mix straight into their bus, so the chunk
+        // buses above still cover every other chunk.
+        render_chunks_.resize(max_chunks + max_bus_count);
+        render_order_.resize(slice_count_, 0);
+        bus_group_first_.resize(static_cast<std::size_t>(max_bus_count) + 2, 0);
+        buses_.resize(max_bus_count);
+        for (BusState &bus : buses_)
+        {
+            bus.mix = MixBus(out_channel_count_, max_block_frames_);
+        }
+        duck_gains_.resize(max_bus_count > 0 ? max_block_frames_ : 0);
+
+        if (max_reverb_bus_count > 0)
+        {
+            const std::uint32_t max_partition_count = std::max<std::uint32_t>(1, (max_impulse_frames + reverb_partition_frames - 1) / reverb_partition_frames);
+            reverb_ = std::make_unique<ConvolutionReverb>(*mix_kernels_, max_reverb_bus_count, reverb_partition_frames, max_partition_count, reverb_head_partitions);
+            reverb_slot_count_ = max_reverb_bus_count;
+            send_scratch_.resize(render_chunks_.size() * max_reverb_bus_count * max_block_frames_);
+            reverb_input_.resize(static_cast<std::size_t>(max_reverb_bus_count) * max_block_frames_);
+            reverb_wet_.resize(static_cast<std::size_t>(max_block_frames_) * 2);
+        }
+
+        if (limiter_lookahead_frames > 0)
+        {
+            limiter_ = std::make_unique<MasterLimiter>(*mix_kernels_, out_channel_count_, max_block_frames_, limiter_lookahead_frames,
+                                                       limiter_release_frames, limiter_ceiling);
+        }
+
+        if (render_worker_count > 0)
+        {
+            render_pool_ = std::make_unique<RenderWorkerPool>(render_worker_count);
+        }
+
+        // A stream's ring holds the prefetch plus one block's worst-case read,
+        // so a voice reading a whole block never waits on the refill of the
+        // frames it is reading.
+        if (stream_voice_count > 0)
+        {
+            streamer_ = std::make_unique<VoiceStreamer>(stream_voice_count, stream_prefetch_frames + max_block_frames_ * 4 + 2);
+        }
 
         // Per-instance storage is sized once against the config caps and never
         // resized - adding banks never touches audio-owned memory.
-        node_state_storage_.resize(max_instances_ * static_cast<std::size_t>(cap_node_count_));
-        voice_storage_.resize(max_instances_ * static_cast<std::size_t>(cap_voice_count_));
-        parameter_storage_.resize(max_instances_ * static_cast<std::size_t>(cap_param_slot_count_));
+        node_state_storage_.resize(slice_count_ * static_cast<std::size_t>(cap_node_count_));
+        voice_storage_.resize(slice_count_ * static_cast<std::size_t>(cap_voice_count_));
+        voice_schedule_storage_.resize(slice_count_ * static_cast<std::size_t>(cap_voice_count_));
+        parameter_storage_.resize(slice_count_ * static_cast<std::size_t>(cap_param_slot_count_));
+
+        // Slice-indexed bookkeeping: id lookup, dense back-links, bank lists.
+        instance_slots_ = InstanceSlotMap(slice_count_);
+        slice_dense_index_.resize(slice_count_, 0);
+        bank_next_slice_.resize(slice_count_, kNoSlice);
+        bank_prev_slice_.resize(slice_count_, kNoSlice);
+        std::fill(std::begin(bank_first_slice_), std::end(bank_first_slice_), kNoSlice);
+
+        if (steal_policy_ != StealPolicy::None)
+        {
+            steal_candidates_ = IndexedMinHeap<StealRank>(slice_count_);
+        }
 
-        free_slices_.reserve(max_instances_);
-        for (std::size_t i = max_instances_; i > 0; --i)
+        free_slices_.reserve(slice_count_);
+        for (std::size_t i = slice_count_; i > 0; --i)
         {
             free_slices_.push_back(i - 1);
         }
@@ -129,109 +300,792 @@ namespace decl_audio::playback
 
     bool AudioRuntime::IsSlotDrained(const BankId bank_id) const noexcept
     {
-        return slot_state_[bank_id.slot].load(std::memory_order_acquire) == SlotState::Drained;
+        // The I/O thread may still be opening a stream for one of the bank's
+        // retired voices, reading its buffer.
+        return slot_state_[bank_id.slot].load(std::memory_order_acquire) == SlotState::Drained &&
+               (streamer_ == nullptr || !streamer_->HoldsBufferReferences());
     }
 
-    void AudioRuntime::Submit(const AudioCommand &command)
+    void AudioRuntime::Submit(const AudioCommand &command, const std::uint64_t at_frame)
     {
-        if (!commands_.push(command))
+        if (!TrySubmit(command, at_frame))
         {
             std::terminate();
         }
     }
 
+    bool AudioRuntime::TrySubmit(const AudioCommand &command, const std::uint64_t at_frame) noexcept
+    {
+        return commands_.push(TimedAudioCommand{command, at_frame});
+    }
+
     void AudioRuntime::Render(float *output, const std::uint32_t frames) noexcept
     {
-        if (frames > max_block_frames_)
+        std::uint32_t written = 0;
+        while (written < frames)
+        {
+            const std::uint32_t block_frames = std::min(frames - written, interleave_bus_.MaxFrames());
+            Render(interleave_bus_, block_frames);
+            interleave_bus_.InterleaveTo(output + (static_cast<std::size_t>(written) * out_channel_count_), block_frames);
+            written += block_frames;
+        }
+    }
+
+    void AudioRuntime::Render(MixBus &bus, const std::uint32_t frames) noexcept
+    {
+        if (frames > bus.MaxFrames() || bus.ChannelCount() != out_channel_count_)
         {
             std::terminate();
         }
 
-        std::fill_n(output, static_cast<std::size_t>(frames) * out_channel_count_, 0.0f);
+        std::uint32_t written = 0;
+        while (written < frames)
+        {
+            if (render_quantum_frames_ == 0)
+            {
+                const std::uint32_t block_frames = std::min(frames - written, max_block_frames_);
+                RenderBlock(bus, written, block_frames);
+                written += block_frames;
+                continue;
+            }
+
+            if (quantum_read_ == render_quantum_frames_)
+            {
+                RenderBlock(quantum_bus_, 0, render_quantum_frames_);
+                quantum_read_ = 0;
+            }
+
+            const std::uint32_t copy_frames = std::min(frames - written, render_quantum_frames_ - quantum_read_);
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                const float *source = quantum_bus_.Channel(channel) + quantum_read_;
+                std::copy(source, source + copy_frames, bus.Channel(channel) + written);
+            }
+
+            quantum_read_ += copy_frames;
+            written += copy_frames;
+        }
+
+        if (streamer_ != nullptr)
+        {
+            streamer_->Wake();
+        }
+    }
+
+    void AudioRuntime::RenderBlock(MixBus &bus, const std::uint32_t offset, const std::uint32_t frames) noexcept
+    {
+        for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+        {
+            float *samples = bus.Channel(channel) + offset;
+            std::fill(samples, samples + frames, 0.0f);
+        }
+
+        // The block is cut at every frame a scheduled command falls due, so
+        // each command lands on its exact frame; blocks with nothing scheduled
+        // inside them render as a single segment.
+        ApplyPendingCommands(clock_frames_);
+
+        std::uint32_t virtual_instance_count = 0;
+        std::uint32_t rendered = 0;
+        while (rendered < frames)
+        {
+            std::uint32_t segment_frames = frames - rendered;
+            if (!scheduled_.empty())
+            {
+                segment_frames = static_cast<std::uint32_t>(
+                    std::min<std::uint64_t>(segment_frames, scheduled_.front().timed.frame - (clock_frames_ + rendered)));
+            }
+
+            virtual_instance_count = RenderSegment(bus, offset + rendered, segment_frames);
+            rendered += segment_frames;
+            ApplyPendingCommands(clock_frames_ + rendered);
+        }
+
+        // The limiter runs per block rather than per segment; its state is
+        // per frame, so where the block was cut makes no difference.
+        float limiter_gain = 1.0f;
+        if (limiter_ != nullptr)
+        {
+            std::array<float *, kMaxOutputChannels> channels{};
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                channels[channel] = bus.Channel(channel) + offset;
+            }
+            limiter_gain = limiter_->Process(channels.data(), frames);
+        }
+
+        clock_frames_ += frames;
+
+        metric_active_instances_.store(static_cast<std::uint32_t>(instances_.size()), std::memory_order_relaxed);
+        metric_virtual_instances_.store(virtual_instance_count, std::memory_order_relaxed);
+        metric_instance_steals_.store(instance_steal_count_, std::memory_order_relaxed);
+        metric_limiter_reduction_db_.store(limiter_gain < 1.0f ? -20.0f * std::log10(limiter_gain) : 0.0f, std::memory_order_relaxed);
+        published_clock_.store(clock_frames_, std::memory_order_release);
+    }
+
+    std::uint32_t AudioRuntime::RenderSegment(MixBus &bus, const std::uint32_t offset, const std::uint32_t frames) noexcept
+    {
+        // Instances are grouped by bus and each group split into fixed-size
+        // chunks. A group's first chunk mixes straight into its bus (or the
+        // output), every other chunk into its own bus, and the chunk buses are
+        // summed in chunk order. The partition and the summation order depend
+        // only on the instances and their buses, so the output is bit-identical
+        // whether the chunks run inline or spread across any number of workers.
+        RunSpatialPass();
+        const std::uint32_t chunk_count = PlanRenderChunks(bus, offset, frames);
+        render_frames_ = frames;
+        if (render_pool_ != nullptr && chunk_count > 1)
+        {
+            render_pool_->Run(&AudioRuntime::RenderChunkTask, this, chunk_count);
+        }
+        else
+        {
+            for (std::uint32_t chunk = 0; chunk < chunk_count; ++chunk)
+            {
+                RenderChunk(chunk, 0);
+            }
+        }
+
+        for (std::uint32_t chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            const RenderChunkPlan &plan = render_chunks_[chunk];
+            if (plan.bus == plan.destination)
+            {
+                continue;
+            }
 
-        ApplyPendingCommands();
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                float *samples = plan.destination->Channel(channel) + plan.destination_offset;
+                const float *chunk_samples = plan.bus->Channel(channel);
+                for (std::uint32_t i = 0; i < frames; ++i)
+                {
+                    samples[i] += chunk_samples[i];
+                }
+            }
+        }
 
-        std::size_t instance_index = 0;
-        while (instance_index < instances_.size())
+        // Sends reduce in chunk order too.
+        for (std::uint32_t chunk = 0; chunk < chunk_count; ++chunk)
         {
-            ProgramInstance &instance = instances_[instance_index];
-            std::fill_n(scratch_.data(), static_cast<std::size_t>(frames) * out_channel_count_, 0.0f);
+            const RenderChunkPlan &plan = render_chunks_[chunk];
+            for (std::uint32_t slot = 0; slot < reverb_slot_count_; ++slot)
+            {
+                if ((plan.send_mask & (1u << slot)) == 0)
+                {
+                    continue;
+                }
 
-            bool keep_instance = RenderProgramInstance(instance, scratch_.data(), frames);
+                float *input = reverb_input_.data() + static_cast<std::size_t>(slot) * max_block_frames_;
+                const float *send = send_scratch_.data() + (static_cast<std::size_t>(chunk) * reverb_slot_count_ + slot) * max_block_frames_;
+                for (std::uint32_t i = 0; i < frames; ++i)
+                {
+                    input[i] += send[i];
+                }
+            }
+        }
 
-            if (instance.stop_requested && instance.compiled->stop_mode == compiler::StopMode::Immediate)
+        MixBuses(bus, offset, frames);
+
+        // Retirement swap-removes, so it waits until every chunk is done and runs
+        // from the back: each instance moved into a retired slot has already been
+        // visited.
+        std::uint32_t virtual_instance_count = 0;
+        for (std::size_t instance_index = instances_.size(); instance_index > 0; --instance_index)
+        {
+            if (retire_flags_[instance_index - 1] != 0)
             {
-                if (instance.compiled->stop_fade_frames == 0)
+                RetireInstance(instance_index - 1);
+            }
+            else
+            {
+                const ProgramInstance &instance = instances_[instance_index - 1];
+                virtual_instance_count += instance.is_virtual ? 1 : 0;
+                if (steal_policy_ == StealPolicy::Quietest && !instance.stolen)
                 {
-                    keep_instance = false;
+                    (void)steal_candidates_.Update(static_cast<std::uint32_t>(instance.slice_index), ComputeStealRank(instance));
                 }
-                else if (instance.stop_fade_frames_remaining > 0)
+            }
+        }
+
+        if (master_gain_ != 1.0f)
+        {
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                float *samples = bus.Channel(channel) + offset;
+                for (std::uint32_t i = 0; i < frames; ++i)
                 {
-                    const float total_f = static_cast<float>(instance.compiled->stop_fade_frames);
-                    const std::uint32_t fade_start = instance.stop_fade_frames_remaining;
-                    for (std::uint32_t f = 0; f < frames; ++f)
+                    samples[i] *= master_gain_;
+                }
+            }
+        }
+
+        return virtual_instance_count;
+    }
+
+    std::uint32_t AudioRuntime::PlanRenderChunks(MixBus &bus, const std::uint32_t offset, const std::uint32_t frames) noexcept
+    {
+        // Counting sort by group, walking the instances backwards so each group
+        // keeps dense order. With no buses render_order_ is the dense order and
+        // the chunks are exactly the dense-index ones.
+        const std::uint32_t group_count = bus_count_ + 1;
+        const std::uint32_t instance_count = static_cast<std::uint32_t>(instances_.size());
+        std::fill(bus_group_first_.begin(), bus_group_first_.begin() + group_count, 0u);
+        for (const ProgramInstance &instance : instances_)
+        {
+            ++bus_group_first_[instance.bus == compiler::kMasterBus ? 0 : instance.bus + 1u];
+        }
+        for (std::uint32_t group = 1; group < group_count; ++group)
+        {
+            bus_group_first_[group] += bus_group_first_[group - 1];
+        }
+        for (std::uint32_t instance_index = instance_count; instance_index > 0; --instance_index)
+        {
+            const compiler::BusId instance_bus = instances_[instance_index - 1].bus;
+            render_order_[--bus_group_first_[instance_bus == compiler::kMasterBus ? 0 : instance_bus + 1u]] = instance_index - 1;
+        }
+        bus_group_first_[group_count] = instance_count;
+
+        // A bus is live when anything plays on it, sends to it or plays on a
+        // bus below it, and a reverb bus while it rings; only live buses are
+        // cleared and mixed. Children come after their parents, so one pass
+        // from the back reaches every ancestor.
+        for (const ProgramInstance &instance : instances_)
+        {
+            if (instance.send_slot != kNoReverb)
+            {
+                buses_[instance.compiled->send_bus].live = true;
+            }
+        }
+        for (std::uint32_t bus_id = bus_count_; bus_id > 0; --bus_id)
+        {
+            BusState &state = buses_[bus_id - 1];
+            state.live = state.live || bus_group_first_[bus_id + 1] > bus_group_first_[bus_id] ||
+                         (state.reverb_slot != kNoReverb && reverb_->IsRinging(state.reverb_slot));
+            if (state.live && state.parent != compiler::kMasterBus)
+            {
+                buses_[state.parent].live = true;
+            }
+        }
+        for (std::uint32_t bus_id = 0; bus_id < bus_count_; ++bus_id)
+        {
+            if (buses_[bus_id].live)
+            {
+                buses_[bus_id].mix.Clear(frames);
+            }
+        }
+        std::fill(reverb_input_.begin(), reverb_input_.begin() + static_cast<std::size_t>(reverb_bus_count_) * max_block_frames_, 0.0f);
+
+        std::uint32_t chunk_count = 0;
+        std::size_t chunk_bus_count = 0;
+        for (std::uint32_t group = 0; group < group_count; ++group)
+        {
+            MixBus *const destination = group == 0 ? &bus : &buses_[group - 1].mix;
+            const std::uint32_t destination_offset = group == 0 ? offset : 0;
+            const std::uint32_t end = bus_group_first_[group + 1];
+            for (std::uint32_t first = bus_group_first_[group]; first < end; first += kInstancesPerChunk)
+            {
+                RenderChunkPlan &plan = render_chunks_[chunk_count++];
+                plan.first = first;
+                plan.count = std::min<std::uint32_t>(kInstancesPerChunk, end - first);
+                plan.destination = destination;
+                plan.destination_offset = destination_offset;
+                const bool owns_bus = first != bus_group_first_[group];
+                plan.bus = owns_bus ? &chunk_buses_[chunk_bus_count++] : destination;
+                plan.offset = owns_bus ? 0 : destination_offset;
+                plan.send_mask = 0;
+            }
+        }
+
+        return chunk_count;
+    }
+
+    void AudioRuntime::MixBuses(MixBus &bus, const std::uint32_t offset, const std::uint32_t frames) noexcept
+    {
+        for (std::uint32_t bus_id = bus_count_; bus_id > 0; --bus_id)
+        {
+            BusState &state = buses_[bus_id - 1];
+            // As for voices, the step is re-derived from the remaining distance,
+            // so a ramp split across segments still lands on its target.
+            const std::uint32_t ramp_frames = std::min(frames, state.ramp_frames_remaining);
+            const float step = ramp_frames > 0 ? (state.gain_target - state.gain) / static_cast<float>(state.ramp_frames_remaining) : 0.0f;
+            const float settled_gain = ramp_frames == state.ramp_frames_remaining ? state.gain_target : state.gain;
+            // A trigger is above every bus it ducks, so it has folded already.
+            const bool ducked = state.duck_by != compiler::kMasterBus;
+            if (ducked)
+            {
+                FollowTrigger(state, frames);
+            }
+
+            if (state.live)
+            {
+                if (state.reverb_slot != kNoReverb)
+                {
+                    RenderReverbBus(state, frames);
+                }
+
+                if (state.filtered)
+                {
+                    std::array<float *, kMaxOutputChannels> channels{};
+                    for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
                     {
-                        const float gain = f < fade_start
-                            ? static_cast<float>(fade_start - f) / total_f
-                            : 0.0f;
-                        const std::size_t idx = static_cast<std::size_t>(f) * out_channel_count_;
-                        scratch_[idx + 0] *= gain;
-                        scratch_[idx + 1] *= gain;
+                        channels[channel] = state.mix.Channel(channel);
                     }
-                    instance.stop_fade_frames_remaining = fade_start > frames ? fade_start - frames : 0;
-                    if (instance.stop_fade_frames_remaining == 0)
+                    mix_kernels_->biquad(channels.data(), out_channel_count_, frames, state.filter_coefficients, state.filter_state.data());
+                }
+
+                const bool top_level = state.parent == compiler::kMasterBus;
+                MixBus &destination = top_level ? bus : buses_[state.parent].mix;
+                const std::uint32_t destination_offset = top_level ? offset : 0;
+                const float *duck_gains = duck_gains_.data();
+                for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+                {
+                    float *samples = destination.Channel(channel) + destination_offset;
+                    const float *bus_samples = state.mix.Channel(channel);
+                    if (ducked)
                     {
-                        keep_instance = false;
+                        for (std::uint32_t i = 0; i < ramp_frames; ++i)
+                        {
+                            samples[i] += bus_samples[i] * ((state.gain + step * static_cast<float>(i)) * duck_gains[i]);
+                        }
+                        for (std::uint32_t i = ramp_frames; i < frames; ++i)
+                        {
+                            samples[i] += bus_samples[i] * (settled_gain * duck_gains[i]);
+                        }
+                        continue;
+                    }
+
+                    for (std::uint32_t i = 0; i < ramp_frames; ++i)
+                    {
+                        samples[i] += bus_samples[i] * (state.gain + step * static_cast<float>(i));
+                    }
+                    for (std::uint32_t i = ramp_frames; i < frames; ++i)
+                    {
+                        samples[i] += bus_samples[i] * settled_gain;
                     }
                 }
-                else
+            }
+            else
+            {
+                state.filter_state = {};
+            }
+
+            state.fold_gain = state.gain;
+            state.fold_step = step;
+            state.fold_settled_gain = settled_gain;
+            state.fold_ramp_frames = ramp_frames;
+            state.ramp_frames_remaining -= ramp_frames;
+            state.gain = state.ramp_frames_remaining == 0 ? state.gain_target : state.gain + step * static_cast<float>(ramp_frames);
+        }
+
+        // Cleared only now: the buses a trigger ducks read its flag after it
+        // has folded.
+        for (std::uint32_t bus_id = 0; bus_id < bus_count_; ++bus_id)
+        {
+            buses_[bus_id].live = false;
+        }
+    }
+
+    void AudioRuntime::FollowTrigger(BusState &state, const std::uint32_t frames) noexcept
+    {
+        float *const levels = duck_gains_.data();
+        const BusState *trigger = state.duck_by < bus_count_ ? &buses_[state.duck_by] : nullptr;
+        if (trigger != nullptr && trigger->live)
+        {
+            // The trigger's level as it leaves for its parent: peaks after its
+            // filter or reverb, scaled by the gain it folded with.
+            std::array<const float *, kMaxOutputChannels> channels{};
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                channels[channel] = trigger->mix.Channel(channel);
+            }
+            mix_kernels_->frame_peak(channels.data(), out_channel_count_, frames, levels);
+            for (std::uint32_t i = 0; i < trigger->fold_ramp_frames; ++i)
+            {
+                levels[i] *= trigger->fold_gain + trigger->fold_step * static_cast<float>(i);
+            }
+            for (std::uint32_t i = trigger->fold_ramp_frames; i < frames; ++i)
+            {
+                levels[i] *= trigger->fold_settled_gain;
+            }
+        }
+        else
+        {
+            std::fill(levels, levels + frames, 0.0f);
+        }
+
+        FollowDuck(state.duck_coefficients, state.duck_state, levels, frames);
+    }
+
+    void AudioRuntime::RenderReverbBus(BusState &state, const std::uint32_t frames) noexcept
+    {
+        // Whatever plays on the bus itself joins the sends, folded to mono.
+        float *const input = reverb_input_.data() + static_cast<std::size_t>(state.reverb_slot) * max_block_frames_;
+        const float fold = 1.0f / static_cast<float>(out_channel_count_);
+        for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+        {
+            const float *samples = state.mix.Channel(channel);
+            for (std::uint32_t i = 0; i < frames; ++i)
+            {
+                input[i] += samples[i] * fold;
+            }
+        }
+
+        float *const left = reverb_wet_.data();
+        float *const right = left + max_block_frames_;
+        reverb_->Process(state.reverb_slot, input, left, right, frames);
+
+        // Stereo and up take the wet pair on their front left and right and
+        // nothing elsewhere; mono takes its centre.
+        state.mix.Clear(frames);
+        if (out_channel_count_ == 1)
+        {
+            float *samples = state.mix.Channel(0);
+            for (std::uint32_t i = 0; i < frames; ++i)
+            {
+                samples[i] = 0.5f * (left[i] + right[i]);
+            }
+            return;
+        }
+
+        std::copy(left, left + frames, state.mix.Channel(0));
+        std::copy(right, right + frames, state.mix.Channel(1));
+    }
+
+    void AudioRuntime::RunSpatialPass() noexcept
+    {
+        // Every instance gets a lane, so lanes line up with dense indices;
+        // unspatialized ones take a placeholder range and never read theirs.
+        const std::size_t count = instances_.size();
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const ProgramInstance &instance = instances_[index];
+            const compiler::CompiledSpatializationSettings &spatialization = instance.compiled->spatialization;
+            const bool spatialized = spatialization.mode != compiler::SpatializationMode::None;
+            spatial_lanes_.position_x[index] = instance.position.x;
+            spatial_lanes_.position_y[index] = instance.position.y;
+            spatial_lanes_.position_z[index] = instance.position.z;
+            spatial_lanes_.min_distance[index] = spatialized ? spatialization.min_distance : 0.0f;
+            spatial_lanes_.max_distance[index] = spatialized ? spatialization.max_distance : 1.0f;
+            spatial_lanes_.attenuation_curve[index] = spatialized ? instance.bank->GetAttenuationCurve(spatialization).data() : kPlaceholderCurve.data();
+        }
+
+        spatial_kernel_(SpatialBatch{static_cast<std::uint32_t>(count),
+                                     spatial_lanes_.position_x.data(),
+                                     spatial_lanes_.position_y.data(),
+                                     spatial_lanes_.position_z.data(),
+                                     spatial_lanes_.min_distance.data(),
+                                     spatial_lanes_.max_distance.data(),
+                                     spatial_lanes_.attenuation_curve.data(),
+                                     spatial_lanes_.gain_left.data(),
+                                     spatial_lanes_.gain_right.data(),
+                                     spatial_lanes_.attenuation.data(),
+                                     spatial_lanes_.local_x.data(),
+                                     spatial_lanes_.local_z.data()},
+                        MakeSpatialListener(listener_));
+    }
+
+    void AudioRuntime::RenderChunkTask(void *context, const std::uint32_t chunk_index, const std::uint32_t executor_index) noexcept
+    {
+        static_cast<AudioRuntime *>(context)->RenderChunk(chunk_index, executor_index);
+    }
+
+    void AudioRuntime::RenderChunk(const std::uint32_t chunk_index, const std::uint32_t executor_index) noexcept
+    {
+        // Touches only this chunk's instances, its bus, its retire flags and the
+        // executor's envelope, so chunks can run concurrently.
+        RenderChunkPlan &plan = render_chunks_[chunk_index];
+        if (plan.bus != plan.destination)
+        {
+            plan.bus->Clear(render_frames_);
+        }
+
+        for (std::uint32_t entry = plan.first; entry < plan.first + plan.count; ++entry)
+        {
+            const std::size_t instance_index = render_order_[entry];
+            const bool keep_instance = RenderInstance(instance_index, plan, chunk_index, executor_index, render_frames_);
+            retire_flags_[instance_index] = keep_instance ? 0 : 1;
+        }
+    }
+
+    bool AudioRuntime::RenderInstance(const std::size_t instance_index,
+                                      RenderChunkPlan &chunk,
+                                      const std::uint32_t chunk_index,
+                                      const std::uint32_t executor_index,
+                                      const std::uint32_t frames) noexcept
+    {
+        ProgramInstance &instance = instances_[instance_index];
+        MixBus &bus = *chunk.bus;
+        const std::uint32_t offset = chunk.offset;
+        bool keep_instance = true;
+        float *const envelope = envelope_.data() + static_cast<std::size_t>(executor_index) * max_block_frames_;
+
+        // An instance out of range mixes nothing, so it goes virtual once its
+        // voices have ramped down to zero: fades and voice timelines still
+        // advance, but no samples are read or written. Coming back into range
+        // just resumes mixing (ramping up from zero) at the current position.
+        //
+        // On a surround layout a spatialized instance's voices mix at a flat
+        // half gain from each source channel into a mono premix (so a mono
+        // source lands at unity), and the spatial gains are per speaker,
+        // applied when the premix is panned out.
+        const bool spatialized = instance.compiled->spatialization.mode != compiler::SpatializationMode::None;
+        const bool speaker_panning = UsesSpeakerPanning(speaker_layout_, instance.compiled->spatialization);
+        MixGains mix_gains;
+        if (speaker_panning)
+        {
+            const std::span<float> target_gains(instance.speaker_gains_target.data(), out_channel_count_);
+            std::array<float, kMaxOutputChannels> gains{};
+            const float loudest = ComputeSpeakerGains(*speaker_layout_,
+                                                      spatial_lanes_.attenuation[instance_index],
+                                                      spatial_lanes_.local_x[instance_index],
+                                                      spatial_lanes_.local_z[instance_index],
+                                                      std::span<float>(gains.data(), out_channel_count_));
+            if (!instance.speaker_gains_primed || gain_ramp_frames_ == 0)
+            {
+                instance.speaker_gains = gains;
+                instance.speaker_gains_target = gains;
+                instance.speaker_ramp_frames_remaining = 0;
+                instance.speaker_gains_primed = true;
+            }
+            else if (!std::equal(target_gains.begin(), target_gains.end(), gains.begin()))
+            {
+                instance.speaker_gains_target = gains;
+                instance.speaker_ramp_frames_remaining = gain_ramp_frames_;
+            }
+
+            const bool settled_at_zero = loudest == 0.0f &&
+                                         std::all_of(instance.speaker_gains.begin(), instance.speaker_gains.end(), [](const float gain)
+                                                     { return gain == 0.0f; });
+            instance.is_virtual = settled_at_zero;
+            instance.audibility = instance.volume * loudest;
+            mix_gains = MixGains{0.5f, 0.5f};
+        }
+        else
+        {
+            if (spatialized)
+            {
+                mix_gains = MixGains{spatial_lanes_.gain_left[instance_index], spatial_lanes_.gain_right[instance_index]};
+            }
+
+            instance.is_virtual = mix_gains.left == 0.0f && mix_gains.right == 0.0f && IsSettledAtZeroGain(instance);
+            instance.audibility = instance.volume * std::max(mix_gains.left, mix_gains.right);
+        }
+
+        // Fades are folded into one per-frame envelope (only built while a fade is
+        // running) and the spatial gains into each voice's L/R gain, so voices
+        // accumulate straight into the bus in a single pass.
+        bool has_envelope = false;
+        if (instance.stolen || (instance.stop_requested && instance.compiled->stop_mode == compiler::StopMode::Immediate))
+        {
+            if (instance.stop_fade_total_frames == 0)
+            {
+                keep_instance = false;
+            }
+            else if (instance.stop_fade_frames_remaining > 0)
+            {
+                const float total_f = static_cast<float>(instance.stop_fade_total_frames);
+                const float level = instance.stop_fade_level;
+                const std::uint32_t fade_start = instance.stop_fade_frames_remaining;
+                if (!instance.is_virtual)
+                {
+                    for (std::uint32_t f = 0; f < frames; ++f)
+                    {
+                        envelope[f] = f < fade_start
+                            ? level * (static_cast<float>(fade_start - f) / total_f)
+                            : 0.0f;
+                    }
+                    has_envelope = true;
+                }
+                instance.stop_fade_frames_remaining = fade_start > frames ? fade_start - frames : 0;
+                if (instance.stop_fade_frames_remaining == 0)
                 {
                     keep_instance = false;
                 }
             }
+            else
+            {
+                keep_instance = false;
+            }
+        }
 
-            if (instance.start_fade_frames_remaining > 0)
+        if (instance.start_fade_frames_remaining > 0)
+        {
+            const float total_f = static_cast<float>(instance.compiled->start_fade_frames);
+            const std::uint32_t remaining = instance.start_fade_frames_remaining;
+            const std::uint32_t elapsed_at_block_start = instance.compiled->start_fade_frames - remaining;
+            if (!instance.is_virtual)
             {
-                const float total_f = static_cast<float>(instance.compiled->start_fade_frames);
-                const std::uint32_t remaining = instance.start_fade_frames_remaining;
-                const std::uint32_t elapsed_at_block_start = instance.compiled->start_fade_frames - remaining;
                 for (std::uint32_t f = 0; f < frames; ++f)
                 {
                     const float gain = f < remaining
                         ? static_cast<float>(elapsed_at_block_start + f) / total_f
                         : 1.0f;
-                    const std::size_t idx = static_cast<std::size_t>(f) * out_channel_count_;
-                    scratch_[idx + 0] *= gain;
-                    scratch_[idx + 1] *= gain;
+                    envelope[f] = has_envelope ? envelope[f] * gain : gain;
+                }
+                has_envelope = true;
+            }
+            instance.start_fade_frames_remaining = remaining > frames ? remaining - frames : 0;
+        }
+
+        // A mono bus takes both the left and right contributions on its one
+        // channel, and so does the surround premix.
+        MixTarget target{bus.Channel(0) + offset,
+                         bus.Channel(out_channel_count_ > 1 ? 1 : 0) + offset,
+                         has_envelope ? envelope : nullptr,
+                         resample_scratch_.data() + static_cast<std::size_t>(executor_index) * max_block_frames_ * 2,
+                         decode_scratch_.data() + static_cast<std::size_t>(executor_index) * decode_scratch_stride_};
+        float *premix = nullptr;
+        if (speaker_panning)
+        {
+            premix = premix_.data() + static_cast<std::size_t>(executor_index) * max_block_frames_;
+            target.left = premix;
+            target.right = premix;
+            if (!instance.is_virtual)
+            {
+                std::fill(premix, premix + frames, 0.0f);
+            }
+        }
+
+        // A filtered or sending program mixes into the executor's filter
+        // scratch (the premix already is one), is filtered there, and is then
+        // added to the bus and its send. A virtual one has nothing to filter
+        // or send and forgets its filter history.
+        const bool filtered = instance.filter != nullptr && !instance.is_virtual;
+        const bool sending = instance.send_slot != kNoReverb && !instance.is_virtual;
+        const std::uint32_t filter_channel_count = speaker_panning || out_channel_count_ == 1 ? 1 : 2;
+        std::array<float *, 2> filter_channels{premix, premix};
+        if ((filtered || sending) && !speaker_panning)
+        {
+            float *const scratch = filter_scratch_.data() + static_cast<std::size_t>(executor_index) * max_block_frames_ * 2;
+            filter_channels = {scratch, scratch + max_block_frames_};
+            std::fill(filter_channels[0], filter_channels[0] + frames, 0.0f);
+            std::fill(filter_channels[1], filter_channels[1] + frames, 0.0f);
+            target.left = filter_channels[0];
+            target.right = filter_channels[filter_channel_count - 1];
+        }
+        if (instance.filter != nullptr && instance.is_virtual)
+        {
+            instance.filter_state = {};
+        }
+
+        const bool program_alive = RenderProgramInstance(instance, target, mix_gains, frames);
+        if (filtered)
+        {
+            mix_kernels_->biquad(filter_channels.data(), filter_channel_count, frames, instance.filter_coefficients, instance.filter_state.data());
+        }
+        if ((filtered || sending) && !speaker_panning)
+        {
+            for (std::uint32_t channel = 0; channel < filter_channel_count; ++channel)
+            {
+                float *samples = bus.Channel(channel) + offset;
+                const float *filtered_samples = filter_channels[channel];
+                for (std::uint32_t i = 0; i < frames; ++i)
+                {
+                    samples[i] += filtered_samples[i];
                 }
-                instance.start_fade_frames_remaining = remaining > frames ? remaining - frames : 0;
             }
+        }
+        if (sending)
+        {
+            AddToSend(chunk, chunk_index, instance.send_slot, filter_channels, filter_channel_count, instance.send_level, frames);
+        }
 
-            const StereoMixGains mix_gains = ComputeSpatialMixGains(instance.compiled->spatialization, instance.position, listener_.position);
-            for (std::uint32_t frame_index = 0; frame_index < frames; ++frame_index)
+        if (speaker_panning)
+        {
+            if (instance.is_virtual)
+            {
+                // Parked at zero like a virtual instance's voices.
+                instance.speaker_gains.fill(0.0f);
+                instance.speaker_ramp_frames_remaining = 0;
+            }
+            else
             {
-                const std::size_t sample_index = static_cast<std::size_t>(frame_index) * out_channel_count_;
-                output[sample_index + 0] += scratch_[sample_index + 0] * mix_gains.left;
-                output[sample_index + 1] += scratch_[sample_index + 1] * mix_gains.right;
+                PanToSpeakers(instance, premix, bus, offset, frames);
             }
+        }
 
-            if (!keep_instance)
+        return keep_instance && program_alive;
+    }
+
+    void AudioRuntime::AddToSend(RenderChunkPlan &chunk,
+                                 const std::uint32_t chunk_index,
+                                 const std::uint32_t slot,
+                                 const std::array<float *, 2> &channels,
+                                 const std::uint32_t channel_count,
+                                 const float level,
+                                 const std::uint32_t frames) noexcept
+    {
+        float *const send = send_scratch_.data() + (static_cast<std::size_t>(chunk_index) * reverb_slot_count_ + slot) * max_block_frames_;
+        if ((chunk.send_mask & (1u << slot)) == 0)
+        {
+            std::fill(send, send + frames, 0.0f);
+            chunk.send_mask |= 1u << slot;
+        }
+
+        if (channel_count == 1)
+        {
+            for (std::uint32_t i = 0; i < frames; ++i)
             {
-                RetireInstance(instance_index);
-                continue;
+                send[i] += channels[0][i] * level;
             }
+            return;
+        }
 
-            ++instance_index;
+        const float half_level = 0.5f * level;
+        for (std::uint32_t i = 0; i < frames; ++i)
+        {
+            send[i] += (channels[0][i] + channels[1][i]) * half_level;
         }
+    }
 
-        if (master_gain_ != 1.0f)
+    void AudioRuntime::PanToSpeakers(ProgramInstance &instance, const float *premix, MixBus &bus, const std::uint32_t offset, const std::uint32_t frames) noexcept
+    {
+        std::array<float *, kMaxOutputChannels> outputs{};
+        for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
         {
-            const std::size_t sample_count = static_cast<std::size_t>(frames) * out_channel_count_;
-            for (std::size_t i = 0; i < sample_count; ++i)
+            outputs[channel] = bus.Channel(channel) + offset;
+        }
+
+        // Same ramp discipline as MixVoiceFrames, across all channels at once.
+        const std::uint32_t ramp_frames = std::min(frames, instance.speaker_ramp_frames_remaining);
+        if (ramp_frames > 0)
+        {
+            const float remaining = static_cast<float>(instance.speaker_ramp_frames_remaining);
+            std::array<float, kMaxOutputChannels> step{};
+            for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+            {
+                step[channel] = (instance.speaker_gains_target[channel] - instance.speaker_gains[channel]) / remaining;
+            }
+
+            mix_kernels_->mono_to_channels(premix, outputs.data(), out_channel_count_, ramp_frames, instance.speaker_gains.data(), step.data());
+
+            instance.speaker_ramp_frames_remaining -= ramp_frames;
+            if (instance.speaker_ramp_frames_remaining == 0)
+            {
+                instance.speaker_gains = instance.speaker_gains_target;
+            }
+            else
             {
-                output[i] *= master_gain_;
+                const float advanced = static_cast<float>(ramp_frames);
+                for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+                {
+                    instance.speaker_gains[channel] += step[channel] * advanced;
+                }
             }
         }
+
+        if (ramp_frames == frames)
+        {
+            return;
+        }
+
+        for (std::uint32_t channel = 0; channel < out_channel_count_; ++channel)
+        {
+            outputs[channel] += ramp_frames;
+        }
+
+        mix_kernels_->mono_to_channels(premix + ramp_frames, outputs.data(), out_channel_count_, frames - ramp_frames, instance.speaker_gains.data(), nullptr);
     }
 
     bool AudioRuntime::TryGetInstanceSnapshot(const InstanceId instance_id, InstanceSnapshot &snapshot) const noexcept
@@ -260,6 +1114,8 @@ namespace decl_audio::playback
         snapshot.max_instances = max_instances_;
         snapshot.max_block_frames = max_block_frames_;
         snapshot.active_instance_count = instances_.size();
+        snapshot.virtual_instance_count = static_cast<std::size_t>(std::count_if(instances_.begin(), instances_.end(), [](const ProgramInstance &instance)
+                                                                                 { return instance.is_virtual; }));
         snapshot.instances.reserve(instances_.size());
 
         for (const ProgramInstance &instance : instances_)
@@ -270,6 +1126,7 @@ namespace decl_audio::playback
             instance_snapshot.volume = instance.volume;
             instance_snapshot.position = instance.position;
             instance_snapshot.stop_requested = instance.stop_requested;
+            instance_snapshot.is_virtual = instance.is_virtual;
             instance_snapshot.active_voice_count = instance.active_voice_count;
             instance_snapshot.nodes.reserve(instance.compiled->node_count);
 
@@ -308,18 +1165,116 @@ namespace decl_audio::playback
         return snapshot;
     }
 
-    void AudioRuntime::ApplyPendingCommands() noexcept
+    RuntimeMetrics AudioRuntime::GetMetrics() const noexcept
     {
-        AudioCommand command;
-        while (commands_.pop(command))
+        RuntimeMetrics metrics;
+        metrics.active_instance_count = metric_active_instances_.load(std::memory_order_relaxed);
+        metrics.virtual_instance_count = metric_virtual_instances_.load(std::memory_order_relaxed);
+        metrics.instance_steal_count = metric_instance_steals_.load(std::memory_order_relaxed);
+        metrics.stream_underrun_count = stream_underrun_count_.load(std::memory_order_relaxed);
+        metrics.limiter_gain_reduction_db = metric_limiter_reduction_db_.load(std::memory_order_relaxed);
+        metrics.reverb_late_tail_count = reverb_ != nullptr ? reverb_->LateTailCount() : 0;
+        return metrics;
+    }
+
+    void AudioRuntime::SetStreamReadDelayForTesting(const std::chrono::microseconds delay) noexcept
+    {
+        if (streamer_ != nullptr)
         {
-            std::visit(
-                [this](const auto &typed_command)
+            streamer_->SetReadDelayForTesting(delay);
+        }
+    }
+
+    bool AudioRuntime::AreStreamsSettledForTesting() const noexcept
+    {
+        return streamer_ == nullptr || streamer_->IsSettledForTesting();
+    }
+
+    void AudioRuntime::SetReverbWaitForTailsForTesting(const bool wait) noexcept
+    {
+        if (reverb_ != nullptr)
+        {
+            reverb_->SetWaitForTailsForTesting(wait);
+        }
+    }
+
+    std::uint64_t AudioRuntime::GetAudioClock() const noexcept
+    {
+        return published_clock_.load(std::memory_order_acquire);
+    }
+
+    void AudioRuntime::ApplyPendingCommands(const std::uint64_t now) noexcept
+    {
+        // Everything scheduled was submitted before anything still in the ring.
+        while (!scheduled_.empty() && scheduled_.front().timed.frame <= now)
+        {
+            std::pop_heap(scheduled_.begin(), scheduled_.end(), IsScheduledLater);
+            ApplyCommand(scheduled_.back().timed.command);
+            scheduled_.pop_back();
+        }
+
+        while (has_held_command_ || commands_.pop(held_command_))
+        {
+            const std::uint64_t frame = ScheduledFrame(held_command_);
+            if (frame <= now)
+            {
+                ApplyCommand(held_command_.command);
+            }
+            else if (scheduled_.size() < scheduled_.capacity())
+            {
+                scheduled_.push_back(ScheduledAudioCommand{TimedAudioCommand{held_command_.command, frame}, schedule_sequence_++});
+                std::push_heap(scheduled_.begin(), scheduled_.end(), IsScheduledLater);
+            }
+            else
+            {
+                has_held_command_ = true;
+                return;
+            }
+
+            has_held_command_ = false;
+        }
+    }
+
+    std::uint64_t AudioRuntime::ScheduledFrame(const TimedAudioCommand &timed) const noexcept
+    {
+        std::uint64_t frame = timed.frame;
+        if (scheduled_.empty())
+        {
+            return frame;
+        }
+
+        if (std::holds_alternative<RetireBankCommand>(timed.command) || std::holds_alternative<AddBusCommand>(timed.command))
+        {
+            for (const ScheduledAudioCommand &scheduled : scheduled_)
+            {
+                frame = std::max(frame, scheduled.timed.frame);
+            }
+            return frame;
+        }
+
+        const InstanceId instance_id = CommandInstanceId(timed.command);
+        if (instance_id != kNoCommandInstance)
+        {
+            for (const ScheduledAudioCommand &scheduled : scheduled_)
+            {
+                if (CommandInstanceId(scheduled.timed.command) == instance_id)
                 {
-                    Apply(typed_command);
-                },
-                command);
+                    frame = std::max(frame, scheduled.timed.frame);
+                }
+            }
         }
+
+        return frame;
+    }
+
+    void AudioRuntime::ApplyCommand(const AudioCommand &command) noexcept
+    {
+        std::visit(
+            [this](const auto &typed_command)
+            {
+                Apply(typed_command);
+            },
+            command);
     }
 
     void AudioRuntime::Apply(const CreateInstanceCommand &command) noexcept
@@ -341,12 +1296,25 @@ namespace decl_audio::playback
             std::terminate();
         }
 
-        if (instances_.size() >= max_instances_)
+        if (instances_.size() - stolen_instance_count_ >= max_instances_)
         {
-            std::terminate();
+            if (steal_policy_ == StealPolicy::None)
+            {
+                std::terminate();
+            }
+
+            StealInstance();
         }
 
         const compiler::CompiledProgram &compiled_program = bank->GetProgram(command.program_id);
+        // AddBusCommand travels ahead of every create that plays on the bus.
+        if ((compiled_program.bus != compiler::kMasterBus && compiled_program.bus >= bus_count_) ||
+            (compiled_program.send_bus != compiler::kMasterBus &&
+             (compiled_program.send_bus >= bus_count_ || buses_[compiled_program.send_bus].reverb_slot == kNoReverb)))
+        {
+            std::terminate();
+        }
+
         const std::size_t slice_index = free_slices_.back();
         free_slices_.pop_back();
 
@@ -374,6 +1342,18 @@ namespace decl_audio::playback
                 count);
         };
 
+        auto make_schedule_span = [&](const std::uint32_t count) noexcept -> std::span<std::uint32_t>
+        {
+            if (count == 0)
+            {
+                return {};
+            }
+
+            return std::span<std::uint32_t>(
+                voice_schedule_storage_.data() + (slice_index * static_cast<std::size_t>(cap_voice_count_)),
+                count);
+        };
+
         auto make_parameter_span = [&](const std::uint32_t count) noexcept -> std::span<float>
         {
             if (count == 0)
@@ -395,17 +1375,74 @@ namespace decl_audio::playback
         instance.slice_index = slice_index;
         instance.volume = command.volume;
         instance.position = command.position;
+        instance.bus = compiled_program.bus;
+        instance.send_slot = compiled_program.send_bus != compiler::kMasterBus ? buses_[compiled_program.send_bus].reverb_slot : kNoReverb;
+        instance.send_level = compiled_program.send_level;
         instance.stop_requested = false;
         instance.active_voice_count = 0;
         instance.stop_fade_frames_remaining = 0;
         instance.start_fade_frames_remaining = compiled_program.start_fade_frames;
+        instance.sequence = next_instance_sequence_++;
+        // The spatial pass has not seen this instance yet, so its first
+        // audibility comes from a one-source batch.
+        float loudest = 1.0f;
+        const compiler::CompiledSpatializationSettings &spatialization = compiled_program.spatialization;
+        if (spatialization.mode != compiler::SpatializationMode::None)
+        {
+            float gain_left = 0.0f;
+            float gain_right = 0.0f;
+            float attenuation = 0.0f;
+            float local_x = 0.0f;
+            float local_z = 0.0f;
+            const float *const curve = bank->GetAttenuationCurve(spatialization).data();
+            spatial_kernel_(SpatialBatch{1,
+                                         &command.position.x,
+                                         &command.position.y,
+                                         &command.position.z,
+                                         &spatialization.min_distance,
+                                         &spatialization.max_distance,
+                                         &curve,
+                                         &gain_left,
+                                         &gain_right,
+                                         &attenuation,
+                                         &local_x,
+                                         &local_z},
+                            MakeSpatialListener(listener_));
+            if (speaker_layout_ != nullptr)
+            {
+                std::array<float, kMaxOutputChannels> gains{};
+                loudest = ComputeSpeakerGains(*speaker_layout_, attenuation, local_x, local_z, std::span<float>(gains.data(), out_channel_count_));
+            }
+            else
+            {
+                loudest = std::max(gain_left, gain_right);
+            }
+        }
+        instance.audibility = command.volume * loudest;
         instance.node_state = make_node_span(compiled_program.node_count);
         instance.voices = make_voice_span(compiled_program.max_concurrent_voices);
+        instance.voice_schedule = make_schedule_span(compiled_program.max_concurrent_voices);
         instance.parameter_slots = make_parameter_span(compiled_program.parameter_slot_count);
 
         std::fill(instance.node_state.begin(), instance.node_state.end(), NodeRuntimeState{});
         std::fill(instance.voices.begin(), instance.voices.end(), VoiceState{});
         std::fill(instance.parameter_slots.begin(), instance.parameter_slots.end(), 0.0f);
+        // Parameters start at 0, so a bound cutoff starts at cutoff_from.
+        instance.filter = compiled_program.filter != compiler::kNoFilter ? &bank->filters[compiled_program.filter] : nullptr;
+        instance.filter_state = {};
+        if (instance.filter != nullptr)
+        {
+            instance.filter_coefficients = DesignBiquad(*instance.filter, FilterCutoff(*instance.filter, 0.0f), sample_rate_);
+        }
+
+        const std::uint32_t slice = static_cast<std::uint32_t>(slice_index);
+        (void)instance_slots_.Insert(command.instance_id, slice); // cannot fail: id checked unique, capacity checked above
+        slice_dense_index_[slice_index] = static_cast<std::uint32_t>(instances_.size());
+        LinkIntoBankList(command.bank_id.slot, slice);
+        if (steal_policy_ != StealPolicy::None)
+        {
+            (void)steal_candidates_.Push(slice, ComputeStealRank(instance));
+        }
 
         live_instances_[command.bank_id.slot].fetch_add(1, std::memory_order_relaxed);
         instances_.push_back(instance);
@@ -420,7 +1457,9 @@ namespace decl_audio::playback
             return;
         }
 
-        instances_[instance_index].volume = command.volume;
+        ProgramInstance &instance = instances_[instance_index];
+        instance.volume = command.volume;
+        RefreshVoiceGains(instance);
     }
 
     void AudioRuntime::Apply(const SetPositionCommand &command) noexcept
@@ -450,6 +1489,33 @@ namespace decl_audio::playback
         }
 
         instance.parameter_slots[parameter_slot] = command.value;
+
+        if (instance.filter != nullptr && instance.filter->parameter_slot == parameter_slot)
+        {
+            instance.filter_coefficients = DesignBiquad(*instance.filter, FilterCutoff(*instance.filter, command.value), sample_rate_);
+        }
+
+        // Parameters reach voices only through blend weights (gain) and leaf
+        // pitch bindings (rate); skip the refreshes this slot drives neither of.
+        bool drives_gain = false;
+        bool drives_rate = false;
+        for (compiler::NodeId node_id = instance.compiled->first_node; node_id < instance.compiled->first_node + instance.compiled->node_count; ++node_id)
+        {
+            const compiler::CompiledNode &node = GetCompiledNode(instance, node_id);
+            if (node.parameter_slot == parameter_slot)
+            {
+                (node.type == compiler::NodeType::Blend ? drives_gain : drives_rate) = true;
+            }
+        }
+
+        if (drives_gain)
+        {
+            RefreshVoiceGains(instance);
+        }
+        if (drives_rate)
+        {
+            RefreshVoiceRates(instance);
+        }
     }
 
     void AudioRuntime::Apply(const RequestStopCommand &command) noexcept
@@ -465,12 +1531,19 @@ namespace decl_audio::playback
 
     void AudioRuntime::RequestInstanceStop(ProgramInstance &instance) noexcept
     {
+        if (instance.stolen)
+        {
+            return; // already on its way out, on a shorter fade
+        }
+
         instance.stop_requested = true;
 
         if (instance.compiled->stop_mode == compiler::StopMode::Immediate)
         {
             // Start fade-out; voices keep playing untouched until the fade kills the instance.
             instance.stop_fade_frames_remaining = instance.compiled->stop_fade_frames;
+            instance.stop_fade_total_frames = instance.compiled->stop_fade_frames;
+            instance.stop_fade_level = 1.0f;
         }
         else
         {
@@ -485,6 +1558,8 @@ namespace decl_audio::playback
                 if (GetCompiledNode(instance, voice.leaf_node).type == compiler::NodeType::Loop)
                 {
                     voice.remaining_loops = 0;
+                    voice.end_frame = ComputeVoiceEndFrame(instance, voice);
+                    RescheduleVoice(instance, static_cast<std::uint32_t>(&voice - instance.voices.data()));
                 }
             }
         }
@@ -498,36 +1573,118 @@ namespace decl_audio::playback
         const std::size_t slot = command.bank_id.slot;
         slot_state_[slot].store(SlotState::Retiring, std::memory_order_relaxed);
 
-        for (ProgramInstance &instance : instances_)
+        // Walk only this slot's instances. Stopping never retires synchronously,
+        // so the list cannot change under the walk.
+        for (std::uint32_t slice = bank_first_slice_[slot]; slice != kNoSlice; slice = bank_next_slice_[slice])
         {
+            ProgramInstance &instance = instances_[slice_dense_index_[slice]];
             if (instance.bank_id == command.bank_id)
             {
                 RequestInstanceStop(instance);
             }
         }
 
-        // Nothing was playing: no retirement will fire to flip Drained, so do it now.
-        if (live_instances_[slot].load(std::memory_order_relaxed) == 0)
+        // Nothing was playing: no retirement will fire to flip Drained, so do it now.
+        if (live_instances_[slot].load(std::memory_order_relaxed) == 0)
+        {
+            slot_state_[slot].store(SlotState::Drained, std::memory_order_release);
+        }
+    }
+
+    void AudioRuntime::RetireInstance(const std::size_t instance_index) noexcept
+    {
+        // The single chokepoint where a slice returns to the pool. Every instance
+        // death funnels here, so the live_instances_ decrement is exact (section 3.4).
+        const std::size_t slot = instances_[instance_index].bank_id.slot;
+        const std::uint32_t slice = static_cast<std::uint32_t>(instances_[instance_index].slice_index);
+
+        // Voices still playing (a stop fade ran out) give back their streams.
+        for (const VoiceState &voice : instances_[instance_index].voices)
+        {
+            if (voice.active && voice.stream_slot != VoiceStreamer::kNoStream)
+            {
+                streamer_->Close(voice.stream_slot);
+            }
+        }
+
+        UnlinkFromBankList(slot, slice);
+        (void)instance_slots_.Erase(instances_[instance_index].instance_id);
+        if (instances_[instance_index].stolen)
+        {
+            --stolen_instance_count_;
+        }
+        else
+        {
+            (void)steal_candidates_.Erase(slice);
+        }
+        free_slices_.push_back(slice);
+
+        // Swap-remove: the instance moved into this dense index takes the
+        // back-link with it.
+        if (instance_index + 1 != instances_.size())
+        {
+            slice_dense_index_[instances_.back().slice_index] = static_cast<std::uint32_t>(instance_index);
+            instances_[instance_index] = instances_.back();
+        }
+        instances_.pop_back();
+
+        const std::uint32_t remaining = live_instances_[slot].fetch_sub(1, std::memory_order_relaxed) - 1u;
+        if (remaining == 0 && slot_state_[slot].load(std::memory_order_relaxed) == SlotState::Retiring)
         {
             slot_state_[slot].store(SlotState::Drained, std::memory_order_release);
         }
     }
 
-    void AudioRuntime::RetireInstance(const std::size_t instance_index) noexcept
+    void AudioRuntime::StealInstance() noexcept
     {
-        // The single chokepoint where a slice returns to the pool. Every instance
-        // death funnels here, so the live_instances_ decrement is exact (section 3.4).
-        const std::size_t slot = instances_[instance_index].bank_id.slot;
+        // Every unstolen instance is a candidate, so at capacity the heap holds
+        // max_instances_ (>= 1) of them.
+        const std::uint32_t slice = steal_candidates_.Top();
+        (void)steal_candidates_.Erase(slice);
+        ++instance_steal_count_;
+
+        const std::size_t instance_index = slice_dense_index_[slice];
+        if (instances_.size() >= slice_count_)
+        {
+            RetireInstance(instance_index);
+            return;
+        }
 
-        free_slices_.push_back(instances_[instance_index].slice_index);
-        instances_[instance_index] = instances_.back();
-        instances_.pop_back();
+        ProgramInstance &victim = instances_[instance_index];
+        const bool fading = victim.stop_requested && victim.compiled->stop_mode == compiler::StopMode::Immediate;
+        victim.stolen = true;
+        victim.stop_requested = true;
+        ++stolen_instance_count_;
 
-        const std::uint32_t remaining = live_instances_[slot].fetch_sub(1, std::memory_order_relaxed) - 1u;
-        if (remaining == 0 && slot_state_[slot].load(std::memory_order_relaxed) == SlotState::Retiring)
+        // Already fading out faster than a steal would: leave that fade alone.
+        if (fading && victim.stop_fade_frames_remaining <= kStealFadeFrames)
         {
-            slot_state_[slot].store(SlotState::Drained, std::memory_order_release);
+            return;
+        }
+
+        // Continue from wherever a longer authored fade has got to.
+        const float level = fading && victim.stop_fade_total_frames > 0
+                                ? victim.stop_fade_level * (static_cast<float>(victim.stop_fade_frames_remaining) / static_cast<float>(victim.stop_fade_total_frames))
+                                : 1.0f;
+        victim.stop_fade_level = level;
+        victim.stop_fade_total_frames = kStealFadeFrames;
+        victim.stop_fade_frames_remaining = kStealFadeFrames;
+    }
+
+    AudioRuntime::StealRank AudioRuntime::ComputeStealRank(const ProgramInstance &instance) const noexcept
+    {
+        switch (steal_policy_)
+        {
+        case StealPolicy::Quietest:
+            return StealRank{instance.audibility, instance.sequence};
+        case StealPolicy::Priority:
+            return StealRank{static_cast<float>(instance.compiled->priority), instance.sequence};
+        case StealPolicy::None:
+        case StealPolicy::Oldest:
+            break;
         }
+
+        return StealRank{0.0f, instance.sequence};
     }
 
     void AudioRuntime::Apply(const SetListenerPositionCommand &command) noexcept
@@ -535,12 +1692,81 @@ namespace decl_audio::playback
         listener_.position = command.position;
     }
 
+    void AudioRuntime::Apply(const SetListenerOrientationCommand &command) noexcept
+    {
+        listener_.orientation = command.orientation;
+    }
+
     void AudioRuntime::Apply(const SetMasterGainCommand &command) noexcept
     {
         master_gain_ = command.gain;
     }
 
-    bool AudioRuntime::RenderProgramInstance(ProgramInstance &instance, float *output, const std::uint32_t frames) noexcept
+    void AudioRuntime::Apply(const AddBusCommand &command) noexcept
+    {
+        if (command.bus != bus_count_ || command.bus >= buses_.size() ||
+            (command.parent != compiler::kMasterBus && command.parent >= command.bus))
+        {
+            std::terminate();
+        }
+
+        BusState &state = buses_[command.bus];
+        state.parent = command.parent;
+        state.gain = command.gain;
+        state.gain_target = command.gain;
+        state.ramp_frames_remaining = 0;
+        state.live = false;
+        state.filtered = command.filtered;
+        state.filter_state = {};
+        if (command.filtered)
+        {
+            state.filter_coefficients = DesignBiquad(command.filter, FilterCutoff(command.filter, 0.0f), sample_rate_);
+        }
+        state.duck_by = command.duck.by;
+        state.duck_state = {};
+        if (command.duck.by != compiler::kMasterBus)
+        {
+            if (command.duck.by <= command.bus)
+            {
+                std::terminate();
+            }
+            state.duck_coefficients = DesignDuck(command.duck, sample_rate_);
+        }
+        state.reverb_slot = kNoReverb;
+        if (command.impulse != nullptr)
+        {
+            // The registry holds reverb buses to max_reverb_bus_count.
+            if (reverb_bus_count_ >= reverb_slot_count_)
+            {
+                std::terminate();
+            }
+
+            state.reverb_slot = reverb_bus_count_++;
+            reverb_->Bind(state.reverb_slot, *command.impulse);
+        }
+        ++bus_count_;
+    }
+
+    void AudioRuntime::Apply(const SetBusGainCommand &command) noexcept
+    {
+        if (command.bus >= bus_count_)
+        {
+            std::terminate();
+        }
+
+        BusState &state = buses_[command.bus];
+        state.gain_target = command.gain;
+        state.ramp_frames_remaining = gain_ramp_frames_;
+        if (gain_ramp_frames_ == 0)
+        {
+            state.gain = command.gain;
+        }
+    }
+
+    bool AudioRuntime::RenderProgramInstance(ProgramInstance &instance,
+                                             const MixTarget &target,
+                                             const MixGains spatial_gains,
+                                             const std::uint32_t frames) noexcept
     {
         const std::uint32_t root_offset = instance.compiled->root_node - instance.compiled->first_node;
         std::uint32_t written = 0;
@@ -557,7 +1783,11 @@ namespace decl_audio::playback
                 std::terminate();
             }
 
-            const std::uint32_t segment_frames = ComputeSegmentFrames(instance, frames - written);
+            // The schedule front is the first voice to run out; every segment
+            // ends at it or at the end of the block.
+            const std::uint64_t next_end_frame = instance.voices[instance.voice_schedule[0]].end_frame;
+            const std::uint32_t segment_frames = static_cast<std::uint32_t>(
+                std::min<std::uint64_t>(frames - written, next_end_frame - instance.clock_frames));
             if (segment_frames == 0)
             {
                 std::terminate();
@@ -570,85 +1800,103 @@ namespace decl_audio::playback
                     continue;
                 }
 
-                RenderVoice(instance,
-                            voice,
-                            output + static_cast<std::size_t>(written) * out_channel_count_,
-                            segment_frames);
+                if (instance.is_virtual)
+                {
+                    AdvanceVirtualVoice(instance, voice, segment_frames);
+                }
+                else
+                {
+                    RenderVoice(instance,
+                                voice,
+                                target.Advanced(written),
+                                spatial_gains,
+                                segment_frames);
+                }
+
+                if (voice.stream_slot != VoiceStreamer::kNoStream)
+                {
+                    ReleaseStreamedFrames(instance, voice);
+                }
             }
 
             written += segment_frames;
+            instance.clock_frames += segment_frames;
 
-            std::size_t voice_index = 0;
-            while (voice_index < instance.voices.size())
+            // Retiring can activate the next voices of a sequence; they are
+            // scheduled in place, and any that end right away retire here too.
+            while (instance.active_voice_count > 0)
             {
-                if (!instance.voices[voice_index].active)
-                {
-                    ++voice_index;
-                    continue;
-                }
-
-                if (ComputeVoiceTerminalFrames(instance, instance.voices[voice_index]) == 0)
+                const std::uint32_t voice_index = instance.voice_schedule[0];
+                if (instance.voices[voice_index].end_frame != instance.clock_frames)
                 {
-                    RetireVoice(instance, static_cast<std::uint32_t>(voice_index));
-                    continue;
+                    break;
                 }
 
-                ++voice_index;
+                RetireVoice(instance, voice_index);
             }
         }
 
         return !(instance.node_state[root_offset].finished && instance.active_voice_count == 0);
     }
 
-    std::uint32_t AudioRuntime::ComputeSegmentFrames(const ProgramInstance &instance, const std::uint32_t frames_remaining) const noexcept
+    bool AudioRuntime::IsSettledAtZeroGain(const ProgramInstance &instance) const noexcept
     {
-        std::uint64_t segment_frames = frames_remaining;
+        // With no ramp the next mixed block would snap to zero anyway.
+        if (gain_ramp_frames_ == 0)
+        {
+            return true;
+        }
+
         for (const VoiceState &voice : instance.voices)
         {
-            if (!voice.active)
+            if (voice.active && voice.mix_gains_primed && voice.mix_gains != MixGains{0.0f, 0.0f})
             {
-                continue;
+                return false;
             }
-
-            segment_frames = std::min(segment_frames, ComputeVoiceTerminalFrames(instance, voice));
         }
 
-        return static_cast<std::uint32_t>(segment_frames);
+        return true;
     }
 
-    void AudioRuntime::RenderVoice(ProgramInstance &instance, VoiceState &voice, float *output, const std::uint32_t frames) noexcept
+    void AudioRuntime::RenderVoice(ProgramInstance &instance,
+                                   VoiceState &voice,
+                                   const MixTarget &target,
+                                   const MixGains spatial_gains,
+                                   const std::uint32_t frames) noexcept
     {
         const compiler::CompiledNode &node = GetCompiledNode(instance, voice.leaf_node);
         const std::span<const compiler::AssetId> asset_ids = GetNodeAssets(instance, voice.leaf_node);
-        const float gain = ComputeVoiceGain(instance, voice.leaf_node);
+        const MixGains target_gains{voice.gain * spatial_gains.left, voice.gain * spatial_gains.right};
+        if (!voice.mix_gains_primed || gain_ramp_frames_ == 0)
+        {
+            voice.mix_gains = target_gains;
+            voice.mix_gains_target = target_gains;
+            voice.gain_ramp_frames_remaining = 0;
+            voice.mix_gains_primed = true;
+        }
+        else if (target_gains != voice.mix_gains_target)
+        {
+            voice.mix_gains_target = target_gains;
+            voice.gain_ramp_frames_remaining = gain_ramp_frames_;
+        }
 
+        const bool resampled = voice.rate != kUnityRate || voice.sample_fraction != 0;
         auto add_frames = [&](const assets::DecodedBuffer &buffer,
                               std::uint64_t &sample_position,
-                              float *target_output,
+                              const MixTarget &run_target,
                               const std::uint32_t frames_requested) noexcept -> std::uint32_t
         {
-            const std::uint64_t remaining_frames = buffer.frame_count - sample_position;
-            const std::uint32_t frames_to_write = static_cast<std::uint32_t>(std::min<std::uint64_t>(remaining_frames, frames_requested));
-
-            for (std::uint32_t frame_index = 0; frame_index < frames_to_write; ++frame_index)
+            if (resampled)
             {
-                const std::size_t source_frame = static_cast<std::size_t>(sample_position + frame_index);
-                const std::size_t target_frame = static_cast<std::size_t>(frame_index) * out_channel_count_;
-
-                if (buffer.channel_count == 1)
-                {
-                    const float sample = buffer.samples[source_frame] * gain;
-                    target_output[target_frame + 0] += sample;
-                    target_output[target_frame + 1] += sample;
-                }
-                else
-                {
-                    const std::size_t source_index = source_frame * buffer.channel_count;
-                    target_output[target_frame + 0] += buffer.samples[source_index + 0] * gain;
-                    target_output[target_frame + 1] += buffer.samples[source_index + 1] * gain;
-                }
+                const bool wraps = node.type == compiler::NodeType::Loop && voice.remaining_loops != 0;
+                return MixResampledFrames(voice, buffer, wraps, run_target, frames_requested);
             }
 
+            const std::uint64_t remaining_frames = buffer.frame_count - sample_position;
+            const std::uint32_t frames_to_write = static_cast<std::uint32_t>(std::min<std::uint64_t>(remaining_frames, frames_requested));
+            const float *source = ReadSourceFrames(voice, buffer, sample_position, frames_to_write, run_target.decode_scratch);
+            MixVoiceFrames(voice, source, buffer.channel_count == 1, run_target, frames_to_write);
+
             sample_position += frames_to_write;
             return frames_to_write;
         };
@@ -656,11 +1904,11 @@ namespace decl_audio::playback
         switch (node.type)
         {
         case compiler::NodeType::OneShot:
-            (void)add_frames(instance.assets->GetBuffer(asset_ids[0]), voice.sample_position, output, frames);
+            (void)add_frames(instance.assets->GetBuffer(asset_ids[0]), voice.sample_position, target, frames);
             return;
 
         case compiler::NodeType::Random:
-            (void)add_frames(instance.assets->GetBuffer(asset_ids[voice.picked_asset_slot]), voice.sample_position, output, frames);
+            (void)add_frames(instance.assets->GetBuffer(asset_ids[voice.picked_asset_slot]), voice.sample_position, target, frames);
             return;
 
         case compiler::NodeType::Loop:
@@ -676,7 +1924,7 @@ namespace decl_audio::playback
             {
                 written += add_frames(buffer,
                                       voice.sample_position,
-                                      output + static_cast<std::size_t>(written) * out_channel_count_,
+                                      target.Advanced(written),
                                       frames - written);
 
                 if (written == frames)
@@ -684,7 +1932,10 @@ namespace decl_audio::playback
                     return;
                 }
 
-                if (voice.sample_position != buffer.frame_count)
+                // A resampled pass can overshoot the end by part of a step; the
+                // overshoot carries into the next pass.
+                const std::uint64_t pass_end = buffer.frame_count << kRateFractionBits;
+                if (GetFixedPosition(voice) < pass_end)
                 {
                     std::terminate();
                 }
@@ -694,7 +1945,11 @@ namespace decl_audio::playback
                     std::terminate();
                 }
 
-                voice.sample_position = 0;
+                SetFixedPosition(voice, GetFixedPosition(voice) - pass_end);
+                if (buffer.IsStreamed())
+                {
+                    voice.stream_origin += buffer.frame_count - buffer.HeadFrameCount();
+                }
                 if (voice.remaining_loops > 0)
                 {
                     --voice.remaining_loops;
@@ -713,6 +1968,214 @@ namespace decl_audio::playback
         std::terminate();
     }
 
+    void AudioRuntime::AdvanceVirtualVoice(ProgramInstance &instance, VoiceState &voice, const std::uint32_t frames) noexcept
+    {
+        // Silent while virtual, so the voice is parked at zero gain and ramps up
+        // from there when it becomes audible again.
+        voice.mix_gains = MixGains{0.0f, 0.0f};
+        voice.mix_gains_target = voice.mix_gains;
+        voice.gain_ramp_frames_remaining = 0;
+        voice.mix_gains_primed = true;
+
+        // Positions are fixed point here so resampled voices advance exactly as
+        // they render.
+        const std::uint64_t advance = static_cast<std::uint64_t>(voice.rate) * frames;
+        const compiler::CompiledNode &node = GetCompiledNode(instance, voice.leaf_node);
+        if (node.type != compiler::NodeType::Loop)
+        {
+            // One-shot and random leaves: segments never run past the buffer end.
+            SetFixedPosition(voice, GetFixedPosition(voice) + advance);
+            return;
+        }
+
+        const assets::DecodedBuffer &buffer = instance.assets->GetBuffer(GetNodeAssets(instance, voice.leaf_node)[0]);
+        const std::uint64_t frame_count = buffer.frame_count << kRateFractionBits;
+        if (frame_count == 0)
+        {
+            std::terminate();
+        }
+
+        // Same end state as RenderVoice's wrap loop, which wraps only when
+        // another frame is due: a pass is left behind once the last frame read
+        // lies past it, so a run that ends exactly on the buffer end (or, when
+        // resampled, overshoots it by under a step) stays there.
+        const std::uint64_t end_position = GetFixedPosition(voice) + advance;
+        const std::uint64_t wraps = advance != 0 ? (end_position - voice.rate) / frame_count : 0;
+        if (wraps == 0)
+        {
+            SetFixedPosition(voice, end_position);
+            return;
+        }
+
+        if (voice.remaining_loops >= 0)
+        {
+            if (static_cast<std::uint64_t>(voice.remaining_loops) < wraps)
+            {
+                std::terminate();
+            }
+
+            voice.remaining_loops -= static_cast<std::int32_t>(wraps);
+        }
+
+        SetFixedPosition(voice, end_position - wraps * frame_count);
+        if (buffer.IsStreamed())
+        {
+            voice.stream_origin += wraps * (buffer.frame_count - buffer.HeadFrameCount());
+        }
+    }
+
+    std::uint32_t AudioRuntime::MixResampledFrames(VoiceState &voice,
+                                                   const assets::DecodedBuffer &buffer,
+                                                   const bool wraps,
+                                                   const MixTarget &target,
+                                                   const std::uint32_t frames_requested) noexcept
+    {
+        const std::uint64_t position = GetFixedPosition(voice);
+        const std::uint64_t pass_end = buffer.frame_count << kRateFractionBits;
+        const std::uint32_t frames = static_cast<std::uint32_t>(std::min<std::uint64_t>(FramesUntil(position, pass_end, voice.rate), frames_requested));
+        if (frames == 0)
+        {
+            return 0;
+        }
+
+        // Frames reading the last source frame have no right neighbour in the
+        // buffer; it is the loop start when another pass follows, and otherwise
+        // the last frame again (the tail holds rather than dropping to zero).
+        const std::uint32_t channels = buffer.channel_count;
+        const std::uint64_t last_frame = (buffer.frame_count - 1) << kRateFractionBits;
+        const std::uint32_t interior = static_cast<std::uint32_t>(std::min<std::uint64_t>(FramesUntil(position, last_frame, voice.rate), frames));
+        const std::uint64_t first_frame = position >> kRateFractionBits;
+        if (interior != 0)
+        {
+            // Every frame the interior reads: up to the right neighbour of the
+            // last one, which is still inside the buffer.
+            const std::uint64_t read_end = ((position + static_cast<std::uint64_t>(voice.rate) * (interior - 1)) >> kRateFractionBits) + 2;
+            const float *samples = ReadSourceFrames(voice, buffer, first_frame, static_cast<std::uint32_t>(read_end - first_frame), target.decode_scratch);
+            mix_kernels_->resample_linear(samples, channels, position - (first_frame << kRateFractionBits), voice.rate, target.resample_scratch, interior);
+        }
+
+        // The edge frames are read only when the run reaches them: a streamed
+        // asset's last frame is not in its ring until the voice gets close.
+        float edge_frames[4] = {};
+        const float *last = interior < frames ? ReadSourceFrames(voice, buffer, buffer.frame_count - 1, 1, edge_frames) : edge_frames;
+        const float *next = wraps && interior < frames ? ReadSourceFrames(voice, buffer, 0, 1, edge_frames + 2) : last;
+        for (std::uint32_t i = interior; i < frames; ++i)
+        {
+            const std::uint64_t edge_position = position + static_cast<std::uint64_t>(voice.rate) * i;
+            const float t = static_cast<float>(edge_position & (kUnityRate - 1)) * (1.0f / static_cast<float>(kUnityRate));
+            for (std::uint32_t c = 0; c < channels; ++c)
+            {
+                target.resample_scratch[static_cast<std::size_t>(i) * channels + c] = last[c] + (next[c] - last[c]) * t;
+            }
+        }
+
+        MixVoiceFrames(voice, target.resample_scratch, channels == 1, target, frames);
+        SetFixedPosition(voice, position + static_cast<std::uint64_t>(voice.rate) * frames);
+        return frames;
+    }
+
+    const float *AudioRuntime::ReadSourceFrames(const VoiceState &voice,
+                                                const assets::DecodedBuffer &buffer,
+                                                const std::uint64_t first_frame,
+                                                const std::uint32_t frames,
+                                                float *scratch) noexcept
+    {
+        const std::size_t offset = static_cast<std::size_t>(first_frame) * buffer.channel_count;
+        const std::uint64_t head_frames = buffer.HeadFrameCount();
+        if (buffer.IsStreamed() && first_frame + frames > head_frames)
+        {
+            // The head part (if any) is copied so the run is contiguous; the
+            // rest is the stream from this pass's origin on.
+            const std::uint32_t channels = buffer.channel_count;
+            const std::uint32_t head_run = first_frame < head_frames ? static_cast<std::uint32_t>(head_frames - first_frame) : 0;
+            std::copy(buffer.samples.data() + offset, buffer.samples.data() + offset + static_cast<std::size_t>(head_run) * channels, scratch);
+
+            const std::uint64_t stream_frame = voice.stream_origin + (first_frame + head_run - head_frames);
+            float *const stream_output = scratch + static_cast<std::size_t>(head_run) * channels;
+            const std::uint32_t stream_run = frames - head_run;
+            const std::uint32_t copied = voice.stream_slot != VoiceStreamer::kNoStream ? streamer_->Read(voice.stream_slot, stream_frame, stream_run, stream_output) : 0;
+            if (copied < stream_run)
+            {
+                std::fill(stream_output + static_cast<std::size_t>(copied) * channels, stream_output + static_cast<std::size_t>(stream_run) * channels, 0.0f);
+                stream_underrun_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return scratch;
+        }
+
+        switch (buffer.format)
+        {
+        case compiler::SampleFormat::F32:
+            return buffer.samples.data() + offset;
+        case compiler::SampleFormat::S16:
+            mix_kernels_->widen_s16(buffer.pcm16.data() + offset, scratch, frames * buffer.channel_count);
+            return scratch;
+        case compiler::SampleFormat::ImaAdpcm:
+            assets::DecodeAdpcmFrames(buffer, first_frame, frames, scratch);
+            return scratch;
+        }
+
+        std::terminate();
+    }
+
+    void AudioRuntime::ReleaseStreamedFrames(const ProgramInstance &instance, const VoiceState &voice) noexcept
+    {
+        const assets::DecodedBuffer &buffer = instance.assets->GetBuffer(GetNodeAssets(instance, voice.leaf_node)[voice.picked_asset_slot]);
+        const std::uint64_t frame = GetFixedPosition(voice) >> kRateFractionBits;
+        const std::uint64_t head_frames = buffer.HeadFrameCount();
+        streamer_->Release(voice.stream_slot, voice.stream_origin + (frame > head_frames ? frame - head_frames : 0));
+    }
+
+    void AudioRuntime::MixVoiceFrames(VoiceState &voice,
+                                      const float *source,
+                                      const bool mono_source,
+                                      const MixTarget &target,
+                                      const std::uint32_t frames) noexcept
+    {
+        // Channel layout is fixed per buffer, so the kernel choice is made once
+        // per run of frames rather than per frame.
+        const std::uint32_t ramp_frames = std::min(frames, voice.gain_ramp_frames_remaining);
+        if (ramp_frames > 0)
+        {
+            // The step is re-derived from the remaining distance on every run, so
+            // a ramp split across segments or loop wraps still lands on target.
+            const float remaining = static_cast<float>(voice.gain_ramp_frames_remaining);
+            const MixGains step{(voice.mix_gains_target.left - voice.mix_gains.left) / remaining,
+                                (voice.mix_gains_target.right - voice.mix_gains.right) / remaining};
+            const RampedMixKernel kernel = mono_source ? mix_kernels_->mono_to_stereo_ramped : mix_kernels_->stereo_to_stereo_ramped;
+            kernel(source, target.left, target.right, ramp_frames, voice.mix_gains, step, target.envelope);
+
+            voice.gain_ramp_frames_remaining -= ramp_frames;
+            if (voice.gain_ramp_frames_remaining == 0)
+            {
+                voice.mix_gains = voice.mix_gains_target;
+            }
+            else
+            {
+                const float advanced = static_cast<float>(ramp_frames);
+                voice.mix_gains = MixGains{voice.mix_gains.left + step.left * advanced, voice.mix_gains.right + step.right * advanced};
+            }
+        }
+
+        if (ramp_frames == frames)
+        {
+            return;
+        }
+
+        const float *rest_source = source + static_cast<std::size_t>(ramp_frames) * (mono_source ? 1 : 2);
+        const MixTarget rest_target = target.Advanced(ramp_frames);
+        if (rest_target.envelope != nullptr)
+        {
+            const EnvelopedMixKernel kernel = mono_source ? mix_kernels_->mono_to_stereo_enveloped : mix_kernels_->stereo_to_stereo_enveloped;
+            kernel(rest_source, rest_target.left, rest_target.right, frames - ramp_frames, voice.mix_gains, rest_target.envelope);
+        }
+        else
+        {
+            const MixKernel kernel = mono_source ? mix_kernels_->mono_to_stereo : mix_kernels_->stereo_to_stereo;
+            kernel(rest_source, rest_target.left, rest_target.right, frames - ramp_frames, voice.mix_gains);
+        }
+    }
+
     void AudioRuntime::ActivateVoice(ProgramInstance &instance, const compiler::NodeId leaf_node) noexcept
     {
         const compiler::CompiledNode &node = GetCompiledNode(instance, leaf_node);
@@ -727,6 +2190,7 @@ namespace decl_audio::playback
 
             voice.leaf_node = leaf_node;
             voice.sample_position = 0;
+            voice.sample_fraction = 0;
             voice.picked_asset_slot = 0;
             voice.remaining_loops = 0;
             voice.active = true;
@@ -769,6 +2233,23 @@ namespace decl_audio::playback
                 std::terminate();
             }
 
+            voice.gain = ComputeVoiceGain(instance, leaf_node);
+            voice.rate = ComputeVoiceRate(instance, leaf_node);
+            voice.mix_gains_primed = false;
+            voice.gain_ramp_frames_remaining = 0;
+            voice.end_frame = ComputeVoiceEndFrame(instance, voice);
+
+            // Streams start filling behind the head while it plays. A voice
+            // that finds no free slot plays its head, then underruns.
+            const assets::DecodedBuffer &buffer = instance.assets->GetBuffer(asset_ids[voice.picked_asset_slot]);
+            voice.stream_slot = VoiceStreamer::kNoStream;
+            voice.stream_origin = 0;
+            if (buffer.IsStreamed() && streamer_ != nullptr)
+            {
+                voice.stream_slot = streamer_->Open(buffer, node.type == compiler::NodeType::Loop && voice.remaining_loops != 0);
+            }
+
+            ScheduleVoice(instance, static_cast<std::uint32_t>(&voice - instance.voices.data()));
             ++instance.active_voice_count;
             for (compiler::NodeId current_node = leaf_node; current_node != kInvalidNodeId; current_node = GetCompiledNode(instance, current_node).parent)
             {
@@ -790,8 +2271,13 @@ namespace decl_audio::playback
         }
 
         const compiler::NodeId leaf_node = voice.leaf_node;
+        if (voice.stream_slot != VoiceStreamer::kNoStream)
+        {
+            streamer_->Close(voice.stream_slot);
+        }
         voice = VoiceState{};
 
+        UnscheduleVoice(instance, voice_index);
         --instance.active_voice_count;
         for (compiler::NodeId current_node = leaf_node; current_node != kInvalidNodeId; current_node = GetCompiledNode(instance, current_node).parent)
         {
@@ -801,6 +2287,56 @@ namespace decl_audio::playback
         TryFinishNode(instance, leaf_node);
     }
 
+    void AudioRuntime::ScheduleVoice(ProgramInstance &instance, const std::uint32_t voice_index) noexcept
+    {
+        std::uint32_t *const schedule = instance.voice_schedule.data();
+        std::uint32_t position = instance.active_voice_count;
+        while (position > 0 && VoiceEndsBefore(instance.voices, voice_index, schedule[position - 1]))
+        {
+            schedule[position] = schedule[position - 1];
+            --position;
+        }
+
+        schedule[position] = voice_index;
+    }
+
+    void AudioRuntime::UnscheduleVoice(ProgramInstance &instance, const std::uint32_t voice_index) noexcept
+    {
+        const auto scheduled = instance.voice_schedule.first(instance.active_voice_count);
+        const auto found = std::find(scheduled.begin(), scheduled.end(), voice_index);
+        if (found == scheduled.end())
+        {
+            std::terminate();
+        }
+
+        std::copy(found + 1, scheduled.end(), found);
+    }
+
+    void AudioRuntime::RescheduleVoice(ProgramInstance &instance, const std::uint32_t voice_index) noexcept
+    {
+        const auto scheduled = instance.voice_schedule.first(instance.active_voice_count);
+        const auto found = std::find(scheduled.begin(), scheduled.end(), voice_index);
+        if (found == scheduled.end())
+        {
+            std::terminate();
+        }
+
+        std::size_t position = static_cast<std::size_t>(found - scheduled.begin());
+        while (position > 0 && VoiceEndsBefore(instance.voices, voice_index, scheduled[position - 1]))
+        {
+            scheduled[position] = scheduled[position - 1];
+            --position;
+        }
+
+        while (position + 1 < scheduled.size() && VoiceEndsBefore(instance.voices, scheduled[position + 1], voice_index))
+        {
+            scheduled[position] = scheduled[position + 1];
+            ++position;
+        }
+
+        scheduled[position] = voice_index;
+    }
+
     void AudioRuntime::EnterNode(ProgramInstance &instance, const compiler::NodeId node_id) noexcept
     {
         NodeRuntimeState &state = instance.node_state[node_id - instance.compiled->first_node];
@@ -950,24 +2486,28 @@ namespace decl_audio::playback
         const compiler::CompiledNode &node = GetCompiledNode(instance, voice.leaf_node);
         const std::span<const compiler::AssetId> asset_ids = GetNodeAssets(instance, voice.leaf_node);
 
+        // Output frames, not source frames: the remaining source span divided by
+        // the rate, rounded up, since the voice renders every frame whose read
+        // position falls before the end.
+        const std::uint64_t position = GetFixedPosition(voice);
         switch (node.type)
         {
         case compiler::NodeType::OneShot:
-            return instance.assets->GetBuffer(asset_ids[0]).frame_count - voice.sample_position;
+            return FramesUntil(position, instance.assets->GetBuffer(asset_ids[0]).frame_count << kRateFractionBits, voice.rate);
 
         case compiler::NodeType::Random:
-            return instance.assets->GetBuffer(asset_ids[voice.picked_asset_slot]).frame_count - voice.sample_position;
+            return FramesUntil(position, instance.assets->GetBuffer(asset_ids[voice.picked_asset_slot]).frame_count << kRateFractionBits, voice.rate);
 
         case compiler::NodeType::Loop:
         {
             const assets::DecodedBuffer &buffer = instance.assets->GetBuffer(asset_ids[0]);
-            const std::uint64_t current_pass_remaining = buffer.frame_count - voice.sample_position;
             if (voice.remaining_loops < 0)
             {
                 return std::numeric_limits<std::uint64_t>::max();
             }
 
-            return current_pass_remaining + (static_cast<std::uint64_t>(voice.remaining_loops) * buffer.frame_count);
+            const std::uint64_t passes = static_cast<std::uint64_t>(voice.remaining_loops) + 1;
+            return FramesUntil(position, (buffer.frame_count * passes) << kRateFractionBits, voice.rate);
         }
 
         case compiler::NodeType::Sequence:
@@ -979,6 +2519,60 @@ namespace decl_audio::playback
         std::terminate();
     }
 
+    std::uint64_t AudioRuntime::ComputeVoiceEndFrame(const ProgramInstance &instance, const VoiceState &voice) const noexcept
+    {
+        const std::uint64_t terminal_frames = ComputeVoiceTerminalFrames(instance, voice);
+        if (terminal_frames == std::numeric_limits<std::uint64_t>::max())
+        {
+            return terminal_frames;
+        }
+
+        return instance.clock_frames + terminal_frames;
+    }
+
+    void AudioRuntime::RefreshVoiceGains(ProgramInstance &instance) noexcept
+    {
+        for (VoiceState &voice : instance.voices)
+        {
+            if (voice.active)
+            {
+                voice.gain = ComputeVoiceGain(instance, voice.leaf_node);
+            }
+        }
+    }
+
+    std::uint32_t AudioRuntime::ComputeVoiceRate(const ProgramInstance &instance, const compiler::NodeId leaf_node) const noexcept
+    {
+        const compiler::CompiledNode &node = GetCompiledNode(instance, leaf_node);
+        if (node.parameter_slot == kInvalidParameterSlot)
+        {
+            return kUnityRate;
+        }
+
+        const float semitones = std::clamp(instance.parameter_slots[node.parameter_slot], -kMaxPitchSemitones, kMaxPitchSemitones);
+        return static_cast<std::uint32_t>(std::lround(std::exp2(semitones / 12.0f) * static_cast<float>(kUnityRate)));
+    }
+
+    void AudioRuntime::RefreshVoiceRates(ProgramInstance &instance) noexcept
+    {
+        for (std::uint32_t voice_index = 0; voice_index < instance.voices.size(); ++voice_index)
+        {
+            VoiceState &voice = instance.voices[voice_index];
+            if (!voice.active)
+            {
+                continue;
+            }
+
+            const std::uint32_t rate = ComputeVoiceRate(instance, voice.leaf_node);
+            if (rate != voice.rate)
+            {
+                voice.rate = rate;
+                voice.end_frame = ComputeVoiceEndFrame(instance, voice);
+                RescheduleVoice(instance, voice_index);
+            }
+        }
+    }
+
     float AudioRuntime::ComputeVoiceGain(const ProgramInstance &instance, const compiler::NodeId leaf_node) const noexcept
     {
         float gain = instance.volume;
@@ -1061,15 +2655,47 @@ namespace decl_audio::playback
 
     std::size_t AudioRuntime::FindInstanceIndex(const InstanceId instance_id) const noexcept
     {
-        for (std::size_t i = 0; i < instances_.size(); ++i)
+        const std::uint32_t slice = instance_slots_.Find(instance_id);
+        if (slice == InstanceSlotMap::kInvalidSlot)
         {
-            if (instances_[i].instance_id == instance_id)
-            {
-                return i;
-            }
+            return kNotFound;
+        }
+
+        return slice_dense_index_[slice];
+    }
+
+    void AudioRuntime::LinkIntoBankList(const std::size_t bank_slot, const std::uint32_t slice) noexcept
+    {
+        const std::uint32_t head = bank_first_slice_[bank_slot];
+        bank_prev_slice_[slice] = kNoSlice;
+        bank_next_slice_[slice] = head;
+        if (head != kNoSlice)
+        {
+            bank_prev_slice_[head] = slice;
+        }
+        bank_first_slice_[bank_slot] = slice;
+    }
+
+    void AudioRuntime::UnlinkFromBankList(const std::size_t bank_slot, const std::uint32_t slice) noexcept
+    {
+        const std::uint32_t prev = bank_prev_slice_[slice];
+        const std::uint32_t next = bank_next_slice_[slice];
+        if (prev != kNoSlice)
+        {
+            bank_next_slice_[prev] = next;
+        }
+        else
+        {
+            bank_first_slice_[bank_slot] = next;
+        }
+
+        if (next != kNoSlice)
+        {
+            bank_prev_slice_[next] = prev;
         }
 
-        return kNotFound;
+        bank_prev_slice_[slice] = kNoSlice;
+        bank_next_slice_[slice] = kNoSlice;
     }
 
     std::uint64_t AudioRuntime::DeriveNodeSeed(const InstanceId instance_id,
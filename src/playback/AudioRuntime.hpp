@@ -1,16 +1,30 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <span>
 #include <vector>
 
+#include "../core/IndexedMinHeap.hpp"
 #include "../core/RingBuffer.hpp"
 #include "../assets/AssetBank.hpp"
 #include "../compiler/CompiledBank.hpp"
 #include "AudioCommands.hpp"
+#include "ConvolutionReverb.hpp"
+#include "Ducker.hpp"
+#include "InstanceSlotMap.hpp"
+#include "MasterLimiter.hpp"
+#include "MixBus.hpp"
+#include "MixKernels.hpp"
+#include "RenderWorkerPool.hpp"
+#include "SpatialKernels.hpp"
+#include "SpeakerLayout.hpp"
+#include "VoiceStreamer.hpp"
 
 namespace decl_audio::playback
 {
@@ -26,8 +40,35 @@ namespace decl_audio::playback
     {
         compiler::NodeId leaf_node = std::numeric_limits<compiler::NodeId>::max();
         std::uint64_t sample_position = 0;
+        // Sub-frame part of the read position, kRateFractionBits wide, and the
+        // fixed-point playback rate from the leaf's pitch parameter. At
+        // kUnityRate with no fraction frames are read straight through;
+        // otherwise RenderVoice interpolates between neighbouring frames.
+        std::uint32_t sample_fraction = 0;
+        std::uint32_t rate = kUnityRate;
         std::int32_t remaining_loops = 0;
         std::uint32_t picked_asset_slot = 0;
+        // Streamed assets only: the VoiceStreamer slot feeding the frames past
+        // the head (kNoStream when every slot was taken), and the stream frame
+        // this pass's first frame past the head is; each loop wrap moves it on
+        // by a pass.
+        std::uint32_t stream_slot = VoiceStreamer::kNoStream;
+        std::uint64_t stream_origin = 0;
+        // Instance clock frame at which the voice runs out (uint64 max for an
+        // endless loop). Fixed at activation; only a graceful stop moves it.
+        std::uint64_t end_frame = 0;
+        // ComputeVoiceGain for this voice's leaf (instance volume x authored gains
+        // x blend weights up to the root). Refreshed only when a command changes
+        // an input on that path, so rendering reads one float.
+        float gain = 0.0f;
+        // Per-channel gain the voice is mixing at (gain x the instance's spatial
+        // gains) and the value it is ramping toward. A change of either input
+        // restarts a linear ramp of gain_ramp_frames from wherever the voice is
+        // now; a newly activated voice starts at its target with no ramp.
+        MixGains mix_gains{};
+        MixGains mix_gains_target{};
+        std::uint32_t gain_ramp_frames_remaining = 0;
+        bool mix_gains_primed = false;
         bool active = false;
     };
 
@@ -43,14 +84,56 @@ namespace decl_audio::playback
         const compiler::CompiledProgram *compiled = nullptr;
         float volume = 1.0f;
         Vec3 position{};
+        // Global mix bus the program plays on (kMasterBus: straight to the output).
+        compiler::BusId bus = compiler::kMasterBus;
+        // Reverb slot of the program's send bus (kNoReverb for no send) and
+        // the level its post-filter mono mix is sent at.
+        std::uint32_t send_slot = std::numeric_limits<std::uint32_t>::max();
+        float send_level = 0.0f;
         bool stop_requested = false;
+        // Taken by instance stealing: fading out over kStealFadeFrames in a
+        // headroom slice, no longer counted against max_instances.
+        bool stolen = false;
+        // Out of audible range (both spatial gains zero) with every voice settled
+        // at zero gain: voices advance their timelines without mixing. Set per
+        // block by RenderInstance.
+        bool is_virtual = false;
         std::uint32_t active_voice_count = 0;
         std::uint32_t stop_fade_frames_remaining = 0;
+        // Length of the running stop fade and the envelope level it started
+        // from (below 1 when a steal cuts an authored fade short).
+        std::uint32_t stop_fade_total_frames = 0;
+        float stop_fade_level = 1.0f;
         std::uint32_t start_fade_frames_remaining = 0;
+        // Frames the voices have rendered (or advanced while virtual) since
+        // creation; the time base of VoiceState::end_frame.
+        std::uint64_t clock_frames = 0;
+        // Creation order, the stealing tiebreaker (older goes first).
+        std::uint64_t sequence = 0;
+        // volume x the loudest spatial gain as of the last render; the Quietest
+        // stealing key.
+        float audibility = 0.0f;
+        // The program's filter (null for none), its coefficients at the
+        // current cutoff, and the history of the one (surround premix) or two
+        // channels it filters. Coefficients change only when the cutoff's
+        // parameter does.
+        const compiler::CompiledFilter *filter = nullptr;
+        BiquadCoefficients filter_coefficients{};
+        std::array<BiquadState, 2> filter_state{};
+        // Surround layouts only: a spatialized instance's voices sum to one mono
+        // premix, which pans onto the speakers at these per-channel gains. They
+        // ramp like VoiceState::mix_gains, over gain_ramp_frames.
+        std::array<float, kMaxOutputChannels> speaker_gains{};
+        std::array<float, kMaxOutputChannels> speaker_gains_target{};
+        std::uint32_t speaker_ramp_frames_remaining = 0;
+        bool speaker_gains_primed = false;
         std::size_t slice_index = 0;
         std::span<float> parameter_slots;
         std::span<NodeRuntimeState> node_state;
         std::span<VoiceState> voices;
+        // Indices of the active voices, the first active_voice_count entries
+        // sorted by (end_frame, index). The front is the next segment boundary.
+        std::span<std::uint32_t> voice_schedule;
     };
 
     struct InstanceSnapshot final
@@ -89,6 +172,7 @@ namespace decl_audio::playback
         float volume = 1.0f;
         Vec3 position{};
         bool stop_requested = false;
+        bool is_virtual = false;
         std::uint32_t active_voice_count = 0;
         std::vector<NodeDebugSnapshot> nodes;
         std::vector<VoiceDebugSnapshot> voices;
@@ -101,12 +185,47 @@ namespace decl_audio::playback
         std::size_t max_instances = 0;
         std::uint32_t max_block_frames = 0;
         std::size_t active_instance_count = 0;
+        std::size_t virtual_instance_count = 0;
         std::vector<InstanceDebugSnapshot> instances;
     };
 
+    // Counters the audio thread publishes once per rendered block, safe to poll
+    // from any thread. Each field is read independently, so a poll may mix two
+    // adjacent blocks.
+    struct RuntimeMetrics final
+    {
+        std::uint32_t active_instance_count = 0;
+        std::uint32_t virtual_instance_count = 0;
+        std::uint32_t instance_steal_count = 0; // total since construction
+        // Device callbacks the render-ahead queue could not fully cover, since
+        // the backend started. Filled in by the engine; always 0 without
+        // render-ahead.
+        std::uint32_t fifo_underrun_count = 0;
+        // Reads of a streamed asset that found the voice's ring short and
+        // played silence instead, since construction.
+        std::uint32_t stream_underrun_count = 0;
+        // The master limiter's deepest gain reduction in the last block, in
+        // dB (0 when it did nothing or is off).
+        float limiter_gain_reduction_db = 0.0f;
+        // Reverb partitions played without their tail because the background
+        // thread was late, since construction (see ConvolutionReverb).
+        std::uint32_t reverb_late_tail_count = 0;
+    };
+
+    // Which live instance makes room when a CreateInstance arrives at
+    // max_instances. None treats overflow as a bug and terminates.
+    enum class StealPolicy : std::uint8_t
+    {
+        None,
+        Quietest, // lowest volume x spatial gain as of the last block
+        Oldest,
+        Priority, // lowest authored priority
+    };
+
     struct ListenerState final
     {
         Vec3 position{};
+        Quat orientation{};
     };
 
     // Per-slot drain state owned by the audio thread (Active/Retiring/Drained,
@@ -130,7 +249,22 @@ namespace decl_audio::playback
                               std::size_t command_queue_capacity = 1024,
                               std::uint32_t max_program_node_count = 256,
                               std::uint32_t max_program_concurrent_voices = 64,
-                              std::uint32_t max_program_parameter_slot_count = 64);
+                              std::uint32_t max_program_parameter_slot_count = 64,
+                              std::uint32_t render_worker_count = 0,
+                              std::uint32_t gain_ramp_frames = 0,
+                              StealPolicy steal_policy = StealPolicy::None,
+                              std::uint32_t render_quantum_frames = 0,
+                              std::uint32_t stream_voice_count = 0,
+                              std::uint32_t stream_prefetch_frames = assets::kDefaultStreamHeadFrames,
+                              std::uint32_t max_bus_count = 0,
+                              std::uint32_t sample_rate = assets::kDefaultSampleRate,
+                              std::uint32_t max_reverb_bus_count = 0,
+                              std::uint32_t reverb_partition_frames = kDefaultReverbPartitionFrames,
+                              std::uint32_t max_impulse_frames = 0,
+                              std::uint32_t reverb_head_partitions = 1,
+                              std::uint32_t limiter_lookahead_frames = 0,
+                              std::uint32_t limiter_release_frames = 0,
+                              float limiter_ceiling = 1.0f);
 
         // Control-thread bank-table management. InstallBank publishes a bank into a
         // slot before the resolver emits any CreateInstance for it (the command ring
@@ -141,7 +275,24 @@ namespace decl_audio::playback
         void FreeBankSlot(BankId bank_id) noexcept;
         [[nodiscard]] bool IsSlotDrained(BankId bank_id) const noexcept;
 
-        void Submit(const AudioCommand &command);
+        // Queues `command` to take effect at audio clock frame `at_frame` (see
+        // GetAudioClock). 0, or any frame already rendered, applies it at the start
+        // of the next block; a later frame inside a block splits that block there.
+        // Terminates if the command ring is full.
+        void Submit(const AudioCommand &command, std::uint64_t at_frame = 0);
+        // Submit, returning false instead when the ring is full - it can fill
+        // while command_queue_capacity commands are already waiting for later
+        // frames, or the audio thread is not running.
+        [[nodiscard]] bool TrySubmit(const AudioCommand &command, std::uint64_t at_frame = 0) noexcept;
+        // Renders `frames` frames into the planar bus (which must have
+        // out_channel_count channels and room for `frames`). This is the device
+        // path; backends interleave once at their edge. Any `frames` works: with
+        // a render quantum the mix runs in whole quanta and the unread tail of
+        // the last one is handed out first next call; without one, calls longer
+        // than max_block_frames are mixed in max_block_frames pieces.
+        void Render(MixBus &bus, std::uint32_t frames) noexcept;
+        // Convenience for tests and the engine's testing hook: renders through an
+        // internal bus and writes interleaved frames to `output`.
         void Render(float *output, std::uint32_t frames) noexcept;
 
         [[nodiscard]] std::size_t ActiveInstanceCount() const noexcept
@@ -151,15 +302,132 @@ namespace decl_audio::playback
 
         [[nodiscard]] bool TryGetInstanceSnapshot(InstanceId instance_id, InstanceSnapshot &snapshot) const noexcept;
         [[nodiscard]] DebugSnapshot GetDebugSnapshot() const noexcept;
+        [[nodiscard]] RuntimeMetrics GetMetrics() const noexcept;
+        // Frames rendered since construction, published at the end of each
+        // Render: the first frame the next block will produce.
+        [[nodiscard]] std::uint64_t GetAudioClock() const noexcept;
+        // Streaming test hooks; no-ops without stream voices. Settled means the
+        // I/O thread is idle until the audio thread reads further.
+        void SetStreamReadDelayForTesting(std::chrono::microseconds delay) noexcept;
+        [[nodiscard]] bool AreStreamsSettledForTesting() const noexcept;
+        // Reverb test hook; a no-op without reverb buses. Makes the audio
+        // thread wait for every reverb tail, so the output does not depend on
+        // how the reverb thread is scheduled.
+        void SetReverbWaitForTailsForTesting(bool wait) noexcept;
         [[nodiscard]] const Vec3 &GetListenerPositionForTesting() const noexcept
         {
             return listener_.position;
         }
 
+        [[nodiscard]] const Quat &GetListenerOrientationForTesting() const noexcept
+        {
+            return listener_.orientation;
+        }
+
     private:
         static constexpr compiler::NodeId kInvalidNodeId = std::numeric_limits<compiler::NodeId>::max();
+        // Render work unit. Fixed (not derived from the worker count) so the
+        // chunk partition - and therefore the summation order - never changes.
+        static constexpr std::size_t kInstancesPerChunk = 16;
+        static constexpr std::uint32_t kNoSlice = std::numeric_limits<std::uint32_t>::max();
+        // Fade applied to a stolen instance (5ms at 48kHz).
+        static constexpr std::uint32_t kStealFadeFrames = 240;
+        static constexpr std::uint32_t kNoReverb = std::numeric_limits<std::uint32_t>::max();
+
+        // A mix bus on the audio thread. Its instances (and child buses) sum
+        // into `mix`, which is scaled by `gain` into the parent's mix, or into
+        // the output for a top-level bus. Gain changes ramp like voice gains.
+        struct BusState final
+        {
+            MixBus mix;
+            compiler::BusId parent = compiler::kMasterBus;
+            float gain = 1.0f;
+            float gain_target = 1.0f;
+            std::uint32_t ramp_frames_remaining = 0;
+            // Set per segment when any instance plays on the bus or below it.
+            bool live = false;
+            // A filtered bus runs its mix through the biquad before folding it;
+            // the history clears whenever the bus goes quiet.
+            bool filtered = false;
+            BiquadCoefficients filter_coefficients{};
+            std::array<BiquadState, kMaxOutputChannels> filter_state{};
+            // A reverb bus's ConvolutionReverb slot (kNoReverb for none). Its
+            // mix is replaced by the wet signal of the sends it receives plus
+            // the mono fold of whatever plays on it, and it stays live while
+            // the reverb rings.
+            std::uint32_t reverb_slot = kNoReverb;
+            // The gain ramp of the last fold, which the buses this one ducks
+            // scale its peaks by.
+            float fold_gain = 1.0f;
+            float fold_step = 0.0f;
+            float fold_settled_gain = 1.0f;
+            std::uint32_t fold_ramp_frames = 0;
+            // A ducked bus's trigger (kMasterBus for none), whose id is above
+            // its own. The follower runs every segment, live or not, so the
+            // envelope is current whenever the bus next plays.
+            compiler::BusId duck_by = compiler::kMasterBus;
+            DuckCoefficients duck_coefficients{};
+            DuckState duck_state{};
+        };
+
+        // One render work unit: `count` entries of render_order_ from `first`,
+        // all on the same bus, mixed into `bus` at `offset`. The first chunk of
+        // each bus mixes straight into that bus's destination; the others own
+        // a chunk bus that is cleared first and summed into the destination
+        // after every chunk has run.
+        struct RenderChunkPlan final
+        {
+            std::uint32_t first = 0;
+            std::uint32_t count = 0;
+            MixBus *bus = nullptr;
+            std::uint32_t offset = 0;
+            MixBus *destination = nullptr;
+            std::uint32_t destination_offset = 0;
+            // Reverb slots this chunk's instances sent to: each has a send
+            // buffer of the chunk's, zeroed by the first instance to send.
+            std::uint32_t send_mask = 0;
+        };
+
+        // Steal victims are ordered by (rank, creation order); the min is taken.
+        struct StealRank final
+        {
+            float rank = 0.0f;
+            std::uint64_t sequence = 0;
 
-        void ApplyPendingCommands() noexcept;
+            [[nodiscard]] friend bool operator<(const StealRank &lhs, const StealRank &rhs) noexcept
+            {
+                return lhs.rank != rhs.rank ? lhs.rank < rhs.rank : lhs.sequence < rhs.sequence;
+            }
+        };
+
+        // Where voices mix to: the bus's left/right channel arrays (the same
+        // array on a mono bus) and the instance's fade envelope (null when no
+        // fade is running), all positioned at the same frame.
+        struct MixTarget final
+        {
+            float *left = nullptr;
+            float *right = nullptr;
+            const float *envelope = nullptr;
+            // The executor's resampling and decode scratch; not positions in
+            // the block, so Advanced leaves them alone.
+            float *resample_scratch = nullptr;
+            float *decode_scratch = nullptr;
+
+            [[nodiscard]] MixTarget Advanced(const std::uint32_t frames) const noexcept
+            {
+                return MixTarget{left + frames, right + frames, envelope != nullptr ? envelope + frames : nullptr, resample_scratch, decode_scratch};
+            }
+        };
+
+        // Applies every command due at or before audio clock frame `now`:
+        // first the scheduled ones, in frame order, then the ring's, in ring
+        // order. Ring commands not yet due move to scheduled_ instead.
+        void ApplyPendingCommands(std::uint64_t now) noexcept;
+        // The frame `timed` may apply at: its own, or later if it must follow
+        // a scheduled command. Commands for one instance keep their order, and
+        // RetireBank and AddBus follow everything scheduled.
+        [[nodiscard]] std::uint64_t ScheduledFrame(const TimedAudioCommand &timed) const noexcept;
+        void ApplyCommand(const AudioCommand &command) noexcept;
         void Apply(const CreateInstanceCommand &command) noexcept;
         void Apply(const SetVolumeCommand &command) noexcept;
         void Apply(const SetPositionCommand &command) noexcept;
@@ -167,34 +435,216 @@ namespace decl_audio::playback
         void Apply(const RequestStopCommand &command) noexcept;
         void Apply(const RetireBankCommand &command) noexcept;
         void Apply(const SetListenerPositionCommand &command) noexcept;
+        void Apply(const SetListenerOrientationCommand &command) noexcept;
         void Apply(const SetMasterGainCommand &command) noexcept;
+        void Apply(const AddBusCommand &command) noexcept;
+        void Apply(const SetBusGainCommand &command) noexcept;
         void RequestInstanceStop(ProgramInstance &instance) noexcept;
+        // Frees a max_instances place for a new instance: the policy's victim
+        // fades out over kStealFadeFrames in a headroom slice, or retires at
+        // once if the headroom is already full of fading victims.
+        void StealInstance() noexcept;
+        [[nodiscard]] StealRank ComputeStealRank(const ProgramInstance &instance) const noexcept;
         // The single retirement chokepoint: removes instance `index`, returns its
         // slice, and does the live_instances_/Drained bookkeeping (section 3.4).
         void RetireInstance(std::size_t instance_index) noexcept;
 
-        [[nodiscard]] bool RenderProgramInstance(ProgramInstance &instance, float *output, std::uint32_t frames) noexcept;
-        [[nodiscard]] std::uint32_t ComputeSegmentFrames(const ProgramInstance &instance, std::uint32_t frames_remaining) const noexcept;
-        void RenderVoice(ProgramInstance &instance, VoiceState &voice, float *output, std::uint32_t frames) noexcept;
+        // Voices accumulate straight into `target` with `spatial_gains` folded
+        // into their node gain.
+        static void RenderChunkTask(void *context, std::uint32_t chunk_index, std::uint32_t executor_index) noexcept;
+        void RenderChunk(std::uint32_t chunk_index, std::uint32_t executor_index) noexcept;
+        // Mixes one block of at most max_block_frames into frames
+        // [offset, offset + frames) of `bus`, applying commands as they fall due,
+        // and advances the audio clock.
+        void RenderBlock(MixBus &bus, std::uint32_t offset, std::uint32_t frames) noexcept;
+        // Mixes every instance into frames [offset, offset + frames) of `bus` and
+        // retires the ones that finished. Returns the virtual instance count.
+        std::uint32_t RenderSegment(MixBus &bus, std::uint32_t offset, std::uint32_t frames) noexcept;
+        // Groups the instances by bus into render_order_ (master first, then
+        // buses by id) and cuts each group into chunks; returns the chunk count.
+        [[nodiscard]] std::uint32_t PlanRenderChunks(MixBus &bus, std::uint32_t offset, std::uint32_t frames) noexcept;
+        // Folds every live bus, from the last id back, into its parent's mix or
+        // frames [offset, offset + frames) of `bus`.
+        void MixBuses(MixBus &bus, std::uint32_t offset, std::uint32_t frames) noexcept;
+        // Computes every instance's spatial gains into spatial_lanes_ in one
+        // SpatialKernel call, ahead of the chunks that read them.
+        void RunSpatialPass() noexcept;
+        // Fades, spatializes and mixes instance `instance_index` into frames
+        // [offset, offset + frames) of `bus`, using executor `executor_index`'s
+        // scratch. Returns false when the instance should retire at the end of
+        // this block.
+        [[nodiscard]] bool RenderInstance(std::size_t instance_index, RenderChunkPlan &chunk, std::uint32_t chunk_index, std::uint32_t executor_index, std::uint32_t frames) noexcept;
+        // Adds `level` x the mono fold of an isolated instance mix (one or
+        // two channels) to the chunk's send buffer for `slot`.
+        void AddToSend(RenderChunkPlan &chunk, std::uint32_t chunk_index, std::uint32_t slot, const std::array<float *, 2> &channels, std::uint32_t channel_count, float level, std::uint32_t frames) noexcept;
+        // Replaces a reverb bus's mix with its wet signal: the convolution of
+        // its summed sends plus the mono fold of its own mix.
+        void RenderReverbBus(BusState &state, std::uint32_t frames) noexcept;
+        // Runs a ducked bus's envelope follower on its trigger's folded peaks,
+        // leaving the bus's gain for each frame in duck_gains_. A trigger not
+        // yet added, or not live this segment, is silence.
+        void FollowTrigger(BusState &state, std::uint32_t frames) noexcept;
+        // Surround path: adds a spatialized instance's mono premix to every bus
+        // channel at its speaker gains, stepping the speaker ramp.
+        void PanToSpeakers(ProgramInstance &instance, const float *premix, MixBus &bus, std::uint32_t offset, std::uint32_t frames) noexcept;
+        // Runs the program's voices for `frames` frames. A virtual instance only
+        // advances them (AdvanceVirtualVoice); `target` is unused.
+        [[nodiscard]] bool RenderProgramInstance(ProgramInstance &instance,
+                                                 const MixTarget &target,
+                                                 MixGains spatial_gains,
+                                                 std::uint32_t frames) noexcept;
+        [[nodiscard]] bool IsSettledAtZeroGain(const ProgramInstance &instance) const noexcept;
+        void RenderVoice(ProgramInstance &instance,
+                         VoiceState &voice,
+                         const MixTarget &target,
+                         MixGains spatial_gains,
+                         std::uint32_t frames) noexcept;
+        // Moves a voice's sample position and loop count on by `frames` exactly as
+        // RenderVoice would, without touching any samples.
+        void AdvanceVirtualVoice(ProgramInstance &instance, VoiceState &voice, std::uint32_t frames) noexcept;
+        // `frames` interleaved float frames of `voice`'s `buffer` from
+        // `first_frame`: the samples themselves for F32, otherwise decoded into
+        // `scratch`. Frames of a streamed asset past its head come from the
+        // voice's stream ring; any it does not hold yet read as silence.
+        [[nodiscard]] const float *ReadSourceFrames(const VoiceState &voice, const assets::DecodedBuffer &buffer, std::uint64_t first_frame, std::uint32_t frames, float *scratch) noexcept;
+        // Hands the stream frames before the voice's read position back to
+        // the I/O thread.
+        void ReleaseStreamedFrames(const ProgramInstance &instance, const VoiceState &voice) noexcept;
+        // Mixes `frames` source frames for one voice, stepping its gain ramp.
+        void MixVoiceFrames(VoiceState &voice, const float *source, bool mono_source, const MixTarget &target, std::uint32_t frames) noexcept;
+        // Off-unity counterpart of reading straight through `buffer`: resamples
+        // up to `frames` output frames of the current pass into the target's
+        // scratch, mixes them, and advances the voice. Stops at the end of the
+        // pass; `wraps` says whether the loop start follows it. Returns frames mixed.
+        [[nodiscard]] std::uint32_t MixResampledFrames(VoiceState &voice, const assets::DecodedBuffer &buffer, bool wraps, const MixTarget &target, std::uint32_t frames) noexcept;
         void ActivateVoice(ProgramInstance &instance, compiler::NodeId leaf_node) noexcept;
         void RetireVoice(ProgramInstance &instance, std::uint32_t voice_index) noexcept;
+        // Keep voice_schedule ordered. Schedule/Unschedule run before the
+        // active_voice_count change; Reschedule after a voice's end_frame moved.
+        void ScheduleVoice(ProgramInstance &instance, std::uint32_t voice_index) noexcept;
+        void UnscheduleVoice(ProgramInstance &instance, std::uint32_t voice_index) noexcept;
+        void RescheduleVoice(ProgramInstance &instance, std::uint32_t voice_index) noexcept;
         void EnterNode(ProgramInstance &instance, compiler::NodeId node_id) noexcept;
         void TryFinishNode(ProgramInstance &instance, compiler::NodeId node_id) noexcept;
         [[nodiscard]] std::uint64_t ComputeVoiceTerminalFrames(const ProgramInstance &instance, const VoiceState &voice) const noexcept;
+        [[nodiscard]] std::uint64_t ComputeVoiceEndFrame(const ProgramInstance &instance, const VoiceState &voice) const noexcept;
         [[nodiscard]] float ComputeVoiceGain(const ProgramInstance &instance, compiler::NodeId leaf_node) const noexcept;
+        void RefreshVoiceGains(ProgramInstance &instance) noexcept;
+        // 2^(semitones / 12) from the leaf's pitch parameter, in kUnityRate units.
+        [[nodiscard]] std::uint32_t ComputeVoiceRate(const ProgramInstance &instance, compiler::NodeId leaf_node) const noexcept;
+        // Re-derives every active voice's rate and, with it, its end frame.
+        void RefreshVoiceRates(ProgramInstance &instance) noexcept;
         [[nodiscard]] static const compiler::CompiledNode &GetCompiledNode(const ProgramInstance &instance, compiler::NodeId node_id) noexcept;
         [[nodiscard]] static std::span<const compiler::NodeId> GetNodeChildren(const ProgramInstance &instance, compiler::NodeId node_id) noexcept;
         [[nodiscard]] static std::span<const compiler::AssetId> GetNodeAssets(const ProgramInstance &instance, compiler::NodeId node_id) noexcept;
         [[nodiscard]] std::uint16_t FindProgramParameterSlot(const ProgramInstance &instance, compiler::ParameterId parameter_id) const noexcept;
+        // O(1): id -> slice via instance_slots_, slice -> dense via slice_dense_index_.
         [[nodiscard]] std::size_t FindInstanceIndex(InstanceId instance_id) const noexcept;
+        void LinkIntoBankList(std::size_t bank_slot, std::uint32_t slice) noexcept;
+        void UnlinkFromBankList(std::size_t bank_slot, std::uint32_t slice) noexcept;
         [[nodiscard]] std::uint64_t DeriveNodeSeed(InstanceId instance_id, compiler::ProgramId program_id, compiler::NodeId node_id) const noexcept;
 
-        RingBuffer<AudioCommand> commands_;
+        RingBuffer<TimedAudioCommand> commands_;
+        // Commands taken off the ring ahead of their frame: a min-heap on
+        // (frame, sequence), preallocated to command_queue_capacity entries.
+        // A command that finds it full waits in held_command_, and the ring
+        // stops draining until the earliest scheduled frame passes.
+        std::vector<ScheduledAudioCommand> scheduled_;
+        std::uint64_t schedule_sequence_ = 0;
+        TimedAudioCommand held_command_{};
+        bool has_held_command_ = false;
+        // Audio clock: frames rendered so far. clock_frames_ is audio-thread
+        // state; published_clock_ is its end-of-block copy for GetAudioClock.
+        std::uint64_t clock_frames_ = 0;
+        std::atomic<std::uint64_t> published_clock_{0};
         std::vector<ProgramInstance> instances_;
         std::vector<std::size_t> free_slices_;
-        std::vector<float> scratch_;
+        // An instance's slice is its stable handle for its whole life (instances_
+        // is dense and swap-removes, so dense indices are not). Control never
+        // reuses an InstanceId, so a stale id simply misses in instance_slots_
+        // rather than aliasing whichever instance took its slice next.
+        InstanceSlotMap instance_slots_;
+        std::vector<std::uint32_t> slice_dense_index_; // slice -> index into instances_
+        // Per-bank intrusive doubly-linked lists threaded through the slices, so
+        // RetireBankCommand visits only that bank's instances.
+        std::vector<std::uint32_t> bank_next_slice_;
+        std::vector<std::uint32_t> bank_prev_slice_;
+        std::uint32_t bank_first_slice_[kMaxBanks] = {};
+        std::vector<float> envelope_; // per-executor start/stop fade of the instance being rendered
+        std::vector<float> premix_;   // per-executor surround premix; empty for mono and stereo output
+        std::vector<float> resample_scratch_; // per-executor, 2 * max_block_frames: interpolated frames of an off-unity voice
+        std::vector<float> decode_scratch_;   // per-executor, decode_scratch_stride_: source frames of a compact-format voice
+        std::vector<float> filter_scratch_;   // per-executor, 2 * max_block_frames: a filtered or sending program's planar mix before the filter
+        std::size_t decode_scratch_stride_ = 0;
+        // The spatial pass's struct-of-arrays lanes, slice_count_ long and
+        // indexed like instances_: positions and ranges gathered in, gains and
+        // listener-space offsets out (see SpatialBatch).
+        struct SpatialLanes final
+        {
+            std::vector<float> position_x;
+            std::vector<float> position_y;
+            std::vector<float> position_z;
+            std::vector<float> min_distance;
+            std::vector<float> max_distance;
+            std::vector<const float *> attenuation_curve;
+            std::vector<float> gain_left;
+            std::vector<float> gain_right;
+            std::vector<float> attenuation;
+            std::vector<float> local_x;
+            std::vector<float> local_z;
+        };
+        SpatialLanes spatial_lanes_;
+        MixBus interleave_bus_;       // only used by the interleaved Render overload
+        // Per-block render state shared with the chunk tasks. Chunks that do
+        // not mix straight into their bus's destination take chunk_buses_ in
+        // order; retire_flags_ is indexed like instances_.
+        std::vector<MixBus> chunk_buses_;
+        std::vector<std::uint8_t> retire_flags_;
+        std::vector<RenderChunkPlan> render_chunks_;
+        // Dense instance indices grouped by bus, and where each group starts
+        // (group 0 is the master output, group b + 1 bus b).
+        std::vector<std::uint32_t> render_order_;
+        std::vector<std::uint32_t> bus_group_first_;
+        // Mix buses by global id, parents first; the first bus_count_ exist.
+        // Storage is allocated for max_bus_count at construction.
+        std::vector<BusState> buses_;
+        std::uint32_t bus_count_ = 0;
+        // Convolution for the reverb buses, which take slots in the order they
+        // are added (null when max_reverb_bus_count is 0). Sends go to
+        // per-chunk buffers (send_scratch_, max_block_frames per chunk and
+        // slot) and are summed in chunk order into reverb_input_ (one block
+        // per slot), so they reduce like the chunk buses. reverb_wet_ is the
+        // planar stereo wet block.
+        std::unique_ptr<ConvolutionReverb> reverb_;
+        std::uint32_t reverb_slot_count_ = 0;
+        std::uint32_t reverb_bus_count_ = 0;
+        std::vector<float> send_scratch_;
+        std::vector<float> reverb_input_;
+        std::vector<float> reverb_wet_;
+        // Per-frame gains of the ducked bus being folded (max_block_frames).
+        std::vector<float> duck_gains_;
+        // Limits each mixed block after the master gain; null when
+        // limiter_lookahead_frames is 0.
+        std::unique_ptr<MasterLimiter> limiter_;
+        // Fixed render quantum (0 = mix each call as delivered). quantum_bus_
+        // holds the last mixed quantum; frames from quantum_read_ on have not
+        // been handed out yet.
+        std::uint32_t render_quantum_frames_ = 0;
+        MixBus quantum_bus_;
+        std::uint32_t quantum_read_ = 0;
+        std::uint32_t render_frames_ = 0;
+        // Published at the end of each Render for GetMetrics.
+        std::atomic<std::uint32_t> metric_active_instances_{0};
+        std::atomic<std::uint32_t> metric_virtual_instances_{0};
+        std::atomic<std::uint32_t> metric_instance_steals_{0};
+        std::atomic<float> metric_limiter_reduction_db_{0.0f};
+        // Bumped by whichever executor hit the underrun.
+        std::atomic<std::uint32_t> stream_underrun_count_{0};
+        std::unique_ptr<RenderWorkerPool> render_pool_; // null when render_worker_count is 0
+        std::unique_ptr<VoiceStreamer> streamer_;       // null when stream_voice_count is 0
         std::vector<NodeRuntimeState> node_state_storage_;
         std::vector<VoiceState> voice_storage_;
+        std::vector<std::uint32_t> voice_schedule_storage_;
         std::vector<float> parameter_storage_;
         // Audio-thread bank table, indexed by BankId.slot. The runtime holds no
         // single "current bank" - it learns banks per instance via commands. The
@@ -211,11 +661,31 @@ namespace decl_audio::playback
         std::size_t max_instances_ = 0;
         std::uint32_t max_block_frames_ = 0;
         std::uint32_t out_channel_count_ = 2;
+        // Device rate, for designing filter coefficients.
+        std::uint32_t sample_rate_ = assets::kDefaultSampleRate;
+        // Null for mono and stereo output, which keep the left/right pan law.
+        const SpeakerLayout *speaker_layout_ = nullptr;
+        // Instance storage is max_instances_ slices plus, when stealing is on, a
+        // headroom of slices that only stolen instances fade out in.
+        std::size_t slice_count_ = 0;
+        StealPolicy steal_policy_ = StealPolicy::None;
+        // Every live, unstolen instance, keyed by slice.
+        IndexedMinHeap<StealRank> steal_candidates_;
+        std::size_t stolen_instance_count_ = 0;
+        std::uint32_t instance_steal_count_ = 0;
+        std::uint64_t next_instance_sequence_ = 0;
         // Per-instance storage caps (EngineConfig-driven). Storage is sized once at
-        // construction to max_instances_ * cap and never resized; AddBank rejects a
+        // construction to slice_count_ * cap and never resized; AddBank rejects a
         // bank whose programs exceed these. These are the slice strides.
         std::uint32_t cap_node_count_ = 0;
         std::uint32_t cap_voice_count_ = 0;
         std::uint32_t cap_param_slot_count_ = 0;
+        // Length of the linear ramp applied when a voice's volume, blend or
+        // spatial gain changes; 0 applies changes at the next block boundary.
+        std::uint32_t gain_ramp_frames_ = 0;
+        // Voice-mixing kernels for this CPU, resolved at construction so the
+        // audio thread never runs ISA detection.
+        const MixKernels *mix_kernels_ = nullptr;
+        SpatialKernel spatial_kernel_ = nullptr;
     };
 } // namespace decl_audio::playback
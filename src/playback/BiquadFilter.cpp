@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include "BiquadFilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kMinCutoffHz = 10.0;
+        constexpr double kMaxCutoffRatio = 0.45;
+    } // namespace
+
+    float FilterCutoff(const compiler::CompiledFilter &filter, const float parameter_value) noexcept
+    {
+        if (filter.parameter_slot == compiler::kInvalidParameterSlot)
+            return filter.cutoff_from;
+
+        const float t = std::clamp(parameter_value, 0.0f, 1.0f);
+        return filter.cutoff_from * std::pow(filter.cutoff_to / filter.cutoff_from, t);
+    }
+
+    BiquadCoefficients DesignBiquad(const compiler::CompiledFilter &filter, const float cutoff_hz, const std::uint32_t sample_rate) noexcept
+    {
+        const double rate = static_cast<double>(sample_rate);
+        const double cutoff = std::clamp(static_cast<double>(cutoff_hz), kMinCutoffHz, kMaxCutoffRatio * rate);
+        const double w0 = 2.0 * kPi * cutoff / rate;
+        const double cos_w0 = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * static_cast<double>(filter.q));
+        const double a = std::pow(10.0, static_cast<double>(filter.gain_db) / 40.0);
+        const double shelf = 2.0 * std::sqrt(a) * alpha;
+
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a0 = 1.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+        switch (filter.type)
+        {
+        case compiler::FilterType::LowPass:
+            b0 = (1.0 - cos_w0) / 2.0;
+            b1 = 1.0 - cos_w0;
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha;
+            break;
+        case compiler::FilterType::HighPass:
+            b0 = (1.0 + cos_w0) / 2.0;
+            b1 = -(1.0 + cos_w0);
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha;
+            break;
+        case compiler::FilterType::LowShelf:
+            b0 = a * ((a + 1.0) - (a - 1.0) * cos_w0 + shelf);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cos_w0 - shelf);
+            a0 = (a + 1.0) + (a - 1.0) * cos_w0 + shelf;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0);
+            a2 = (a + 1.0) + (a - 1.0) * cos_w0 - shelf;
+            break;
+        case compiler::FilterType::HighShelf:
+            b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + shelf);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - shelf);
+            a0 = (a + 1.0) - (a - 1.0) * cos_w0 + shelf;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0);
+            a2 = (a + 1.0) - (a - 1.0) * cos_w0 - shelf;
+            break;
+        }
+
+        b0 /= a0;
+        b1 /= a0;
+        b2 /= a0;
+        a1 /= a0;
+        a2 /= a0;
+
+        BiquadCoefficients coefficients;
+        coefficients.b0 = static_cast<float>(b0);
+        coefficients.b1 = static_cast<float>(b1);
+        coefficients.b2 = static_cast<float>(b2);
+        coefficients.a1 = static_cast<float>(a1);
+        coefficients.a2 = static_cast<float>(a2);
+
+        // Column j is the block's response to a unit value in element j of
+        // (x[n], x[n+1], x[n+2], x[n+3], x[n-1], x[n-2], y[n-1], y[n-2]) with
+        // the rest zero: the recursion run four frames from that start.
+        for (std::uint32_t j = 0; j < 8; ++j)
+        {
+            double x[6] = {}; // x[n-2] .. x[n+3]
+            double y[6] = {}; // y[n-2] .. y[n+3]
+            if (j < 4)
+                x[2 + j] = 1.0;
+            else if (j == 4)
+                x[1] = 1.0;
+            else if (j == 5)
+                x[0] = 1.0;
+            else if (j == 6)
+                y[1] = 1.0;
+            else
+                y[0] = 1.0;
+
+            for (std::uint32_t k = 0; k < 4; ++k)
+            {
+                y[2 + k] = b0 * x[2 + k] + b1 * x[1 + k] + b2 * x[k] - a1 * y[1 + k] - a2 * y[k];
+                coefficients.block[j][k] = static_cast<float>(y[2 + k]);
+            }
+        }
+
+        return coefficients;
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../compiler/CompiledBank.hpp"
+#include "MixKernels.hpp"
+
+namespace decl_audio::playback
+{
+    // The cutoff `filter` sets for a parameter value: cutoff_from at 0 to
+    // cutoff_to at 1, interpolated on a log-frequency scale and clamped like a
+    // blend weight. Filters without a parameter sit at cutoff_from.
+    [[nodiscard]] float FilterCutoff(const compiler::CompiledFilter &filter, float parameter_value) noexcept;
+
+    // RBJ cookbook coefficients for `filter` at `cutoff_hz`, in both the block
+    // and direct forms the biquad kernel runs. The cutoff is clamped to
+    // [10 Hz, 0.45 x sample_rate] so a parameter swept to an extreme stays
+    // stable. Designed in double; cheap enough for the audio thread to call
+    // when a bound parameter changes, not per block.
+    [[nodiscard]] BiquadCoefficients DesignBiquad(const compiler::CompiledFilter &filter, float cutoff_hz, std::uint32_t sample_rate) noexcept;
+} // namespace decl_audio::playback
@@ -0,0 +1,393 @@
+#include "pch.h"
+
+#include "ConvolutionReverb.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "../assets/SampleCodec.hpp"
+
+namespace decl_audio::playback
+{
+    ImpulseResponse TransformImpulseResponse(const assets::DecodedBuffer &buffer, const std::uint32_t partition_frames)
+    {
+        const bool compact = buffer.format != compiler::SampleFormat::F32;
+        const assets::DecodedBuffer decoded_storage = compact ? assets::DecodeBuffer(buffer) : assets::DecodedBuffer{};
+        const assets::DecodedBuffer &decoded = compact ? decoded_storage : buffer;
+
+        ImpulseResponse impulse;
+        impulse.partition_frames = partition_frames;
+        impulse.partition_count = std::max<std::uint32_t>(1, static_cast<std::uint32_t>((decoded.frame_count + partition_frames - 1) / partition_frames));
+        impulse.channel_count = std::clamp<std::uint32_t>(decoded.channel_count, 1, 2);
+        impulse.spectra.resize(impulse.SpectrumFloats() * impulse.partition_count * impulse.channel_count);
+
+        RealFft fft(partition_frames * 2);
+        std::vector<float> padded(static_cast<std::size_t>(partition_frames) * 2);
+        for (std::uint32_t channel = 0; channel < impulse.channel_count; ++channel)
+        {
+            for (std::uint32_t partition = 0; partition < impulse.partition_count; ++partition)
+            {
+                std::fill(padded.begin(), padded.end(), 0.0f);
+                const std::uint64_t first = static_cast<std::uint64_t>(partition) * partition_frames;
+                const std::uint64_t end = std::min<std::uint64_t>(first + partition_frames, decoded.frame_count);
+                for (std::uint64_t frame = first; frame < end && channel < decoded.channel_count; ++frame)
+                {
+                    padded[static_cast<std::size_t>(frame - first)] = decoded.samples[static_cast<std::size_t>(frame * decoded.channel_count + channel)];
+                }
+
+                fft.Forward(padded.data(), impulse.spectra.data() + (static_cast<std::size_t>(channel) * impulse.partition_count + partition) * impulse.SpectrumFloats());
+            }
+        }
+
+        return impulse;
+    }
+
+    ConvolutionReverb::ConvolutionReverb(const MixKernels &kernels,
+                                         const std::uint32_t slot_count,
+                                         const std::uint32_t partition_frames,
+                                         const std::uint32_t max_partition_count,
+                                         const std::uint32_t head_partition_count)
+        : kernels_(kernels),
+          partition_frames_(partition_frames),
+          head_partition_count_(std::max<std::uint32_t>(1, head_partition_count)),
+          recent_partition_count_(head_partition_count_ * 2),
+          slots_(slot_count),
+          fft_(partition_frames * 2),
+          time_scratch_(static_cast<std::size_t>(partition_frames) * 2),
+          spectrum_scratch_(static_cast<std::size_t>(partition_frames + 1) * 4)
+    {
+        const std::size_t spectrum_floats = static_cast<std::size_t>(partition_frames + 1) * 2;
+        for (Slot &slot : slots_)
+        {
+            slot.input.resize(partition_frames);
+            slot.output.resize(static_cast<std::size_t>(partition_frames) * 2);
+            slot.overlap.resize(static_cast<std::size_t>(partition_frames) * 2);
+            slot.recent.resize(spectrum_floats * recent_partition_count_);
+            slot.history.resize(spectrum_floats * max_partition_count);
+            slot.tickets = std::make_unique<std::atomic<std::uint64_t>[]>(head_partition_count_);
+            slot.tails.resize(spectrum_floats * 2 * head_partition_count_);
+        }
+
+        thread_ = std::thread([this]() { WorkerMain(); });
+    }
+
+    ConvolutionReverb::~ConvolutionReverb()
+    {
+        stopping_.store(true, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void ConvolutionReverb::Bind(const std::uint32_t slot_index, const ImpulseResponse &impulse) noexcept
+    {
+        Slot &slot = slots_[slot_index];
+        slot.impulse = &impulse;
+        std::fill(slot.recent.begin(), slot.recent.end(), 0.0f);
+        std::fill(slot.history.begin(), slot.history.end(), 0.0f);
+        slot.history_written = 0;
+        slot.history_complete_from = 0;
+        slot.late_entry = kNoLateJob;
+        std::fill(slot.output.begin(), slot.output.end(), 0.0f);
+        std::fill(slot.overlap.begin(), slot.overlap.end(), 0.0f);
+        slot.fill = 0;
+        slot.partition = 0;
+        slot.silent_partitions = std::numeric_limits<std::uint32_t>::max();
+    }
+
+    void ConvolutionReverb::Process(const std::uint32_t slot_index, const float *input, float *left, float *right, std::uint32_t frames) noexcept
+    {
+        Slot &slot = slots_[slot_index];
+        const float *output_right = slot.output.data() + (slot.impulse->channel_count > 1 ? partition_frames_ : 0);
+        while (frames > 0)
+        {
+            const std::uint32_t run = std::min(frames, partition_frames_ - slot.fill);
+            std::copy(input, input + run, slot.input.data() + slot.fill);
+            std::copy(slot.output.data() + slot.fill, slot.output.data() + slot.fill + run, left);
+            std::copy(output_right + slot.fill, output_right + slot.fill + run, right);
+            slot.fill += run;
+            input += run;
+            left += run;
+            right += run;
+            frames -= run;
+
+            if (slot.fill == partition_frames_)
+            {
+                RunPartition(slot);
+                slot.fill = 0;
+            }
+        }
+    }
+
+    bool ConvolutionReverb::IsRinging(const std::uint32_t slot_index) const noexcept
+    {
+        // Past partition_count silent partitions no head or tail term is left,
+        // and one more plays out the last overlap.
+        const Slot &slot = slots_[slot_index];
+        return slot.impulse != nullptr && slot.silent_partitions <= slot.impulse->partition_count + 1;
+    }
+
+    void ConvolutionReverb::SetWaitForTailsForTesting(const bool wait) noexcept
+    {
+        wait_for_tails_ = wait;
+    }
+
+    void ConvolutionReverb::SetTailDelayForTesting(const std::chrono::microseconds delay) noexcept
+    {
+        tail_delay_us_.store(delay.count(), std::memory_order_relaxed);
+    }
+
+    void ConvolutionReverb::RunPartition(Slot &slot) noexcept
+    {
+        const ImpulseResponse &impulse = *slot.impulse;
+        const std::uint32_t partition_count = impulse.partition_count;
+        const std::size_t spectrum_floats = impulse.SpectrumFloats();
+        const std::uint64_t partition = slot.partition++;
+
+        const bool silent = std::all_of(slot.input.begin(), slot.input.end(), [](const float sample) { return sample == 0.0f; });
+        if (!silent)
+        {
+            slot.silent_partitions = 0;
+        }
+        else if (slot.silent_partitions != std::numeric_limits<std::uint32_t>::max())
+        {
+            ++slot.silent_partitions;
+        }
+
+        // The recent entry being replaced is already zero after
+        // recent_partition_count_ silent partitions.
+        float *const spectrum = slot.recent.data() + static_cast<std::size_t>(partition % recent_partition_count_) * spectrum_floats;
+        if (!silent)
+        {
+            std::copy(slot.input.begin(), slot.input.end(), time_scratch_.begin());
+            std::fill(time_scratch_.begin() + partition_frames_, time_scratch_.end(), 0.0f);
+            fft_.Forward(time_scratch_.data(), spectrum);
+        }
+        else if (slot.silent_partitions <= recent_partition_count_)
+        {
+            std::fill(spectrum, spectrum + spectrum_floats, 0.0f);
+        }
+
+        // A late job that is still running may read any tail history entry,
+        // so the history waits for it. Its Done pairs with this acquire.
+        if (slot.late_entry != kNoLateJob && (slot.tickets[slot.late_entry].load(std::memory_order_acquire) & 3) != kTailRunning)
+        {
+            slot.late_entry = kNoLateJob;
+        }
+        if (slot.late_entry == kNoLateJob)
+        {
+            UpdateHistory(slot, partition);
+        }
+
+        // Collect this partition's tail, queued head_partition_count_
+        // partitions ago unless everything it would have summed was silence.
+        // One the thread has not finished is left out: a queued job is taken
+        // back, and a running one is left to finish as the late job.
+        const std::uint32_t entry = static_cast<std::uint32_t>(partition % head_partition_count_);
+        std::atomic<std::uint64_t> &ticket = slot.tickets[entry];
+        const std::uint64_t done = partition * 4 + kTailDone;
+        std::uint64_t seen = ticket.load(std::memory_order_acquire);
+        bool has_tail = partition_count > head_partition_count_ && seen >> 2 == partition && (seen & 3) != 0;
+        if (has_tail && seen != done)
+        {
+            if (wait_for_tails_)
+            {
+                while (ticket.load(std::memory_order_acquire) != done)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else if ((seen & 3) == kTailQueued && ticket.compare_exchange_strong(seen, 0, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                has_tail = false;
+            }
+            else if (ticket.load(std::memory_order_acquire) != done)
+            {
+                slot.late_entry = entry;
+                has_tail = false;
+            }
+
+            if (!has_tail)
+            {
+                late_tail_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        const std::uint32_t channel_count = impulse.channel_count;
+        const float *const tail = slot.tails.data() + static_cast<std::size_t>(entry) * spectrum_floats * 2;
+        const std::uint32_t head_count = std::min(head_partition_count_, partition_count);
+        const bool has_head = slot.silent_partitions < head_count;
+        if (!has_head && !has_tail)
+        {
+            std::copy(slot.overlap.begin(), slot.overlap.end(), slot.output.begin());
+            std::fill(slot.overlap.begin(), slot.overlap.end(), 0.0f);
+        }
+        else
+        {
+            float *const sums = spectrum_scratch_.data();
+            std::fill(sums, sums + spectrum_floats * channel_count, 0.0f);
+            Accumulate(impulse, slot.recent.data(), recent_partition_count_, partition, 0, head_count, sums);
+            if (has_tail)
+            {
+                for (std::size_t i = 0; i < spectrum_floats * channel_count; ++i)
+                {
+                    sums[i] += tail[i];
+                }
+            }
+
+            for (std::uint32_t channel = 0; channel < channel_count; ++channel)
+            {
+                fft_.Inverse(sums + channel * spectrum_floats, time_scratch_.data());
+                float *output = slot.output.data() + static_cast<std::size_t>(channel) * partition_frames_;
+                float *overlap = slot.overlap.data() + static_cast<std::size_t>(channel) * partition_frames_;
+                for (std::uint32_t i = 0; i < partition_frames_; ++i)
+                {
+                    output[i] = time_scratch_[i] + overlap[i];
+                    overlap[i] = time_scratch_[partition_frames_ + i];
+                }
+            }
+        }
+
+        // The job for the output head_partition_count_ partitions on reads
+        // history up to this partition and no further, so it can start now,
+        // unless the history is held for the late job or has lost a partition
+        // the job would read; that output then goes without its tail.
+        const std::uint64_t job_partition = partition + head_partition_count_;
+        if (partition_count > head_partition_count_ && slot.silent_partitions < partition_count - head_partition_count_)
+        {
+            if (slot.late_entry == entry || slot.history_written != partition + 1 ||
+                (slot.history_complete_from != 0 && slot.history_complete_from + partition_count > job_partition + 1))
+            {
+                late_tail_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                ticket.store(job_partition * 4 + kTailQueued, std::memory_order_release);
+                // Pairs with the fence in WorkerMain: either this sees the
+                // thread parked, or the thread sees this job before it parks.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (parked_.load(std::memory_order_relaxed))
+                {
+                    wake_.fetch_add(1, std::memory_order_release);
+                    wake_.notify_one();
+                }
+            }
+        }
+    }
+
+    void ConvolutionReverb::UpdateHistory(Slot &slot, const std::uint64_t partition) const noexcept
+    {
+        const ImpulseResponse &impulse = *slot.impulse;
+        const std::size_t spectrum_floats = impulse.SpectrumFloats();
+        if (slot.history_written + recent_partition_count_ <= partition)
+        {
+            slot.history_written = partition + 1 - recent_partition_count_;
+            slot.history_complete_from = slot.history_written;
+        }
+
+        // The entry a silent partition replaces is already zero after
+        // partition_count silent partitions, if none of them was lost.
+        if (slot.history_written == partition && slot.silent_partitions > impulse.partition_count &&
+            (slot.silent_partitions == std::numeric_limits<std::uint32_t>::max() || slot.history_complete_from + impulse.partition_count <= partition))
+        {
+            slot.history_written = partition + 1;
+            return;
+        }
+
+        for (; slot.history_written <= partition; ++slot.history_written)
+        {
+            const float *source = slot.recent.data() + static_cast<std::size_t>(slot.history_written % recent_partition_count_) * spectrum_floats;
+            std::copy(source, source + spectrum_floats, slot.history.data() + static_cast<std::size_t>(slot.history_written % impulse.partition_count) * spectrum_floats);
+        }
+    }
+
+    void ConvolutionReverb::Accumulate(const ImpulseResponse &impulse,
+                                       const float *ring,
+                                       const std::uint32_t ring_partitions,
+                                       const std::uint64_t partition,
+                                       const std::uint32_t first,
+                                       const std::uint32_t last,
+                                       float *sums) const noexcept
+    {
+        const std::size_t spectrum_floats = impulse.SpectrumFloats();
+        for (std::uint32_t channel = 0; channel < impulse.channel_count; ++channel)
+        {
+            float *const channel_sums = sums + channel * spectrum_floats;
+            for (std::uint32_t k = first; k < last && k <= partition; ++k)
+            {
+                const float *input = ring + static_cast<std::size_t>((partition - k) % ring_partitions) * spectrum_floats;
+                kernels_.spectrum_mac(input, impulse.Spectrum(channel, k), channel_sums, impulse.partition_frames + 1);
+            }
+        }
+    }
+
+    void ConvolutionReverb::WorkerMain() noexcept
+    {
+        while (true)
+        {
+            const std::uint32_t seen = wake_.load(std::memory_order_acquire);
+            if (stopping_.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            bool progressed = false;
+            for (Slot &slot : slots_)
+            {
+                for (std::uint32_t entry = 0; entry < head_partition_count_; ++entry)
+                {
+                    std::atomic<std::uint64_t> &ticket = slot.tickets[entry];
+                    std::uint64_t queued = ticket.load(std::memory_order_acquire);
+                    if ((queued & 3) != kTailQueued ||
+                        !ticket.compare_exchange_strong(queued, queued - kTailQueued + kTailRunning, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    {
+                        continue;
+                    }
+
+                    const std::int64_t delay = tail_delay_us_.load(std::memory_order_relaxed);
+                    if (delay > 0)
+                    {
+                        std::this_thread::sleep_for(std::chrono::microseconds(delay));
+                    }
+
+                    const ImpulseResponse &impulse = *slot.impulse;
+                    float *const sums = slot.tails.data() + static_cast<std::size_t>(entry) * impulse.SpectrumFloats() * 2;
+                    std::fill(sums, sums + impulse.SpectrumFloats() * impulse.channel_count, 0.0f);
+                    Accumulate(impulse, slot.history.data(), impulse.partition_count, queued >> 2, head_partition_count_, impulse.partition_count, sums);
+                    // The audio side leaves a running ticket alone.
+                    ticket.store(queued - kTailQueued + kTailDone, std::memory_order_release);
+                    progressed = true;
+                }
+            }
+
+            if (progressed)
+            {
+                continue;
+            }
+
+            parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasQueuedJob())
+            {
+                wake_.wait(seen, std::memory_order_acquire);
+            }
+            parked_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    bool ConvolutionReverb::HasQueuedJob() const noexcept
+    {
+        for (const Slot &slot : slots_)
+        {
+            for (std::uint32_t entry = 0; entry < head_partition_count_; ++entry)
+            {
+                if ((slot.tickets[entry].load(std::memory_order_relaxed) & 3) == kTailQueued)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+} // namespace decl_audio::playback
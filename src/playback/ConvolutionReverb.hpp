@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../assets/AssetBank.hpp"
+#include "MixKernels.hpp"
+#include "RealFft.hpp"
+
+namespace decl_audio::playback
+{
+    // Partition size when the caller names none: 5.3 ms of added latency at
+    // 48 kHz.
+    inline constexpr std::uint32_t kDefaultReverbPartitionFrames = 256;
+
+    // An impulse response cut into partitions of partition_frames frames, each
+    // zero-padded to twice that and transformed once at load: the filter side
+    // of a uniformly partitioned convolution. Control-thread built and
+    // immutable after, so the audio and reverb threads read it freely.
+    struct ImpulseResponse final
+    {
+        std::uint32_t partition_frames = 0;
+        std::uint32_t partition_count = 0;
+        std::uint32_t channel_count = 0; // 1 or 2
+        // RealFft spectra (partition_frames + 1 bins, split), channel-major.
+        std::vector<float> spectra;
+
+        [[nodiscard]] std::size_t SpectrumFloats() const noexcept
+        {
+            return static_cast<std::size_t>(partition_frames + 1) * 2;
+        }
+
+        [[nodiscard]] const float *Spectrum(const std::uint32_t channel, const std::uint32_t partition) const noexcept
+        {
+            return spectra.data() + (static_cast<std::size_t>(channel) * partition_count + partition) * SpectrumFloats();
+        }
+    };
+
+    // `buffer` (any format, not streamed) partitioned and transformed for
+    // ConvolutionReverb; only its first two channels are kept.
+    [[nodiscard]] ImpulseResponse TransformImpulseResponse(const assets::DecodedBuffer &buffer, std::uint32_t partition_frames);
+
+    // Convolution reverb for the mix buses that carry an impulse response:
+    // uniformly partitioned overlap-add convolution of a mono input with a
+    // mono or stereo impulse response, in a fixed set of slots allocated at
+    // construction for impulse responses up to max_partition_count partitions.
+    //
+    // Each slot buffers its input a partition at a time, so it adds
+    // partition_frames of latency. When a partition completes, the audio side
+    // transforms it into the slot's spectrum history and sums the first
+    // head_partition_count partitions' products itself; the products of the
+    // remaining (tail) partitions for the output head_partition_count
+    // partitions ahead only need history that exists already, so they are
+    // handed to one background thread, which has that many partitions of
+    // audio to finish them. The audio side never waits on that thread and
+    // does no tail work itself: a partition whose tail is not ready in time
+    // goes out with its head only (and is counted, see LateTailCount). When
+    // every tail is on time, each partition is the head sum plus the tail
+    // sum, each accumulated in partition order, so the output does not depend
+    // on timing.
+    //
+    // A slot that has heard nothing but silence for longer than its impulse
+    // response does no work at all, and reports itself not ringing.
+    class ConvolutionReverb final
+    {
+    public:
+        ConvolutionReverb(const MixKernels &kernels,
+                          std::uint32_t slot_count,
+                          std::uint32_t partition_frames,
+                          std::uint32_t max_partition_count,
+                          std::uint32_t head_partition_count);
+        ~ConvolutionReverb();
+
+        ConvolutionReverb(const ConvolutionReverb &) = delete;
+        ConvolutionReverb &operator=(const ConvolutionReverb &) = delete;
+
+        // Audio side. Points `slot` at `impulse` (which must match the
+        // partition size, fit max_partition_count and outlive the reverb) and
+        // clears its history. Only for a slot that has never processed audio.
+        void Bind(std::uint32_t slot, const ImpulseResponse &impulse) noexcept;
+        // Convolves `frames` input frames, writing as many frames of wet
+        // output (delayed by partition_frames) over `left` and `right`; a mono
+        // impulse response writes the same signal to both.
+        void Process(std::uint32_t slot, const float *input, float *left, float *right, std::uint32_t frames) noexcept;
+        // False once the slot's input has been silent long enough that its
+        // output is silence until the input is not.
+        [[nodiscard]] bool IsRinging(std::uint32_t slot) const noexcept;
+        // Partitions that went out without their tail because the background
+        // thread was late, since construction. Any thread.
+        [[nodiscard]] std::uint32_t LateTailCount() const noexcept
+        {
+            return late_tail_count_.load(std::memory_order_relaxed);
+        }
+
+        // Tests: makes the audio side wait for every tail instead of going
+        // without it, so the output is the same however the thread is
+        // scheduled. Audio side, before processing.
+        void SetWaitForTailsForTesting(bool wait) noexcept;
+        // Tests: a pause before each tail the background thread sums,
+        // standing in for a starved thread.
+        void SetTailDelayForTesting(std::chrono::microseconds delay) noexcept;
+
+    private:
+        // Low two bits of a tail ticket. The thread moves a job from Queued to
+        // Running to Done; the audio side takes back a late job that is still
+        // Queued by zeroing its ticket, which makes the thread skip it. A late
+        // job that is already Running is left to finish.
+        enum TailState : std::uint64_t
+        {
+            kTailQueued = 1,
+            kTailRunning = 2,
+            kTailDone = 3,
+        };
+
+        static constexpr std::uint32_t kNoLateJob = std::numeric_limits<std::uint32_t>::max();
+
+        struct Slot final
+        {
+            const ImpulseResponse *impulse = nullptr;
+            // Audio side: the partition being filled, the wet partition being
+            // played out while it fills, and the overlap carried into the next.
+            std::vector<float> input;
+            std::vector<float> output;  // 2 x partition_frames, planar
+            std::vector<float> overlap; // 2 x partition_frames, planar
+            std::uint32_t fill = 0;
+            std::uint64_t partition = 0;
+            std::uint32_t silent_partitions = std::numeric_limits<std::uint32_t>::max();
+            // Input spectra of the last recent_partition_count_ partitions,
+            // partition p at p % recent_partition_count_: what the head sums
+            // read. Audio side only.
+            std::vector<float> recent;
+            // Input spectra of the last partition_count partitions, partition p
+            // at p % partition_count: what tail jobs read. Copied in from
+            // `recent` by the audio side, which overwrites no entry a job may
+            // still be reading: a job reads nothing the audio side replaces
+            // before it collects the job, and while a late job is still
+            // running the copies stop (late_entry) and catch up once it is
+            // done. Partitions from history_written on are not copied yet;
+            // from history_complete_from on none was lost.
+            std::vector<float> history;
+            std::uint64_t history_written = 0;
+            std::uint64_t history_complete_from = 0;
+            // The entry whose job was still running when it came due, or
+            // kNoLateJob. There is one background thread, so at most one.
+            std::uint32_t late_entry = kNoLateJob;
+            // One tail job per entry, head_partition_count of them: the job for
+            // output partition m sits at m % head_partition_count. Its ticket
+            // is 4m plus a TailState, or 0 once the audio side has taken the
+            // job back; `tails` holds its sum (two channels of spectra) once
+            // done.
+            std::unique_ptr<std::atomic<std::uint64_t>[]> tickets;
+            std::vector<float> tails;
+        };
+
+        // Runs once the partition in `slot.input` is complete: updates the
+        // history, collects this partition's tail, queues the next job and
+        // produces the wet partition.
+        void RunPartition(Slot &slot) noexcept;
+        // Copies the partitions `slot.history` is missing, up to `partition`,
+        // from `slot.recent`; those it no longer holds are lost.
+        void UpdateHistory(Slot &slot, std::uint64_t partition) const noexcept;
+        // Sums spectrum products for partitions [first, last) of `impulse`
+        // against the input spectra in `ring` (ring_partitions entries, input
+        // partition p at p % ring_partitions) ending at input partition
+        // `partition`.
+        void Accumulate(const ImpulseResponse &impulse,
+                        const float *ring,
+                        std::uint32_t ring_partitions,
+                        std::uint64_t partition,
+                        std::uint32_t first,
+                        std::uint32_t last,
+                        float *sums) const noexcept;
+        void WorkerMain() noexcept;
+        [[nodiscard]] bool HasQueuedJob() const noexcept;
+
+        const MixKernels &kernels_;
+        std::uint32_t partition_frames_ = 0;
+        std::uint32_t head_partition_count_ = 0;
+        // The head plus as many partitions of grace: the history loses
+        // nothing to a late job that finishes within them.
+        std::uint32_t recent_partition_count_ = 0;
+        std::vector<Slot> slots_;
+        // Audio side only, like the slots' audio-side state.
+        RealFft fft_;
+        std::vector<float> time_scratch_;   // 2 x partition_frames
+        std::vector<float> spectrum_scratch_; // two channels of spectra
+        bool wait_for_tails_ = false;
+        std::atomic<std::uint32_t> late_tail_count_{0};
+        std::atomic<std::int64_t> tail_delay_us_{0};
+        // Bumped by a queued job that finds the thread parked (and at
+        // shutdown); the thread parks on it. Jobs queued while it is busy skip
+        // the notify, so most partitions make no wake syscall.
+        std::atomic<std::uint32_t> wake_{0};
+        std::atomic<bool> parked_{false};
+        std::atomic<bool> stopping_{false};
+        std::thread thread_;
+    };
+} // namespace decl_audio::playback
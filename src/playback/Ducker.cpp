@@ -0,0 +1,46 @@
+#include "pch.h"
+
+#include "Ducker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // Envelopes below this are flushed to zero, as biquad history is.
+        constexpr float kEnvelopeFlushThreshold = 1.0e-25f;
+
+        // The coefficient that leaves 1/e of a step after `ms`.
+        [[nodiscard]] float SmoothingCoefficient(const float ms, const std::uint32_t sample_rate) noexcept
+        {
+            const double time_frames = static_cast<double>(ms) * 0.001 * static_cast<double>(sample_rate);
+            return time_frames > 0.0 ? static_cast<float>(std::exp(-1.0 / time_frames)) : 0.0f;
+        }
+    } // namespace
+
+    DuckCoefficients DesignDuck(const compiler::CompiledDuck &duck, const std::uint32_t sample_rate) noexcept
+    {
+        DuckCoefficients coefficients;
+        coefficients.attack = SmoothingCoefficient(duck.attack_ms, sample_rate);
+        coefficients.release = SmoothingCoefficient(duck.release_ms, sample_rate);
+        coefficients.inverse_threshold = static_cast<float>(1.0 / static_cast<double>(duck.threshold));
+        coefficients.range = static_cast<float>(1.0 - static_cast<double>(duck.depth));
+        return coefficients;
+    }
+
+    void FollowDuck(const DuckCoefficients &coefficients, DuckState &state, float *levels, const std::uint32_t frames) noexcept
+    {
+        float envelope = state.envelope;
+        for (std::uint32_t i = 0; i < frames; ++i)
+        {
+            const float level = levels[i];
+            const float coefficient = level > envelope ? coefficients.attack : coefficients.release;
+            envelope = level + coefficient * (envelope - level);
+            levels[i] = 1.0f - coefficients.range * std::min(1.0f, envelope * coefficients.inverse_threshold);
+        }
+
+        state.envelope = envelope < kEnvelopeFlushThreshold ? 0.0f : envelope;
+    }
+} // namespace decl_audio::playback
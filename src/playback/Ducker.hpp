@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../compiler/CompiledBank.hpp"
+
+namespace decl_audio::playback
+{
+    // A CompiledDuck at a sample rate: one-pole smoothing coefficients for a
+    // rising and a falling level (0 follows instantly), and the gain computer
+    // gain = 1 - range * min(1, envelope * inverse_threshold).
+    struct DuckCoefficients final
+    {
+        float attack = 0.0f;
+        float release = 0.0f;
+        float inverse_threshold = 1.0f;
+        float range = 0.0f; // 1 - depth
+    };
+
+    struct DuckState final
+    {
+        float envelope = 0.0f;
+    };
+
+    // Designed in double; for the audio thread to call when a bus is added.
+    [[nodiscard]] DuckCoefficients DesignDuck(const compiler::CompiledDuck &duck, std::uint32_t sample_rate) noexcept;
+
+    // Runs the envelope follower over `levels`, the trigger's peak level per
+    // frame, and overwrites each with the ducked bus's gain for that frame.
+    // The recursion is serial, so this is plain scalar code; the per-frame
+    // peaks feeding it come from the frame_peak kernel. An envelope that
+    // decays below the float normal range is flushed to zero at the end of
+    // each call.
+    void FollowDuck(const DuckCoefficients &coefficients, DuckState &state, float *levels, std::uint32_t frames) noexcept;
+} // namespace decl_audio::playback
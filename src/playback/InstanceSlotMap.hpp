@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "AudioCommands.hpp"
+
+namespace decl_audio::playback
+{
+    // Fixed-capacity open-addressed map from a control-minted InstanceId to the
+    // audio-thread storage slot (slice index) holding that instance. Sized once
+    // at construction to at least twice the instance cap, so the load factor
+    // stays at or below one half and probes stay short; never allocates after
+    // that. Linear probing with backward-shift deletion keeps lookups
+    // tombstone-free no matter how many instances come and go.
+    class InstanceSlotMap final
+    {
+    public:
+        static constexpr std::uint32_t kInvalidSlot = std::numeric_limits<std::uint32_t>::max();
+
+        InstanceSlotMap() = default;
+
+        explicit InstanceSlotMap(const std::size_t max_entries)
+        {
+            std::size_t capacity = 2;
+            while (capacity < max_entries * 2)
+            {
+                capacity *= 2;
+            }
+
+            entries_.resize(capacity);
+            mask_ = capacity - 1;
+            max_entries_ = max_entries;
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return size_;
+        }
+
+        // Returns the slot for `instance_id`, or kInvalidSlot if it is not mapped.
+        [[nodiscard]] std::uint32_t Find(const InstanceId instance_id) const noexcept
+        {
+            if (entries_.empty())
+            {
+                return kInvalidSlot;
+            }
+
+            for (std::size_t index = HomeIndex(instance_id);; index = (index + 1) & mask_)
+            {
+                const Entry &entry = entries_[index];
+                if (entry.slot == kInvalidSlot)
+                {
+                    return kInvalidSlot;
+                }
+
+                if (entry.instance_id == instance_id)
+                {
+                    return entry.slot;
+                }
+            }
+        }
+
+        // Returns false (and changes nothing) if `instance_id` is already mapped
+        // or the map already holds max_entries instances.
+        [[nodiscard]] bool Insert(const InstanceId instance_id, const std::uint32_t slot) noexcept
+        {
+            if (size_ >= max_entries_ || slot == kInvalidSlot)
+            {
+                return false;
+            }
+
+            for (std::size_t index = HomeIndex(instance_id);; index = (index + 1) & mask_)
+            {
+                Entry &entry = entries_[index];
+                if (entry.slot == kInvalidSlot)
+                {
+                    entry.instance_id = instance_id;
+                    entry.slot = slot;
+                    ++size_;
+                    return true;
+                }
+
+                if (entry.instance_id == instance_id)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // Returns false if `instance_id` was not mapped.
+        bool Erase(const InstanceId instance_id) noexcept
+        {
+            if (entries_.empty())
+            {
+                return false;
+            }
+
+            std::size_t hole = HomeIndex(instance_id);
+            while (true)
+            {
+                if (entries_[hole].slot == kInvalidSlot)
+                {
+                    return false;
+                }
+
+                if (entries_[hole].instance_id == instance_id)
+                {
+                    break;
+                }
+
+                hole = (hole + 1) & mask_;
+            }
+
+            // Backward shift: pull later members of the probe run into the hole
+            // whenever the hole lies on their path from their home bucket.
+            for (std::size_t index = (hole + 1) & mask_;; index = (index + 1) & mask_)
+            {
+                Entry &entry = entries_[index];
+                if (entry.slot == kInvalidSlot)
+                {
+                    break;
+                }
+
+                const std::size_t home = HomeIndex(entry.instance_id);
+                const std::size_t distance_to_entry = (index - home) & mask_;
+                const std::size_t distance_to_hole = (hole - home) & mask_;
+                if (distance_to_hole < distance_to_entry)
+                {
+                    entries_[hole] = entry;
+                    hole = index;
+                }
+            }
+
+            entries_[hole] = Entry{};
+            --size_;
+            return true;
+        }
+
+    private:
+        struct Entry final
+        {
+            InstanceId instance_id = 0;
+            std::uint32_t slot = kInvalidSlot; // kInvalidSlot marks an empty bucket
+        };
+
+        [[nodiscard]] std::size_t HomeIndex(const InstanceId instance_id) const noexcept
+        {
+            // Ids are minted sequentially; a 64-bit finalizer spreads them so
+            // neighbouring ids do not form one long probe run.
+            std::uint64_t value = instance_id;
+            value = (value ^ (value >> 33U)) * 0xFF51AFD7ED558CCDULL;
+            value = (value ^ (value >> 33U)) * 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33U;
+            return static_cast<std::size_t>(value) & mask_;
+        }
+
+        std::vector<Entry> entries_;
+        std::size_t mask_ = 0;
+        std::size_t size_ = 0;
+        std::size_t max_entries_ = 0;
+    };
+} // namespace decl_audio::playback
@@ -0,0 +1,113 @@
+#include "pch.h"
+
+#include "MasterLimiter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace decl_audio::playback
+{
+    MasterLimiter::MasterLimiter(const MixKernels &kernels,
+                                 const std::uint32_t channel_count,
+                                 const std::uint32_t max_block_frames,
+                                 const std::uint32_t lookahead_frames,
+                                 const std::uint32_t release_frames,
+                                 const float ceiling)
+        : kernels_(kernels),
+          channel_count_(channel_count),
+          lookahead_frames_(lookahead_frames),
+          window_frames_(lookahead_frames + 1),
+          ceiling_(ceiling),
+          release_(release_frames > 0 ? static_cast<float>(std::exp(-1.0 / static_cast<double>(release_frames))) : 0.0f),
+          delay_(static_cast<std::size_t>(channel_count) * (lookahead_frames + max_block_frames), 0.0f),
+          gains_(max_block_frames),
+          minimum_targets_(window_frames_),
+          minimum_frames_(window_frames_),
+          box_(window_frames_, 1.0f),
+          box_sum_(static_cast<double>(window_frames_)),
+          unity_frames_(window_frames_)
+    {
+    }
+
+    float MasterLimiter::Process(float *const *channels, const std::uint32_t frames) noexcept
+    {
+        float *const gains = gains_.data();
+        kernels_.frame_peak(channels, channel_count_, frames, gains);
+
+        // Idle and staying under the ceiling: every gain would be exactly 1,
+        // so only the window bookkeeping moves on.
+        const bool idle = unity_frames_ >= window_frames_ &&
+                          std::all_of(gains, gains + frames, [this](const float peak) { return !(peak > ceiling_); });
+        float lowest_gain = 1.0f;
+        if (idle)
+        {
+            frame_ += frames;
+            box_next_ = static_cast<std::uint32_t>((box_next_ + frames) % window_frames_);
+            minimum_first_ = 0;
+            minimum_count_ = 0;
+        }
+        else
+        {
+            for (std::uint32_t i = 0; i < frames; ++i)
+            {
+                const float peak = gains[i];
+                gains[i] = NextGain(peak > ceiling_ ? ceiling_ / peak : 1.0f);
+                lowest_gain = std::min(lowest_gain, gains[i]);
+            }
+        }
+
+        const std::size_t stride = static_cast<std::size_t>(lookahead_frames_) + gains_.size();
+        for (std::uint32_t channel = 0; channel < channel_count_; ++channel)
+        {
+            float *const delayed = delay_.data() + channel * stride;
+            float *const samples = channels[channel];
+            std::copy(samples, samples + frames, delayed + lookahead_frames_);
+            if (idle)
+            {
+                std::copy(delayed, delayed + frames, samples);
+            }
+            else
+            {
+                for (std::uint32_t i = 0; i < frames; ++i)
+                {
+                    samples[i] = delayed[i] * gains[i];
+                }
+            }
+            std::copy(delayed + frames, delayed + frames + lookahead_frames_, delayed);
+        }
+
+        return lowest_gain;
+    }
+
+    float MasterLimiter::NextGain(const float target) noexcept
+    {
+        // An empty window (after idling) stands for a window of unity targets.
+        const std::uint64_t frame = frame_++;
+        if (minimum_count_ > 0 && frame - minimum_frames_[minimum_first_] >= window_frames_)
+        {
+            minimum_first_ = minimum_first_ + 1 == window_frames_ ? 0 : minimum_first_ + 1;
+            --minimum_count_;
+        }
+        while (minimum_count_ > 0 && minimum_targets_[(minimum_first_ + minimum_count_ - 1) % window_frames_] >= target)
+        {
+            --minimum_count_;
+        }
+        minimum_targets_[(minimum_first_ + minimum_count_) % window_frames_] = target;
+        minimum_frames_[(minimum_first_ + minimum_count_) % window_frames_] = frame;
+        ++minimum_count_;
+        const float minimum = minimum_targets_[minimum_first_];
+
+        released_ = minimum < released_ ? minimum : minimum + release_ * (released_ - minimum);
+        unity_frames_ = released_ != 1.0f ? 0 : std::min(unity_frames_ + 1, window_frames_);
+
+        box_sum_ += static_cast<double>(released_) - static_cast<double>(box_[box_next_]);
+        box_[box_next_] = released_;
+        box_next_ = box_next_ + 1 == window_frames_ ? 0 : box_next_ + 1;
+        if (unity_frames_ == window_frames_)
+        {
+            box_sum_ = static_cast<double>(window_frames_);
+        }
+
+        return static_cast<float>(box_sum_ / static_cast<double>(window_frames_));
+    }
+} // namespace decl_audio::playback
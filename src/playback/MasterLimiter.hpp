@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MixKernels.hpp"
+
+namespace decl_audio::playback
+{
+    // Lookahead peak limiter for the master output. Every frame's target gain
+    // is min(1, ceiling / peak), the peak across channels coming from the
+    // frame_peak kernel. The gain applied is the minimum target over the next
+    // lookahead_frames + 1 frames, released upward by a one-pole smoother and
+    // then averaged over a box of that same length, so it glides down in
+    // time for each peak instead of stepping. Output is the input delayed by
+    // lookahead_frames with that gain applied, which keeps every sample
+    // within the ceiling (to float rounding).
+    //
+    // The state is per frame, so output does not depend on how the signal is
+    // cut into calls. A limiter that has seen nothing over the ceiling for a
+    // whole window only delays. Storage is allocated at construction.
+    class MasterLimiter final
+    {
+    public:
+        // `ceiling` is linear, in (0, 1]; a release of 0 frames recovers
+        // instantly once the peak has passed.
+        MasterLimiter(const MixKernels &kernels,
+                      std::uint32_t channel_count,
+                      std::uint32_t max_block_frames,
+                      std::uint32_t lookahead_frames,
+                      std::uint32_t release_frames,
+                      float ceiling);
+
+        [[nodiscard]] std::uint32_t LookaheadFrames() const noexcept
+        {
+            return lookahead_frames_;
+        }
+
+        // Limits `frames` (at most max_block_frames) frames of the planar
+        // `channels` in place and returns the lowest gain it applied.
+        float Process(float *const *channels, std::uint32_t frames) noexcept;
+
+    private:
+        // The frame's gain from its target: slides the minimum window, applies
+        // the release and returns the box average.
+        [[nodiscard]] float NextGain(float target) noexcept;
+
+        const MixKernels &kernels_;
+        std::uint32_t channel_count_ = 0;
+        std::uint32_t lookahead_frames_ = 0;
+        std::uint32_t window_frames_ = 0; // lookahead_frames_ + 1
+        float ceiling_ = 1.0f;
+        float release_ = 0.0f;
+        // Per channel, lookahead_frames_ frames of delayed signal followed by
+        // room for one block.
+        std::vector<float> delay_;
+        std::vector<float> gains_; // peaks, then gains, for one block
+        // Sliding minimum of the targets: a ring of window_frames_ entries
+        // holding increasing targets and the frames they arrived on.
+        std::vector<float> minimum_targets_;
+        std::vector<std::uint64_t> minimum_frames_;
+        std::uint32_t minimum_first_ = 0;
+        std::uint32_t minimum_count_ = 0;
+        // The released minimum, and its last window_frames_ values with their
+        // sum, kept in double so the average of a settled window is exact.
+        float released_ = 1.0f;
+        std::vector<float> box_;
+        std::uint32_t box_next_ = 0;
+        double box_sum_ = 0.0;
+        // Consecutive frames the released minimum has been 1; a whole window
+        // of them means the limiter is idle.
+        std::uint32_t unity_frames_ = 0;
+        std::uint64_t frame_ = 0;
+    };
+} // namespace decl_audio::playback
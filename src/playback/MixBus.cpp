@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include "MixBus.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace decl_audio::playback
+{
+    MixBus::MixBus(const std::uint32_t channel_count, const std::uint32_t max_frames)
+        : channel_count_(channel_count),
+          max_frames_(max_frames)
+    {
+        // Round each channel up to a whole number of cache lines so every channel
+        // after the first stays aligned, then over-allocate one line for the base.
+        stride_ = (static_cast<std::size_t>(max_frames) + kAlignmentFloats - 1) / kAlignmentFloats * kAlignmentFloats;
+        storage_.resize(stride_ * channel_count + kAlignmentFloats, 0.0f);
+
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage_.data());
+        const std::uintptr_t alignment = kAlignmentFloats * sizeof(float);
+        offset_ = static_cast<std::size_t>(((alignment - (address % alignment)) % alignment) / sizeof(float));
+    }
+
+    void MixBus::Clear(const std::uint32_t frames) noexcept
+    {
+        for (std::uint32_t channel = 0; channel < channel_count_; ++channel)
+        {
+            std::fill_n(Channel(channel), frames, 0.0f);
+        }
+    }
+
+    void MixBus::InterleaveTo(float *output, const std::uint32_t frames) const noexcept
+    {
+        if (channel_count_ == 2)
+        {
+            const float *left = Channel(0);
+            const float *right = Channel(1);
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                output[2 * static_cast<std::size_t>(frame) + 0] = left[frame];
+                output[2 * static_cast<std::size_t>(frame) + 1] = right[frame];
+            }
+            return;
+        }
+
+        for (std::uint32_t channel = 0; channel < channel_count_; ++channel)
+        {
+            const float *source = Channel(channel);
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                output[static_cast<std::size_t>(frame) * channel_count_ + channel] = source[frame];
+            }
+        }
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace decl_audio::playback
+{
+    // Planar mix buffer: one contiguous float array per channel, each starting on
+    // a 64-byte boundary, so every inner mixing loop is a unit-stride stream.
+    // Sized once at construction and never resized; the audio thread only ever
+    // clears and writes it. Interleaving for a device happens once, at the
+    // backend edge, via InterleaveTo.
+    class MixBus final
+    {
+    public:
+        static constexpr std::size_t kAlignmentFloats = 16; // 64 bytes
+
+        MixBus() = default;
+        MixBus(std::uint32_t channel_count, std::uint32_t max_frames);
+
+        // A copy would land at a different alignment; moves keep the allocation.
+        MixBus(const MixBus &) = delete;
+        MixBus &operator=(const MixBus &) = delete;
+        MixBus(MixBus &&) noexcept = default;
+        MixBus &operator=(MixBus &&) noexcept = default;
+
+        [[nodiscard]] std::uint32_t ChannelCount() const noexcept
+        {
+            return channel_count_;
+        }
+
+        [[nodiscard]] std::uint32_t MaxFrames() const noexcept
+        {
+            return max_frames_;
+        }
+
+        [[nodiscard]] float *Channel(const std::uint32_t channel) noexcept
+        {
+            return storage_.data() + offset_ + channel * stride_;
+        }
+
+        [[nodiscard]] const float *Channel(const std::uint32_t channel) const noexcept
+        {
+            return storage_.data() + offset_ + channel * stride_;
+        }
+
+        // Zeroes the first `frames` frames of every channel.
+        void Clear(std::uint32_t frames) noexcept;
+
+        // Writes the first `frames` frames to `output` as interleaved
+        // frame-major samples (frames * ChannelCount() floats).
+        void InterleaveTo(float *output, std::uint32_t frames) const noexcept;
+
+    private:
+        // Aligned base = storage_.data() + offset_; stride_ is a whole number of
+        // cache lines so every channel shares that alignment.
+        std::vector<float> storage_;
+        std::size_t offset_ = 0;
+        std::size_t stride_ = 0;
+        std::uint32_t channel_count_ = 0;
+        std::uint32_t max_frames_ = 0;
+    };
+} // namespace decl_audio::playback
@@ -0,0 +1,911 @@
+#include "pch.h"
+
+#include "MixKernels.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+#include "SpeakerLayout.hpp"
+
+#if DECL_AUDIO_X86
+#include <immintrin.h>
+#endif
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // One kernel body per ISA, specialized at compile time on source channel
+        // count, envelope and ramp, so every combination is a branch-free loop.
+        // Each body handles frames [begin, frames) and hands its remainder to the
+        // next narrower ISA, ending in scalar; frame indices stay absolute so the
+        // ramp gain start + step * f is computed identically on every path.
+        //
+        // Every body writes `left` before reading `right` for the same frames,
+        // which is what keeps left == right (a mono bus) well defined.
+        struct KernelArgs final
+        {
+            const float *source = nullptr;
+            float *left = nullptr;
+            float *right = nullptr;
+            std::uint32_t frames = 0;
+            MixGains start{};
+            MixGains step{};
+            const float *envelope = nullptr;
+        };
+
+        template <std::uint32_t kSourceChannels, bool kEnvelope, bool kRamp>
+        void MixScalar(const KernelArgs &args, const std::uint32_t begin) noexcept
+        {
+            for (std::uint32_t i = begin; i < args.frames; ++i)
+            {
+                float gain_left = args.start.left;
+                float gain_right = args.start.right;
+                if constexpr (kRamp)
+                {
+                    const float x = static_cast<float>(i);
+                    gain_left = args.start.left + args.step.left * x;
+                    gain_right = args.start.right + args.step.right * x;
+                }
+
+                float sample_left;
+                float sample_right;
+                if constexpr (kSourceChannels == 1)
+                {
+                    sample_left = args.source[i];
+                    sample_right = args.source[i];
+                }
+                else
+                {
+                    sample_left = args.source[2 * static_cast<std::size_t>(i) + 0];
+                    sample_right = args.source[2 * static_cast<std::size_t>(i) + 1];
+                }
+
+                if constexpr (kEnvelope)
+                {
+                    sample_left *= args.envelope[i];
+                    sample_right *= args.envelope[i];
+                }
+
+                args.left[i] += sample_left * gain_left;
+                args.right[i] += sample_right * gain_right;
+            }
+        }
+
+        struct PanArgs final
+        {
+            const float *source = nullptr;
+            float *const *outputs = nullptr;
+            std::uint32_t channel_count = 0;
+            std::uint32_t frames = 0;
+            const float *start = nullptr;
+            const float *step = nullptr;
+        };
+
+        template <bool kRamp>
+        void PanScalar(const PanArgs &args, const std::uint32_t begin) noexcept
+        {
+            for (std::uint32_t i = begin; i < args.frames; ++i)
+            {
+                const float sample = args.source[i];
+                for (std::uint32_t c = 0; c < args.channel_count; ++c)
+                {
+                    float gain = args.start[c];
+                    if constexpr (kRamp)
+                    {
+                        gain = args.start[c] + args.step[c] * static_cast<float>(i);
+                    }
+
+                    args.outputs[c][i] += sample * gain;
+                }
+            }
+        }
+
+        struct ResampleArgs final
+        {
+            const float *source = nullptr;
+            std::uint64_t position = 0;
+            std::uint32_t step = 0;
+            float *output = nullptr;
+            std::uint32_t frames = 0;
+        };
+
+        constexpr std::uint64_t kFractionMask = kUnityRate - 1;
+        constexpr float kFractionScale = 1.0f / static_cast<float>(kUnityRate);
+
+        // Integer part, in floats from the source start, and fraction (exact as a
+        // float) of output frame i's read position.
+        template <std::uint32_t kChannels>
+        inline void ResamplePosition(const ResampleArgs &args, const std::uint32_t i, std::int32_t &offset, std::int32_t &fraction) noexcept
+        {
+            const std::uint64_t position = args.position + static_cast<std::uint64_t>(args.step) * i;
+            offset = static_cast<std::int32_t>((position >> kRateFractionBits) * kChannels);
+            fraction = static_cast<std::int32_t>(position & kFractionMask);
+        }
+
+        template <std::uint32_t kChannels>
+        void ResampleScalar(const ResampleArgs &args, const std::uint32_t begin) noexcept
+        {
+            for (std::uint32_t i = begin; i < args.frames; ++i)
+            {
+                std::int32_t offset;
+                std::int32_t fraction;
+                ResamplePosition<kChannels>(args, i, offset, fraction);
+                const float t = static_cast<float>(fraction) * kFractionScale;
+                for (std::uint32_t c = 0; c < kChannels; ++c)
+                {
+                    const float a = args.source[offset + c];
+                    const float b = args.source[offset + kChannels + c];
+                    args.output[static_cast<std::size_t>(i) * kChannels + c] = a + (b - a) * t;
+                }
+            }
+        }
+
+        // The scale assets::DecodeBuffer uses, so decode-on-mix matches it.
+        constexpr float kS16Scale = 1.0f / 32768.0f;
+
+        void WidenScalar(const std::int16_t *source, float *output, const std::uint32_t begin, const std::uint32_t count) noexcept
+        {
+            for (std::uint32_t i = begin; i < count; ++i)
+            {
+                output[i] = static_cast<float>(source[i]) * kS16Scale;
+            }
+        }
+
+        void SpectrumMacScalar(const float *x, const float *h, float *acc, const std::uint32_t begin, const std::uint32_t bins) noexcept
+        {
+            const float *x_im = x + bins;
+            const float *h_im = h + bins;
+            float *acc_im = acc + bins;
+            for (std::uint32_t k = begin; k < bins; ++k)
+            {
+                acc[k] += x[k] * h[k] - x_im[k] * h_im[k];
+                acc_im[k] += x[k] * h_im[k] + x_im[k] * h[k];
+            }
+        }
+
+        // The compare-and-select every level's max instruction performs, so
+        // the scalar path agrees with it even on NaN.
+        inline float PeakOf(const float value, const float peak) noexcept
+        {
+            return value > peak ? value : peak;
+        }
+
+        void FramePeakScalar(const float *const *channels, const std::uint32_t channel_count, const std::uint32_t begin, const std::uint32_t frames, float *peaks) noexcept
+        {
+            for (std::uint32_t i = begin; i < frames; ++i)
+            {
+                float peak = 0.0f;
+                for (std::uint32_t c = 0; c < channel_count; ++c)
+                {
+                    peak = PeakOf(std::fabs(channels[c][i]), peak);
+                }
+                peaks[i] = peak;
+            }
+        }
+
+        // Biquad history below this is flushed to zero: far under audibility,
+        // and above where float products start producing denormals.
+        constexpr float kBiquadFlushThreshold = 1.0e-25f;
+
+        // One 4-frame block of one channel, in place: the lane math every
+        // level reproduces, term by term.
+        inline void BiquadBlockScalar(const BiquadCoefficients &coefficients, float *x, BiquadState &state) noexcept
+        {
+            const float v[8] = {x[0], x[1], x[2], x[3], state.x1, state.x2, state.y1, state.y2};
+            float y[4];
+            for (std::uint32_t k = 0; k < 4; ++k)
+            {
+                float acc = coefficients.block[0][k] * v[0];
+                for (std::uint32_t j = 1; j < 8; ++j)
+                {
+                    acc += coefficients.block[j][k] * v[j];
+                }
+                y[k] = acc;
+            }
+
+            state = BiquadState{v[3], v[2], y[3], y[2]};
+            for (std::uint32_t k = 0; k < 4; ++k)
+            {
+                x[k] = y[k];
+            }
+        }
+
+        void BiquadBlocksScalar(float *x, const std::uint32_t block_frames, const BiquadCoefficients &coefficients, BiquadState &state) noexcept
+        {
+            for (std::uint32_t i = 0; i < block_frames; i += 4)
+            {
+                BiquadBlockScalar(coefficients, x + i, state);
+            }
+        }
+
+        // Direct form I over [begin, frames), then the denormal flush; shared
+        // by every level.
+        void BiquadTail(float *x, const std::uint32_t begin, const std::uint32_t frames, const BiquadCoefficients &coefficients, BiquadState &state) noexcept
+        {
+            for (std::uint32_t i = begin; i < frames; ++i)
+            {
+                const float input = x[i];
+                const float output = coefficients.b0 * input + coefficients.b1 * state.x1 + coefficients.b2 * state.x2 - coefficients.a1 * state.y1 - coefficients.a2 * state.y2;
+                state = BiquadState{input, state.x1, output, state.y1};
+                x[i] = output;
+            }
+
+            for (float *value : {&state.x1, &state.x2, &state.y1, &state.y2})
+            {
+                if (std::fabs(*value) < kBiquadFlushThreshold)
+                    *value = 0.0f;
+            }
+        }
+
+#if DECL_AUDIO_X86
+        // Splits 4 interleaved stereo frames into 4 left and 4 right samples.
+        inline void DeinterleaveSse2(const float *source, __m128 &l, __m128 &r) noexcept
+        {
+            const __m128 a = _mm_loadu_ps(source + 0);
+            const __m128 b = _mm_loadu_ps(source + 4);
+            l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        template <std::uint32_t kSourceChannels, bool kEnvelope, bool kRamp>
+        void MixSse2(const KernelArgs &args, const std::uint32_t begin) noexcept
+        {
+            const __m128 start_left = _mm_set1_ps(args.start.left);
+            const __m128 start_right = _mm_set1_ps(args.start.right);
+            const __m128 step_left = _mm_set1_ps(args.step.left);
+            const __m128 step_right = _mm_set1_ps(args.step.right);
+            const __m128 lane_offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            __m128 gain_left = start_left;
+            __m128 gain_right = start_right;
+
+            std::uint32_t i = begin;
+            for (; i + 4 <= args.frames; i += 4)
+            {
+                __m128 sample_left;
+                __m128 sample_right;
+                if constexpr (kSourceChannels == 1)
+                {
+                    sample_left = _mm_loadu_ps(args.source + i);
+                    sample_right = sample_left;
+                }
+                else
+                {
+                    DeinterleaveSse2(args.source + 2 * static_cast<std::size_t>(i), sample_left, sample_right);
+                }
+
+                if constexpr (kEnvelope)
+                {
+                    const __m128 e = _mm_loadu_ps(args.envelope + i);
+                    sample_left = _mm_mul_ps(sample_left, e);
+                    sample_right = _mm_mul_ps(sample_right, e);
+                }
+
+                if constexpr (kRamp)
+                {
+                    const __m128 x = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane_offsets);
+                    gain_left = _mm_add_ps(start_left, _mm_mul_ps(step_left, x));
+                    gain_right = _mm_add_ps(start_right, _mm_mul_ps(step_right, x));
+                }
+
+                _mm_storeu_ps(args.left + i, _mm_add_ps(_mm_loadu_ps(args.left + i), _mm_mul_ps(sample_left, gain_left)));
+                _mm_storeu_ps(args.right + i, _mm_add_ps(_mm_loadu_ps(args.right + i), _mm_mul_ps(sample_right, gain_right)));
+            }
+
+            MixScalar<kSourceChannels, kEnvelope, kRamp>(args, i);
+        }
+
+        template <bool kRamp>
+        void PanSse2(const PanArgs &args, const std::uint32_t begin) noexcept
+        {
+            __m128 start[kMaxOutputChannels];
+            __m128 step[kMaxOutputChannels];
+            for (std::uint32_t c = 0; c < args.channel_count; ++c)
+            {
+                start[c] = _mm_set1_ps(args.start[c]);
+                step[c] = kRamp ? _mm_set1_ps(args.step[c]) : _mm_setzero_ps();
+            }
+
+            const __m128 lane_offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            std::uint32_t i = begin;
+            for (; i + 4 <= args.frames; i += 4)
+            {
+                const __m128 sample = _mm_loadu_ps(args.source + i);
+                const __m128 x = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane_offsets);
+                for (std::uint32_t c = 0; c < args.channel_count; ++c)
+                {
+                    __m128 gain = start[c];
+                    if constexpr (kRamp)
+                    {
+                        gain = _mm_add_ps(start[c], _mm_mul_ps(step[c], x));
+                    }
+
+                    float *output = args.outputs[c] + i;
+                    _mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_mul_ps(sample, gain)));
+                }
+            }
+
+            PanScalar<kRamp>(args, i);
+        }
+
+        // Each vector holds 4 / kChannels whole output frames, lane k being
+        // channel k % kChannels. SSE2 has no gather, so neighbours load per lane.
+        template <std::uint32_t kChannels>
+        void ResampleSse2(const ResampleArgs &args, const std::uint32_t begin) noexcept
+        {
+            constexpr std::uint32_t kFrames = 4 / kChannels;
+            const __m128 scale = _mm_set1_ps(kFractionScale);
+
+            std::uint32_t i = begin;
+            for (; i + kFrames <= args.frames; i += kFrames)
+            {
+                alignas(16) float a[4];
+                alignas(16) float b[4];
+                alignas(16) std::int32_t fraction[4];
+                for (std::uint32_t lane = 0; lane < 4; lane += kChannels)
+                {
+                    std::int32_t offset;
+                    ResamplePosition<kChannels>(args, i + lane / kChannels, offset, fraction[lane]);
+                    for (std::uint32_t c = 0; c < kChannels; ++c)
+                    {
+                        a[lane + c] = args.source[offset + c];
+                        b[lane + c] = args.source[offset + kChannels + c];
+                        fraction[lane + c] = fraction[lane];
+                    }
+                }
+
+                const __m128 va = _mm_load_ps(a);
+                const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(fraction))), scale);
+                _mm_storeu_ps(args.output + static_cast<std::size_t>(i) * kChannels, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b), va), t)));
+            }
+
+            ResampleScalar<kChannels>(args, i);
+        }
+
+        // Sign-extends by unpacking each sample into the high half of a 32-bit
+        // lane and shifting it back down.
+        void WidenSse2(const std::int16_t *source, float *output, const std::uint32_t begin, const std::uint32_t count) noexcept
+        {
+            const __m128 scale = _mm_set1_ps(kS16Scale);
+
+            std::uint32_t i = begin;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+                const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+                const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+            }
+
+            WidenScalar(source, output, i, count);
+        }
+
+        void SpectrumMacSse2(const float *x, const float *h, float *acc, const std::uint32_t begin, const std::uint32_t bins) noexcept
+        {
+            const float *x_im = x + bins;
+            const float *h_im = h + bins;
+            float *acc_im = acc + bins;
+            std::uint32_t k = begin;
+            for (; k + 4 <= bins; k += 4)
+            {
+                const __m128 xr = _mm_loadu_ps(x + k);
+                const __m128 xi = _mm_loadu_ps(x_im + k);
+                const __m128 hr = _mm_loadu_ps(h + k);
+                const __m128 hi = _mm_loadu_ps(h_im + k);
+                _mm_storeu_ps(acc + k, _mm_add_ps(_mm_loadu_ps(acc + k), _mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi))));
+                _mm_storeu_ps(acc_im + k, _mm_add_ps(_mm_loadu_ps(acc_im + k), _mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr))));
+            }
+
+            SpectrumMacScalar(x, h, acc, k, bins);
+        }
+
+        void FramePeakSse2(const float *const *channels, const std::uint32_t channel_count, const std::uint32_t begin, const std::uint32_t frames, float *peaks) noexcept
+        {
+            const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            std::uint32_t i = begin;
+            for (; i + 4 <= frames; i += 4)
+            {
+                __m128 peak = _mm_setzero_ps();
+                for (std::uint32_t c = 0; c < channel_count; ++c)
+                {
+                    peak = _mm_max_ps(_mm_and_ps(_mm_loadu_ps(channels[c] + i), magnitude), peak);
+                }
+                _mm_storeu_ps(peaks + i, peak);
+            }
+
+            FramePeakScalar(channels, channel_count, i, frames, peaks);
+        }
+
+        // BiquadBlockScalar with the four outputs as lanes: each term
+        // broadcasts one element of v against its coefficient column. The
+        // history lives in a register as (x1, x2, y1, y2), so the next block's
+        // is one shuffle of this block's input and output.
+        void BiquadBlocksSse2(float *x, const std::uint32_t block_frames, const BiquadCoefficients &coefficients, BiquadState &state) noexcept
+        {
+            __m128 column[8];
+            for (std::uint32_t j = 0; j < 8; ++j)
+            {
+                column[j] = _mm_load_ps(coefficients.block[j]);
+            }
+            __m128 history = _mm_setr_ps(state.x1, state.x2, state.y1, state.y2);
+
+            for (std::uint32_t i = 0; i < block_frames; i += 4)
+            {
+                const __m128 input = _mm_loadu_ps(x + i);
+                __m128 acc = _mm_mul_ps(column[0], _mm_shuffle_ps(input, input, _MM_SHUFFLE(0, 0, 0, 0)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[1], _mm_shuffle_ps(input, input, _MM_SHUFFLE(1, 1, 1, 1))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[2], _mm_shuffle_ps(input, input, _MM_SHUFFLE(2, 2, 2, 2))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[3], _mm_shuffle_ps(input, input, _MM_SHUFFLE(3, 3, 3, 3))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[4], _mm_shuffle_ps(history, history, _MM_SHUFFLE(0, 0, 0, 0))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[5], _mm_shuffle_ps(history, history, _MM_SHUFFLE(1, 1, 1, 1))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[6], _mm_shuffle_ps(history, history, _MM_SHUFFLE(2, 2, 2, 2))));
+                acc = _mm_add_ps(acc, _mm_mul_ps(column[7], _mm_shuffle_ps(history, history, _MM_SHUFFLE(3, 3, 3, 3))));
+                history = _mm_shuffle_ps(input, acc, _MM_SHUFFLE(2, 3, 2, 3));
+                _mm_storeu_ps(x + i, acc);
+            }
+
+            alignas(16) float saved[4];
+            _mm_store_ps(saved, history);
+            state = BiquadState{saved[0], saved[1], saved[2], saved[3]};
+        }
+
+        // Splits 8 interleaved stereo frames into 8 left and 8 right samples. The
+        // in-lane shuffle yields [l0 l1 l4 l5 | l2 l3 l6 l7]; swapping the middle
+        // 64-bit pairs restores frame order.
+        DECL_AUDIO_TARGET_AVX2 inline void DeinterleaveAvx2(const float *source, __m256 &l, __m256 &r) noexcept
+        {
+            const __m256 a = _mm256_loadu_ps(source + 0);
+            const __m256 b = _mm256_loadu_ps(source + 8);
+            l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), 0xD8));
+            r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), 0xD8));
+        }
+
+        template <std::uint32_t kSourceChannels, bool kEnvelope, bool kRamp>
+        DECL_AUDIO_TARGET_AVX2 void MixAvx2(const KernelArgs &args, const std::uint32_t begin) noexcept
+        {
+            const __m256 start_left = _mm256_set1_ps(args.start.left);
+            const __m256 start_right = _mm256_set1_ps(args.start.right);
+            const __m256 step_left = _mm256_set1_ps(args.step.left);
+            const __m256 step_right = _mm256_set1_ps(args.step.right);
+            const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            __m256 gain_left = start_left;
+            __m256 gain_right = start_right;
+
+            std::uint32_t i = begin;
+            for (; i + 8 <= args.frames; i += 8)
+            {
+                __m256 sample_left;
+                __m256 sample_right;
+                if constexpr (kSourceChannels == 1)
+                {
+                    sample_left = _mm256_loadu_ps(args.source + i);
+                    sample_right = sample_left;
+                }
+                else
+                {
+                    DeinterleaveAvx2(args.source + 2 * static_cast<std::size_t>(i), sample_left, sample_right);
+                }
+
+                if constexpr (kEnvelope)
+                {
+                    const __m256 e = _mm256_loadu_ps(args.envelope + i);
+                    sample_left = _mm256_mul_ps(sample_left, e);
+                    sample_right = _mm256_mul_ps(sample_right, e);
+                }
+
+                if constexpr (kRamp)
+                {
+                    const __m256 x = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane_offsets);
+                    gain_left = _mm256_add_ps(start_left, _mm256_mul_ps(step_left, x));
+                    gain_right = _mm256_add_ps(start_right, _mm256_mul_ps(step_right, x));
+                }
+
+                _mm256_storeu_ps(args.left + i, _mm256_add_ps(_mm256_loadu_ps(args.left + i), _mm256_mul_ps(sample_left, gain_left)));
+                _mm256_storeu_ps(args.right + i, _mm256_add_ps(_mm256_loadu_ps(args.right + i), _mm256_mul_ps(sample_right, gain_right)));
+            }
+
+            MixSse2<kSourceChannels, kEnvelope, kRamp>(args, i);
+        }
+
+        template <bool kRamp>
+        DECL_AUDIO_TARGET_AVX2 void PanAvx2(const PanArgs &args, const std::uint32_t begin) noexcept
+        {
+            __m256 start[kMaxOutputChannels];
+            __m256 step[kMaxOutputChannels];
+            for (std::uint32_t c = 0; c < args.channel_count; ++c)
+            {
+                start[c] = _mm256_set1_ps(args.start[c]);
+                step[c] = kRamp ? _mm256_set1_ps(args.step[c]) : _mm256_setzero_ps();
+            }
+
+            const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            std::uint32_t i = begin;
+            for (; i + 8 <= args.frames; i += 8)
+            {
+                const __m256 sample = _mm256_loadu_ps(args.source + i);
+                const __m256 x = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane_offsets);
+                for (std::uint32_t c = 0; c < args.channel_count; ++c)
+                {
+                    __m256 gain = start[c];
+                    if constexpr (kRamp)
+                    {
+                        gain = _mm256_add_ps(start[c], _mm256_mul_ps(step[c], x));
+                    }
+
+                    float *output = args.outputs[c] + i;
+                    _mm256_storeu_ps(output, _mm256_add_ps(_mm256_loadu_ps(output), _mm256_mul_ps(sample, gain)));
+                }
+            }
+
+            PanSse2<kRamp>(args, i);
+        }
+
+        // Same lane layout as ResampleSse2 over 8 lanes, gathering both
+        // neighbours.
+        template <std::uint32_t kChannels>
+        DECL_AUDIO_TARGET_AVX2 void ResampleAvx2(const ResampleArgs &args, const std::uint32_t begin) noexcept
+        {
+            constexpr std::uint32_t kFrames = 8 / kChannels;
+            const __m256 scale = _mm256_set1_ps(kFractionScale);
+
+            std::uint32_t i = begin;
+            for (; i + kFrames <= args.frames; i += kFrames)
+            {
+                alignas(32) std::int32_t offset[8];
+                alignas(32) std::int32_t fraction[8];
+                for (std::uint32_t lane = 0; lane < 8; lane += kChannels)
+                {
+                    ResamplePosition<kChannels>(args, i + lane / kChannels, offset[lane], fraction[lane]);
+                    for (std::uint32_t c = 0; c < kChannels; ++c)
+                    {
+                        offset[lane + c] = offset[lane] + static_cast<std::int32_t>(c);
+                        fraction[lane + c] = fraction[lane];
+                    }
+                }
+
+                const __m256i index = _mm256_load_si256(reinterpret_cast<const __m256i *>(offset));
+                const __m256 a = _mm256_i32gather_ps(args.source, index, 4);
+                const __m256 b = _mm256_i32gather_ps(args.source + kChannels, index, 4);
+                const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_load_si256(reinterpret_cast<const __m256i *>(fraction))), scale);
+                _mm256_storeu_ps(args.output + static_cast<std::size_t>(i) * kChannels, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t)));
+            }
+
+            ResampleSse2<kChannels>(args, i);
+        }
+
+        DECL_AUDIO_TARGET_AVX2 void WidenAvx2(const std::int16_t *source, float *output, const std::uint32_t begin, const std::uint32_t count) noexcept
+        {
+            const __m256 scale = _mm256_set1_ps(kS16Scale);
+
+            std::uint32_t i = begin;
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)));
+                const __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i + 8)));
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+                _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+            }
+
+            WidenSse2(source, output, i, count);
+        }
+        DECL_AUDIO_TARGET_AVX2 void SpectrumMacAvx2(const float *x, const float *h, float *acc, const std::uint32_t begin, const std::uint32_t bins) noexcept
+        {
+            const float *x_im = x + bins;
+            const float *h_im = h + bins;
+            float *acc_im = acc + bins;
+            std::uint32_t k = begin;
+            for (; k + 8 <= bins; k += 8)
+            {
+                const __m256 xr = _mm256_loadu_ps(x + k);
+                const __m256 xi = _mm256_loadu_ps(x_im + k);
+                const __m256 hr = _mm256_loadu_ps(h + k);
+                const __m256 hi = _mm256_loadu_ps(h_im + k);
+                _mm256_storeu_ps(acc + k, _mm256_add_ps(_mm256_loadu_ps(acc + k), _mm256_sub_ps(_mm256_mul_ps(xr, hr), _mm256_mul_ps(xi, hi))));
+                _mm256_storeu_ps(acc_im + k, _mm256_add_ps(_mm256_loadu_ps(acc_im + k), _mm256_add_ps(_mm256_mul_ps(xr, hi), _mm256_mul_ps(xi, hr))));
+            }
+
+            SpectrumMacSse2(x, h, acc, k, bins);
+        }
+
+        DECL_AUDIO_TARGET_AVX2 void FramePeakAvx2(const float *const *channels, const std::uint32_t channel_count, const std::uint32_t begin, const std::uint32_t frames, float *peaks) noexcept
+        {
+            const __m256 magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+            std::uint32_t i = begin;
+            for (; i + 8 <= frames; i += 8)
+            {
+                __m256 peak = _mm256_setzero_ps();
+                for (std::uint32_t c = 0; c < channel_count; ++c)
+                {
+                    peak = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(channels[c] + i), magnitude), peak);
+                }
+                _mm256_storeu_ps(peaks + i, peak);
+            }
+
+            FramePeakSse2(channels, channel_count, i, frames, peaks);
+        }
+
+        // BiquadBlocksSse2 for two channels at once, one per 128-bit half.
+        // Every shuffle stays within its half, so each half computes exactly
+        // what the SSE2 body would.
+        DECL_AUDIO_TARGET_AVX2 void BiquadPairAvx2(float *first, float *second, const std::uint32_t block_frames, const BiquadCoefficients &coefficients, BiquadState &first_state, BiquadState &second_state) noexcept
+        {
+            __m256 column[8];
+            for (std::uint32_t j = 0; j < 8; ++j)
+            {
+                column[j] = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(coefficients.block[j]));
+            }
+            __m256 history = _mm256_setr_ps(first_state.x1, first_state.x2, first_state.y1, first_state.y2,
+                                            second_state.x1, second_state.x2, second_state.y1, second_state.y2);
+
+            for (std::uint32_t i = 0; i < block_frames; i += 4)
+            {
+                const __m256 input = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(first + i)), _mm_loadu_ps(second + i), 1);
+                __m256 acc = _mm256_mul_ps(column[0], _mm256_permute_ps(input, _MM_SHUFFLE(0, 0, 0, 0)));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[1], _mm256_permute_ps(input, _MM_SHUFFLE(1, 1, 1, 1))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[2], _mm256_permute_ps(input, _MM_SHUFFLE(2, 2, 2, 2))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[3], _mm256_permute_ps(input, _MM_SHUFFLE(3, 3, 3, 3))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[4], _mm256_permute_ps(history, _MM_SHUFFLE(0, 0, 0, 0))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[5], _mm256_permute_ps(history, _MM_SHUFFLE(1, 1, 1, 1))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[6], _mm256_permute_ps(history, _MM_SHUFFLE(2, 2, 2, 2))));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(column[7], _mm256_permute_ps(history, _MM_SHUFFLE(3, 3, 3, 3))));
+                history = _mm256_shuffle_ps(input, acc, _MM_SHUFFLE(2, 3, 2, 3));
+                _mm_storeu_ps(first + i, _mm256_castps256_ps128(acc));
+                _mm_storeu_ps(second + i, _mm256_extractf128_ps(acc, 1));
+            }
+
+            alignas(32) float saved[8];
+            _mm256_store_ps(saved, history);
+            first_state = BiquadState{saved[0], saved[1], saved[2], saved[3]};
+            second_state = BiquadState{saved[4], saved[5], saved[6], saved[7]};
+        }
+#endif
+
+        template <SimdLevel kLevel, std::uint32_t kSourceChannels, bool kEnvelope, bool kRamp>
+        void Mix(const KernelArgs &args) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                MixAvx2<kSourceChannels, kEnvelope, kRamp>(args, 0);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                MixSse2<kSourceChannels, kEnvelope, kRamp>(args, 0);
+                return;
+            }
+#endif
+            MixScalar<kSourceChannels, kEnvelope, kRamp>(args, 0);
+        }
+
+        // Entry points with the public kernel signatures.
+
+        template <SimdLevel kLevel, std::uint32_t kSourceChannels>
+        void MixFlat(const float *source, float *left, float *right, const std::uint32_t frames, const MixGains gains) noexcept
+        {
+            Mix<kLevel, kSourceChannels, false, false>(KernelArgs{source, left, right, frames, gains, MixGains{}, nullptr});
+        }
+
+        template <SimdLevel kLevel, std::uint32_t kSourceChannels>
+        void MixEnveloped(const float *source, float *left, float *right, const std::uint32_t frames, const MixGains gains, const float *envelope) noexcept
+        {
+            Mix<kLevel, kSourceChannels, true, false>(KernelArgs{source, left, right, frames, gains, MixGains{}, envelope});
+        }
+
+        template <SimdLevel kLevel, std::uint32_t kSourceChannels>
+        void MixRamped(const float *source, float *left, float *right, const std::uint32_t frames, const MixGains start, const MixGains step, const float *envelope) noexcept
+        {
+            const KernelArgs args{source, left, right, frames, start, step, envelope};
+            if (envelope != nullptr)
+            {
+                Mix<kLevel, kSourceChannels, true, true>(args);
+            }
+            else
+            {
+                Mix<kLevel, kSourceChannels, false, true>(args);
+            }
+        }
+
+        template <SimdLevel kLevel, bool kRamp>
+        void Pan(const PanArgs &args) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                PanAvx2<kRamp>(args, 0);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                PanSse2<kRamp>(args, 0);
+                return;
+            }
+#endif
+            PanScalar<kRamp>(args, 0);
+        }
+
+        template <SimdLevel kLevel>
+        void PanToChannels(const float *source, float *const *outputs, const std::uint32_t channel_count, const std::uint32_t frames, const float *start, const float *step) noexcept
+        {
+            const PanArgs args{source, outputs, channel_count, frames, start, step};
+            if (step != nullptr)
+            {
+                Pan<kLevel, true>(args);
+            }
+            else
+            {
+                Pan<kLevel, false>(args);
+            }
+        }
+
+        template <SimdLevel kLevel, std::uint32_t kChannels>
+        void Resample(const ResampleArgs &args) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                ResampleAvx2<kChannels>(args, 0);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                ResampleSse2<kChannels>(args, 0);
+                return;
+            }
+#endif
+            ResampleScalar<kChannels>(args, 0);
+        }
+
+        template <SimdLevel kLevel>
+        void ResampleLinear(const float *source, const std::uint32_t channel_count, const std::uint64_t position, const std::uint32_t step, float *output, const std::uint32_t frames) noexcept
+        {
+            const ResampleArgs args{source, position, step, output, frames};
+            if (channel_count == 1)
+            {
+                Resample<kLevel, 1>(args);
+            }
+            else
+            {
+                Resample<kLevel, 2>(args);
+            }
+        }
+
+        template <SimdLevel kLevel>
+        void WidenS16(const std::int16_t *source, float *output, const std::uint32_t count) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                WidenAvx2(source, output, 0, count);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                WidenSse2(source, output, 0, count);
+                return;
+            }
+#endif
+            WidenScalar(source, output, 0, count);
+        }
+
+        // Blocks run across channels at the widest level that fits (AVX2
+        // pairs channels, an odd one drops to SSE2); every channel's tail
+        // runs the shared direct form.
+        template <SimdLevel kLevel>
+        void Biquad(float *const *channels, const std::uint32_t channel_count, const std::uint32_t frames, const BiquadCoefficients &coefficients, BiquadState *states) noexcept
+        {
+            const std::uint32_t block_frames = frames & ~3u;
+            std::uint32_t c = 0;
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                for (; c + 2 <= channel_count; c += 2)
+                {
+                    BiquadPairAvx2(channels[c], channels[c + 1], block_frames, coefficients, states[c], states[c + 1]);
+                }
+            }
+            if constexpr (kLevel != SimdLevel::Scalar)
+            {
+                for (; c < channel_count; ++c)
+                {
+                    BiquadBlocksSse2(channels[c], block_frames, coefficients, states[c]);
+                }
+            }
+#endif
+            for (; c < channel_count; ++c)
+            {
+                BiquadBlocksScalar(channels[c], block_frames, coefficients, states[c]);
+            }
+
+            for (c = 0; c < channel_count; ++c)
+            {
+                BiquadTail(channels[c], block_frames, frames, coefficients, states[c]);
+            }
+        }
+
+        template <SimdLevel kLevel>
+        void SpectrumMac(const float *x, const float *h, float *acc, const std::uint32_t bins) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                SpectrumMacAvx2(x, h, acc, 0, bins);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                SpectrumMacSse2(x, h, acc, 0, bins);
+                return;
+            }
+#endif
+            SpectrumMacScalar(x, h, acc, 0, bins);
+        }
+
+        template <SimdLevel kLevel>
+        void FramePeak(const float *const *channels, const std::uint32_t channel_count, const std::uint32_t frames, float *peaks) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                FramePeakAvx2(channels, channel_count, 0, frames, peaks);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                FramePeakSse2(channels, channel_count, 0, frames, peaks);
+                return;
+            }
+#endif
+            FramePeakScalar(channels, channel_count, 0, frames, peaks);
+        }
+
+        template <SimdLevel kLevel>
+        constexpr MixKernels MakeKernels() noexcept
+        {
+            return MixKernels{kLevel,
+                              &MixFlat<kLevel, 1>,
+                              &MixFlat<kLevel, 2>,
+                              &MixEnveloped<kLevel, 1>,
+                              &MixEnveloped<kLevel, 2>,
+                              &MixRamped<kLevel, 1>,
+                              &MixRamped<kLevel, 2>,
+                              &PanToChannels<kLevel>,
+                              &ResampleLinear<kLevel>,
+                              &WidenS16<kLevel>,
+                              &Biquad<kLevel>,
+                              &SpectrumMac<kLevel>,
+                              &FramePeak<kLevel>};
+        }
+
+        constexpr MixKernels kScalarKernels = MakeKernels<SimdLevel::Scalar>();
+#if DECL_AUDIO_X86
+        constexpr MixKernels kSse2Kernels = MakeKernels<SimdLevel::Sse2>();
+        constexpr MixKernels kAvx2Kernels = MakeKernels<SimdLevel::Avx2>();
+#endif
+    } // namespace
+
+    const MixKernels &GetMixKernels(const SimdLevel level) noexcept
+    {
+#if DECL_AUDIO_X86
+        switch (level)
+        {
+        case SimdLevel::Avx2:
+            return kAvx2Kernels;
+        case SimdLevel::Sse2:
+            return kSse2Kernels;
+        case SimdLevel::Scalar:
+            break;
+        }
+#else
+        (void)level;
+#endif
+        return kScalarKernels;
+    }
+
+    const MixKernels &GetMixKernels() noexcept
+    {
+        static const MixKernels &selected = GetMixKernels(DetectSimdLevel());
+        return selected;
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../core/CpuFeatures.hpp"
+
+namespace decl_audio::playback
+{
+    // Per-channel gain for one voice's contribution to the stereo bus: the
+    // voice's node gain already folded together with the instance's spatial
+    // left/right gains.
+    struct MixGains final
+    {
+        float left = 1.0f;
+        float right = 1.0f;
+
+        [[nodiscard]] friend bool operator==(const MixGains &, const MixGains &) noexcept = default;
+    };
+
+    // Accumulate-with-gain into a planar stereo bus:
+    //   left[f]  += source(f, 0) * gains.left
+    //   right[f] += source(f, 1) * gains.right
+    // Mono sources feed the one channel to both sides; stereo sources are the
+    // assets' interleaved L/R frames. The enveloped form additionally scales each
+    // frame by envelope[f] (the instance's start/stop fade), applied to the
+    // source sample before the channel gain. The ramped form uses a per-frame
+    // gain of start + step * f instead of a constant, and takes the envelope as
+    // optional (null for none). `left` and `right` may be the same array (a mono
+    // bus takes both contributions); otherwise no argument may overlap another.
+    // Every variant uses the same multiply/add order and no FMA, so all ISAs
+    // produce bit-identical results.
+    using MixKernel = void (*)(const float *source, float *left, float *right, std::uint32_t frames, MixGains gains) noexcept;
+    using EnvelopedMixKernel = void (*)(const float *source, float *left, float *right, std::uint32_t frames, MixGains gains, const float *envelope) noexcept;
+    using RampedMixKernel = void (*)(const float *source, float *left, float *right, std::uint32_t frames, MixGains start, MixGains step, const float *envelope) noexcept;
+
+    // Spreads a planar mono source over up to kMaxOutputChannels bus channels:
+    //   outputs[c][f] += source[f] * gain_c(f)
+    // where gain_c(f) is start[c], or start[c] + step[c] * f when `step` is not
+    // null. Each source vector is loaded once and added into every channel. No
+    // output may overlap the source or another output. Same bit-identity rule
+    // as the voice kernels.
+    using PanKernel = void (*)(const float *source, float *const *outputs, std::uint32_t channel_count, std::uint32_t frames, const float *start, const float *step) noexcept;
+
+    // Voice read positions and playback rates are fixed point with
+    // kRateFractionBits fractional bits: frame f is f << kRateFractionBits, and
+    // a rate of kUnityRate advances one source frame per output frame.
+    inline constexpr std::uint32_t kRateFractionBits = 16;
+    inline constexpr std::uint32_t kUnityRate = 1u << kRateFractionBits;
+
+    // Linear-interpolating resampler into an interleaved run:
+    //   p(f)         = position + step * f   (fixed point, relative to `source`)
+    //   output(f, c) = a + (b - a) * fraction(p(f))
+    // with a and b channel c of source frames floor(p(f)) and floor(p(f)) + 1,
+    // for 1 or 2 channels. The caller keeps every floor(p(f)) + 1 inside the
+    // source. `output` is overwritten and may not overlap the source. Positions
+    // are integer arithmetic and the lerp has one operation order, so all ISAs
+    // produce bit-identical results.
+    using ResampleKernel = void (*)(const float *source, std::uint32_t channel_count, std::uint64_t position, std::uint32_t step, float *output, std::uint32_t frames) noexcept;
+
+    // Widens 16-bit PCM to float, output[i] = source[i] / 32768, for voices
+    // mixing S16 assets. Exact at every level.
+    using WidenS16Kernel = void (*)(const std::int16_t *source, float *output, std::uint32_t count) noexcept;
+
+    // A normalized biquad (a0 = 1) in two forms. `block` maps the vector
+    //   v = (x[n], x[n+1], x[n+2], x[n+3], x[n-1], x[n-2], y[n-1], y[n-2])
+    // to the next four outputs, y[n+k] = sum_j block[j][k] * v[j], which is the
+    // recursion unrolled so a 4-frame block is eight independent
+    // multiply-adds across the lanes instead of a serial chain. The direct
+    // form-I terms filter the frames left over after the last whole block.
+    struct BiquadCoefficients final
+    {
+        alignas(16) float block[8][4] = {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}};
+        float b0 = 1.0f;
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+        float a1 = 0.0f;
+        float a2 = 0.0f;
+    };
+
+    // One channel's history: the last two inputs and outputs, newest first.
+    struct BiquadState final
+    {
+        float x1 = 0.0f;
+        float x2 = 0.0f;
+        float y1 = 0.0f;
+        float y2 = 0.0f;
+    };
+
+    // Filters `channel_count` planar channels of `frames` frames in place,
+    // carrying channels[c]'s history in states[c]. Whole 4-frame blocks use
+    // the block form with one accumulation order (block[0] term first, no
+    // FMA) and the remainder uses the direct form, so all ISAs produce
+    // bit-identical results. History that decays below the float normal range
+    // is flushed to zero at the end of each call, so a silent tail cannot leave
+    // the recursion grinding through denormals.
+    using BiquadKernel = void (*)(float *const *channels, std::uint32_t channel_count, std::uint32_t frames, const BiquadCoefficients &coefficients, BiquadState *states) noexcept;
+
+    // Complex multiply-accumulate over half spectra stored split: `bins` real
+    // parts followed by `bins` imaginary parts. For every bin k
+    //   acc[k] += x[k] * h[k]
+    // with the real part as (xr * hr - xi * hi) and the imaginary part as
+    // (xr * hi + xi * hr), each added to the accumulator last. `acc` may not
+    // overlap `x` or `h`. One operation order and no FMA, so all ISAs produce
+    // bit-identical results.
+    using SpectrumMacKernel = void (*)(const float *x, const float *h, float *acc, std::uint32_t bins) noexcept;
+
+    // The peak level of each frame across `channel_count` planar channels:
+    //   peaks[f] = max over c of |channels[c][f]|
+    // (0 with no channels), overwriting `peaks`, which may not overlap a
+    // channel. Absolute value and max are exact and every level selects the
+    // same operand, so all ISAs produce bit-identical results.
+    using FramePeakKernel = void (*)(const float *const *channels, std::uint32_t channel_count, std::uint32_t frames, float *peaks) noexcept;
+
+    struct MixKernels final
+    {
+        SimdLevel level = SimdLevel::Scalar;
+        MixKernel mono_to_stereo = nullptr;   // source: 1 float per frame
+        MixKernel stereo_to_stereo = nullptr; // source: 2 interleaved floats per frame
+        EnvelopedMixKernel mono_to_stereo_enveloped = nullptr;
+        EnvelopedMixKernel stereo_to_stereo_enveloped = nullptr;
+        RampedMixKernel mono_to_stereo_ramped = nullptr;
+        RampedMixKernel stereo_to_stereo_ramped = nullptr;
+        PanKernel mono_to_channels = nullptr;
+        ResampleKernel resample_linear = nullptr;
+        WidenS16Kernel widen_s16 = nullptr;
+        BiquadKernel biquad = nullptr;
+        SpectrumMacKernel spectrum_mac = nullptr;
+        FramePeakKernel frame_peak = nullptr;
+    };
+
+    // The table for the best level this CPU supports, detected on first use and
+    // cached for the life of the process. The audio thread only ever calls this.
+    [[nodiscard]] const MixKernels &GetMixKernels() noexcept;
+
+    // The table for a specific level, for tests and benchmarks. The caller must
+    // not request a level above DetectSimdLevel(); on non-x86 builds every level
+    // resolves to the scalar table.
+    [[nodiscard]] const MixKernels &GetMixKernels(SimdLevel level) noexcept;
+} // namespace decl_audio::playback
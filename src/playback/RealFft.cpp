@@ -0,0 +1,133 @@
+#include "pch.h"
+
+#include "RealFft.hpp"
+
+#include <cmath>
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+    } // namespace
+
+    RealFft::RealFft(const std::uint32_t size)
+        : size_(size),
+          half_(size / 2),
+          bit_reverse_(size / 2),
+          twiddle_re_(size / 4),
+          twiddle_im_(size / 4),
+          split_re_(size / 2 + 1),
+          split_im_(size / 2 + 1),
+          work_re_(size / 2),
+          work_im_(size / 2)
+    {
+        std::uint32_t bits = 0;
+        while ((1u << bits) < half_)
+            ++bits;
+
+        for (std::uint32_t index = 0; index < half_; ++index)
+        {
+            std::uint32_t reversed = 0;
+            for (std::uint32_t bit = 0; bit < bits; ++bit)
+                reversed |= ((index >> bit) & 1u) << (bits - 1 - bit);
+            bit_reverse_[index] = reversed;
+        }
+
+        // Built in double so every table entry is the correctly rounded value.
+        for (std::uint32_t k = 0; k < half_ / 2; ++k)
+        {
+            const double angle = -2.0 * kPi * static_cast<double>(k) / static_cast<double>(half_);
+            twiddle_re_[k] = static_cast<float>(std::cos(angle));
+            twiddle_im_[k] = static_cast<float>(std::sin(angle));
+        }
+        for (std::uint32_t k = 0; k <= half_; ++k)
+        {
+            const double angle = -2.0 * kPi * static_cast<double>(k) / static_cast<double>(size_);
+            split_re_[k] = static_cast<float>(std::cos(angle));
+            split_im_[k] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    void RealFft::Forward(const float *input, float *spectrum) noexcept
+    {
+        // Sample pairs become one complex sample each: z[n] = x[2n] + i x[2n + 1].
+        for (std::uint32_t n = 0; n < half_; ++n)
+        {
+            work_re_[bit_reverse_[n]] = input[2 * n];
+            work_im_[bit_reverse_[n]] = input[2 * n + 1];
+        }
+        Transform(false);
+
+        // Z[k] = E[k] + i O[k], with E and O the spectra of the even and odd
+        // samples; X[k] = E[k] + W^k O[k].
+        float *re = spectrum;
+        float *im = spectrum + half_ + 1;
+        for (std::uint32_t k = 0; k <= half_; ++k)
+        {
+            const std::uint32_t a = k == half_ ? 0 : k;
+            const std::uint32_t b = k == 0 ? 0 : half_ - k;
+            const float even_re = 0.5f * (work_re_[a] + work_re_[b]);
+            const float even_im = 0.5f * (work_im_[a] - work_im_[b]);
+            const float odd_re = 0.5f * (work_im_[a] + work_im_[b]);
+            const float odd_im = -0.5f * (work_re_[a] - work_re_[b]);
+            re[k] = even_re + (split_re_[k] * odd_re - split_im_[k] * odd_im);
+            im[k] = even_im + (split_re_[k] * odd_im + split_im_[k] * odd_re);
+        }
+    }
+
+    void RealFft::Inverse(const float *spectrum, float *output) noexcept
+    {
+        const float *re = spectrum;
+        const float *im = spectrum + half_ + 1;
+        for (std::uint32_t k = 0; k < half_; ++k)
+        {
+            // E[k] = (X[k] + conj X[half - k]) / 2 and
+            // O[k] = (X[k] - conj X[half - k]) conj(W^k) / 2.
+            const float mirror_re = re[half_ - k];
+            const float mirror_im = -im[half_ - k];
+            const float even_re = 0.5f * (re[k] + mirror_re);
+            const float even_im = 0.5f * (im[k] + mirror_im);
+            const float diff_re = 0.5f * (re[k] - mirror_re);
+            const float diff_im = 0.5f * (im[k] - mirror_im);
+            const float odd_re = diff_re * split_re_[k] + diff_im * split_im_[k];
+            const float odd_im = diff_im * split_re_[k] - diff_re * split_im_[k];
+            work_re_[bit_reverse_[k]] = even_re - odd_im;
+            work_im_[bit_reverse_[k]] = even_im + odd_re;
+        }
+        Transform(true);
+
+        const float scale = 1.0f / static_cast<float>(half_);
+        for (std::uint32_t n = 0; n < half_; ++n)
+        {
+            output[2 * n] = work_re_[n] * scale;
+            output[2 * n + 1] = work_im_[n] * scale;
+        }
+    }
+
+    void RealFft::Transform(const bool inverse) noexcept
+    {
+        const float sign = inverse ? -1.0f : 1.0f;
+        for (std::uint32_t length = 2; length <= half_; length <<= 1)
+        {
+            const std::uint32_t span = length / 2;
+            const std::uint32_t stride = half_ / length;
+            for (std::uint32_t first = 0; first < half_; first += length)
+            {
+                for (std::uint32_t j = 0; j < span; ++j)
+                {
+                    const float w_re = twiddle_re_[j * stride];
+                    const float w_im = sign * twiddle_im_[j * stride];
+                    const std::uint32_t a = first + j;
+                    const std::uint32_t b = a + span;
+                    const float t_re = w_re * work_re_[b] - w_im * work_im_[b];
+                    const float t_im = w_re * work_im_[b] + w_im * work_re_[b];
+                    work_re_[b] = work_re_[a] - t_re;
+                    work_im_[b] = work_im_[a] - t_im;
+                    work_re_[a] += t_re;
+                    work_im_[a] += t_im;
+                }
+            }
+        }
+    }
+} // namespace decl_audio::playback
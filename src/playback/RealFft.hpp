@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace decl_audio::playback
+{
+    // Radix-2 FFT of a real signal of a fixed power-of-two size, computed as a
+    // complex FFT of half that size over the even/odd sample pairs. Spectra
+    // are the size / 2 + 1 non-negative bins stored split: the real parts,
+    // then the imaginary parts (the layout SpectrumMacKernel takes).
+    //
+    // Tables and the work buffer are allocated at construction; Forward and
+    // Inverse allocate nothing, but share that buffer, so one instance serves
+    // one thread.
+    class RealFft final
+    {
+    public:
+        // `size` must be a power of two, at least 4.
+        explicit RealFft(std::uint32_t size);
+
+        [[nodiscard]] std::uint32_t Size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] std::uint32_t BinCount() const noexcept
+        {
+            return half_ + 1;
+        }
+
+        // The unnormalized DFT of `size` samples of `input`.
+        void Forward(const float *input, float *spectrum) noexcept;
+        // The inverse of Forward (scaled by 1 / size) into `size` samples.
+        void Inverse(const float *spectrum, float *output) noexcept;
+
+    private:
+        // In-place complex FFT of the bit-reversed work buffer; `inverse` runs
+        // it with conjugated twiddles and no scaling.
+        void Transform(bool inverse) noexcept;
+
+        std::uint32_t size_ = 0;
+        std::uint32_t half_ = 0;
+        std::vector<std::uint32_t> bit_reverse_; // half_ entries
+        // e^(-2 pi i k / half_) for k < half_ / 2: the complex FFT's twiddles.
+        std::vector<float> twiddle_re_;
+        std::vector<float> twiddle_im_;
+        // e^(-2 pi i k / size_) for k <= half_: joins the even and odd halves.
+        std::vector<float> split_re_;
+        std::vector<float> split_im_;
+        std::vector<float> work_re_;
+        std::vector<float> work_im_;
+    };
+} // namespace decl_audio::playback
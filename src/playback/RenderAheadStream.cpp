@@ -0,0 +1,117 @@
+#include "pch.h"
+
+#include "RenderAheadStream.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // Best effort: without the privilege for it the thread just keeps its
+        // normal priority, which the queue depth is there to absorb.
+        void RaiseCurrentThreadPriority() noexcept
+        {
+#if defined(_WIN32)
+            (void)SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+            sched_param param{};
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+            (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+        }
+    } // namespace
+
+    RenderAheadStream::RenderAheadStream(AudioRuntime &runtime,
+                                         const std::uint32_t channel_count,
+                                         const std::uint32_t block_frames,
+                                         const std::uint32_t target_frames,
+                                         const std::uint32_t headroom_frames)
+        : runtime_(runtime),
+          fifo_(channel_count, target_frames + headroom_frames),
+          bus_(channel_count, block_frames),
+          interleaved_(static_cast<std::size_t>(channel_count) * block_frames),
+          block_frames_(block_frames),
+          target_frames_(target_frames),
+          wake_below_frames_(target_frames > block_frames ? target_frames - block_frames + 1 : target_frames)
+    {
+        if (block_frames_ == 0 || headroom_frames < block_frames_)
+        {
+            std::terminate();
+        }
+
+        // Prime on the constructing thread: the device has not started, so the
+        // first callback already finds a full queue.
+        RenderToTarget();
+        thread_ = std::thread([this]() { ThreadMain(); });
+    }
+
+    RenderAheadStream::~RenderAheadStream()
+    {
+        stopping_.store(true, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void RenderAheadStream::Read(float *output, const std::uint32_t frames) noexcept
+    {
+        const std::uint32_t read = fifo_.Read(output, frames);
+        if (read < frames)
+        {
+            const std::uint32_t channel_count = fifo_.ChannelCount();
+            std::fill(output + static_cast<std::size_t>(read) * channel_count, output + static_cast<std::size_t>(frames) * channel_count, 0.0f);
+            underrun_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Pairs with the fence in ThreadMain: either this sees the thread
+        // parked, or the thread sees this read's room before it parks.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed) && fifo_.ReadableFrames() < wake_below_frames_)
+        {
+            wake_.fetch_add(1, std::memory_order_release);
+            wake_.notify_one();
+        }
+    }
+
+    void RenderAheadStream::ThreadMain() noexcept
+    {
+        RaiseCurrentThreadPriority();
+        while (true)
+        {
+            // Sample the wake counter before checking the queue: a Read that
+            // lands after this point changes it, so the wait below cannot miss it.
+            const std::uint32_t seen = wake_.load(std::memory_order_acquire);
+            if (stopping_.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            RenderToTarget();
+
+            parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (fifo_.ReadableFrames() >= wake_below_frames_)
+            {
+                wake_.wait(seen, std::memory_order_acquire);
+            }
+            parked_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void RenderAheadStream::RenderToTarget() noexcept
+    {
+        while (fifo_.ReadableFrames() < target_frames_ && fifo_.WritableFrames() >= block_frames_)
+        {
+            runtime_.Render(bus_, block_frames_);
+            bus_.InterleaveTo(interleaved_.data(), block_frames_);
+            (void)fifo_.Write(interleaved_.data(), block_frames_);
+        }
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "AudioRuntime.hpp"
+#include "MixBus.hpp"
+#include "SampleFifo.hpp"
+
+namespace decl_audio::playback
+{
+    // Mixes ahead of the device on a dedicated high-priority thread. The thread
+    // keeps `target_frames` of finished output queued in a SampleFifo, so the
+    // device callback only copies; a slow Render eats into the queue instead
+    // of missing the deadline. Latency grows by the queue depth.
+    //
+    // While a stream is alive it is the runtime's only renderer.
+    class RenderAheadStream final
+    {
+    public:
+        // Renders in `block_frames` blocks (<= the runtime's max_block_frames).
+        // The FIFO holds target_frames + headroom_frames; headroom_frames must
+        // be at least block_frames so a block always fits below the target.
+        // The queue is filled to the target before the constructor returns.
+        RenderAheadStream(AudioRuntime &runtime,
+                          std::uint32_t channel_count,
+                          std::uint32_t block_frames,
+                          std::uint32_t target_frames,
+                          std::uint32_t headroom_frames);
+        ~RenderAheadStream();
+
+        RenderAheadStream(const RenderAheadStream &) = delete;
+        RenderAheadStream &operator=(const RenderAheadStream &) = delete;
+
+        // Device side: copies `frames` interleaved frames out of the queue.
+        // Never blocks; frames the queue cannot cover are silence and the call
+        // counts as one underrun.
+        void Read(float *output, std::uint32_t frames) noexcept;
+
+        [[nodiscard]] std::uint32_t UnderrunCount() const noexcept
+        {
+            return underrun_count_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint32_t QueuedFrames() const noexcept
+        {
+            return fifo_.ReadableFrames();
+        }
+
+    private:
+        void ThreadMain() noexcept;
+        void RenderToTarget() noexcept;
+
+        AudioRuntime &runtime_;
+        SampleFifo fifo_;
+        MixBus bus_;
+        std::vector<float> interleaved_;
+        std::uint32_t block_frames_ = 0;
+        std::uint32_t target_frames_ = 0;
+        // Below this many queued frames there is room for a whole block under
+        // the target, so it is worth waking the render thread.
+        std::uint32_t wake_below_frames_ = 0;
+        // Bumped by a Read that finds the render thread parked with room for a
+        // block (and at shutdown); the render thread parks on it. Reads that
+        // find it running or with nothing to do skip the notify, so most
+        // callbacks make no wake syscall.
+        std::atomic<std::uint32_t> wake_{0};
+        std::atomic<bool> parked_{false};
+        std::atomic<bool> stopping_{false};
+        std::atomic<std::uint32_t> underrun_count_{0};
+        std::thread thread_;
+    };
+} // namespace decl_audio::playback
@@ -0,0 +1,124 @@
+#include "pch.h"
+
+#include "RenderWorkerPool.hpp"
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // Polls before parking, so back-to-back blocks hand off without a futex
+        // round trip while an idle engine still sleeps.
+        constexpr std::uint32_t kSpinsBeforePark = 256;
+
+        [[nodiscard]] constexpr std::uint64_t PackCursor(const std::uint32_t batch, const std::uint32_t next_task) noexcept
+        {
+            return (static_cast<std::uint64_t>(batch) << 32U) | next_task;
+        }
+    } // namespace
+
+    RenderWorkerPool::RenderWorkerPool(const std::uint32_t worker_count)
+    {
+        threads_.reserve(worker_count);
+        for (std::uint32_t i = 0; i < worker_count; ++i)
+        {
+            threads_.emplace_back([this, i]() { WorkerMain(i + 1); });
+        }
+    }
+
+    RenderWorkerPool::~RenderWorkerPool()
+    {
+        stopping_.store(true, std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_release);
+        generation_.notify_all();
+        for (std::thread &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void RenderWorkerPool::Run(const TaskFunction task, void *context, const std::uint32_t task_count) noexcept
+    {
+        if (task_count == 0)
+        {
+            return;
+        }
+
+        const std::uint32_t batch = generation_.load(std::memory_order_relaxed) + 1;
+
+        task_.store(task, std::memory_order_relaxed);
+        context_.store(context, std::memory_order_relaxed);
+        task_count_.store(task_count, std::memory_order_relaxed);
+        completed_tasks_.store(0, std::memory_order_relaxed);
+        cursor_.store(PackCursor(batch, 0), std::memory_order_release);
+
+        if (!threads_.empty())
+        {
+            generation_.store(batch, std::memory_order_release);
+            generation_.notify_all();
+        }
+
+        DrainTasks(batch, 0);
+
+        while (completed_tasks_.load(std::memory_order_acquire) < task_count)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void RenderWorkerPool::WorkerMain(const std::uint32_t executor_index) noexcept
+    {
+        std::uint32_t seen = 0;
+        while (true)
+        {
+            std::uint32_t current = generation_.load(std::memory_order_acquire);
+            for (std::uint32_t spin = 0; current == seen && spin < kSpinsBeforePark; ++spin)
+            {
+                std::this_thread::yield();
+                current = generation_.load(std::memory_order_acquire);
+            }
+
+            if (current == seen)
+            {
+                generation_.wait(seen, std::memory_order_acquire);
+                continue;
+            }
+
+            seen = current;
+            if (stopping_.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            DrainTasks(current, executor_index);
+        }
+    }
+
+    void RenderWorkerPool::DrainTasks(const std::uint32_t batch, const std::uint32_t executor_index) noexcept
+    {
+        std::uint64_t cursor = cursor_.load(std::memory_order_acquire);
+        while (true)
+        {
+            if (static_cast<std::uint32_t>(cursor >> 32U) != batch)
+            {
+                return;
+            }
+
+            const std::uint32_t task_index = static_cast<std::uint32_t>(cursor);
+            if (task_index >= task_count_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            if (!cursor_.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            // The claim succeeded under `batch`, and Run() cannot return (and so
+            // cannot publish another batch) until this task completes.
+            task_.load(std::memory_order_relaxed)(context_.load(std::memory_order_relaxed), task_index, executor_index);
+            completed_tasks_.fetch_add(1, std::memory_order_acq_rel);
+            cursor = cursor_.load(std::memory_order_acquire);
+        }
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace decl_audio::playback
+{
+    // Fixed set of render threads that help the device callback thread work
+    // through a batch of independent tasks. Threads are created at construction
+    // and parked on an atomic between batches; Run() neither allocates nor takes
+    // a lock, so it is safe to call from the audio callback.
+    //
+    // Tasks are claimed dynamically, so which thread runs a task is not fixed.
+    // Determinism is the caller's job: each task must write only to storage
+    // owned by that task (or by the executing thread, via `executor_index`).
+    class RenderWorkerPool final
+    {
+    public:
+        // `executor_index` is 0 for the calling thread and 1..WorkerCount() for
+        // pool threads, so callers can keep per-executor scratch.
+        using TaskFunction = void (*)(void *context, std::uint32_t task_index, std::uint32_t executor_index) noexcept;
+
+        explicit RenderWorkerPool(std::uint32_t worker_count);
+        ~RenderWorkerPool();
+
+        RenderWorkerPool(const RenderWorkerPool &) = delete;
+        RenderWorkerPool &operator=(const RenderWorkerPool &) = delete;
+
+        [[nodiscard]] std::uint32_t WorkerCount() const noexcept
+        {
+            return static_cast<std::uint32_t>(threads_.size());
+        }
+
+        // Runs task(context, i, executor) for every i in [0, task_count) across the
+        // calling thread and the workers, returning once all have finished. The
+        // calling thread always participates, so it never waits on a worker that
+        // has not woken up yet - it just does the work itself.
+        void Run(TaskFunction task, void *context, std::uint32_t task_count) noexcept;
+
+    private:
+        void WorkerMain(std::uint32_t executor_index) noexcept;
+        // Claims and runs tasks of batch `batch` until none are left (or the
+        // batch is already over).
+        void DrainTasks(std::uint32_t batch, std::uint32_t executor_index) noexcept;
+
+        std::vector<std::thread> threads_;
+        // Bumped once per batch (and once at shutdown); parked workers wait on it.
+        std::atomic<std::uint32_t> generation_{0};
+        // (batch << 32) | next unclaimed task. Claiming is a CAS on the whole word,
+        // so a worker that wakes late can never claim a task from a later batch
+        // under this batch's number.
+        std::atomic<std::uint64_t> cursor_{0};
+        std::atomic<std::uint32_t> completed_tasks_{0};
+        std::atomic<bool> stopping_{false};
+        // Batch description, published before the cursor's release store. Atomic
+        // only so a late worker's read of a newer batch is not a data race; its
+        // claim then fails on the batch number.
+        std::atomic<TaskFunction> task_{nullptr};
+        std::atomic<void *> context_{nullptr};
+        std::atomic<std::uint32_t> task_count_{0};
+    };
+} // namespace decl_audio::playback
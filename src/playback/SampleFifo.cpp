@@ -0,0 +1,54 @@
+#include "pch.h"
+
+#include "SampleFifo.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace decl_audio::playback
+{
+    SampleFifo::SampleFifo(const std::uint32_t channel_count, const std::uint32_t capacity_frames)
+        : samples_(static_cast<std::size_t>(channel_count) * capacity_frames, 0.0f),
+          channel_count_(channel_count),
+          capacity_frames_(capacity_frames)
+    {
+    }
+
+    std::uint32_t SampleFifo::ReadableFrames() const noexcept
+    {
+        const std::uint64_t read = read_position_.load(std::memory_order_acquire);
+        const std::uint64_t written = write_position_.load(std::memory_order_acquire);
+        return static_cast<std::uint32_t>(written - read);
+    }
+
+    std::uint32_t SampleFifo::Write(const float *interleaved, const std::uint32_t frames) noexcept
+    {
+        const std::uint64_t written = write_position_.load(std::memory_order_relaxed);
+        const std::uint64_t read = read_position_.load(std::memory_order_acquire);
+        const std::uint32_t count = std::min(frames, capacity_frames_ - static_cast<std::uint32_t>(written - read));
+
+        // At most two runs: up to the end of the storage, then from its start.
+        const std::uint32_t start = static_cast<std::uint32_t>(written % capacity_frames_);
+        const std::uint32_t first = std::min(count, capacity_frames_ - start);
+        std::copy_n(interleaved, static_cast<std::size_t>(first) * channel_count_, samples_.data() + static_cast<std::size_t>(start) * channel_count_);
+        std::copy_n(interleaved + static_cast<std::size_t>(first) * channel_count_, static_cast<std::size_t>(count - first) * channel_count_, samples_.data());
+
+        write_position_.store(written + count, std::memory_order_release);
+        return count;
+    }
+
+    std::uint32_t SampleFifo::Read(float *interleaved, const std::uint32_t frames) noexcept
+    {
+        const std::uint64_t read = read_position_.load(std::memory_order_relaxed);
+        const std::uint64_t written = write_position_.load(std::memory_order_acquire);
+        const std::uint32_t count = std::min(frames, static_cast<std::uint32_t>(written - read));
+
+        const std::uint32_t start = static_cast<std::uint32_t>(read % capacity_frames_);
+        const std::uint32_t first = std::min(count, capacity_frames_ - start);
+        std::copy_n(samples_.data() + static_cast<std::size_t>(start) * channel_count_, static_cast<std::size_t>(first) * channel_count_, interleaved);
+        std::copy_n(samples_.data(), static_cast<std::size_t>(count - first) * channel_count_, interleaved + static_cast<std::size_t>(first) * channel_count_);
+
+        read_position_.store(read + count, std::memory_order_release);
+        return count;
+    }
+} // namespace decl_audio::playback
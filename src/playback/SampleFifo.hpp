@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace decl_audio::playback
+{
+    // Single-producer single-consumer FIFO of interleaved sample frames. Sized
+    // once at construction; Write and Read only copy and publish a position, so
+    // both ends are safe on real-time threads. Positions count frames since
+    // construction and never wrap in practice (64-bit).
+    class SampleFifo final
+    {
+    public:
+        SampleFifo(std::uint32_t channel_count, std::uint32_t capacity_frames);
+
+        SampleFifo(const SampleFifo &) = delete;
+        SampleFifo &operator=(const SampleFifo &) = delete;
+
+        [[nodiscard]] std::uint32_t ChannelCount() const noexcept
+        {
+            return channel_count_;
+        }
+
+        [[nodiscard]] std::uint32_t CapacityFrames() const noexcept
+        {
+            return capacity_frames_;
+        }
+
+        // Frames written and not yet read. Exact on either end; a lower bound
+        // of what the consumer will see, an upper bound for the producer.
+        [[nodiscard]] std::uint32_t ReadableFrames() const noexcept;
+        [[nodiscard]] std::uint32_t WritableFrames() const noexcept
+        {
+            return capacity_frames_ - ReadableFrames();
+        }
+
+        // Producer: appends up to `frames` frames; returns how many fit.
+        std::uint32_t Write(const float *interleaved, std::uint32_t frames) noexcept;
+        // Consumer: takes up to `frames` frames; returns how many were there.
+        std::uint32_t Read(float *interleaved, std::uint32_t frames) noexcept;
+
+    private:
+        std::vector<float> samples_;
+        std::uint32_t channel_count_ = 0;
+        std::uint32_t capacity_frames_ = 0;
+        std::atomic<std::uint64_t> write_position_{0};
+        std::atomic<std::uint64_t> read_position_{0};
+    };
+} // namespace decl_audio::playback
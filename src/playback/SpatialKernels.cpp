@@ -0,0 +1,240 @@
+#include "pch.h"
+
+#include "SpatialKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if DECL_AUDIO_X86
+#include <immintrin.h>
+#endif
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // The pan angle (pan + 1) * pi/4 is taken as pi/4 + u with u = pan * pi/4
+        // in [-pi/4, pi/4], where short Taylor series are accurate to float
+        // precision; sin and cos of the full angle are then (cos u +- sin u) / sqrt 2.
+        constexpr float kQuarterTurn = 0.78539816339744830962f;
+        constexpr float kHalfSqrt2 = 0.70710678118654752440f;
+        constexpr float kSin3 = -1.0f / 6.0f;
+        constexpr float kSin5 = 1.0f / 120.0f;
+        constexpr float kSin7 = -1.0f / 5040.0f;
+        constexpr float kSin9 = 1.0f / 362880.0f;
+        constexpr float kCos2 = -1.0f / 2.0f;
+        constexpr float kCos4 = 1.0f / 24.0f;
+        constexpr float kCos6 = -1.0f / 720.0f;
+        constexpr float kCos8 = 1.0f / 40320.0f;
+
+        constexpr std::uint32_t kCurveSegments = compiler::kAttenuationCurvePoints - 1;
+
+        // `position` is the normalized distance scaled to [0, kCurveSegments].
+        // Shared by every ISA (vector bodies spill their positions and read
+        // lane by lane), so all levels interpolate identically.
+        [[nodiscard]] inline float SampleCurve(const float *curve, const float position) noexcept
+        {
+            const std::uint32_t segment = std::min(static_cast<std::uint32_t>(position), kCurveSegments - 1);
+            const float fraction = position - static_cast<float>(segment);
+            return curve[segment] + (curve[segment + 1] - curve[segment]) * fraction;
+        }
+
+        // Each body handles sources [begin, count) and hands its remainder to the
+        // next narrower ISA, ending in scalar.
+        void SpatializeScalar(const SpatialBatch &batch, const SpatialListener &listener, const std::uint32_t begin) noexcept
+        {
+            for (std::uint32_t i = begin; i < batch.count; ++i)
+            {
+                const float x = batch.position_x[i] - listener.position.x;
+                const float y = batch.position_y[i] - listener.position.y;
+                const float z = batch.position_z[i] - listener.position.z;
+                const float distance = std::sqrt(x * x + y * y + z * z);
+                const float local_x = x * listener.right.x + y * listener.right.y + z * listener.right.z;
+                const float local_z = x * listener.forward.x + y * listener.forward.y + z * listener.forward.z;
+
+                const float fraction = (distance - batch.min_distance[i]) / (batch.max_distance[i] - batch.min_distance[i]);
+                const float position = std::min(std::max(fraction, 0.0f), 1.0f) * static_cast<float>(kCurveSegments);
+                const float attenuation = SampleCurve(batch.attenuation_curve[i], position);
+                const float pan = distance > 0.0f ? std::min(std::max(local_x / distance, -1.0f), 1.0f) : 0.0f;
+
+                const float u = pan * kQuarterTurn;
+                const float u2 = u * u;
+                const float sin_u = ((((kSin9 * u2 + kSin7) * u2 + kSin5) * u2 + kSin3) * u2 + 1.0f) * u;
+                const float cos_u = (((kCos8 * u2 + kCos6) * u2 + kCos4) * u2 + kCos2) * u2 + 1.0f;
+
+                batch.gain_left[i] = ((cos_u - sin_u) * kHalfSqrt2) * attenuation;
+                batch.gain_right[i] = ((cos_u + sin_u) * kHalfSqrt2) * attenuation;
+                batch.attenuation[i] = attenuation;
+                batch.local_x[i] = local_x;
+                batch.local_z[i] = local_z;
+            }
+        }
+
+#if DECL_AUDIO_X86
+        void SpatializeSse2(const SpatialBatch &batch, const SpatialListener &listener, const std::uint32_t begin) noexcept
+        {
+            const __m128 listener_x = _mm_set1_ps(listener.position.x);
+            const __m128 listener_y = _mm_set1_ps(listener.position.y);
+            const __m128 listener_z = _mm_set1_ps(listener.position.z);
+            const __m128 right_x = _mm_set1_ps(listener.right.x);
+            const __m128 right_y = _mm_set1_ps(listener.right.y);
+            const __m128 right_z = _mm_set1_ps(listener.right.z);
+            const __m128 forward_x = _mm_set1_ps(listener.forward.x);
+            const __m128 forward_y = _mm_set1_ps(listener.forward.y);
+            const __m128 forward_z = _mm_set1_ps(listener.forward.z);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 minus_one = _mm_set1_ps(-1.0f);
+            const __m128 segments = _mm_set1_ps(static_cast<float>(kCurveSegments));
+
+            std::uint32_t i = begin;
+            for (; i + 4 <= batch.count; i += 4)
+            {
+                const __m128 x = _mm_sub_ps(_mm_loadu_ps(batch.position_x + i), listener_x);
+                const __m128 y = _mm_sub_ps(_mm_loadu_ps(batch.position_y + i), listener_y);
+                const __m128 z = _mm_sub_ps(_mm_loadu_ps(batch.position_z + i), listener_z);
+                const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+                const __m128 local_x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, right_x), _mm_mul_ps(y, right_y)), _mm_mul_ps(z, right_z));
+                const __m128 local_z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, forward_x), _mm_mul_ps(y, forward_y)), _mm_mul_ps(z, forward_z));
+
+                const __m128 min_distance = _mm_loadu_ps(batch.min_distance + i);
+                const __m128 fraction = _mm_div_ps(_mm_sub_ps(distance, min_distance), _mm_sub_ps(_mm_loadu_ps(batch.max_distance + i), min_distance));
+                alignas(16) float position[4];
+                _mm_store_ps(position, _mm_mul_ps(_mm_min_ps(_mm_max_ps(fraction, zero), one), segments));
+                alignas(16) float curve_gain[4];
+                for (std::uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    curve_gain[lane] = SampleCurve(batch.attenuation_curve[i + lane], position[lane]);
+                }
+                const __m128 attenuation = _mm_load_ps(curve_gain);
+                // Lanes at distance 0 divide 0/0; the mask zeroes them.
+                const __m128 has_distance = _mm_cmpgt_ps(distance, zero);
+                const __m128 pan = _mm_and_ps(has_distance, _mm_min_ps(_mm_max_ps(_mm_div_ps(local_x, distance), minus_one), one));
+
+                const __m128 u = _mm_mul_ps(pan, _mm_set1_ps(kQuarterTurn));
+                const __m128 u2 = _mm_mul_ps(u, u);
+                __m128 sin_u = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin9), u2), _mm_set1_ps(kSin7));
+                sin_u = _mm_add_ps(_mm_mul_ps(sin_u, u2), _mm_set1_ps(kSin5));
+                sin_u = _mm_add_ps(_mm_mul_ps(sin_u, u2), _mm_set1_ps(kSin3));
+                sin_u = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(sin_u, u2), one), u);
+                __m128 cos_u = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos8), u2), _mm_set1_ps(kCos6));
+                cos_u = _mm_add_ps(_mm_mul_ps(cos_u, u2), _mm_set1_ps(kCos4));
+                cos_u = _mm_add_ps(_mm_mul_ps(cos_u, u2), _mm_set1_ps(kCos2));
+                cos_u = _mm_add_ps(_mm_mul_ps(cos_u, u2), one);
+
+                const __m128 half_sqrt2 = _mm_set1_ps(kHalfSqrt2);
+                _mm_storeu_ps(batch.gain_left + i, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(cos_u, sin_u), half_sqrt2), attenuation));
+                _mm_storeu_ps(batch.gain_right + i, _mm_mul_ps(_mm_mul_ps(_mm_add_ps(cos_u, sin_u), half_sqrt2), attenuation));
+                _mm_storeu_ps(batch.attenuation + i, attenuation);
+                _mm_storeu_ps(batch.local_x + i, local_x);
+                _mm_storeu_ps(batch.local_z + i, local_z);
+            }
+
+            SpatializeScalar(batch, listener, i);
+        }
+
+        DECL_AUDIO_TARGET_AVX2 void SpatializeAvx2(const SpatialBatch &batch, const SpatialListener &listener, const std::uint32_t begin) noexcept
+        {
+            const __m256 listener_x = _mm256_set1_ps(listener.position.x);
+            const __m256 listener_y = _mm256_set1_ps(listener.position.y);
+            const __m256 listener_z = _mm256_set1_ps(listener.position.z);
+            const __m256 right_x = _mm256_set1_ps(listener.right.x);
+            const __m256 right_y = _mm256_set1_ps(listener.right.y);
+            const __m256 right_z = _mm256_set1_ps(listener.right.z);
+            const __m256 forward_x = _mm256_set1_ps(listener.forward.x);
+            const __m256 forward_y = _mm256_set1_ps(listener.forward.y);
+            const __m256 forward_z = _mm256_set1_ps(listener.forward.z);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 minus_one = _mm256_set1_ps(-1.0f);
+            const __m256 segments = _mm256_set1_ps(static_cast<float>(kCurveSegments));
+
+            std::uint32_t i = begin;
+            for (; i + 8 <= batch.count; i += 8)
+            {
+                const __m256 x = _mm256_sub_ps(_mm256_loadu_ps(batch.position_x + i), listener_x);
+                const __m256 y = _mm256_sub_ps(_mm256_loadu_ps(batch.position_y + i), listener_y);
+                const __m256 z = _mm256_sub_ps(_mm256_loadu_ps(batch.position_z + i), listener_z);
+                const __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+                const __m256 local_x = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, right_x), _mm256_mul_ps(y, right_y)), _mm256_mul_ps(z, right_z));
+                const __m256 local_z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, forward_x), _mm256_mul_ps(y, forward_y)), _mm256_mul_ps(z, forward_z));
+
+                const __m256 min_distance = _mm256_loadu_ps(batch.min_distance + i);
+                const __m256 fraction = _mm256_div_ps(_mm256_sub_ps(distance, min_distance), _mm256_sub_ps(_mm256_loadu_ps(batch.max_distance + i), min_distance));
+                alignas(32) float position[8];
+                _mm256_store_ps(position, _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(fraction, zero), one), segments));
+                alignas(32) float curve_gain[8];
+                for (std::uint32_t lane = 0; lane < 8; ++lane)
+                {
+                    curve_gain[lane] = SampleCurve(batch.attenuation_curve[i + lane], position[lane]);
+                }
+                const __m256 attenuation = _mm256_load_ps(curve_gain);
+                const __m256 has_distance = _mm256_cmp_ps(distance, zero, _CMP_GT_OQ);
+                const __m256 pan = _mm256_and_ps(has_distance, _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(local_x, distance), minus_one), one));
+
+                const __m256 u = _mm256_mul_ps(pan, _mm256_set1_ps(kQuarterTurn));
+                const __m256 u2 = _mm256_mul_ps(u, u);
+                __m256 sin_u = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kSin9), u2), _mm256_set1_ps(kSin7));
+                sin_u = _mm256_add_ps(_mm256_mul_ps(sin_u, u2), _mm256_set1_ps(kSin5));
+                sin_u = _mm256_add_ps(_mm256_mul_ps(sin_u, u2), _mm256_set1_ps(kSin3));
+                sin_u = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(sin_u, u2), one), u);
+                __m256 cos_u = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kCos8), u2), _mm256_set1_ps(kCos6));
+                cos_u = _mm256_add_ps(_mm256_mul_ps(cos_u, u2), _mm256_set1_ps(kCos4));
+                cos_u = _mm256_add_ps(_mm256_mul_ps(cos_u, u2), _mm256_set1_ps(kCos2));
+                cos_u = _mm256_add_ps(_mm256_mul_ps(cos_u, u2), one);
+
+                const __m256 half_sqrt2 = _mm256_set1_ps(kHalfSqrt2);
+                _mm256_storeu_ps(batch.gain_left + i, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(cos_u, sin_u), half_sqrt2), attenuation));
+                _mm256_storeu_ps(batch.gain_right + i, _mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(cos_u, sin_u), half_sqrt2), attenuation));
+                _mm256_storeu_ps(batch.attenuation + i, attenuation);
+                _mm256_storeu_ps(batch.local_x + i, local_x);
+                _mm256_storeu_ps(batch.local_z + i, local_z);
+            }
+
+            SpatializeSse2(batch, listener, i);
+        }
+#endif
+
+        template <SimdLevel kLevel>
+        void Spatialize(const SpatialBatch &batch, const SpatialListener &listener) noexcept
+        {
+#if DECL_AUDIO_X86
+            if constexpr (kLevel == SimdLevel::Avx2)
+            {
+                SpatializeAvx2(batch, listener, 0);
+                return;
+            }
+            else if constexpr (kLevel == SimdLevel::Sse2)
+            {
+                SpatializeSse2(batch, listener, 0);
+                return;
+            }
+#endif
+            SpatializeScalar(batch, listener, 0);
+        }
+    } // namespace
+
+    SpatialKernel GetSpatialKernel(const SimdLevel level) noexcept
+    {
+#if DECL_AUDIO_X86
+        switch (level)
+        {
+        case SimdLevel::Avx2:
+            return &Spatialize<SimdLevel::Avx2>;
+        case SimdLevel::Sse2:
+            return &Spatialize<SimdLevel::Sse2>;
+        case SimdLevel::Scalar:
+            break;
+        }
+#else
+        (void)level;
+#endif
+        return &Spatialize<SimdLevel::Scalar>;
+    }
+
+    SpatialKernel GetSpatialKernel() noexcept
+    {
+        static const SpatialKernel selected = GetSpatialKernel(DetectSimdLevel());
+        return selected;
+    }
+} // namespace decl_audio::playback
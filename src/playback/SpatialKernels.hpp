@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../compiler/CompilerTypes.hpp"
+#include "../core/CpuFeatures.hpp"
+#include "../core/vec3.hpp"
+
+namespace decl_audio::playback
+{
+    // One block's spatialized sources in structure-of-arrays form, `count`
+    // entries per array. Outputs may not overlap inputs or each other.
+    struct SpatialBatch final
+    {
+        std::uint32_t count = 0;
+        // World-space source positions, attenuation ranges, and each source's
+        // baked attenuation curve (compiler::kAttenuationCurvePoints samples
+        // spanning its range).
+        const float *position_x = nullptr;
+        const float *position_y = nullptr;
+        const float *position_z = nullptr;
+        const float *min_distance = nullptr;
+        const float *max_distance = nullptr;
+        const float *const *attenuation_curve = nullptr;
+        // Constant-power left/right gains with the attenuation folded in, the
+        // attenuation alone, and the source offset along the listener's right
+        // and forward axes (where surround panning takes its direction from).
+        float *gain_left = nullptr;
+        float *gain_right = nullptr;
+        float *attenuation = nullptr;
+        float *local_x = nullptr;
+        float *local_z = nullptr;
+    };
+
+    // The listener's position and its unit right/forward axes in world space.
+    struct SpatialListener final
+    {
+        Vec3 position{};
+        Vec3 right{1.0f, 0.0f, 0.0f};
+        Vec3 forward{0.0f, 0.0f, 1.0f};
+    };
+
+    // For each source:
+    //   offset      = position - listener.position
+    //   distance    = |offset|
+    //   attenuation = curve sampled at clamp((distance - min) / (max - min), 0, 1),
+    //                 interpolating linearly between neighbouring points
+    //   pan         = clamp(dot(offset, right) / distance, -1, 1)  (0 at distance 0)
+    //   left, right = cos, sin of (pan + 1) * pi/4, times attenuation
+    // The sine and cosine are one shared polynomial (within 1e-7 of the libm
+    // values) and every curve is a table read, so no lane calls into libm
+    // whatever the attenuation mode. As with the mix
+    // kernels, every ISA uses the same operation order and no FMA, so all
+    // levels produce bit-identical results.
+    using SpatialKernel = void (*)(const SpatialBatch &batch, const SpatialListener &listener) noexcept;
+
+    // The kernel for the best level this CPU supports, detected on first use.
+    [[nodiscard]] SpatialKernel GetSpatialKernel() noexcept;
+
+    // The kernel for a specific level (not above DetectSimdLevel()), for tests.
+    [[nodiscard]] SpatialKernel GetSpatialKernel(SimdLevel level) noexcept;
+} // namespace decl_audio::playback
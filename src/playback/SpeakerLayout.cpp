@@ -0,0 +1,94 @@
+#include "pch.h"
+
+#include "SpeakerLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        constexpr float kDegrees = 3.14159265358979323846f / 180.0f;
+        constexpr float kFullTurn = 6.28318530717958647692f;
+
+        // FL FR BL BR.
+        constexpr SpeakerLayout kQuadLayout{
+            4,
+            4,
+            {2, 0, 1, 3},
+            {-135.0f * kDegrees, -45.0f * kDegrees, 45.0f * kDegrees, 135.0f * kDegrees}};
+
+        // FL FR FC LFE SL SR (ITU-R BS.775 angles).
+        constexpr SpeakerLayout kSurround51Layout{
+            6,
+            5,
+            {4, 0, 2, 1, 5},
+            {-110.0f * kDegrees, -30.0f * kDegrees, 0.0f, 30.0f * kDegrees, 110.0f * kDegrees}};
+
+        // FL FR FC LFE BL BR SL SR.
+        constexpr SpeakerLayout kSurround71Layout{
+            8,
+            7,
+            {4, 6, 0, 2, 1, 7, 5},
+            {-150.0f * kDegrees, -90.0f * kDegrees, -30.0f * kDegrees, 0.0f, 30.0f * kDegrees, 90.0f * kDegrees, 150.0f * kDegrees}};
+    } // namespace
+
+    const SpeakerLayout *FindSurroundLayout(const std::uint32_t channel_count) noexcept
+    {
+        switch (channel_count)
+        {
+        case 4:
+            return &kQuadLayout;
+        case 6:
+            return &kSurround51Layout;
+        case 8:
+            return &kSurround71Layout;
+        default:
+            return nullptr;
+        }
+    }
+
+    bool IsSupportedOutputChannelCount(const std::uint32_t channel_count) noexcept
+    {
+        return channel_count == 1 || channel_count == 2 || FindSurroundLayout(channel_count) != nullptr;
+    }
+
+    void ComputeVbapGains(const SpeakerLayout &layout, const float azimuth, const std::span<float> gains) noexcept
+    {
+        std::fill(gains.begin(), gains.end(), 0.0f);
+
+        // Bring the azimuth into [first, first + full turn) so exactly one ring
+        // pair encloses it; the last pair wraps back to the first speaker.
+        const float first = layout.ring_azimuths[0];
+        float source = std::fmod(azimuth - first, kFullTurn);
+        source += (source < 0.0f ? kFullTurn : 0.0f) + first;
+
+        std::uint32_t pair = layout.ring_count - 1;
+        for (std::uint32_t i = 0; i + 1 < layout.ring_count; ++i)
+        {
+            if (source < layout.ring_azimuths[i + 1])
+            {
+                pair = i;
+                break;
+            }
+        }
+
+        const std::uint32_t next = pair + 1 < layout.ring_count ? pair + 1 : 0;
+        const float from = layout.ring_azimuths[pair];
+        const float to = next != 0 ? layout.ring_azimuths[next] : first + kFullTurn;
+
+        // Solving source = g_from * from + g_to * to for unit vectors on the
+        // circle gives the sine ratios below; every pair spans less than half a
+        // turn, so both gains are non-negative. Normalized to constant power.
+        const float span_sin = std::sin(to - from);
+        float gain_from = std::sin(to - source) / span_sin;
+        float gain_to = std::sin(source - from) / span_sin;
+        const float norm = std::sqrt(gain_from * gain_from + gain_to * gain_to);
+        gain_from /= norm;
+        gain_to /= norm;
+
+        gains[layout.ring_channels[pair]] = std::max(gain_from, 0.0f);
+        gains[layout.ring_channels[next]] = std::max(gain_to, 0.0f);
+    }
+} // namespace decl_audio::playback
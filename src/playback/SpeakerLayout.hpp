@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace decl_audio::playback
+{
+    inline constexpr std::uint32_t kMaxOutputChannels = 8;
+
+    // A surround output layout: which device channels carry a positioned
+    // speaker and where it sits on the horizontal ring around the listener.
+    // Channels are in the standard WAVE/Microsoft order the backends open the
+    // device with; the LFE channel is not on the ring and never takes panned
+    // signal.
+    //
+    // Azimuths are radians, 0 straight ahead (+z) and positive toward the
+    // listener's right (+x). The ring lists the speakers in ascending azimuth,
+    // so neighbouring entries (wrapping last -> first) form the VBAP pairs.
+    struct SpeakerLayout final
+    {
+        std::uint32_t channel_count = 0;
+        std::uint32_t ring_count = 0;
+        std::array<std::uint8_t, kMaxOutputChannels> ring_channels{};
+        std::array<float, kMaxOutputChannels> ring_azimuths{};
+    };
+
+    // The layout for a surround channel count (4 = quad, 6 = 5.1, 8 = 7.1), or
+    // null. Mono and stereo have no layout: they keep the constant-power
+    // left/right pan law.
+    [[nodiscard]] const SpeakerLayout *FindSurroundLayout(std::uint32_t channel_count) noexcept;
+
+    // 1, 2, or a channel count FindSurroundLayout knows.
+    [[nodiscard]] bool IsSupportedOutputChannelCount(std::uint32_t channel_count) noexcept;
+
+    // Two-dimensional vector-based amplitude panning: writes one gain per
+    // device channel (gains.size() == layout.channel_count) for a source at
+    // `azimuth`. The pair of ring speakers enclosing the source share it with
+    // constant power; every other channel gets 0.
+    void ComputeVbapGains(const SpeakerLayout &layout, float azimuth, std::span<float> gains) noexcept;
+} // namespace decl_audio::playback
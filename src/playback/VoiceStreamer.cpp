@@ -0,0 +1,222 @@
+#include "pch.h"
+
+#include "VoiceStreamer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace decl_audio::playback
+{
+    namespace
+    {
+        // Rings are sized for stereo; assets are mono or stereo.
+        constexpr std::uint32_t kMaxStreamChannels = 2;
+    } // namespace
+
+    VoiceStreamer::VoiceStreamer(const std::uint32_t slot_count, const std::uint32_t capacity_frames)
+        : slots_(slot_count),
+          capacity_frames_(capacity_frames)
+    {
+        for (Slot &slot : slots_)
+            slot.ring.resize(static_cast<std::size_t>(capacity_frames) * kMaxStreamChannels);
+
+        thread_ = std::thread([this]() { IoMain(); });
+    }
+
+    VoiceStreamer::~VoiceStreamer()
+    {
+        stopping_.store(true, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    std::uint32_t VoiceStreamer::Open(const assets::DecodedBuffer &buffer, const bool looping) noexcept
+    {
+        for (std::uint32_t index = 0; index < slots_.size(); ++index)
+        {
+            Slot &slot = slots_[index];
+            SlotState expected = SlotState::Free;
+            if (!slot.state.compare_exchange_strong(expected, SlotState::Claimed, std::memory_order_acquire, std::memory_order_relaxed))
+                continue;
+
+            slot.buffer = &buffer;
+            slot.channel_count = buffer.channel_count;
+            slot.looping = looping;
+            slot.write_frame.store(0, std::memory_order_relaxed);
+            slot.read_frame.store(0, std::memory_order_relaxed);
+            busy_slot_count_.fetch_add(1, std::memory_order_relaxed);
+            slot.state.store(SlotState::Opening, std::memory_order_release);
+            return index;
+        }
+
+        return kNoStream;
+    }
+
+    void VoiceStreamer::Close(const std::uint32_t slot) noexcept
+    {
+        slots_[slot].state.store(SlotState::Closing, std::memory_order_release);
+    }
+
+    std::uint32_t VoiceStreamer::Read(const std::uint32_t slot_index, const std::uint64_t first_frame, const std::uint32_t frames, float *output) const noexcept
+    {
+        const Slot &slot = slots_[slot_index];
+        const std::uint64_t write_frame = slot.write_frame.load(std::memory_order_acquire);
+        if (write_frame <= first_frame)
+            return 0;
+
+        const std::uint32_t available = static_cast<std::uint32_t>(std::min<std::uint64_t>(frames, write_frame - first_frame));
+        const std::uint32_t channels = slot.channel_count;
+        const std::uint32_t ring_offset = static_cast<std::uint32_t>(first_frame % capacity_frames_);
+        const std::uint32_t first_run = std::min(available, capacity_frames_ - ring_offset);
+        std::memcpy(output, slot.ring.data() + static_cast<std::size_t>(ring_offset) * channels, static_cast<std::size_t>(first_run) * channels * sizeof(float));
+        std::memcpy(output + static_cast<std::size_t>(first_run) * channels, slot.ring.data(), static_cast<std::size_t>(available - first_run) * channels * sizeof(float));
+        return available;
+    }
+
+    void VoiceStreamer::Release(const std::uint32_t slot, const std::uint64_t frame) noexcept
+    {
+        std::atomic<std::uint64_t> &read_frame = slots_[slot].read_frame;
+        if (frame > read_frame.load(std::memory_order_relaxed))
+            read_frame.store(frame, std::memory_order_release);
+    }
+
+    void VoiceStreamer::Wake() noexcept
+    {
+        if (busy_slot_count_.load(std::memory_order_relaxed) == 0)
+            return;
+
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+    }
+
+    bool VoiceStreamer::HoldsBufferReferences() const noexcept
+    {
+        // Streaming and Failed slots are done with their buffer; a Closing one
+        // may have closed while its open was still in flight.
+        return std::any_of(slots_.begin(), slots_.end(), [](const Slot &slot) {
+            const SlotState state = slot.state.load(std::memory_order_acquire);
+            return state == SlotState::Claimed || state == SlotState::Opening || state == SlotState::Closing;
+        });
+    }
+
+    void VoiceStreamer::SetReadDelayForTesting(const std::chrono::microseconds delay) noexcept
+    {
+        read_delay_us_.store(delay.count(), std::memory_order_relaxed);
+    }
+
+    bool VoiceStreamer::IsSettledForTesting() const noexcept
+    {
+        return settled_wake_.load(std::memory_order_acquire) == wake_.load(std::memory_order_acquire) && !HoldsBufferReferences();
+    }
+
+    void VoiceStreamer::IoMain() noexcept
+    {
+        while (true)
+        {
+            const std::uint32_t seen = wake_.load(std::memory_order_acquire);
+            if (stopping_.load(std::memory_order_acquire))
+                break;
+
+            bool progressed = false;
+            for (Slot &slot : slots_)
+                progressed |= ServiceSlot(slot);
+
+            if (!progressed)
+            {
+                settled_wake_.store(seen, std::memory_order_release);
+                wake_.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        for (Slot &slot : slots_)
+            slot.reader.Close();
+    }
+
+    bool VoiceStreamer::ServiceSlot(Slot &slot) noexcept
+    {
+        switch (slot.state.load(std::memory_order_acquire))
+        {
+        case SlotState::Opening:
+            return OpenSlot(slot);
+        case SlotState::Streaming:
+            return FillSlot(slot);
+        case SlotState::Closing:
+            slot.reader.Close();
+            slot.buffer = nullptr;
+            slot.state.store(SlotState::Free, std::memory_order_release);
+            busy_slot_count_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        case SlotState::Free:
+        case SlotState::Claimed:
+        case SlotState::Failed:
+            return false;
+        }
+
+        return false;
+    }
+
+    bool VoiceStreamer::OpenSlot(Slot &slot) noexcept
+    {
+        const assets::DecodedBuffer &buffer = *slot.buffer;
+        slot.head_frames = buffer.HeadFrameCount();
+        slot.stream_frames = buffer.frame_count - slot.head_frames;
+        slot.source_frame = slot.head_frames;
+
+        // The decoder must agree with the head it continues; a file changed
+        // on disk since the bank loaded streams nothing rather than garbage.
+        bool opened = false;
+        try
+        {
+            opened = slot.reader.Open(buffer.stream_path, buffer.sample_rate).empty();
+        }
+        catch (...)
+        {
+        }
+        opened = opened && slot.reader.FrameCount() == buffer.frame_count && slot.reader.ChannelCount() == buffer.channel_count &&
+                 slot.reader.Seek(slot.head_frames);
+
+        // Closed while opening: leave the state for the Closing pass to free.
+        SlotState expected = SlotState::Opening;
+        if (!slot.state.compare_exchange_strong(expected, opened ? SlotState::Streaming : SlotState::Failed, std::memory_order_release, std::memory_order_relaxed))
+            return true;
+
+        if (!opened)
+            slot.reader.Close();
+        return true;
+    }
+
+    bool VoiceStreamer::FillSlot(Slot &slot) noexcept
+    {
+        const std::uint64_t read_frame = slot.read_frame.load(std::memory_order_acquire);
+        // A consumer that ran past the ring skips the frames it no longer wants.
+        const std::uint64_t write_frame = std::max(slot.write_frame.load(std::memory_order_relaxed), read_frame);
+        const std::uint64_t position = slot.looping ? write_frame % slot.stream_frames : write_frame;
+
+        std::uint64_t frames = std::min<std::uint64_t>(kChunkFrames, read_frame + capacity_frames_ - write_frame);
+        frames = std::min<std::uint64_t>(frames, capacity_frames_ - write_frame % capacity_frames_);
+        frames = std::min<std::uint64_t>(frames, position < slot.stream_frames ? slot.stream_frames - position : 0);
+        if (frames == 0)
+            return false;
+
+        const std::int64_t delay = read_delay_us_.load(std::memory_order_relaxed);
+        if (delay > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(delay));
+
+        const std::uint64_t source_frame = slot.head_frames + position;
+        if (source_frame != slot.source_frame && !slot.reader.Seek(source_frame))
+            slot.source_frame = ~std::uint64_t{0};
+        else
+            slot.source_frame = source_frame;
+
+        const std::uint32_t channels = slot.channel_count;
+        float *const output = slot.ring.data() + static_cast<std::size_t>(write_frame % capacity_frames_) * channels;
+        const std::uint64_t frames_read = slot.source_frame == source_frame ? slot.reader.Read(output, frames) : 0;
+        // A short read (a truncated file) plays as silence.
+        std::fill(output + frames_read * channels, output + frames * channels, 0.0f);
+        slot.source_frame = frames_read == frames ? source_frame + frames : ~std::uint64_t{0};
+
+        slot.write_frame.store(write_frame + frames, std::memory_order_release);
+        return true;
+    }
+} // namespace decl_audio::playback
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "../assets/AssetBank.hpp"
+#include "../assets/AssetStream.hpp"
+
+namespace decl_audio::playback
+{
+    // Reads streamed assets from disk for the voices playing them. Each of a
+    // fixed set of slots holds a ring of decoded frames that one background I/O
+    // thread keeps filled ahead of its voice. The audio side only claims and
+    // releases slots, copies frames out and publishes how far it has read, so
+    // nothing it calls blocks, allocates or touches a file.
+    //
+    // A slot streams the part of its asset after the resident head, unrolled:
+    // stream frame s is source frame head + s, and for a looping voice the
+    // stream carries on from the head's end again after the last frame (the
+    // voice reads the head itself from memory on every pass).
+    class VoiceStreamer final
+    {
+    public:
+        static constexpr std::uint32_t kNoStream = std::numeric_limits<std::uint32_t>::max();
+        // Frames the I/O thread decodes per read, ring space permitting.
+        static constexpr std::uint32_t kChunkFrames = 4096;
+
+        // Rings hold `capacity_frames` frames of up to two channels.
+        VoiceStreamer(std::uint32_t slot_count, std::uint32_t capacity_frames);
+        ~VoiceStreamer();
+
+        VoiceStreamer(const VoiceStreamer &) = delete;
+        VoiceStreamer &operator=(const VoiceStreamer &) = delete;
+
+        // Audio side. Claims a slot streaming `buffer` (which must outlive the
+        // stream, see HoldsBufferReferences); returns kNoStream when every slot
+        // is taken. The ring starts filling at the next Wake.
+        [[nodiscard]] std::uint32_t Open(const assets::DecodedBuffer &buffer, bool looping) noexcept;
+        void Close(std::uint32_t slot) noexcept;
+        // Copies stream frames [first_frame, first_frame + frames) to `output`
+        // as far as the ring has them; returns how many leading frames it
+        // copied. `first_frame` must not be before the last Release.
+        [[nodiscard]] std::uint32_t Read(std::uint32_t slot, std::uint64_t first_frame, std::uint32_t frames, float *output) const noexcept;
+        // Stream frames before `frame` will not be read again, so the I/O
+        // thread may refill their space. Releasing past what has been filled
+        // makes the I/O thread skip ahead to `frame`.
+        void Release(std::uint32_t slot, std::uint64_t frame) noexcept;
+        // Wakes the I/O thread when any slot is in use. Called once per block.
+        void Wake() noexcept;
+
+        // True while the I/O thread may still read a DecodedBuffer handed to
+        // Open: a closed stream's buffer can be freed once this clears.
+        [[nodiscard]] bool HoldsBufferReferences() const noexcept;
+
+        // Tests: a pause before each chunk the I/O thread decodes, standing in
+        // for slow storage.
+        void SetReadDelayForTesting(std::chrono::microseconds delay) noexcept;
+        // Tests: true once the I/O thread has done everything it can until the
+        // audio side reads further or opens or closes a stream.
+        [[nodiscard]] bool IsSettledForTesting() const noexcept;
+
+    private:
+        enum class SlotState : std::uint8_t
+        {
+            Free,
+            Claimed,   // audio side is filling in the request
+            Opening,   // waiting for the I/O thread to open the file
+            Streaming,
+            Failed,    // the file did not open; reads come back empty
+            Closing,   // released by the audio side; the I/O thread frees it
+        };
+
+        struct Slot final
+        {
+            std::atomic<SlotState> state{SlotState::Free};
+            // Stream frames [read_frame, write_frame) are in the ring.
+            std::atomic<std::uint64_t> write_frame{0};
+            std::atomic<std::uint64_t> read_frame{0};
+            // Written by the audio side while Claimed; the I/O thread reads
+            // them after it sees Opening.
+            const assets::DecodedBuffer *buffer = nullptr;
+            std::uint32_t channel_count = 0;
+            bool looping = false;
+            // I/O thread only.
+            assets::AssetStreamReader reader;
+            std::uint64_t head_frames = 0;
+            std::uint64_t stream_frames = 0; // frame_count - head_frames
+            std::uint64_t source_frame = 0;  // where `reader` will decode next
+            std::vector<float> ring;
+        };
+
+        void IoMain() noexcept;
+        // One step of I/O work on `slot`; false when it had nothing to do.
+        bool ServiceSlot(Slot &slot) noexcept;
+        bool OpenSlot(Slot &slot) noexcept;
+        bool FillSlot(Slot &slot) noexcept;
+
+        std::vector<Slot> slots_;
+        std::uint32_t capacity_frames_ = 0;
+        // Slots between Open and the I/O thread freeing them.
+        std::atomic<std::uint32_t> busy_slot_count_{0};
+        // Bumped by Wake (and at shutdown); the I/O thread parks on it.
+        std::atomic<std::uint32_t> wake_{0};
+        // The wake_ value of the last I/O pass that found nothing to do.
+        std::atomic<std::uint32_t> settled_wake_{std::numeric_limits<std::uint32_t>::max()};
+        std::atomic<std::int64_t> read_delay_us_{0};
+        std::atomic<bool> stopping_{false};
+        std::thread thread_;
+    };
+} // namespace decl_audio::playback
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../assets/AssetBank.hpp"
+#include "../compiler/CompiledBank.hpp"
+#include "../compiler/CompilerTypes.hpp"
+#include "../playback/ConvolutionReverb.hpp"
+
+namespace decl_audio::runtime
+{
+    // Owns the engine-wide bus graph. Buses are shared by name across banks
+    // ("music" is one bus however many banks route to it), so a bank's buses are
+    // merged here and its programs rewritten to global bus ids, the way
+    // VocabularyRegistry does for tags and parameters.
+    //
+    // Control-thread only and grow-only: a bus outlives the banks that declared
+    // it, and global ids are minted parents first, so the audio thread's flat
+    // array stays in an order it can fold from the back. The host's volume for a
+    // bus is kept by name, so it may be set before any bank declares the bus.
+    //
+    // A bus with an impulse response owns it, transformed for convolution when
+    // the bus is first merged, so it outlives the bank whose asset it came from.
+    //
+    // A ducked bus must also sit below the bus that ducks it. New buses are
+    // appended in the bank's order, which has that property, so the only
+    // relation that cannot merge is a new bus ducked by a bus some earlier
+    // bank declared.
+    class BusRegistry final
+    {
+    public:
+        explicit BusRegistry(const std::uint32_t max_bus_count = 0,
+                             const std::uint32_t max_reverb_bus_count = 0,
+                             const std::uint32_t reverb_partition_frames = playback::kDefaultReverbPartitionFrames,
+                             const std::uint32_t max_impulse_frames = 0) noexcept
+            : max_bus_count_(max_bus_count),
+              max_reverb_bus_count_(max_reverb_bus_count),
+              reverb_partition_frames_(reverb_partition_frames),
+              max_impulse_frames_(max_impulse_frames)
+        {
+        }
+
+        // Why `bank`'s buses cannot merge - a name already declared with another
+        // parent, volume, filter, impulse response or duck, a new bus ducked by
+        // an existing one, more buses than max_bus_count, more with impulse
+        // responses than max_reverb_bus_count, or a new impulse response in
+        // `assets` that is not mono or stereo or is longer than
+        // max_impulse_frames - or empty when they can. Changes nothing.
+        [[nodiscard]] std::string CheckBank(const compiler::CompiledBank &bank, const assets::AssetBank &assets) const
+        {
+            const std::vector<std::string_view> names = NamesByLocalId(bank);
+            std::uint32_t new_bus_count = 0;
+            std::uint32_t new_reverb_bus_count = 0;
+            for (std::size_t local_id = 0; local_id < bank.buses.size(); ++local_id)
+            {
+                const compiler::CompiledBus &bus = bank.buses[local_id];
+                const std::string_view parent_name = bus.parent != compiler::kMasterBus ? names[bus.parent] : std::string_view{};
+                const std::string_view trigger_name = bus.duck.by != compiler::kMasterBus ? names[bus.duck.by] : std::string_view{};
+                const auto it = name_to_id_.find(std::string(names[local_id]));
+                if (it == name_to_id_.end())
+                {
+                    ++new_bus_count;
+                    if (!trigger_name.empty() && name_to_id_.contains(std::string(trigger_name)))
+                        return "bus '" + std::string(names[local_id]) + "' is ducked by '" + std::string(trigger_name) + "', which an earlier bank declared; a ducked bus must be declared no later than the bus that ducks it";
+                    if (bus.impulse == compiler::kNoImpulse)
+                        continue;
+
+                    ++new_reverb_bus_count;
+                    const assets::DecodedBuffer &impulse = assets.GetBuffer(bus.impulse);
+                    if (impulse.channel_count == 0 || impulse.channel_count > 2)
+                        return "bus '" + std::string(names[local_id]) + "' impulse response must be mono or stereo";
+                    if (impulse.frame_count > max_impulse_frames_)
+                        return "bus '" + std::string(names[local_id]) + "' impulse response is " + std::to_string(impulse.frame_count) + " frames, more than max_impulse_frames";
+                    continue;
+                }
+
+                const Bus &existing = buses_[it->second];
+                const std::string_view existing_parent = existing.parent != compiler::kMasterBus ? std::string_view(buses_[existing.parent].name) : std::string_view{};
+                const std::string_view existing_trigger = existing.duck.by != compiler::kMasterBus ? std::string_view(buses_[existing.duck.by].name) : std::string_view{};
+                compiler::CompiledDuck duck = bus.duck;
+                duck.by = existing.duck.by;
+                if (existing_parent != parent_name || existing.volume != bus.volume || existing.filtered != (bus.filter != compiler::kNoFilter) ||
+                    (existing.filtered && existing.filter != bank.filters[bus.filter]) || existing.impulse_name != ImpulseName(bank, bus) ||
+                    existing_trigger != trigger_name || existing.duck != duck)
+                    return "bus '" + std::string(names[local_id]) + "' is already declared with a different parent, volume, filter, impulse response or duck";
+            }
+
+            if (buses_.size() + new_bus_count > max_bus_count_)
+                return "bank needs " + std::to_string(buses_.size() + new_bus_count) + " buses, more than max_bus_count";
+            if (reverb_bus_count_ + new_reverb_bus_count > max_reverb_bus_count_)
+                return "bank needs " + std::to_string(reverb_bus_count_ + new_reverb_bus_count) + " buses with impulse responses, more than max_reverb_bus_count";
+
+            return {};
+        }
+
+        // Adds the buses of `bank` (which CheckBank accepted) that are new,
+        // transforming their impulse responses from `assets`, and rewrites its
+        // programs' bus and send ids to global ones. Returns the first new
+        // global id; the bank added [first, BusCount()).
+        compiler::BusId MergeBank(compiler::CompiledBank &bank, const assets::AssetBank &assets)
+        {
+            const compiler::BusId first_new = static_cast<compiler::BusId>(buses_.size());
+            const std::vector<std::string_view> names = NamesByLocalId(bank);
+            // Local ids are parents first too, so a parent is always mapped
+            // before the buses under it.
+            std::vector<compiler::BusId> remap(bank.buses.size());
+            for (std::size_t local_id = 0; local_id < bank.buses.size(); ++local_id)
+            {
+                const std::string name(names[local_id]);
+                const auto [it, inserted] = name_to_id_.emplace(name, static_cast<compiler::BusId>(buses_.size()));
+                remap[local_id] = it->second;
+                if (!inserted)
+                    continue;
+
+                const compiler::CompiledBus &bus = bank.buses[local_id];
+                const auto volume_it = host_volumes_.find(name);
+                buses_.push_back(Bus{name,
+                                     bus.parent != compiler::kMasterBus ? remap[bus.parent] : compiler::kMasterBus,
+                                     bus.volume,
+                                     volume_it != host_volumes_.end() ? volume_it->second : 1.0f,
+                                     bus.filter != compiler::kNoFilter,
+                                     bus.filter != compiler::kNoFilter ? bank.filters[bus.filter] : compiler::CompiledFilter{},
+                                     std::string(ImpulseName(bank, bus)),
+                                     nullptr,
+                                     bus.duck});
+                if (bus.impulse != compiler::kNoImpulse)
+                {
+                    buses_.back().impulse = std::make_unique<playback::ImpulseResponse>(
+                        playback::TransformImpulseResponse(assets.GetBuffer(bus.impulse), reverb_partition_frames_));
+                    ++reverb_bus_count_;
+                }
+            }
+
+            // Triggers come after the buses they duck, so only now are they all
+            // mapped. A bus that already existed keeps its own.
+            for (std::size_t local_id = 0; local_id < bank.buses.size(); ++local_id)
+            {
+                const compiler::BusId trigger = bank.buses[local_id].duck.by;
+                if (trigger != compiler::kMasterBus && remap[local_id] >= first_new)
+                    buses_[remap[local_id]].duck.by = remap[trigger];
+            }
+
+            for (compiler::CompiledProgram &program : bank.programs)
+            {
+                if (program.bus != compiler::kMasterBus)
+                    program.bus = remap[program.bus];
+                if (program.send_bus != compiler::kMasterBus)
+                    program.send_bus = remap[program.send_bus];
+            }
+
+            return first_new;
+        }
+
+        // Records the host's volume for the bus called `name`. Returns true, with
+        // its id, when that bus exists and its gain changed with it.
+        [[nodiscard]] bool SetHostVolume(std::string_view name, const float volume, compiler::BusId &bus_id)
+        {
+            const std::string key(name);
+            host_volumes_[key] = volume;
+            const auto it = name_to_id_.find(key);
+            if (it == name_to_id_.end())
+                return false;
+
+            bus_id = it->second;
+            buses_[bus_id].host_volume = volume;
+            return true;
+        }
+
+        [[nodiscard]] std::uint32_t BusCount() const noexcept
+        {
+            return static_cast<std::uint32_t>(buses_.size());
+        }
+
+        [[nodiscard]] compiler::BusId Parent(const compiler::BusId bus_id) const noexcept
+        {
+            return buses_[bus_id].parent;
+        }
+
+        // Authored volume x host volume; parents apply their own on top.
+        [[nodiscard]] float Gain(const compiler::BusId bus_id) const noexcept
+        {
+            return buses_[bus_id].volume * buses_[bus_id].host_volume;
+        }
+
+        // The bus's authored filter, or null when it has none.
+        [[nodiscard]] const compiler::CompiledFilter *Filter(const compiler::BusId bus_id) const noexcept
+        {
+            return buses_[bus_id].filtered ? &buses_[bus_id].filter : nullptr;
+        }
+
+        // The bus's transformed impulse response, or null when it has none.
+        [[nodiscard]] const playback::ImpulseResponse *Impulse(const compiler::BusId bus_id) const noexcept
+        {
+            return buses_[bus_id].impulse.get();
+        }
+
+        // The bus's duck, by a global id above its own (kMasterBus for none).
+        [[nodiscard]] const compiler::CompiledDuck &Duck(const compiler::BusId bus_id) const noexcept
+        {
+            return buses_[bus_id].duck;
+        }
+
+    private:
+        struct Bus final
+        {
+            std::string name;
+            compiler::BusId parent = compiler::kMasterBus;
+            float volume = 1.0f;
+            float host_volume = 1.0f;
+            bool filtered = false;
+            compiler::CompiledFilter filter{};
+            std::string impulse_name; // the asset as authored; empty for none
+            std::unique_ptr<playback::ImpulseResponse> impulse;
+            compiler::CompiledDuck duck{};
+        };
+
+        [[nodiscard]] static std::string_view ImpulseName(const compiler::CompiledBank &bank, const compiler::CompiledBus &bus)
+        {
+            if (bus.impulse == compiler::kNoImpulse)
+                return {};
+
+            for (const auto &[name, asset_id] : bank.asset_name_to_id)
+            {
+                if (asset_id == bus.impulse)
+                    return name;
+            }
+            return {};
+        }
+
+        [[nodiscard]] static std::vector<std::string_view> NamesByLocalId(const compiler::CompiledBank &bank)
+        {
+            std::vector<std::string_view> names(bank.buses.size());
+            for (const auto &[name, local_id] : bank.bus_name_to_id)
+            {
+                names[local_id] = name;
+            }
+            return names;
+        }
+
+        std::uint32_t max_bus_count_ = 0;
+        std::uint32_t max_reverb_bus_count_ = 0;
+        std::uint32_t reverb_partition_frames_ = playback::kDefaultReverbPartitionFrames;
+        std::uint32_t max_impulse_frames_ = 0;
+        std::uint32_t reverb_bus_count_ = 0;
+        std::vector<Bus> buses_;
+        std::unordered_map<std::string, compiler::BusId> name_to_id_;
+        std::unordered_map<std::string, float> host_volumes_;
+    };
+} // namespace decl_audio::runtime
@@ -117,12 +117,36 @@ namespace decl_audio::runtime
         entity.has_position = true;
     }
 
+    void ControlRuntime::Apply(const SetEntityTransformCommand &command) noexcept
+    {
+        EntityState &entity = world_state_.GetOrCreateEntity(command.entity_id);
+        entity.position = command.position;
+        entity.has_position = true;
+        entity.orientation = command.orientation.Normalized();
+        entity.has_orientation = true;
+    }
+
+    void ControlRuntime::Apply(const SetQuatValueCommand &command) noexcept
+    {
+        const compiler::ParameterId parameter_id = vocabulary_.GetOrInternParam(command.parameter_name);
+        world_state_.GetOrCreateEntity(command.entity_id).quat_values[parameter_id] = command.value;
+    }
+
     void ControlRuntime::Apply(const SetListenerPositionCommand &command) noexcept
     {
         listener_position_ = command.position;
         listener_position_dirty_ = true;
     }
 
+    void ControlRuntime::Apply(const SetListenerTransformCommand &command) noexcept
+    {
+        listener_position_ = command.position;
+        listener_position_dirty_ = true;
+        // Normalized here so the audio thread can take the axes straight off it.
+        listener_orientation_ = command.orientation.Normalized();
+        listener_orientation_dirty_ = true;
+    }
+
     void ControlRuntime::Apply(const DestroyEntityCommand &command) noexcept
     {
         world_state_.entities.erase(command.entity_id);
@@ -134,6 +158,11 @@ namespace decl_audio::runtime
         master_gain_dirty_ = true;
     }
 
+    void ControlRuntime::Apply(const SetBusVolumeCommand &command) noexcept
+    {
+        pending_bus_volumes_.push_back(command);
+    }
+
     void ControlRuntime::Apply(const UnloadBankCommand &command) noexcept
     {
         // The engine owns the bank registry, so just record the request; it drains
@@ -30,6 +30,15 @@ namespace decl_audio::runtime
             return taken;
         }
 
+        // Bus volume changes the host made since the last call, in order; the
+        // engine resolves the names. Moves them out and clears the buffer.
+        [[nodiscard]] std::vector<SetBusVolumeCommand> TakePendingBusVolumes()
+        {
+            std::vector<SetBusVolumeCommand> taken = std::move(pending_bus_volumes_);
+            pending_bus_volumes_.clear();
+            return taken;
+        }
+
         [[nodiscard]] const WorldState &GetWorldState() const noexcept
         {
             return world_state_;
@@ -47,6 +56,18 @@ namespace decl_audio::runtime
             return true;
         }
 
+        [[nodiscard]] bool ListenerOrientationChanged(Quat &orientation) noexcept
+        {
+            if (!listener_orientation_dirty_)
+            {
+                return false;
+            }
+
+            orientation = listener_orientation_;
+            listener_orientation_dirty_ = false;
+            return true;
+        }
+
         [[nodiscard]] bool MasterGainChanged(float &gain) noexcept
         {
             if (!master_gain_dirty_)
@@ -69,9 +90,13 @@ namespace decl_audio::runtime
         void Apply(const SetGlobalFloatValueCommand &command) noexcept;
         void Apply(const SetEntityVolumeCommand &command) noexcept;
         void Apply(const SetEntityPositionCommand &command) noexcept;
+        void Apply(const SetEntityTransformCommand &command) noexcept;
+        void Apply(const SetQuatValueCommand &command) noexcept;
         void Apply(const SetListenerPositionCommand &command) noexcept;
+        void Apply(const SetListenerTransformCommand &command) noexcept;
         void Apply(const DestroyEntityCommand &command) noexcept;
         void Apply(const SetMasterGainCommand &command) noexcept;
+        void Apply(const SetBusVolumeCommand &command) noexcept;
         void Apply(const UnloadBankCommand &command) noexcept;
 
         VocabularyRegistry &vocabulary_;
@@ -79,10 +104,13 @@ namespace decl_audio::runtime
         WorldState world_state_;
         Vec3 listener_position_{};
         bool listener_position_dirty_ = false;
+        Quat listener_orientation_{};
+        bool listener_orientation_dirty_ = false;
         float master_gain_ = 1.0f;
         bool master_gain_dirty_ = false;
 
         std::vector<std::tuple<std::string, decl_audio::compiler::TagId>> transientTags_{};
         std::vector<std::string> pending_unloads_{};
+        std::vector<SetBusVolumeCommand> pending_bus_volumes_{};
     };
 } // namespace decl_audio::runtime
@@ -4,6 +4,7 @@
 #include <variant>
 
 #include "../compiler/CompilerTypes.hpp"
+#include "../core/quat.hpp"
 #include "../core/vec3.hpp"
 
 namespace decl_audio::runtime
@@ -47,11 +48,31 @@ namespace decl_audio::runtime
         Vec3 position{};
     };
 
+    struct SetEntityTransformCommand final
+    {
+        std::string entity_id;
+        Vec3 position{};
+        Quat orientation{};
+    };
+
+    struct SetQuatValueCommand final
+    {
+        std::string entity_id;
+        std::string parameter_name;
+        Quat value{};
+    };
+
     struct SetListenerPositionCommand final
     {
         Vec3 position{};
     };
 
+    struct SetListenerTransformCommand final
+    {
+        Vec3 position{};
+        Quat orientation{};
+    };
+
     struct DestroyEntityCommand final
     {
         std::string entity_id;
@@ -76,6 +97,14 @@ namespace decl_audio::runtime
         float gain = 1.0f;
     };
 
+    // Named like the tag commands; the engine resolves the name against the
+    // BusRegistry after Tick().
+    struct SetBusVolumeCommand final
+    {
+        std::string bus_name;
+        float volume = 1.0f;
+    };
+
     // Routed through the host->control ring like the fact-setters so unload still
     // works once Update() moves to its own thread. The control thread maps the path
     // to a BankId and runs the retire handshake (section 3.2).
@@ -91,11 +120,15 @@ namespace decl_audio::runtime
         SetFloatValueCommand,
         SetEntityVolumeCommand,
         SetEntityPositionCommand,
+        SetEntityTransformCommand,
+        SetQuatValueCommand,
         SetListenerPositionCommand,
+        SetListenerTransformCommand,
         DestroyEntityCommand,
         SetGlobalTagCommand,
         RemoveGlobalTagCommand,
         SetGlobalFloatValueCommand,
         SetMasterGainCommand,
+        SetBusVolumeCommand,
         UnloadBankCommand>;
 } // namespace decl_audio::runtime
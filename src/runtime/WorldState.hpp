@@ -5,6 +5,7 @@
 #include <unordered_set>
 
 #include "../compiler/CompilerTypes.hpp"
+#include "../core/quat.hpp"
 #include "../core/vec3.hpp"
 
 namespace decl_audio::runtime
@@ -14,10 +15,13 @@ namespace decl_audio::runtime
         std::unordered_set<compiler::TagId> tags;
         std::unordered_set<compiler::TagId> transient_tags;
         std::unordered_map<compiler::ParameterId, float> float_values;
+        std::unordered_map<compiler::ParameterId, Quat> quat_values;
         float volume = 1.0f;
         Vec3 position{};
+        Quat orientation{};
         bool has_volume = false;
         bool has_position = false;
+        bool has_orientation = false;
 
         [[nodiscard]] bool HasTag(compiler::TagId tag_id) const noexcept
         {
@@ -34,6 +38,16 @@ namespace decl_audio::runtime
             return float_values.at(parameter_id);
         }
 
+        [[nodiscard]] bool HasQuatValue(compiler::ParameterId parameter_id) const noexcept
+        {
+            return quat_values.contains(parameter_id);
+        }
+
+        [[nodiscard]] const Quat &GetQuatValue(compiler::ParameterId parameter_id) const
+        {
+            return quat_values.at(parameter_id);
+        }
+
         [[nodiscard]] bool HasVolume() const noexcept
         {
             return has_volume;
@@ -53,6 +67,16 @@ namespace decl_audio::runtime
         {
             return position;
         }
+
+        [[nodiscard]] bool HasOrientation() const noexcept
+        {
+            return has_orientation;
+        }
+
+        [[nodiscard]] const Quat &GetOrientation() const noexcept
+        {
+            return orientation;
+        }
     };
 
     struct WorldState final
@@ -1,13 +1,21 @@
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include "../src/assets/AssetBank.hpp"
+#include "../src/assets/Resampler.hpp"
+#include "../src/assets/SampleCodec.hpp"
 #include "../src/compiler/Compiler.hpp"
 #include "../src/core/Engine.hpp"
 
 namespace
 {
+    constexpr double kPi = 3.14159265358979323846;
+
     bool Expect(bool condition, const char *message)
     {
         if (!condition)
@@ -53,7 +61,7 @@ namespace
         const decl_audio::assets::DecodedBuffer &mono_buffer = asset_bank.GetBuffer(mono_asset_id);
         if (!Expect(mono_buffer.channel_count == 1, "mono fixture should decode as mono"))
             return false;
-        if (!Expect(mono_buffer.sample_rate == decl_audio::assets::kRequiredSampleRate, "mono fixture should decode at 48 kHz"))
+        if (!Expect(mono_buffer.sample_rate == decl_audio::assets::kDefaultSampleRate, "mono fixture should decode at 48 kHz"))
             return false;
         if (!Expect(mono_buffer.frame_count > 0, "mono fixture should contain frames"))
             return false;
@@ -64,7 +72,7 @@ namespace
         const decl_audio::assets::DecodedBuffer &stereo_buffer = asset_bank.GetBuffer(stereo_asset_id);
         if (!Expect(stereo_buffer.channel_count == 2, "stereo fixture should decode as stereo"))
             return false;
-        if (!Expect(stereo_buffer.sample_rate == decl_audio::assets::kRequiredSampleRate, "stereo fixture should decode at 48 kHz"))
+        if (!Expect(stereo_buffer.sample_rate == decl_audio::assets::kDefaultSampleRate, "stereo fixture should decode at 48 kHz"))
             return false;
         if (!Expect(stereo_buffer.frame_count > 0, "stereo fixture should contain frames"))
             return false;
@@ -75,26 +83,235 @@ namespace
         return true;
     }
 
-    bool TestSampleRateMismatchFailsLoudly()
+    bool TestMismatchedSampleRateConvertsOnLoad()
     {
-        const std::filesystem::path fixture_path = GetFixturePath("InvalidSampleRateBehaviorBank.json");
+        const std::filesystem::path fixture_path = GetFixturePath("ResampledBehaviorBank.json");
         const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
 
-        if (!Expect(!compile_result.HasErrors(), "sample-rate mismatch fixture should compile"))
+        if (!Expect(!compile_result.HasErrors(), "resampled fixture should compile"))
+            return false;
+
+        const decl_audio::assets::LoadResult native_result = decl_audio::assets::LoadAssetBank(compile_result.bank, fixture_path, 44100);
+        if (!Expect(!native_result.HasErrors(), "44.1 kHz asset should load at its own rate"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer &native_buffer = *native_result.bank.buffers[0];
+        if (!Expect(native_buffer.sample_rate == 44100, "an asset at the target rate should not be converted"))
             return false;
 
         auto config = GetTestConfig();
 
         decl_audio::Engine engine(config);
-        if (!Expect(!engine.LoadBehaviors(fixture_path.string().c_str()), "44.1 kHz asset should fail load"))
+        if (!Expect(engine.LoadBehaviors(fixture_path.string().c_str()), "44.1 kHz asset should load by converting to the engine rate"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(engine.GetLoadDiagnostics());
             return false;
+        }
 
-        const std::string diagnostics = decl_audio::DumpDiagnostics(engine.GetLoadDiagnostics());
-        if (!Expect(diagnostics.find("unsupported sample rate 44100 Hz; expected 48000 Hz") != std::string::npos, "load diagnostics should report the sample-rate mismatch"))
+        // 48000 / 44100 reduces to 160 / 147.
+        const decl_audio::assets::DecodedBuffer &converted_buffer = *engine.GetAssetBank().buffers[0];
+        if (!Expect(converted_buffer.sample_rate == config.sample_rate, "converted asset should carry the engine rate"))
+            return false;
+        if (!Expect(converted_buffer.frame_count == (native_buffer.frame_count * 160 + 146) / 147, "conversion should stretch the frame count by the rate ratio"))
             return false;
 
-        std::cout << diagnostics;
-        return true;
+        return Expect(converted_buffer.samples.size() == converted_buffer.frame_count * converted_buffer.channel_count, "converted sample storage should match frame count");
+    }
+
+    decl_audio::assets::DecodedBuffer MakeSine(const std::uint32_t sample_rate, const std::uint32_t channels, const double frequency, const std::uint64_t frames)
+    {
+        decl_audio::assets::DecodedBuffer buffer;
+        buffer.sample_rate = sample_rate;
+        buffer.channel_count = channels;
+        buffer.frame_count = frames;
+        buffer.samples.resize(static_cast<std::size_t>(frames * channels));
+        for (std::uint64_t frame = 0; frame < frames; ++frame)
+        {
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const double phase = 2.0 * kPi * frequency * static_cast<double>(frame) / sample_rate + channel;
+                buffer.samples[static_cast<std::size_t>(frame * channels + channel)] = static_cast<float>(0.5 * std::sin(phase));
+            }
+        }
+
+        return buffer;
+    }
+
+    // Away from the edges (where the filter reads silence past the source) the
+    // output must follow the same sine sampled at the new rate.
+    bool ExpectTracksSine(const decl_audio::assets::DecodedBuffer &output, const std::uint32_t channels, const double frequency, const float tolerance)
+    {
+        const decl_audio::assets::DecodedBuffer expected = MakeSine(output.sample_rate, channels, frequency, output.frame_count);
+        float max_error = 0.0f;
+        for (std::size_t index = 64 * channels; index + 64 * channels < output.samples.size(); ++index)
+            max_error = std::max(max_error, std::fabs(output.samples[index] - expected.samples[index]));
+
+        return max_error <= tolerance;
+    }
+
+    bool TestPolyphaseResamplerTracksSignal()
+    {
+        constexpr double kFrequency = 1000.0;
+        constexpr std::uint32_t kRates[][2] = {{44100, 48000}, {48000, 44100}, {22050, 48000}, {96000, 48000}, {44101, 48000}};
+        for (const auto &rates : kRates)
+        {
+            for (const std::uint32_t channels : {1U, 2U})
+            {
+                const decl_audio::assets::DecodedBuffer source = MakeSine(rates[0], channels, kFrequency, 4096);
+                const decl_audio::assets::DecodedBuffer output = decl_audio::assets::ResampleBuffer(source, rates[1]);
+                if (!Expect(output.sample_rate == rates[1] && output.channel_count == channels, "resampled buffer should carry the target rate and channel count") ||
+                    !Expect(ExpectTracksSine(output, channels, kFrequency, 1e-3f), "resampled sine should match the sine sampled at the target rate"))
+                {
+                    std::cerr << "  " << rates[0] << " -> " << rates[1] << " Hz, channels=" << channels << '\n';
+                    return false;
+                }
+            }
+        }
+
+        // Downsampling must filter out what the new rate cannot represent: a
+        // 22 kHz tone has no alias to fold to at 32 kHz.
+        const decl_audio::assets::DecodedBuffer high = MakeSine(48000, 1, 22000.0, 4096);
+        const decl_audio::assets::DecodedBuffer filtered = decl_audio::assets::ResampleBuffer(high, 32000);
+        float peak = 0.0f;
+        for (std::size_t index = 64; index + 64 < filtered.samples.size(); ++index)
+            peak = std::max(peak, std::fabs(filtered.samples[index]));
+
+        return Expect(peak < 1e-3f, "downsampling should reject content above the target Nyquist rate");
+    }
+
+    bool TestResampleCacheConvertsOnce()
+    {
+        using decl_audio::compiler::SampleFormat;
+
+        decl_audio::assets::ResampleCache cache;
+        const decl_audio::assets::DecodedBuffer source = MakeSine(44100, 1, 440.0, 512);
+
+        std::shared_ptr<const decl_audio::assets::DecodedBuffer> first = cache.Convert("tone", source, 48000, SampleFormat::F32);
+        const std::shared_ptr<const decl_audio::assets::DecodedBuffer> second = cache.Convert("tone", source, 48000, SampleFormat::F32);
+        if (!Expect(cache.EntryCount() == 1 && first == second, "a repeated conversion should share the cached buffer"))
+            return false;
+
+        std::shared_ptr<const decl_audio::assets::DecodedBuffer> compact = cache.Convert("tone", source, 48000, SampleFormat::ImaAdpcm);
+        std::shared_ptr<const decl_audio::assets::DecodedBuffer> faster = cache.Convert("tone", source, 96000, SampleFormat::F32);
+        if (!Expect(cache.EntryCount() == 3 && compact->format == SampleFormat::ImaAdpcm && compact->samples.empty(),
+                    "each target rate and format should get its own entry, stored only in that format"))
+            return false;
+
+        const std::shared_ptr<const decl_audio::assets::DecodedBuffer> native = cache.Convert("tone", source, 44100, SampleFormat::F32);
+        if (!Expect(cache.EntryCount() == 3 && native->samples == source.samples, "a buffer already at the target rate should bypass the cache"))
+            return false;
+
+        // Entries hold no samples of their own: one goes once no bank holds it.
+        compact.reset();
+        faster.reset();
+        if (!Expect(cache.EntryCount() == 1, "a conversion nobody holds should leave the cache"))
+            return false;
+
+        first.reset();
+        return Expect(cache.EntryCount() == 1 && cache.Convert("tone", source, 48000, SampleFormat::F32) == second, "a held conversion should stay cached");
+    }
+
+    bool TestResampleKeysTrackFileContents()
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "decl_audio_resample_key.bin";
+        std::ofstream(path, std::ios::binary) << "first";
+        const std::string first_key = decl_audio::assets::MakeResampleKey(path);
+        if (!Expect(first_key == decl_audio::assets::MakeResampleKey(path), "an unchanged file should keep its key") ||
+            !Expect(first_key != decl_audio::assets::MakeResampleKey(path, "tone"), "assets inside one file should get their own keys"))
+            return false;
+
+        // Rebuilt with different contents (and length), as a re-exported asset
+        // or re-baked bank would be.
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "rebuilt";
+        const std::string rebuilt_key = decl_audio::assets::MakeResampleKey(path);
+        std::filesystem::remove(path);
+        return Expect(rebuilt_key != first_key, "a rebuilt file should miss the cache");
+    }
+
+    float MaxError(const decl_audio::assets::DecodedBuffer &actual, const decl_audio::assets::DecodedBuffer &expected)
+    {
+        float max_error = 0.0f;
+        for (std::size_t index = 0; index < expected.samples.size(); ++index)
+            max_error = std::max(max_error, std::fabs(actual.samples[index] - expected.samples[index]));
+
+        return max_error;
+    }
+
+    bool TestCompactFormatsEncodeAndDecode()
+    {
+        using decl_audio::compiler::SampleFormat;
+
+        // 1000 frames leave the last ADPCM block part-filled.
+        const decl_audio::assets::DecodedBuffer source = MakeSine(48000, 2, 1000.0, 1000);
+
+        const decl_audio::assets::DecodedBuffer pcm16 = decl_audio::assets::EncodeBuffer(source, SampleFormat::S16);
+        if (!Expect(pcm16.format == SampleFormat::S16 && decl_audio::assets::HasConsistentStorage(pcm16), "S16 encoding should replace the float samples") ||
+            !Expect(pcm16.ResidentBytes() * 2 == source.ResidentBytes(), "S16 should take half the memory of F32"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer pcm16_decoded = decl_audio::assets::DecodeBuffer(pcm16);
+        if (!Expect(pcm16_decoded.format == SampleFormat::F32 && pcm16_decoded.frame_count == source.frame_count, "S16 should decode back to F32") ||
+            !Expect(MaxError(pcm16_decoded, source) <= 0.5f / 32768.0f, "S16 should round to the nearest 16-bit step"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer adpcm = decl_audio::assets::EncodeBuffer(source, SampleFormat::ImaAdpcm);
+        if (!Expect(adpcm.format == SampleFormat::ImaAdpcm && decl_audio::assets::HasConsistentStorage(adpcm), "ADPCM encoding should replace the float samples") ||
+            !Expect(adpcm.ResidentBytes() == 4 * 2 * decl_audio::assets::kAdpcmChannelBlockBytes, "ADPCM should store 4 blocks per channel for 1000 frames") ||
+            !Expect(adpcm.ResidentBytes() * 7 < source.ResidentBytes(), "ADPCM should take under a seventh of the memory of F32"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer adpcm_decoded = decl_audio::assets::DecodeBuffer(adpcm);
+        // 4-bit codes leave a steep 1 kHz tone within 2% of full scale.
+        if (!Expect(MaxError(adpcm_decoded, source) <= 0.02f, "ADPCM should track a sine within its quantization error"))
+            return false;
+
+        // A run starting mid-block and crossing a block boundary decodes the
+        // same samples as the whole buffer.
+        std::vector<float> run(200 * 2);
+        decl_audio::assets::DecodeAdpcmFrames(adpcm, 300, 200, run.data());
+        return Expect(std::equal(run.begin(), run.end(), adpcm_decoded.samples.begin() + 300 * 2), "a decoded ADPCM run should match the whole-buffer decode");
+    }
+
+    bool TestStreamedAssetsKeepOnlyTheirHead()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("StreamedBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "streamed fixture should compile"))
+            return false;
+
+        // The whole file for reference: a head at least as long as it.
+        const decl_audio::assets::LoadResult resident_result = decl_audio::assets::LoadAssetBank(compile_result.bank, fixture_path, 48000, nullptr, 48000);
+        const decl_audio::assets::LoadResult streamed_result = decl_audio::assets::LoadAssetBank(compile_result.bank, fixture_path, 48000, nullptr, 1000);
+        if (!Expect(!resident_result.HasErrors() && !streamed_result.HasErrors(), "streamed fixture should load"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer &resident = *resident_result.bank.buffers[0];
+        const decl_audio::assets::DecodedBuffer &streamed = *streamed_result.bank.buffers[0];
+        if (!Expect(!resident.IsStreamed() && resident.HeadFrameCount() == resident.frame_count, "an asset no longer than its head should load whole"))
+            return false;
+        if (!Expect(streamed.IsStreamed() && streamed.frame_count == resident.frame_count && streamed.HeadFrameCount() == 1000 &&
+                        decl_audio::assets::HasConsistentStorage(streamed),
+                    "a streamed asset should keep only its head resident"))
+            return false;
+        if (!Expect(std::equal(streamed.samples.begin(), streamed.samples.end(), resident.samples.begin()), "the head should hold the asset's first frames"))
+            return false;
+
+        // The engine sizes the head from its prefetch depth and converts it
+        // with the rest of the bank.
+        EngineConfig config = GetTestConfig();
+        config.sample_rate = 44100;
+        config.stream_prefetch_frames = 1000;
+        decl_audio::Engine engine(config);
+        if (!Expect(engine.LoadBehaviors(fixture_path.string().c_str()), "streamed fixture should load into the engine"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(engine.GetLoadDiagnostics());
+            return false;
+        }
+
+        const decl_audio::assets::DecodedBuffer &converted = *engine.GetAssetBank().buffers[0];
+        return Expect(converted.IsStreamed() && converted.sample_rate == 44100 && converted.HeadFrameCount() == 1000 &&
+                          converted.frame_count == resident.frame_count * 147 / 160,
+                      "a streamed asset should re-read its head at the engine rate");
     }
 } // namespace
 
@@ -103,7 +320,22 @@ bool RunAssetBankTests()
     if (!TestValidAssetsDecodeAndLoad())
         return false;
 
-    if (!TestSampleRateMismatchFailsLoudly())
+    if (!TestMismatchedSampleRateConvertsOnLoad())
+        return false;
+
+    if (!TestPolyphaseResamplerTracksSignal())
+        return false;
+
+    if (!TestResampleCacheConvertsOnce())
+        return false;
+
+    if (!TestResampleKeysTrackFileContents())
+        return false;
+
+    if (!TestCompactFormatsEncodeAndDecode())
+        return false;
+
+    if (!TestStreamedAssetsKeepOnlyTheirHead())
         return false;
 
     std::cout << "AssetBank tests passed\n";
@@ -110,8 +110,8 @@ namespace
             return false;
         for (std::size_t i = 0; i < la.buffers.size(); ++i)
         {
-            const auto &a = orig_audio.buffers[i];
-            const auto &b = la.buffers[i];
+            const auto &a = *orig_audio.buffers[i];
+            const auto &b = *la.buffers[i];
             if (!Expect(b.frame_count == a.frame_count, "round-trip: frame_count"))
                 return false;
             if (!Expect(b.channel_count == a.channel_count, "round-trip: channel_count"))
@@ -138,6 +138,312 @@ namespace
         return Expect(engine_load_ok, "round-trip: Engine::LoadBank should return true");
     }
 
+    bool TestAttenuationCurvesRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("SpatializationBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_curves.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "curves: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "curves: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "curves: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        if (!Expect(!loaded.compiled_bank.attenuation_curves.empty(), "curves: fixture should carry baked LUTs"))
+            return false;
+        if (!Expect(loaded.compiled_bank.attenuation_curves == compile_result.bank.attenuation_curves, "curves: LUT samples should round-trip exactly"))
+            return false;
+
+        for (std::size_t i = 0; i < loaded.compiled_bank.programs.size(); ++i)
+        {
+            if (!Expect(loaded.compiled_bank.programs[i].spatialization.attenuation_curve ==
+                            compile_result.bank.programs[i].spatialization.attenuation_curve,
+                        "curves: each program should keep its LUT offset"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestCompactFormatsRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("CompactFormatBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_compact.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "compact: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "compact: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "compact: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        for (std::size_t i = 0; i < asset_result.bank.buffers.size(); ++i)
+        {
+            const decl_audio::assets::DecodedBuffer &original = *asset_result.bank.buffers[i];
+            const decl_audio::assets::DecodedBuffer &restored = *loaded.asset_bank.buffers[i];
+            if (!Expect(restored.format == original.format && restored.frame_count == original.frame_count &&
+                            restored.pcm16 == original.pcm16 && restored.adpcm == original.adpcm && restored.samples.empty(),
+                        "compact: each buffer should keep its format and encoded samples"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestStreamedAssetsRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("StreamedBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_streamed.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path, decl_audio::assets::kDefaultSampleRate, nullptr, 1000);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "streamed: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "streamed: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "streamed: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        // Only the head is baked; the path resolves back to the same file.
+        const decl_audio::assets::DecodedBuffer &original = *asset_result.bank.buffers[0];
+        const decl_audio::assets::DecodedBuffer &restored = *loaded.asset_bank.buffers[0];
+        return Expect(restored.IsStreamed() && restored.frame_count == original.frame_count && restored.samples == original.samples &&
+                          std::filesystem::equivalent(restored.stream_path, original.stream_path),
+                      "streamed: the buffer should keep its head and its file");
+    }
+
+    bool TestBusesRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("BusBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_buses.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "buses: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "buses: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "buses: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &original = compile_result.bank;
+        const decl_audio::compiler::CompiledBank &restored = loaded.compiled_bank;
+        if (!Expect(restored.buses.size() == original.buses.size() && restored.bus_name_to_id == original.bus_name_to_id,
+                    "buses: the bus graph and its names should round-trip"))
+            return false;
+
+        for (std::size_t i = 0; i < original.buses.size(); ++i)
+        {
+            if (!Expect(restored.buses[i].parent == original.buses[i].parent && restored.buses[i].volume == original.buses[i].volume,
+                        "buses: each bus should keep its parent and volume"))
+                return false;
+        }
+
+        for (std::size_t i = 0; i < original.programs.size(); ++i)
+        {
+            if (!Expect(restored.programs[i].bus == original.programs[i].bus, "buses: each program should keep its bus"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestFiltersRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("FilterBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_filters.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "filters: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "filters: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "filters: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &original = compile_result.bank;
+        const decl_audio::compiler::CompiledBank &restored = loaded.compiled_bank;
+        if (!Expect(original.filters.size() == 2 && restored.filters == original.filters, "filters: the filter pool should round-trip"))
+            return false;
+
+        for (std::size_t i = 0; i < original.programs.size(); ++i)
+        {
+            if (!Expect(restored.programs[i].filter == original.programs[i].filter, "filters: each program should keep its filter"))
+                return false;
+        }
+
+        for (std::size_t i = 0; i < original.buses.size(); ++i)
+        {
+            if (!Expect(restored.buses[i].filter == original.buses[i].filter, "filters: each bus should keep its filter"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestReverbSendsRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("ReverbBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_reverb.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "reverb: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "reverb: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "reverb: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &original = compile_result.bank;
+        const decl_audio::compiler::CompiledBank &restored = loaded.compiled_bank;
+        for (std::size_t i = 0; i < original.buses.size(); ++i)
+        {
+            if (!Expect(restored.buses[i].impulse == original.buses[i].impulse, "reverb: each bus should keep its impulse response"))
+                return false;
+        }
+
+        for (std::size_t i = 0; i < original.programs.size(); ++i)
+        {
+            if (!Expect(restored.programs[i].send_bus == original.programs[i].send_bus && restored.programs[i].send_level == original.programs[i].send_level,
+                        "reverb: each program should keep its send"))
+                return false;
+        }
+
+        const decl_audio::compiler::AssetId impulse = original.buses[original.GetBusId("hall")].impulse;
+        return Expect(loaded.asset_bank.GetBuffer(impulse).samples == asset_result.bank.GetBuffer(impulse).samples,
+                      "reverb: the impulse response samples should round-trip");
+    }
+
+    bool TestBusDucksRoundTrip()
+    {
+        const std::filesystem::path json_path   = GetFixturePath("DuckBehaviorBank.json");
+        const std::filesystem::path output_path = GetFixturePath("temp_duck.dacbank");
+
+        const decl_audio::compiler::CompileResult compile_result =
+            decl_audio::compiler::LoadCompiledBankFromJsonFile(json_path);
+        const decl_audio::assets::LoadResult asset_result =
+            decl_audio::assets::LoadAssetBank(compile_result.bank, json_path);
+        if (!Expect(!compile_result.HasErrors() && !asset_result.HasErrors(), "duck: fixture should compile and load"))
+            return false;
+
+        std::vector<decl_audio::Diagnostic> write_diags;
+        if (!Expect(
+                decl_audio::serialization::WriteBankToFile(
+                    output_path.string().c_str(), compile_result.bank, asset_result.bank, write_diags),
+                "duck: WriteBankToFile should succeed"))
+            return false;
+
+        const decl_audio::serialization::LoadBankResult loaded =
+            decl_audio::serialization::LoadBankFromFile(output_path.string().c_str());
+        std::filesystem::remove(output_path);
+        if (!Expect(!loaded.HasErrors(), "duck: LoadBankFromFile should succeed"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(loaded.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &original = compile_result.bank;
+        const decl_audio::compiler::CompiledBank &restored = loaded.compiled_bank;
+        for (std::size_t i = 0; i < original.buses.size(); ++i)
+        {
+            if (!Expect(restored.buses[i].duck == original.buses[i].duck, "duck: each bus should keep its duck"))
+                return false;
+        }
+
+        return true;
+    }
+
     bool TestMagicMismatch()
     {
         const std::filesystem::path path = GetFixturePath("temp_bad_magic.dacbank");
@@ -280,6 +586,13 @@ namespace
 bool RunBankSerializerTests()
 {
     if (!TestRoundTrip())         return false;
+    if (!TestAttenuationCurvesRoundTrip()) return false;
+    if (!TestCompactFormatsRoundTrip()) return false;
+    if (!TestStreamedAssetsRoundTrip()) return false;
+    if (!TestBusesRoundTrip())    return false;
+    if (!TestFiltersRoundTrip())  return false;
+    if (!TestReverbSendsRoundTrip()) return false;
+    if (!TestBusDucksRoundTrip())  return false;
     if (!TestMagicMismatch())     return false;
     if (!TestVersionMismatch())   return false;
     if (!TestTruncatedFile())     return false;
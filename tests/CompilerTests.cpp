@@ -1,5 +1,7 @@
+#include <cmath>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <string_view>
 
@@ -261,6 +263,102 @@ namespace
         return true;
     }
 
+    bool TestAttenuationCurvesBakeIntoSharedLuts()
+    {
+        using decl_audio::compiler::kAttenuationCurvePoints;
+
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "attenuation curve fixture should compile without errors"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        const auto program_spatialization = [&](const char *name) -> const decl_audio::compiler::CompiledSpatializationSettings &
+        {
+            return bank.GetProgram(bank.GetProgramId(name)).spatialization;
+        };
+
+        if (!Expect(program_spatialization("spatial.mono").attenuation_curve == program_spatialization("spatial.stereo").attenuation_curve,
+                    "programs with the same curve should share one LUT"))
+            return false;
+        if (!Expect(bank.attenuation_curves.size() == 3 * kAttenuationCurvePoints, "the fixture's three distinct curves should bake three LUTs"))
+            return false;
+
+        // Linear: 1 - t; point 16 of 64 is a quarter of the way out.
+        const std::span<const float> linear = bank.GetAttenuationCurve(program_spatialization("spatial.mono"));
+        if (!Expect(linear.front() == 1.0f && linear.back() == 0.0f && linear[16] == 0.75f, "linear curve should bake 1 - t"))
+            return false;
+
+        // Inverse over 1..5, tapered: (1/d - 1/5) / (1 - 1/5); the midpoint is d = 3.
+        const decl_audio::compiler::CompiledSpatializationSettings &inverse_settings = program_spatialization("spatial.inverse");
+        const std::span<const float> inverse = bank.GetAttenuationCurve(inverse_settings);
+        if (!Expect(inverse_settings.attenuation == decl_audio::compiler::AttenuationMode::Inverse, "inverse program should keep its attenuation mode"))
+            return false;
+        if (!Expect(inverse.front() == 1.0f && inverse.back() == 0.0f, "inverse curve should run from 1 at minDistance to 0 at maxDistance"))
+            return false;
+        if (!Expect(std::fabs(inverse[32] - 1.0f / 6.0f) <= 1e-7f, "inverse curve should follow the tapered inverse law"))
+            return false;
+
+        // Custom: held at 1 until d = 2 (point 16), 0.25 at d = 3 (point 32), and
+        // halfway along the last segment at d = 4 (point 48).
+        const std::span<const float> custom = bank.GetAttenuationCurve(program_spatialization("spatial.custom"));
+        if (!Expect(custom[0] == 1.0f && custom[16] == 1.0f, "custom curve should hold its first gain before the first point"))
+            return false;
+        if (!Expect(custom[32] == 0.25f && custom[48] == 0.125f && custom.back() == 0.0f, "custom curve should interpolate between authored points"))
+            return false;
+
+        constexpr std::string_view kInvalidCurveSource = R"json(
+{
+  "behaviors": [
+    {
+      "id": "spatial.invalid.custom",
+      "spatialization": {
+        "minDistance": 1.0,
+        "maxDistance": 5.0,
+        "attenuation": "custom",
+        "attenuationCurve": [
+          { "distance": 6.0, "gain": 0.5 }
+        ]
+      },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "spatial.invalid.inverse",
+      "spatialization": {
+        "minDistance": 0.0,
+        "maxDistance": 5.0,
+        "attenuation": "inverseSquare",
+        "attenuationCurve": [
+          { "distance": 1.0, "gain": 1.0 },
+          { "distance": 2.0, "gain": 0.0 }
+        ]
+      },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidCurveSource, "AttenuationCurveValidation.json");
+        if (!Expect(!parse_result.HasErrors(), "curve validation fixture should parse before compile validation"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(parse_result.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("attenuationCurve needs at least two points") != std::string::npos, "custom curves should need two points"))
+            return false;
+        if (!Expect(diagnostics.find("attenuationCurve requires attenuation 'custom'") != std::string::npos, "curves should be rejected on built-in modes"))
+            return false;
+
+        return Expect(diagnostics.find("minDistance must be > 0 for this attenuation") != std::string::npos, "inverse laws should need a positive minDistance");
+    }
+
     bool TestNestedNodeValidationAndLowering()
     {
         const std::filesystem::path fixture_path = GetFixturePath("NestedBehaviorBank.json");
@@ -295,6 +393,14 @@ namespace
         if (!Expect(select_program.max_concurrent_voices == 2, "select fixture should budget to the loudest chosen subtree"))
             return false;
 
+        const decl_audio::compiler::CompiledProgram &pitched_program = compile_result.bank.GetProgram(compile_result.bank.GetProgramId("nested.pitched_oneshot"));
+        const std::span<const decl_audio::compiler::CompiledNode> pitched_nodes = compile_result.bank.GetProgramNodes(pitched_program.id);
+        if (!Expect(pitched_program.parameter_slot_count == 1, "pitched program should compile one runtime parameter slot"))
+            return false;
+        if (!Expect(pitched_nodes[1].type == decl_audio::compiler::NodeType::OneShot && pitched_nodes[1].parameter_slot == 0,
+                    "pitchParameter should bind the leaf's parameter slot"))
+            return false;
+
         constexpr std::string_view kInvalidNestedSource = R"json(
 {
   "behaviors": [
@@ -314,6 +420,17 @@ namespace
         {
           "type": "select",
           "children": []
+        },
+        {
+          "type": "sequence",
+          "pitchParameter": "mix",
+          "children": [
+            {
+              "type": "oneshot",
+              "asset": "audio/test_48_24_1ch.wav",
+              "pitchParameter": "undeclared"
+            }
+          ]
         }
       ]
     }
@@ -336,10 +453,505 @@ namespace
             return false;
         if (!Expect(diagnostics.find("select nodes require at least one child") != std::string::npos, "invalid select should require children"))
             return false;
+        if (!Expect(diagnostics.find("sequence nodes do not allow pitchParameter") != std::string::npos, "structural nodes should reject pitchParameter"))
+            return false;
+        if (!Expect(diagnostics.find("pitchParameter 'undeclared' must be declared") != std::string::npos, "pitchParameter should require a declared parameter"))
+            return false;
 
         return true;
     }
 
+    bool TestAssetFormatsLowerAndValidate()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("CompactFormatBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "compact format fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        if (!Expect(bank.asset_formats.size() == bank.asset_paths.size(), "every asset should carry a sample format"))
+            return false;
+        if (!Expect(bank.asset_formats[bank.GetAssetId("audio/test_48_24_1ch.wav")] == decl_audio::compiler::SampleFormat::S16 &&
+                        bank.asset_formats[bank.GetAssetId("audio/test_48_24_2ch.wav")] == decl_audio::compiler::SampleFormat::ImaAdpcm,
+                    "assetFormats should set each named asset's format"))
+            return false;
+
+        constexpr std::string_view kInvalidFormatSource = R"json(
+{
+  "assetFormats": {
+    "audio/test_48_24_1ch.wav": "mp3",
+    "audio/unplayed.wav": "s16"
+  },
+  "behaviors": [
+    {
+      "id": "formats.invalid",
+      "program": [
+        {
+          "type": "oneshot",
+          "asset": "audio/test_48_24_1ch.wav"
+        }
+      ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidFormatSource, "AssetFormats.json");
+        const std::string parse_diagnostics = decl_audio::DumpDiagnostics(parse_result.diagnostics);
+        if (!Expect(parse_diagnostics.find("must be 'f32', 's16' or 'adpcm'") != std::string::npos, "assetFormats should reject unknown format names"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string compile_diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        return Expect(compile_diagnostics.find("assetFormats names 'audio/unplayed.wav', which no program plays") != std::string::npos,
+                      "assetFormats should reject assets no program plays");
+    }
+
+    bool TestStreamedAssetsLowerAndValidate()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("StreamedBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "streamed fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        if (!Expect(bank.asset_streamed.size() == bank.asset_paths.size() && bank.asset_streamed[bank.GetAssetId("audio/test_48_24_2ch.wav")],
+                    "a leaf's stream flag should mark its asset streamed"))
+            return false;
+
+        constexpr std::string_view kInvalidStreamSource = R"json(
+{
+  "assetFormats": {
+    "audio/test_48_24_2ch.wav": "adpcm"
+  },
+  "behaviors": [
+    {
+      "id": "stream.invalid",
+      "program": [
+        {
+          "type": "sequence",
+          "stream": true,
+          "children": [
+            {
+              "type": "oneshot",
+              "asset": "audio/test_48_24_2ch.wav",
+              "stream": true
+            }
+          ]
+        }
+      ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidStreamSource, "StreamValidation.json");
+        if (!Expect(!parse_result.HasErrors(), "invalid stream fixture should parse before compile validation"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("sequence nodes do not allow stream") != std::string::npos, "structural nodes should reject stream"))
+            return false;
+
+        return Expect(diagnostics.find("assetFormats cannot compact 'audio/test_48_24_2ch.wav', which is streamed") != std::string::npos,
+                      "assetFormats should reject compacting a streamed asset");
+    }
+
+    bool TestBusGraphFlattensParentsFirstAndValidates()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("BusBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "bus fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        // sfx.weapons is authored before its parent but must be emitted after it.
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        const decl_audio::compiler::BusId sfx = bank.GetBusId("sfx");
+        const decl_audio::compiler::BusId weapons = bank.GetBusId("sfx.weapons");
+        if (!Expect(bank.buses.size() == 3 && sfx < weapons && bank.buses[weapons].parent == sfx, "buses should be flattened parents first"))
+            return false;
+        if (!Expect(bank.buses[bank.GetBusId("music")].parent == decl_audio::compiler::kMasterBus && bank.buses[weapons].volume == 0.5f,
+                    "top-level buses should feed the master and keep their authored volume"))
+            return false;
+        if (!Expect(bank.programs[bank.GetProgramId("bus.weapons")].bus == weapons &&
+                        bank.programs[bank.GetProgramId("bus.master")].bus == decl_audio::compiler::kMasterBus,
+                    "programs should route to their behavior's bus, or the master without one"))
+            return false;
+
+        constexpr std::string_view kInvalidBusSource = R"json(
+{
+  "buses": [
+    { "id": "dup" },
+    { "id": "dup" },
+    { "id": "orphan", "parent": "missing" },
+    { "id": "loud", "volume": -1 }
+  ],
+  "behaviors": [
+    {
+      "id": "bus.invalid",
+      "bus": "nowhere",
+      "program": [
+        {
+          "type": "oneshot",
+          "asset": "audio/test_48_24_1ch.wav"
+        }
+      ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidBusSource, "BusValidation.json");
+        if (!Expect(!parse_result.HasErrors(), "invalid bus fixture should parse before compile validation"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("duplicate bus id 'dup'") != std::string::npos, "bus ids should be unique"))
+            return false;
+        if (!Expect(diagnostics.find("bus 'orphan' names unknown parent bus 'missing'") != std::string::npos, "bus parents should be declared"))
+            return false;
+        if (!Expect(diagnostics.find("bus 'loud' volume must be >= 0") != std::string::npos, "bus volumes should not be negative"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'bus.invalid' plays on unknown bus 'nowhere'") != std::string::npos, "behaviors should name a declared bus"))
+            return false;
+
+        constexpr std::string_view kCyclicBusSource = R"json(
+{
+  "buses": [
+    { "id": "a", "parent": "b" },
+    { "id": "b", "parent": "a" }
+  ],
+  "behaviors": []
+}
+)json";
+
+        const decl_audio::compiler::ParseResult cyclic_parse_result = decl_audio::compiler::ParseAuthoringJson(kCyclicBusSource, "BusCycle.json");
+        const decl_audio::compiler::CompileResult cyclic_result = decl_audio::compiler::CompileAuthoringDocument(cyclic_parse_result.document);
+        return Expect(decl_audio::DumpDiagnostics(cyclic_result.diagnostics).find("is its own ancestor") != std::string::npos,
+                      "a bus cycle should fail to compile");
+    }
+
+    bool TestFiltersLowerAndValidate()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("FilterBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "filter fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        if (!Expect(bank.programs[bank.GetProgramId("filter.dry")].filter == decl_audio::compiler::kNoFilter &&
+                        bank.programs[bank.GetProgramId("filter.bus")].filter == decl_audio::compiler::kNoFilter,
+                    "programs without an authored filter should not get one"))
+            return false;
+
+        // The cutoff binds to the program's slot for its parameter and sweeps
+        // the authored range; a fixed cutoff is a range of one frequency.
+        const decl_audio::compiler::CompiledProgram &occluded = bank.programs[bank.GetProgramId("filter.occluded")];
+        if (!Expect(occluded.filter < bank.filters.size(), "a filtered program should point into the filter pool"))
+            return false;
+        const decl_audio::compiler::CompiledFilter &program_filter = bank.filters[occluded.filter];
+        if (!Expect(program_filter.type == decl_audio::compiler::FilterType::LowPass && program_filter.parameter_slot == 0 &&
+                        bank.GetProgramParameters(occluded.id)[0] == bank.GetParameterId("occlusion") &&
+                        program_filter.cutoff_from == 20000.0f && program_filter.cutoff_to == 100.0f,
+                    "a parameter-driven cutoff should lower to the program's parameter slot and range"))
+            return false;
+
+        const decl_audio::compiler::CompiledBus &muffled = bank.buses[bank.GetBusId("muffled")];
+        if (!Expect(muffled.filter < bank.filters.size() &&
+                        bank.filters[muffled.filter].parameter_slot == decl_audio::compiler::kInvalidParameterSlot &&
+                        bank.filters[muffled.filter].cutoff_from == 100.0f && bank.filters[muffled.filter].cutoff_to == 100.0f,
+                    "a bus filter should lower to a fixed cutoff"))
+            return false;
+
+        constexpr std::string_view kInvalidFilterSource = R"json(
+{
+  "buses": [
+    { "id": "swept", "filter": { "type": "lowpass", "cutoffParameter": "speed", "cutoffRange": [100, 1000] } },
+    { "id": "unknown", "filter": { "type": "bandpass", "cutoff": 100 } }
+  ],
+  "behaviors": [
+    {
+      "id": "filter.both",
+      "parameters": ["speed"],
+      "filter": { "type": "lowpass", "cutoff": 100, "cutoffParameter": "speed", "cutoffRange": [100, 1000] },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "filter.unranged",
+      "parameters": ["speed"],
+      "filter": { "type": "highpass", "cutoffParameter": "speed", "q": 0 },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "filter.shelfless",
+      "filter": { "type": "lowpass", "cutoff": 100, "gainDb": -6 },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "filter.undeclared",
+      "filter": { "type": "lowpass", "cutoffParameter": "missing", "cutoffRange": [100, 1000] },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidFilterSource, "FilterValidation.json");
+        if (!Expect(decl_audio::DumpDiagnostics(parse_result.diagnostics).find("must be 'lowpass', 'highpass', 'lowshelf' or 'highshelf'") != std::string::npos,
+                    "an unknown filter type should fail to parse"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("bus 'swept' filter cannot bind a cutoffParameter") != std::string::npos, "bus filters should have a fixed cutoff"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'filter.both' filter takes either cutoff or cutoffParameter, not both") != std::string::npos,
+                    "a filter should not take both a fixed and a bound cutoff"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'filter.unranged' filter cutoffParameter needs a cutoffRange") != std::string::npos,
+                    "a bound cutoff should need a range"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'filter.unranged' filter q must be > 0") != std::string::npos, "filter q should be positive"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'filter.shelfless' filter gainDb only applies to shelf filters") != std::string::npos,
+                    "gainDb should be rejected on pass filters"))
+            return false;
+        return Expect(diagnostics.find("behavior 'filter.undeclared' filter cutoffParameter 'missing' must be declared in behavior.parameters") != std::string::npos,
+                      "a cutoff parameter should be declared by the behavior");
+    }
+
+    bool TestReverbSendsLowerAndValidate()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("ReverbBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "reverb fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        // The impulse response is an asset of the bank like any other; the
+        // send points at the bus that carries it.
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        const decl_audio::compiler::BusId hall = bank.GetBusId("hall");
+        const auto impulse_it = bank.asset_name_to_id.find("audio/test_48_24_1ch_2.wav");
+        if (!Expect(impulse_it != bank.asset_name_to_id.end() && bank.buses[hall].impulse == impulse_it->second,
+                    "a bus impulse response should intern as a bank asset"))
+            return false;
+
+        const decl_audio::compiler::CompiledProgram &wet = bank.programs[bank.GetProgramId("reverb.wet")];
+        const decl_audio::compiler::CompiledProgram &dry = bank.programs[bank.GetProgramId("reverb.dry")];
+        if (!Expect(wet.send_bus == hall && wet.send_level == 0.25f && wet.bus == decl_audio::compiler::kMasterBus,
+                    "a send should lower to its bus and level without moving the program's own bus"))
+            return false;
+        if (!Expect(dry.send_bus == decl_audio::compiler::kMasterBus && dry.send_level == 0.0f, "a program without a send should not get one"))
+            return false;
+
+        constexpr std::string_view kInvalidSendSource = R"json(
+{
+  "buses": [
+    { "id": "plain" },
+    { "id": "cave", "impulseResponse": "audio/test_48_24_1ch_2.wav" },
+    { "id": "blank", "impulseResponse": "" }
+  ],
+  "behaviors": [
+    {
+      "id": "send.unknown",
+      "send": { "bus": "missing" },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "send.dry",
+      "send": { "bus": "plain" },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "send.negative",
+      "send": { "bus": "cave", "level": -1 },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ]
+    },
+    {
+      "id": "send.streams",
+      "send": { "bus": "cave", "gain": 1 },
+      "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch_2.wav", "stream": true } ]
+    }
+  ]
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidSendSource, "SendValidation.json");
+        const std::string parse_diagnostics = decl_audio::DumpDiagnostics(parse_result.diagnostics);
+        if (!Expect(parse_diagnostics.find("impulseResponse") != std::string::npos && parse_diagnostics.find("must be a non-empty string") != std::string::npos,
+                    "an empty impulseResponse should fail to parse"))
+            return false;
+        if (!Expect(parse_diagnostics.find("send.gain") != std::string::npos && parse_diagnostics.find("is not a supported send field") != std::string::npos,
+                    "unknown send fields should fail to parse"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("behavior 'send.unknown' sends to unknown bus 'missing'") != std::string::npos, "a send to an unknown bus should fail to compile"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'send.dry' sends to bus 'plain', which has no impulseResponse") != std::string::npos,
+                    "a send should need a bus with an impulse response"))
+            return false;
+        if (!Expect(diagnostics.find("behavior 'send.negative' send level must be >= 0") != std::string::npos, "a negative send level should fail to compile"))
+            return false;
+        return Expect(diagnostics.find("bus 'cave' impulseResponse 'audio/test_48_24_1ch_2.wav' is streamed by a program") != std::string::npos,
+                      "an impulse response should not be streamed");
+    }
+
+    // `source` compiled, or an empty bank after reporting its diagnostics.
+    decl_audio::compiler::CompiledBank CompileBusSource(const std::string_view source, const char *name)
+    {
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(source, name);
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        if (parse_result.HasErrors() || compile_result.HasErrors())
+        {
+            std::cerr << decl_audio::DumpDiagnostics(parse_result.diagnostics) << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return {};
+        }
+        return compile_result.bank;
+    }
+
+    bool TestBusDucksLowerAndOrder()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("DuckBehaviorBank.json");
+        const decl_audio::compiler::CompileResult compile_result = decl_audio::compiler::LoadCompiledBankFromJsonFile(fixture_path);
+        if (!Expect(!compile_result.HasErrors(), "duck fixture should compile"))
+        {
+            std::cerr << decl_audio::DumpDiagnostics(compile_result.diagnostics);
+            return false;
+        }
+
+        // Dialogue is authored first, but the bus it ducks must fold after it
+        // has mixed, so it is placed below music.
+        const decl_audio::compiler::CompiledBank &bank = compile_result.bank;
+        const decl_audio::compiler::BusId music = bank.GetBusId("music");
+        const decl_audio::compiler::BusId dialogue = bank.GetBusId("dialogue");
+        if (!Expect(music < dialogue, "a ducked bus should be placed before the bus that ducks it"))
+            return false;
+        const decl_audio::compiler::CompiledDuck &duck = bank.buses[music].duck;
+        if (!Expect(duck.by == dialogue && std::fabs(duck.depth - 0.25118864f) < 1e-6f && std::fabs(duck.threshold - 0.01f) < 1e-8f &&
+                        duck.attack_ms == 0.0f && duck.release_ms == 50.0f,
+                    "a duck should lower to its trigger, linear depth and threshold, and times"))
+            return false;
+        if (!Expect(bank.buses[dialogue].duck.by == decl_audio::compiler::kMasterBus, "a bus without a duck should not get one"))
+            return false;
+
+        constexpr std::string_view kInvalidDuckSource = R"json(
+{
+  "buses": [
+    { "id": "game" },
+    { "id": "ambience", "duck": { "by": "missing" } },
+    { "id": "vo", "duck": { "by": "vo", "depthDb": 6, "thresholdDb": 3, "attackMs": -1 } },
+    { "id": "stinger", "duck": { "by": "game", "hold": 10 } }
+  ],
+  "behaviors": []
+}
+)json";
+
+        const decl_audio::compiler::ParseResult parse_result = decl_audio::compiler::ParseAuthoringJson(kInvalidDuckSource, "DuckValidation.json");
+        const std::string parse_diagnostics = decl_audio::DumpDiagnostics(parse_result.diagnostics);
+        if (!Expect(parse_diagnostics.find("duck.hold") != std::string::npos && parse_diagnostics.find("is not a supported duck field") != std::string::npos,
+                    "unknown duck fields should fail to parse"))
+            return false;
+
+        const decl_audio::compiler::CompileResult invalid_result = decl_audio::compiler::CompileAuthoringDocument(parse_result.document);
+        const std::string diagnostics = decl_audio::DumpDiagnostics(invalid_result.diagnostics);
+        if (!Expect(diagnostics.find("bus 'ambience' is ducked by unknown bus 'missing'") != std::string::npos, "a duck by an unknown bus should fail to compile"))
+            return false;
+        if (!Expect(diagnostics.find("bus 'vo' cannot duck itself") != std::string::npos, "a bus should not duck itself"))
+            return false;
+        if (!Expect(diagnostics.find("bus 'vo' duck depthDb must be a finite value <= 0") != std::string::npos &&
+                        diagnostics.find("bus 'vo' duck thresholdDb must be a finite value <= 0") != std::string::npos &&
+                        diagnostics.find("bus 'vo' duck attackMs and releaseMs must be finite values >= 0") != std::string::npos,
+                    "duck settings should be range checked"))
+            return false;
+
+        // A trigger that mixes the bus it ducks could never finish first.
+        constexpr std::string_view kAncestorDuckSource = R"json(
+{
+  "buses": [
+    { "id": "game" },
+    { "id": "music", "parent": "game", "duck": { "by": "game" } }
+  ],
+  "behaviors": []
+}
+)json";
+        constexpr std::string_view kMutualDuckSource = R"json(
+{
+  "buses": [
+    { "id": "music", "duck": { "by": "vo" } },
+    { "id": "vo", "duck": { "by": "music" } }
+  ],
+  "behaviors": []
+}
+)json";
+
+        for (const std::string_view source : {kAncestorDuckSource, kMutualDuckSource})
+        {
+            const decl_audio::compiler::ParseResult cyclic_parse_result = decl_audio::compiler::ParseAuthoringJson(source, "DuckCycle.json");
+            const decl_audio::compiler::CompileResult cyclic_result = decl_audio::compiler::CompileAuthoringDocument(cyclic_parse_result.document);
+            if (!Expect(decl_audio::DumpDiagnostics(cyclic_result.diagnostics).find("which depends on it") != std::string::npos,
+                        "a duck whose trigger depends on the ducked bus should fail to compile"))
+            {
+                std::cerr << decl_audio::DumpDiagnostics(cyclic_result.diagnostics);
+                return false;
+            }
+        }
+
+        // Across banks a new bus cannot be ducked by one an earlier bank
+        // placed below it, and a shared bus keeps its duck.
+        constexpr std::string_view kDialogueBankSource = R"json(
+{
+  "buses": [ { "id": "dialogue" } ],
+  "behaviors": [ { "id": "vo.line", "bus": "dialogue", "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ] } ]
+}
+)json";
+        constexpr std::string_view kUnduckedBankSource = R"json(
+{
+  "buses": [ { "id": "music" } ],
+  "behaviors": [ { "id": "music.cue", "bus": "music", "program": [ { "type": "oneshot", "asset": "audio/test_48_24_1ch.wav" } ] } ]
+}
+)json";
+        decl_audio::compiler::CompiledBank dialogue_bank = CompileBusSource(kDialogueBankSource, "DialogueBank.json");
+        decl_audio::compiler::CompiledBank ducked_bank = bank;
+        decl_audio::compiler::CompiledBank unducked_bank = CompileBusSource(kUnduckedBankSource, "MusicBank.json");
+        const decl_audio::assets::AssetBank no_assets;
+
+        decl_audio::runtime::BusRegistry late_registry(8);
+        (void)late_registry.MergeBank(dialogue_bank, no_assets);
+        if (!Expect(late_registry.CheckBank(ducked_bank, no_assets).find("which an earlier bank declared") != std::string::npos,
+                    "a new bus ducked by an existing one should be rejected"))
+            return false;
+
+        decl_audio::runtime::BusRegistry registry(8);
+        if (!Expect(registry.CheckBank(ducked_bank, no_assets).empty(), "the duck fixture should merge into an empty registry"))
+            return false;
+        (void)registry.MergeBank(ducked_bank, no_assets);
+        if (!Expect(registry.Duck(music).by == dialogue, "a merged duck should name its trigger's global id"))
+            return false;
+        if (!Expect(registry.CheckBank(dialogue_bank, no_assets).empty(), "a bank sharing only the trigger should merge"))
+            return false;
+        return Expect(registry.CheckBank(unducked_bank, no_assets).find("impulse response or duck") != std::string::npos,
+                      "a bank redeclaring a ducked bus without its duck should be rejected");
+    }
+
     bool TestAudioConfigDefaultsAndValidation()
     {
         auto audio_config = GetDefaultConfig();
@@ -354,6 +966,27 @@ namespace
             return false;
         if (!Expect(audio_config.max_block_frames == 4096u, "default audio config should reserve a bounded render block slack"))
             return false;
+        if (!Expect(audio_config.render_worker_count == 0u, "default audio config should render on the callback thread only"))
+            return false;
+        if (!Expect(audio_config.gain_ramp_frames == 256u, "default audio config should smooth gain changes over a short ramp"))
+            return false;
+        if (!Expect(audio_config.steal_policy == DECL_AUDIO_STEAL_QUIETEST, "default audio config should steal the quietest instance at capacity"))
+            return false;
+        if (!Expect(audio_config.render_quantum_frames == 256u, "default audio config should mix in a fixed render quantum"))
+            return false;
+        if (!Expect(audio_config.render_ahead_frames == 0u, "default audio config should mix inside the device callback"))
+            return false;
+        if (!Expect(audio_config.stream_voice_count == 0u, "default audio config should start no disk streaming thread"))
+            return false;
+        if (!Expect(audio_config.max_bus_count == 32u, "default audio config should reserve room for a modest bus graph"))
+            return false;
+        if (!Expect(audio_config.max_reverb_bus_count == 0u && audio_config.reverb_partition_frames == 256u && audio_config.max_impulse_frames == 192000u,
+                    "default audio config should start no reverb thread, ready for four-second impulse responses"))
+            return false;
+        if (!Expect(audio_config.master_limiter_lookahead_frames == 0u && audio_config.master_limiter_release_frames == 4800u &&
+                        audio_config.master_limiter_ceiling_db == -1.0f,
+                    "default audio config should leave the master limiter off, ready at -1 dB with a 100 ms release"))
+            return false;
         if (!Expect(audio_config.backend == DECL_AUDIO_BACKEND_PLATFORM_DEFAULT, "default audio config should use the platform backend"))
             return false;
 
@@ -363,6 +996,18 @@ namespace
             return false;
         if (!Expect(engine == nullptr, "CreateEngine should leave the output engine pointer null on invalid audio config"))
             return false;
+        audio_config.output_channel_count = 5;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject channel counts without a speaker layout"))
+            return false;
+        audio_config.backend = DECL_AUDIO_BACKEND_SILENT;
+        for (const std::uint32_t surround_channel_count : {4u, 6u, 8u})
+        {
+            audio_config.output_channel_count = surround_channel_count;
+            if (!Expect(CreateEngine(&audio_config, &engine), "CreateEngine should accept quad, 5.1 and 7.1 output"))
+                return false;
+            DestroyEngine(engine);
+            engine = nullptr;
+        }
 
         audio_config = GetDefaultConfig();
         audio_config.max_instances = 0;
@@ -371,6 +1016,97 @@ namespace
         if (!Expect(engine == nullptr, "CreateEngine should leave the output engine pointer null on invalid runtime capacity"))
             return false;
 
+        audio_config = GetDefaultConfig();
+        audio_config.render_worker_count = 65;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject an unbounded render worker count"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.gain_ramp_frames = audio_config.sample_rate + 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject gain ramps longer than one second"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.steal_policy = static_cast<DeclAudioStealPolicy>(DECL_AUDIO_STEAL_PRIORITY + 1);
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject unknown steal policies"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.render_quantum_frames = audio_config.max_block_frames + 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject render quanta larger than the block capacity"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.render_ahead_frames = 2048;
+        audio_config.render_ahead_headroom_frames = audio_config.render_quantum_frames - 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject render-ahead headroom smaller than one mix block"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.render_ahead_frames = audio_config.render_quantum_frames - 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject a render-ahead depth smaller than one mix block"))
+            return false;
+
+        // Without a quantum the render-ahead thread mixes whole block-capacity
+        // blocks, however short the device period.
+        audio_config = GetDefaultConfig();
+        audio_config.render_quantum_frames = 0;
+        audio_config.render_ahead_frames = audio_config.max_block_frames;
+        audio_config.render_ahead_headroom_frames = audio_config.max_block_frames - 1;
+        if (!Expect(audio_config.callback_frame_count <= audio_config.render_ahead_headroom_frames, "the default callback period should fit the short headroom") ||
+            !Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject render-ahead headroom smaller than the block capacity without a quantum"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.stream_prefetch_frames = 0;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject an empty stream prefetch"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.max_bus_count = 65535;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject a bus count that reaches the master bus id"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        for (const std::uint32_t partition_frames : {32u, 96u, 8192u})
+        {
+            audio_config.reverb_partition_frames = partition_frames;
+            if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject reverb partitions that are not a power of two from 64 to 4096"))
+                return false;
+        }
+
+        audio_config = GetDefaultConfig();
+        audio_config.max_reverb_bus_count = 33;
+        audio_config.max_bus_count = 64;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject more than 32 reverb buses"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.master_limiter_lookahead_frames = audio_config.sample_rate / 20 + 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject a master limiter lookahead over 50 ms"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        audio_config.master_limiter_release_frames = audio_config.sample_rate + 1;
+        if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject a master limiter release over one second"))
+            return false;
+
+        audio_config = GetDefaultConfig();
+        for (const float ceiling_db : {0.5f, std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::infinity()})
+        {
+            audio_config.master_limiter_ceiling_db = ceiling_db;
+            if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject a master limiter ceiling that is not a finite level at most 0 dB"))
+                return false;
+        }
+
+        audio_config = GetDefaultConfig();
+        audio_config.backend = DECL_AUDIO_BACKEND_SILENT;
+        audio_config.master_limiter_lookahead_frames = audio_config.sample_rate / 20;
+        if (!Expect(CreateEngine(&audio_config, &engine), "CreateEngine should accept a 50 ms master limiter lookahead"))
+            return false;
+        DestroyEngine(engine);
+        engine = nullptr;
+
         audio_config = GetDefaultConfig();
         audio_config.max_block_frames = audio_config.callback_frame_count - 1;
         if (!Expect(!CreateEngine(&audio_config, &engine), "CreateEngine should reject runtime block capacities smaller than the callback size"))
@@ -399,9 +1135,30 @@ bool RunCompilerTests()
     if (!TestSpatializationValidationFailsLoudly())
         return false;
 
+    if (!TestAttenuationCurvesBakeIntoSharedLuts())
+        return false;
+
     if (!TestNestedNodeValidationAndLowering())
         return false;
 
+    if (!TestAssetFormatsLowerAndValidate())
+        return false;
+
+    if (!TestStreamedAssetsLowerAndValidate())
+        return false;
+
+    if (!TestBusGraphFlattensParentsFirstAndValidates())
+        return false;
+
+    if (!TestFiltersLowerAndValidate())
+        return false;
+
+    if (!TestReverbSendsLowerAndValidate())
+        return false;
+
+    if (!TestBusDucksLowerAndOrder())
+        return false;
+
     if (!TestAudioConfigDefaultsAndValidation())
         return false;
 
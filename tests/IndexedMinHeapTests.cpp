@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../src/core/IndexedMinHeap.hpp"
+
+namespace
+{
+    using decl_audio::IndexedMinHeap;
+
+    bool Expect(bool condition, const char *message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    bool TestPushUpdateErase()
+    {
+        IndexedMinHeap<int> heap(4);
+
+        if (!Expect(heap.Empty() && !heap.Contains(0), "a new heap should be empty"))
+            return false;
+        if (!Expect(heap.Push(0, 30) && heap.Push(1, 10) && heap.Push(2, 20), "pushes of new handles should succeed"))
+            return false;
+        if (!Expect(!heap.Push(1, 5) && !heap.Push(4, 5), "duplicate and out-of-range pushes should be rejected"))
+            return false;
+        if (!Expect(heap.Top() == 1 && heap.Size() == 3, "the smallest key should be on top"))
+            return false;
+
+        if (!Expect(heap.Update(0, 5) && heap.Top() == 0, "lowering a key should move it to the top"))
+            return false;
+        if (!Expect(heap.Update(0, 40) && heap.Top() == 1, "raising the top key should sink it"))
+            return false;
+
+        if (!Expect(heap.Erase(1) && !heap.Contains(1) && heap.Top() == 2, "erasing the top should promote the next smallest"))
+            return false;
+        if (!Expect(!heap.Erase(1) && !heap.Update(1, 0), "erased handles should no longer be present"))
+            return false;
+
+        return Expect(heap.Erase(2) && heap.Erase(0) && heap.Empty(), "erasing every handle should empty the heap");
+    }
+
+    bool TestChurnMatchesReference()
+    {
+        constexpr std::uint32_t kCapacity = 97;
+        IndexedMinHeap<std::uint32_t> heap(kCapacity);
+        std::vector<bool> present(kCapacity, false);
+        std::vector<std::uint32_t> keys(kCapacity, 0);
+
+        std::uint64_t rng = 0x9E3779B97F4A7C15ULL;
+        for (int step = 0; step < 20000; ++step)
+        {
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            const std::uint32_t handle = static_cast<std::uint32_t>(rng >> 33U) % kCapacity;
+            const std::uint32_t key = static_cast<std::uint32_t>(rng >> 45U) % 1000U;
+            switch ((rng >> 20U) % 3U)
+            {
+            case 0:
+                if (!Expect(heap.Push(handle, key) != present[handle], "push should succeed exactly when the handle is absent"))
+                    return false;
+                if (!present[handle])
+                {
+                    present[handle] = true;
+                    keys[handle] = key;
+                }
+                break;
+
+            case 1:
+                if (!Expect(heap.Update(handle, key) == present[handle], "update should succeed exactly when the handle is present"))
+                    return false;
+                if (present[handle])
+                {
+                    keys[handle] = key;
+                }
+                break;
+
+            default:
+                if (!Expect(heap.Erase(handle) == present[handle], "erase should succeed exactly when the handle is present"))
+                    return false;
+                present[handle] = false;
+                break;
+            }
+
+            std::size_t expected_size = 0;
+            std::uint32_t min_key = UINT32_MAX;
+            for (std::uint32_t h = 0; h < kCapacity; ++h)
+            {
+                if (present[h])
+                {
+                    ++expected_size;
+                    min_key = keys[h] < min_key ? keys[h] : min_key;
+                }
+            }
+
+            if (!Expect(heap.Size() == expected_size, "size should match the reference after churn"))
+                return false;
+            if (expected_size > 0 && !Expect(heap.KeyOf(heap.Top()) == min_key, "the top should always carry the smallest live key"))
+                return false;
+        }
+
+        return true;
+    }
+} // namespace
+
+bool RunIndexedMinHeapTests()
+{
+    if (!TestPushUpdateErase())
+    {
+        return false;
+    }
+
+    if (!TestChurnMatchesReference())
+    {
+        return false;
+    }
+
+    std::cout << "IndexedMinHeap tests passed\n";
+    return true;
+}
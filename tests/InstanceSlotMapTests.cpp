@@ -0,0 +1,117 @@
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/playback/InstanceSlotMap.hpp"
+
+namespace
+{
+    using decl_audio::playback::InstanceId;
+    using decl_audio::playback::InstanceSlotMap;
+
+    bool Expect(bool condition, const char *message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    bool TestInsertFindErase()
+    {
+        InstanceSlotMap map(4);
+
+        if (!Expect(map.Find(7) == InstanceSlotMap::kInvalidSlot, "empty map should not find any id"))
+            return false;
+        if (!Expect(map.Insert(7, 0) && map.Insert(8, 1) && map.Insert(9, 2), "inserts below capacity should succeed"))
+            return false;
+        if (!Expect(!map.Insert(8, 3), "inserting a mapped id should fail"))
+            return false;
+        if (!Expect(map.Find(8) == 1, "find should return the mapped slot"))
+            return false;
+        if (!Expect(map.Insert(10, 3) && !map.Insert(11, 0), "insert should fail once max_entries ids are mapped"))
+            return false;
+        if (!Expect(map.Erase(8) && !map.Erase(8), "erase should succeed exactly once per mapped id"))
+            return false;
+        if (!Expect(map.Find(8) == InstanceSlotMap::kInvalidSlot && map.Find(9) == 2 && map.Find(10) == 3,
+                    "erase should unmap only the erased id"))
+            return false;
+
+        return Expect(map.Size() == 3, "size should track inserts and erases");
+    }
+
+    // Heavy churn at full load against a reference map. Sequential ids with
+    // interleaved erases exercise every backward-shift case, including runs
+    // that wrap past the end of the table.
+    bool TestChurnMatchesReference()
+    {
+        constexpr std::size_t kMaxEntries = 64;
+        InstanceSlotMap map(kMaxEntries);
+        std::unordered_map<InstanceId, std::uint32_t> reference;
+        std::vector<InstanceId> live;
+
+        std::uint64_t rng = 0x1234567ULL;
+        InstanceId next_id = 1;
+        InstanceId last_erased = 0;
+        for (int step = 0; step < 20000; ++step)
+        {
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            const bool insert = live.size() < kMaxEntries && (live.empty() || ((rng >> 40U) & 3U) != 0);
+            if (insert)
+            {
+                const InstanceId id = next_id++;
+                const std::uint32_t slot = static_cast<std::uint32_t>(step % kMaxEntries);
+                if (!Expect(map.Insert(id, slot), "churn insert should succeed below capacity"))
+                    return false;
+                reference[id] = slot;
+                live.push_back(id);
+            }
+            else
+            {
+                const std::size_t victim = static_cast<std::size_t>(rng >> 33U) % live.size();
+                if (!Expect(map.Erase(live[victim]), "churn erase should find a live id"))
+                    return false;
+                reference.erase(live[victim]);
+                last_erased = live[victim];
+                live[victim] = live.back();
+                live.pop_back();
+            }
+
+            if (step % 97 == 0)
+            {
+                for (const auto &[id, slot] : reference)
+                {
+                    if (!Expect(map.Find(id) == slot, "every live id should resolve to its slot after churn"))
+                        return false;
+                }
+
+                if (!Expect(map.Find(next_id) == InstanceSlotMap::kInvalidSlot &&
+                                (last_erased == 0 || map.Find(last_erased) == InstanceSlotMap::kInvalidSlot),
+                            "erased and never-inserted ids should not resolve"))
+                    return false;
+            }
+        }
+
+        return Expect(map.Size() == reference.size(), "size should match the reference after churn");
+    }
+} // namespace
+
+bool RunInstanceSlotMapTests()
+{
+    if (!TestInsertFindErase())
+    {
+        return false;
+    }
+
+    if (!TestChurnMatchesReference())
+    {
+        return false;
+    }
+
+    std::cout << "InstanceSlotMap tests passed\n";
+    return true;
+}
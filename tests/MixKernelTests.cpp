@@ -0,0 +1,1183 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../src/core/CpuFeatures.hpp"
+#include "../src/playback/BiquadFilter.hpp"
+#include "../src/playback/ConvolutionReverb.hpp"
+#include "../src/playback/MixBus.hpp"
+#include "../src/playback/MixKernels.hpp"
+#include "../src/playback/RealFft.hpp"
+#include "../src/playback/SpatialKernels.hpp"
+
+namespace
+{
+    using decl_audio::SimdLevel;
+    using decl_audio::playback::BiquadCoefficients;
+    using decl_audio::playback::BiquadState;
+    using decl_audio::playback::EnvelopedMixKernel;
+    using decl_audio::playback::GetMixKernels;
+    using decl_audio::playback::MixGains;
+    using decl_audio::playback::MixKernel;
+    using decl_audio::playback::MixKernels;
+    using decl_audio::playback::RampedMixKernel;
+    using decl_audio::playback::ResampleKernel;
+    using decl_audio::playback::SpatialBatch;
+    using decl_audio::playback::SpatialKernel;
+    using decl_audio::playback::SpatialListener;
+
+    constexpr MixGains kTestGains{0.625f, -0.3f};
+    constexpr MixGains kTestStep{-0.0037f, 0.0021f};
+
+    bool Expect(bool condition, const char *message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    std::vector<float> MakeSignal(const std::size_t count, std::uint32_t seed)
+    {
+        std::vector<float> samples(count);
+        for (float &sample : samples)
+        {
+            seed = seed * 1664525U + 1013904223U;
+            sample = static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U) * 2.0f - 1.0f;
+        }
+
+        return samples;
+    }
+
+    // Runs `kernel` and the scalar reference over the same input, starting at a
+    // deliberately unaligned offset, and requires bit-identical output plus an
+    // untouched guard frame past the end. With `shared_channel` both gains land
+    // on one array, the way a mono bus is mixed. Ramped kernels run without an
+    // envelope unless `ramp_envelope` is set.
+    template <typename Kernel>
+    bool ExpectMatchesScalar(const Kernel kernel,
+                             const Kernel reference,
+                             const std::uint32_t source_channels,
+                             const std::uint32_t frames,
+                             const bool shared_channel,
+                             const char *message,
+                             const bool ramp_envelope = false)
+    {
+        constexpr std::size_t kOffsetFrames = 1;
+        const std::vector<float> source = MakeSignal((frames + kOffsetFrames) * source_channels, frames + source_channels);
+        const std::vector<float> envelope = MakeSignal(frames + kOffsetFrames, frames * 3U + 1U);
+        std::vector<float> expected = MakeSignal((frames + kOffsetFrames + 1) * 2, frames * 7U + 3U);
+        std::vector<float> actual = expected;
+
+        const float *src = source.data() + kOffsetFrames * source_channels;
+        const std::size_t right_offset = shared_channel ? kOffsetFrames : frames + kOffsetFrames + 1 + kOffsetFrames;
+        auto run = [&](const Kernel k, std::vector<float> &bus)
+        {
+            float *left = bus.data() + kOffsetFrames;
+            float *right = bus.data() + right_offset;
+            if constexpr (std::is_same_v<Kernel, RampedMixKernel>)
+            {
+                k(src, left, right, frames, kTestGains, kTestStep, ramp_envelope ? envelope.data() + kOffsetFrames : nullptr);
+            }
+            else if constexpr (std::is_same_v<Kernel, EnvelopedMixKernel>)
+            {
+                k(src, left, right, frames, kTestGains, envelope.data() + kOffsetFrames);
+            }
+            else
+            {
+                k(src, left, right, frames, kTestGains);
+            }
+        };
+
+        run(reference, expected);
+        run(kernel, actual);
+
+        return Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0, message);
+    }
+
+    // The pan kernel counterpart: six unaligned output channels, flat and
+    // ramped, against the scalar reference.
+    bool ExpectPanMatchesScalar(const MixKernels &kernels, const std::uint32_t frames)
+    {
+        constexpr std::uint32_t kChannels = 6;
+        constexpr std::size_t kOffsetFrames = 1;
+        constexpr float kStart[kChannels] = {0.625f, -0.3f, 0.0f, 1.0f, 0.125f, -0.75f};
+        constexpr float kStep[kChannels] = {-0.0037f, 0.0021f, 0.0f, -0.001f, 0.0005f, 0.003f};
+        const std::size_t stride = frames + kOffsetFrames + 1;
+        const std::vector<float> source = MakeSignal(frames + kOffsetFrames, frames + 11U);
+
+        for (const float *step : {static_cast<const float *>(nullptr), kStep})
+        {
+            std::vector<float> expected = MakeSignal(stride * kChannels, frames * 5U + 2U);
+            std::vector<float> actual = expected;
+            auto run = [&](const decl_audio::playback::PanKernel kernel, std::vector<float> &bus)
+            {
+                float *outputs[kChannels];
+                for (std::uint32_t c = 0; c < kChannels; ++c)
+                {
+                    outputs[c] = bus.data() + c * stride + kOffsetFrames;
+                }
+
+                kernel(source.data() + kOffsetFrames, outputs, kChannels, frames, kStart, step);
+            };
+
+            run(GetMixKernels(SimdLevel::Scalar).mono_to_channels, expected);
+            run(kernels.mono_to_channels, actual);
+            if (!Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                        step != nullptr ? "ramped pan kernel should match the scalar reference bit for bit"
+                                        : "pan kernel should match the scalar reference bit for bit"))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool TestSelectedKernelsMatchDetectedLevel()
+    {
+        const MixKernels &selected = GetMixKernels();
+        if (!Expect(selected.level == GetMixKernels(decl_audio::DetectSimdLevel()).level,
+                    "startup kernel selection should use the detected SIMD level"))
+        {
+            return false;
+        }
+
+        return Expect(&GetMixKernels() == &selected, "kernel selection should be made once and cached");
+    }
+
+    bool ExpectLevelMatchesScalar(const MixKernels &kernels, const std::uint32_t frames, const bool shared_channel)
+    {
+        const MixKernels &scalar = GetMixKernels(SimdLevel::Scalar);
+        return ExpectMatchesScalar(kernels.mono_to_stereo, scalar.mono_to_stereo, 1, frames, shared_channel,
+                                   "mono->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.stereo_to_stereo, scalar.stereo_to_stereo, 2, frames, shared_channel,
+                                   "stereo->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.mono_to_stereo_enveloped, scalar.mono_to_stereo_enveloped, 1, frames, shared_channel,
+                                   "enveloped mono->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.stereo_to_stereo_enveloped, scalar.stereo_to_stereo_enveloped, 2, frames, shared_channel,
+                                   "enveloped stereo->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.mono_to_stereo_ramped, scalar.mono_to_stereo_ramped, 1, frames, shared_channel,
+                                   "ramped mono->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.stereo_to_stereo_ramped, scalar.stereo_to_stereo_ramped, 2, frames, shared_channel,
+                                   "ramped stereo->stereo kernel should match the scalar reference bit for bit") &&
+               ExpectMatchesScalar(kernels.mono_to_stereo_ramped, scalar.mono_to_stereo_ramped, 1, frames, shared_channel,
+                                   "enveloped ramped mono->stereo kernel should match the scalar reference bit for bit", true) &&
+               ExpectMatchesScalar(kernels.stereo_to_stereo_ramped, scalar.stereo_to_stereo_ramped, 2, frames, shared_channel,
+                                   "enveloped ramped stereo->stereo kernel should match the scalar reference bit for bit", true);
+    }
+
+    bool TestKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        // Lengths straddle every vector width and remainder path.
+        constexpr std::uint32_t kFrameCounts[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 257};
+
+        for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+
+            for (const std::uint32_t frames : kFrameCounts)
+            {
+                if (!ExpectLevelMatchesScalar(GetMixKernels(level), frames, false) ||
+                    !ExpectLevelMatchesScalar(GetMixKernels(level), frames, true) ||
+                    !ExpectPanMatchesScalar(GetMixKernels(level), frames))
+                {
+                    std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " frames=" << frames << '\n';
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Resamples one run at each level and at the scalar reference, starting
+    // mid-frame, and requires bit-identical output plus an untouched guard.
+    bool ExpectResampleMatchesScalar(const ResampleKernel kernel,
+                                     const std::uint32_t channels,
+                                     const std::uint32_t step,
+                                     const std::uint32_t frames)
+    {
+        const ResampleKernel scalar = GetMixKernels(SimdLevel::Scalar).resample_linear;
+        const std::uint64_t position = 0x9C40U; // 0.61 of a frame
+        const std::size_t source_frames = ((position + static_cast<std::uint64_t>(step) * frames) >> decl_audio::playback::kRateFractionBits) + 2;
+        const std::vector<float> source = MakeSignal(source_frames * channels, frames + step);
+        const float guard = 12345.0f;
+        std::vector<float> expected(static_cast<std::size_t>(frames + 1) * channels, guard);
+        std::vector<float> actual(expected.size(), guard);
+
+        scalar(source.data(), channels, position, step, expected.data(), frames);
+        kernel(source.data(), channels, position, step, actual.data(), frames);
+        return Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                      "resample kernel should match the scalar reference bit for bit") &&
+               Expect(actual.back() == guard, "resample kernel should not write past the requested frames");
+    }
+
+    bool TestResampleKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        constexpr std::uint32_t kFrameCounts[] = {0, 1, 3, 4, 7, 8, 9, 17, 257};
+        // Down an octave, a detuned near-unity step, a fifth up, and two octaves up.
+        constexpr std::uint32_t kSteps[] = {0x8000U, 0x10123U, 0x17F9EU, 0x40000U};
+
+        for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+
+            for (const std::uint32_t channels : {1U, 2U})
+            {
+                for (const std::uint32_t step : kSteps)
+                {
+                    for (const std::uint32_t frames : kFrameCounts)
+                    {
+                        if (!ExpectResampleMatchesScalar(GetMixKernels(level).resample_linear, channels, step, frames))
+                        {
+                            std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " channels=" << channels << " step=" << step
+                                      << " frames=" << frames << '\n';
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestScalarResampleInterpolatesLinearly()
+    {
+        const float stereo[6] = {0.0f, 1.0f, 1.0f, -1.0f, 3.0f, 0.0f};
+        float output[6] = {};
+
+        // Starting a quarter into frame 0 and stepping 0.75 frames: reads at
+        // 0.25, 1.0 and 1.75.
+        GetMixKernels(SimdLevel::Scalar).resample_linear(stereo, 2, 0x4000U, 0xC000U, output, 3);
+        return Expect(output[0] == 0.25f && output[1] == 0.5f && output[2] == 1.0f && output[3] == -1.0f &&
+                          output[4] == 2.5f && output[5] == -0.25f,
+                      "resampling should interpolate each channel linearly between neighbouring frames");
+    }
+
+    bool TestWidenKernelsScaleExactly()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        constexpr float kGuard = 12345.0f;
+
+        // Odd lengths leave a remainder at every level's width.
+        for (const std::uint32_t count : {0U, 1U, 7U, 8U, 15U, 16U, 33U, 257U})
+        {
+            std::vector<std::int16_t> source(count);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                source[i] = static_cast<std::int16_t>(static_cast<std::int32_t>(i * 7919U % 65536U) - 32768);
+            }
+            if (count > 2)
+            {
+                source[1] = 32767;
+                source[2] = -32768;
+            }
+
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2})
+            {
+                if (level > detected)
+                {
+                    continue;
+                }
+
+                std::vector<float> output(count + 1, kGuard);
+                GetMixKernels(level).widen_s16(source.data(), output.data(), count);
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    if (!Expect(output[i] == static_cast<float>(source[i]) / 32768.0f, "widening should scale each sample by 1/32768 exactly"))
+                    {
+                        std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " count=" << count << " index=" << i << '\n';
+                        return false;
+                    }
+                }
+
+                if (!Expect(output[count] == kGuard, "widening should not write past the requested samples"))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // A resonant low-pass at 48 kHz: enough feedback that any difference in
+    // accumulation order would show up within a few blocks.
+    BiquadCoefficients MakeTestBiquad()
+    {
+        decl_audio::compiler::CompiledFilter filter;
+        filter.type = decl_audio::compiler::FilterType::LowPass;
+        filter.q = 4.0f;
+        return decl_audio::playback::DesignBiquad(filter, 2500.0f, 48000);
+    }
+
+    bool TestBiquadKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        const BiquadCoefficients coefficients = MakeTestBiquad();
+        constexpr float kGuard = 12345.0f;
+
+        for (const SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+
+            // One to three channels cover the AVX2 pair, its odd channel and
+            // the SSE2 single; the frame counts every block remainder. Two
+            // calls per run carry the history across a call boundary.
+            for (const std::uint32_t channels : {1U, 2U, 3U})
+            {
+                for (const std::uint32_t frames : {0U, 1U, 3U, 4U, 7U, 8U, 9U, 17U, 257U})
+                {
+                    const std::size_t stride = frames + 2;
+                    std::vector<float> expected = MakeSignal(stride * channels * 2, frames + channels);
+                    for (std::size_t channel = 0; channel < channels * 2; ++channel)
+                    {
+                        expected[channel * stride + stride - 1] = kGuard;
+                    }
+                    std::vector<float> actual = expected;
+
+                    auto run = [&](const decl_audio::playback::BiquadKernel kernel, std::vector<float> &samples)
+                    {
+                        std::array<BiquadState, 3> states{};
+                        for (std::uint32_t call = 0; call < 2; ++call)
+                        {
+                            float *pointers[3];
+                            for (std::uint32_t c = 0; c < channels; ++c)
+                            {
+                                pointers[c] = samples.data() + (call * channels + c) * stride + 1;
+                            }
+                            kernel(pointers, channels, frames, coefficients, states.data());
+                        }
+                    };
+
+                    run(GetMixKernels(SimdLevel::Scalar).biquad, expected);
+                    run(GetMixKernels(level).biquad, actual);
+                    if (!Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                                "biquad kernel should match the scalar reference bit for bit") ||
+                        !Expect(actual[stride - 1] == kGuard, "biquad kernel should not write past the requested frames"))
+                    {
+                        std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " channels=" << channels << " frames=" << frames << '\n';
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestScalarBiquadFollowsDirectForm()
+    {
+        // The block form is the direct-form recursion regrouped, so running
+        // the same signal through both stays within float rounding.
+        const BiquadCoefficients coefficients = MakeTestBiquad();
+        const std::vector<float> source = MakeSignal(1024, 99U);
+        std::vector<float> filtered = source;
+        float *channel = filtered.data();
+        BiquadState state;
+        GetMixKernels(SimdLevel::Scalar).biquad(&channel, 1, static_cast<std::uint32_t>(filtered.size()), coefficients, &state);
+
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            const double y = coefficients.b0 * source[i] + coefficients.b1 * x1 + coefficients.b2 * x2 - coefficients.a1 * y1 - coefficients.a2 * y2;
+            x2 = x1;
+            x1 = source[i];
+            y2 = y1;
+            y1 = y;
+            if (!Expect(std::abs(filtered[i] - y) < 1.0e-4, "block biquad should track the direct-form recursion"))
+            {
+                std::cerr << "  frame=" << i << '\n';
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Steady-state amplitude of a unit sine at `hz` through `coefficients`.
+    float BiquadSineGain(const BiquadCoefficients &coefficients, const float hz)
+    {
+        constexpr std::uint32_t kFrames = 9600;
+        std::vector<float> samples(kFrames);
+        for (std::uint32_t i = 0; i < kFrames; ++i)
+        {
+            samples[i] = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * hz * i / 48000.0));
+        }
+
+        float *channel = samples.data();
+        BiquadState state;
+        GetMixKernels(SimdLevel::Scalar).biquad(&channel, 1, kFrames, coefficients, &state);
+        return *std::max_element(samples.begin() + kFrames / 2, samples.end());
+    }
+
+    bool TestBiquadDesignsShapeTheSpectrum()
+    {
+        using decl_audio::compiler::CompiledFilter;
+        using decl_audio::compiler::FilterType;
+        using decl_audio::playback::DesignBiquad;
+
+        CompiledFilter low_pass;
+        low_pass.type = FilterType::LowPass;
+        const BiquadCoefficients low = DesignBiquad(low_pass, 1000.0f, 48000);
+        CompiledFilter high_pass;
+        high_pass.type = FilterType::HighPass;
+        const BiquadCoefficients high = DesignBiquad(high_pass, 1000.0f, 48000);
+        CompiledFilter high_shelf;
+        high_shelf.type = FilterType::HighShelf;
+        high_shelf.gain_db = -12.0f;
+        const BiquadCoefficients shelf = DesignBiquad(high_shelf, 1000.0f, 48000);
+
+        // -3 dB at the cutoff for a Butterworth Q, -40 dB a decade past it.
+        return Expect(std::abs(BiquadSineGain(low, 100.0f) - 1.0f) < 0.01f, "low-pass should pass frequencies well below the cutoff") &&
+               Expect(std::abs(BiquadSineGain(low, 1000.0f) - 0.7071f) < 0.01f, "low-pass should be 3 dB down at the cutoff") &&
+               Expect(BiquadSineGain(low, 10000.0f) < 0.012f, "low-pass should roll off 12 dB per octave above the cutoff") &&
+               Expect(BiquadSineGain(high, 100.0f) < 0.012f, "high-pass should roll off below the cutoff") &&
+               Expect(std::abs(BiquadSineGain(high, 10000.0f) - 1.0f) < 0.01f, "high-pass should pass frequencies well above the cutoff") &&
+               Expect(std::abs(BiquadSineGain(shelf, 100.0f) - 1.0f) < 0.01f, "high shelf should leave low frequencies alone") &&
+               Expect(std::abs(BiquadSineGain(shelf, 15000.0f) - 0.2512f) < 0.01f, "high shelf should cut high frequencies by its gain");
+    }
+
+    bool TestBiquadFlushesDecayedHistory()
+    {
+        // An impulse rings down through the float range; once it has decayed
+        // past the flush threshold the history is exactly zero, not denormal.
+        const BiquadCoefficients coefficients = MakeTestBiquad();
+        std::vector<float> samples(48000, 0.0f);
+        samples[0] = 1.0f;
+        float *channel = samples.data();
+        BiquadState state;
+        for (std::uint32_t offset = 0; offset < samples.size(); offset += 480)
+        {
+            channel = samples.data() + offset;
+            GetMixKernels().biquad(&channel, 1, 480, coefficients, &state);
+        }
+
+        return Expect(state.x1 == 0.0f && state.x2 == 0.0f && state.y1 == 0.0f && state.y2 == 0.0f,
+                      "a decayed biquad should settle to an exactly zero history");
+    }
+
+    bool TestSpectrumMacKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        constexpr float kGuard = 12345.0f;
+
+        for (const SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+
+            // Bin counts cover every block remainder and the 2^n + 1 a
+            // RealFft spectrum has. The accumulator starts non-zero.
+            for (const std::uint32_t bins : {1U, 2U, 3U, 4U, 7U, 8U, 9U, 17U, 129U, 257U})
+            {
+                const std::vector<float> x = MakeSignal(bins * 2, bins + 5U);
+                const std::vector<float> h = MakeSignal(bins * 2, bins * 3U + 1U);
+                std::vector<float> expected = MakeSignal(bins * 2 + 1, bins * 7U + 2U);
+                expected[bins * 2] = kGuard;
+                std::vector<float> actual = expected;
+
+                auto run = [&](const decl_audio::playback::SpectrumMacKernel kernel, std::vector<float> &acc)
+                {
+                    kernel(x.data(), h.data(), acc.data(), bins);
+                };
+
+                run(GetMixKernels(SimdLevel::Scalar).spectrum_mac, expected);
+                run(GetMixKernels(level).spectrum_mac, actual);
+                if (!Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                            "spectrum kernel should match the scalar reference bit for bit") ||
+                    !Expect(actual[bins * 2] == kGuard, "spectrum kernel should not write past the spectrum"))
+                {
+                    std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " bins=" << bins << '\n';
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestFramePeakKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        constexpr float kGuard = 12345.0f;
+
+        for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+
+            for (const std::uint32_t channel_count : {0U, 1U, 2U, 3U, 8U})
+            {
+                for (const std::uint32_t frames : {1U, 3U, 4U, 7U, 8U, 9U, 33U, 257U})
+                {
+                    std::vector<std::vector<float>> signals;
+                    std::vector<const float *> channels;
+                    for (std::uint32_t c = 0; c < channel_count; ++c)
+                    {
+                        signals.push_back(MakeSignal(frames, frames * 5U + c));
+                    }
+                    // Signed zeros and a NaN, which every level must resolve
+                    // the same way.
+                    if (channel_count > 1)
+                    {
+                        signals[0][0] = -0.0f;
+                        signals[1][frames / 2] = std::numeric_limits<float>::quiet_NaN();
+                    }
+                    for (const std::vector<float> &signal : signals)
+                    {
+                        channels.push_back(signal.data());
+                    }
+
+                    std::vector<float> expected(frames + 1, kGuard);
+                    std::vector<float> actual(frames + 1, kGuard);
+                    GetMixKernels(SimdLevel::Scalar).frame_peak(channels.data(), channel_count, frames, expected.data());
+                    GetMixKernels(level).frame_peak(channels.data(), channel_count, frames, actual.data());
+
+                    bool is_peak = true;
+                    for (std::uint32_t i = 0; i < frames; ++i)
+                    {
+                        float peak = 0.0f;
+                        for (std::uint32_t c = 0; c < channel_count; ++c)
+                        {
+                            peak = std::isnan(signals[c][i]) ? peak : std::max(peak, std::fabs(signals[c][i]));
+                        }
+                        is_peak = is_peak && expected[i] == peak;
+                    }
+
+                    if (!Expect(is_peak, "scalar frame peaks should be the largest magnitude across channels") ||
+                        !Expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                                "frame peak kernel should match the scalar reference bit for bit") ||
+                        !Expect(actual[frames] == kGuard, "frame peak kernel should not write past the block"))
+                    {
+                        std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " channels=" << channel_count << " frames=" << frames << '\n';
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestRealFftMatchesDftAndInverts()
+    {
+        constexpr std::uint32_t kSize = 64;
+        decl_audio::playback::RealFft fft(kSize);
+        const std::vector<float> signal = MakeSignal(kSize, 41U);
+        std::vector<float> spectrum(fft.BinCount() * 2);
+        fft.Forward(signal.data(), spectrum.data());
+
+        for (std::uint32_t k = 0; k < fft.BinCount(); ++k)
+        {
+            double re = 0.0, im = 0.0;
+            for (std::uint32_t n = 0; n < kSize; ++n)
+            {
+                const double angle = -2.0 * 3.14159265358979323846 * k * n / kSize;
+                re += signal[n] * std::cos(angle);
+                im += signal[n] * std::sin(angle);
+            }
+
+            if (!Expect(std::abs(spectrum[k] - re) < 1.0e-4 && std::abs(spectrum[fft.BinCount() + k] - im) < 1.0e-4,
+                        "real FFT should match the direct DFT"))
+            {
+                std::cerr << "  bin=" << k << '\n';
+                return false;
+            }
+        }
+
+        std::vector<float> restored(kSize);
+        fft.Inverse(spectrum.data(), restored.data());
+        for (std::uint32_t n = 0; n < kSize; ++n)
+        {
+            if (!Expect(std::abs(restored[n] - signal[n]) < 1.0e-5f, "inverse real FFT should restore the signal"))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    decl_audio::assets::DecodedBuffer MakeImpulseBuffer(const std::uint32_t frames, const std::uint32_t channels)
+    {
+        decl_audio::assets::DecodedBuffer buffer;
+        buffer.samples = MakeSignal(static_cast<std::size_t>(frames) * channels, frames + channels);
+        buffer.frame_count = frames;
+        buffer.channel_count = channels;
+        buffer.sample_rate = 48000;
+        return buffer;
+    }
+
+    // Wet output of `input` through `impulse`, fed `block` frames at a time,
+    // waiting for every tail.
+    std::vector<float> Convolve(const decl_audio::playback::ImpulseResponse &impulse,
+                                const std::vector<float> &input,
+                                const std::uint32_t head_partitions,
+                                const std::uint32_t block)
+    {
+        decl_audio::playback::ConvolutionReverb reverb(GetMixKernels(), 1, impulse.partition_frames, impulse.partition_count, head_partitions);
+        reverb.SetWaitForTailsForTesting(true);
+        reverb.Bind(0, impulse);
+        std::vector<float> output(input.size() * 2);
+        for (std::size_t first = 0; first < input.size(); first += block)
+        {
+            const std::uint32_t frames = static_cast<std::uint32_t>(std::min<std::size_t>(block, input.size() - first));
+            reverb.Process(0, input.data() + first, output.data() + first, output.data() + input.size() + first, frames);
+        }
+
+        return output;
+    }
+
+    bool TestConvolutionReverbMatchesDirectConvolution()
+    {
+        constexpr std::uint32_t kPartition = 64;
+        constexpr std::uint32_t kImpulseFrames = 1000; // 16 partitions, the last partial
+        const decl_audio::assets::DecodedBuffer buffer = MakeImpulseBuffer(kImpulseFrames, 2);
+        const decl_audio::playback::ImpulseResponse impulse = decl_audio::playback::TransformImpulseResponse(buffer, kPartition);
+        if (!Expect(impulse.partition_count == 16 && impulse.channel_count == 2, "impulse should cut into whole partitions"))
+        {
+            return false;
+        }
+
+        // Signal, then silence for the tail to ring out.
+        std::vector<float> input = MakeSignal(2000, 17U);
+        input.resize(input.size() + kImpulseFrames + kPartition * 2, 0.0f);
+
+        // Whatever the head split and block size, the output is the input
+        // convolved with the impulse response a partition late; block size
+        // changes nothing at all.
+        for (const std::uint32_t head : {1U, 3U, 16U})
+        {
+            const std::vector<float> reference = Convolve(impulse, input, head, kPartition);
+            for (std::size_t n = 0; n < input.size(); ++n)
+            {
+                for (std::uint32_t channel = 0; channel < 2; ++channel)
+                {
+                    double expected = 0.0;
+                    for (std::size_t k = 0; k < kImpulseFrames && k + kPartition <= n; ++k)
+                    {
+                        expected += static_cast<double>(input[n - kPartition - k]) * buffer.samples[k * 2 + channel];
+                    }
+
+                    if (!Expect(std::abs(reference[channel * input.size() + n] - expected) < 1.0e-3, "convolution should match the direct sum a partition late"))
+                    {
+                        std::cerr << "  head=" << head << " frame=" << n << " channel=" << channel << '\n';
+                        return false;
+                    }
+                }
+            }
+
+            for (const std::uint32_t block : {1U, 37U, 200U, 1024U})
+            {
+                const std::vector<float> blocked = Convolve(impulse, input, head, block);
+                if (!Expect(std::memcmp(reference.data(), blocked.data(), reference.size() * sizeof(float)) == 0,
+                            "convolution should not depend on the block size"))
+                {
+                    std::cerr << "  head=" << head << " block=" << block << '\n';
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestConvolutionReverbPlaysOnlyTheHeadWhenTailsAreLate()
+    {
+        // A reverb thread far slower than the input drops every tail, and the
+        // audio side neither sums one itself nor lets a late job disturb the
+        // head: the output is the input convolved with the head partitions of
+        // the impulse response alone.
+        constexpr std::uint32_t kPartition = 64;
+        constexpr std::uint32_t kHead = 2;
+        constexpr std::uint32_t kImpulseFrames = 1000;
+        const decl_audio::assets::DecodedBuffer buffer = MakeImpulseBuffer(kImpulseFrames, 2);
+        const decl_audio::playback::ImpulseResponse impulse = decl_audio::playback::TransformImpulseResponse(buffer, kPartition);
+        const std::vector<float> input = MakeSignal(2000, 29U);
+
+        decl_audio::playback::ConvolutionReverb reverb(GetMixKernels(), 1, kPartition, impulse.partition_count, kHead);
+        reverb.SetTailDelayForTesting(std::chrono::milliseconds(100));
+        reverb.Bind(0, impulse);
+        std::vector<float> output(input.size() * 2);
+        for (std::size_t first = 0; first < input.size(); first += kPartition)
+        {
+            const std::uint32_t frames = static_cast<std::uint32_t>(std::min<std::size_t>(kPartition, input.size() - first));
+            reverb.Process(0, input.data() + first, output.data() + first, output.data() + input.size() + first, frames);
+            // Give the thread time to pick up a job, so the rest of the input
+            // runs while a late job is still being summed.
+            if (first == kPartition * 8)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        if (!Expect(reverb.LateTailCount() > 0, "a starved reverb thread should leave tails out"))
+        {
+            return false;
+        }
+
+        for (std::size_t n = 0; n < input.size(); ++n)
+        {
+            for (std::uint32_t channel = 0; channel < 2; ++channel)
+            {
+                double expected = 0.0;
+                for (std::size_t k = 0; k < kHead * kPartition && k + kPartition <= n; ++k)
+                {
+                    expected += static_cast<double>(input[n - kPartition - k]) * buffer.samples[k * 2 + channel];
+                }
+
+                if (!Expect(std::abs(output[channel * input.size() + n] - expected) < 1.0e-3, "late tails should leave the head convolution alone"))
+                {
+                    std::cerr << "  frame=" << n << " channel=" << channel << '\n';
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestConvolutionReverbGoesIdleAfterSilence()
+    {
+        constexpr std::uint32_t kPartition = 64;
+        const decl_audio::playback::ImpulseResponse impulse = decl_audio::playback::TransformImpulseResponse(MakeImpulseBuffer(300, 1), kPartition);
+        decl_audio::playback::ConvolutionReverb reverb(GetMixKernels(), 1, kPartition, impulse.partition_count, 2);
+        reverb.Bind(0, impulse);
+        if (!Expect(!reverb.IsRinging(0), "a reverb that has heard nothing should not ring"))
+        {
+            return false;
+        }
+
+        const std::vector<float> burst = MakeSignal(kPartition, 5U);
+        const std::vector<float> silence(kPartition, 0.0f);
+        std::vector<float> left(kPartition), right(kPartition);
+        reverb.Process(0, burst.data(), left.data(), right.data(), kPartition);
+        if (!Expect(reverb.IsRinging(0), "input should start the reverb ringing"))
+        {
+            return false;
+        }
+
+        // A mono impulse response plays the same wet signal on both sides,
+        // and falls silent within its length plus the partition of latency.
+        bool heard = false;
+        for (std::uint32_t partition = 0; partition <= impulse.partition_count + 1; ++partition)
+        {
+            reverb.Process(0, silence.data(), left.data(), right.data(), kPartition);
+            heard = heard || std::any_of(left.begin(), left.end(), [](const float sample) { return sample != 0.0f; });
+            if (!Expect(left == right, "a mono impulse response should write both outputs alike"))
+            {
+                return false;
+            }
+        }
+
+        reverb.Process(0, silence.data(), left.data(), right.data(), kPartition);
+        return Expect(heard, "the burst should come back out wet") &&
+               Expect(!reverb.IsRinging(0), "the reverb should stop ringing once its tail has played out") &&
+               Expect(std::all_of(left.begin(), left.end(), [](const float sample) { return sample == 0.0f; }), "a reverb that stopped ringing should be silent");
+    }
+
+    using AttenuationCurve = std::array<float, decl_audio::compiler::kAttenuationCurvePoints>;
+
+    // 1 - t, as the compiler bakes a linear curve.
+    const AttenuationCurve &LinearCurve()
+    {
+        static const AttenuationCurve curve = []
+        {
+            AttenuationCurve points{};
+            for (std::size_t i = 0; i < points.size(); ++i)
+                points[i] = 1.0f - static_cast<float>(i) / static_cast<float>(points.size() - 1);
+            return points;
+        }();
+        return curve;
+    }
+
+    // (1 - t)^2, so interpolation between points is not exact.
+    const AttenuationCurve &SquaredCurve()
+    {
+        static const AttenuationCurve curve = []
+        {
+            AttenuationCurve points = LinearCurve();
+            for (float &point : points)
+                point *= point;
+            return points;
+        }();
+        return curve;
+    }
+
+    // Owns a batch's lanes so tests can run two kernels over the same sources.
+    // Sources alternate between the linear and squared curves.
+    struct SpatialLanes
+    {
+        explicit SpatialLanes(const std::uint32_t count)
+            : position_x(MakeSignal(count, count + 11U)),
+              position_y(MakeSignal(count, count + 12U)),
+              position_z(MakeSignal(count, count + 13U)),
+              min_distance(count, 0.5f),
+              max_distance(count, 6.0f),
+              attenuation_curve(count),
+              gain_left(count),
+              gain_right(count),
+              attenuation(count),
+              local_x(count),
+              local_z(count)
+        {
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                position_x[i] *= 8.0f;
+                position_y[i] *= 8.0f;
+                position_z[i] *= 8.0f;
+                attenuation_curve[i] = (i % 2 == 0 ? LinearCurve() : SquaredCurve()).data();
+            }
+        }
+
+        SpatialBatch Batch()
+        {
+            return SpatialBatch{static_cast<std::uint32_t>(position_x.size()),
+                                position_x.data(),
+                                position_y.data(),
+                                position_z.data(),
+                                min_distance.data(),
+                                max_distance.data(),
+                                attenuation_curve.data(),
+                                gain_left.data(),
+                                gain_right.data(),
+                                attenuation.data(),
+                                local_x.data(),
+                                local_z.data()};
+        }
+
+        bool Matches(const SpatialLanes &other) const
+        {
+            const std::size_t bytes = gain_left.size() * sizeof(float);
+            return std::memcmp(gain_left.data(), other.gain_left.data(), bytes) == 0 &&
+                   std::memcmp(gain_right.data(), other.gain_right.data(), bytes) == 0 &&
+                   std::memcmp(attenuation.data(), other.attenuation.data(), bytes) == 0 &&
+                   std::memcmp(local_x.data(), other.local_x.data(), bytes) == 0 &&
+                   std::memcmp(local_z.data(), other.local_z.data(), bytes) == 0;
+        }
+
+        std::vector<float> position_x;
+        std::vector<float> position_y;
+        std::vector<float> position_z;
+        std::vector<float> min_distance;
+        std::vector<float> max_distance;
+        std::vector<const float *> attenuation_curve;
+        std::vector<float> gain_left;
+        std::vector<float> gain_right;
+        std::vector<float> attenuation;
+        std::vector<float> local_x;
+        std::vector<float> local_z;
+    };
+
+    bool TestSpatialKernelsMatchScalarReference()
+    {
+        const SimdLevel detected = decl_audio::DetectSimdLevel();
+        constexpr std::uint32_t kSourceCounts[] = {0, 1, 3, 4, 7, 8, 9, 17, 33};
+
+        // A turned, displaced listener so every axis term contributes.
+        SpatialListener listener;
+        listener.position = Vec3{0.5f, -0.25f, 1.0f};
+        listener.right = Vec3{0.6f, 0.0f, -0.8f};
+        listener.forward = Vec3{0.8f, 0.0f, 0.6f};
+
+        for (const std::uint32_t count : kSourceCounts)
+        {
+            SpatialLanes expected(count);
+            if (count > 0)
+            {
+                // One source on top of the listener takes the zero-distance path.
+                expected.position_x[0] = listener.position.x;
+                expected.position_y[0] = listener.position.y;
+                expected.position_z[0] = listener.position.z;
+            }
+
+            SpatialLanes actual = expected;
+            SpatialBatch reference_batch = expected.Batch();
+            decl_audio::playback::GetSpatialKernel(SimdLevel::Scalar)(reference_batch, listener);
+
+            for (const SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2})
+            {
+                if (level > detected)
+                {
+                    continue;
+                }
+
+                SpatialBatch batch = actual.Batch();
+                decl_audio::playback::GetSpatialKernel(level)(batch, listener);
+                if (!Expect(actual.Matches(expected), "spatial kernel should match the scalar reference bit for bit"))
+                {
+                    std::cerr << "  level=" << decl_audio::SimdLevelName(level) << " sources=" << count << '\n';
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TestSpatialKernelFollowsConstantPowerLaw()
+    {
+        constexpr float kQuarterTurn = 0.78539816339744830962f;
+        constexpr std::uint32_t kCount = 64;
+        SpatialLanes lanes(kCount);
+        std::fill(lanes.attenuation_curve.begin(), lanes.attenuation_curve.end(), LinearCurve().data());
+        lanes.position_x[1] = 6.0f;
+        lanes.position_y[1] = 0.0f;
+        lanes.position_z[1] = 0.0f;
+
+        SpatialBatch batch = lanes.Batch();
+        const SpatialListener listener;
+        decl_audio::playback::GetSpatialKernel()(batch, listener);
+
+        for (std::uint32_t i = 0; i < kCount; ++i)
+        {
+            const float x = lanes.position_x[i];
+            const float y = lanes.position_y[i];
+            const float z = lanes.position_z[i];
+            const float distance = std::sqrt(x * x + y * y + z * z);
+            const float attenuation = std::clamp(1.0f - (distance - 0.5f) / 5.5f, 0.0f, 1.0f);
+            const float angle = (std::clamp(x / distance, -1.0f, 1.0f) + 1.0f) * kQuarterTurn;
+            if (!Expect(std::fabs(lanes.attenuation[i] - attenuation) <= 1e-6f, "spatial kernel attenuation should follow the linear range") ||
+                !Expect(std::fabs(lanes.gain_left[i] - std::cos(angle) * attenuation) <= 1e-6f, "spatial kernel left gain should follow the cosine law") ||
+                !Expect(std::fabs(lanes.gain_right[i] - std::sin(angle) * attenuation) <= 1e-6f, "spatial kernel right gain should follow the sine law"))
+            {
+                return false;
+            }
+        }
+
+        return Expect(lanes.attenuation[1] == 0.0f && lanes.gain_left[1] == 0.0f && lanes.gain_right[1] == 0.0f,
+                      "a source at max distance should be fully attenuated");
+    }
+
+    bool TestSpatialKernelInterpolatesAttenuationCurve()
+    {
+        // Sources straight ahead: inside minDistance, halfway between curve
+        // points 16 and 17, and past maxDistance.
+        SpatialLanes lanes(3);
+        std::fill(lanes.attenuation_curve.begin(), lanes.attenuation_curve.end(), SquaredCurve().data());
+        const float between_points = 0.5f + 5.5f * (16.5f / 64.0f);
+        const float distances[3] = {0.25f, between_points, 9.0f};
+        for (std::uint32_t i = 0; i < 3; ++i)
+        {
+            lanes.position_x[i] = 0.0f;
+            lanes.position_y[i] = 0.0f;
+            lanes.position_z[i] = distances[i];
+        }
+
+        SpatialBatch batch = lanes.Batch();
+        decl_audio::playback::GetSpatialKernel()(batch, SpatialListener{});
+
+        const AttenuationCurve &curve = SquaredCurve();
+        return Expect(lanes.attenuation[0] == 1.0f, "a source inside minDistance should read the curve's first point") &&
+               Expect(std::fabs(lanes.attenuation[1] - (curve[16] + curve[17]) * 0.5f) <= 1e-6f, "attenuation should interpolate between neighbouring curve points") &&
+               Expect(lanes.attenuation[2] == 0.0f, "a source past maxDistance should read the curve's last point");
+    }
+
+    bool TestScalarKernelsAccumulate()
+    {
+        const MixKernels &scalar = GetMixKernels(SimdLevel::Scalar);
+        const float mono[2] = {1.0f, -0.5f};
+        const float stereo[4] = {0.25f, 0.5f, -1.0f, 2.0f};
+        const float envelope[2] = {0.5f, 0.0f};
+        float left[2] = {1.0f, 1.0f};
+        float right[2] = {1.0f, 1.0f};
+
+        scalar.mono_to_stereo(mono, left, right, 2, MixGains{0.5f, 0.25f});
+        if (!Expect(left[0] == 1.5f && right[0] == 1.25f && left[1] == 0.75f && right[1] == 0.875f,
+                    "mono->stereo should add the sample to each channel with that channel's gain"))
+        {
+            return false;
+        }
+
+        scalar.stereo_to_stereo(stereo, left, right, 2, MixGains{2.0f, 1.0f});
+        if (!Expect(left[0] == 2.0f && right[0] == 1.75f && left[1] == -1.25f && right[1] == 2.875f,
+                    "stereo->stereo should deinterleave each gained channel into its own bus channel"))
+        {
+            return false;
+        }
+
+        scalar.stereo_to_stereo_enveloped(stereo, left, right, 2, MixGains{2.0f, 1.0f}, envelope);
+        if (!Expect(left[0] == 2.25f && right[0] == 2.0f && left[1] == -1.25f && right[1] == 2.875f,
+                    "enveloped kernels should scale each frame by its envelope value"))
+        {
+            return false;
+        }
+
+        scalar.mono_to_stereo_ramped(mono, left, right, 2, MixGains{1.0f, 0.0f}, MixGains{-0.5f, 0.5f}, nullptr);
+        if (!Expect(left[0] == 3.25f && right[0] == 2.0f && left[1] == -1.5f && right[1] == 2.625f,
+                    "ramped kernels should apply start + step * frame as each frame's gain"))
+        {
+            return false;
+        }
+
+        float *outputs[2] = {left, right};
+        const float pan_start[2] = {2.0f, 0.5f};
+        const float pan_step[2] = {-1.0f, 0.0f};
+        scalar.mono_to_channels(mono, outputs, 2, 2, pan_start, pan_step);
+        return Expect(left[0] == 5.25f && right[0] == 2.5f && left[1] == -2.0f && right[1] == 2.375f,
+                      "the pan kernel should add the source to every output at that output's gain");
+    }
+
+    bool TestMixBusLayout()
+    {
+        decl_audio::playback::MixBus bus(2, 5);
+        for (std::uint32_t channel = 0; channel < bus.ChannelCount(); ++channel)
+        {
+            if (!Expect(reinterpret_cast<std::uintptr_t>(bus.Channel(channel)) % 64 == 0, "every bus channel should start on a 64-byte boundary"))
+            {
+                return false;
+            }
+        }
+
+        for (std::uint32_t frame = 0; frame < 5; ++frame)
+        {
+            bus.Channel(0)[frame] = static_cast<float>(frame);
+            bus.Channel(1)[frame] = -static_cast<float>(frame);
+        }
+
+        float interleaved[10] = {};
+        bus.InterleaveTo(interleaved, 5);
+        if (!Expect(interleaved[6] == 3.0f && interleaved[7] == -3.0f, "InterleaveTo should write frame-major L/R pairs"))
+        {
+            return false;
+        }
+
+        bus.Clear(5);
+        return Expect(bus.Channel(0)[4] == 0.0f && bus.Channel(1)[4] == 0.0f, "Clear should zero every channel");
+    }
+} // namespace
+
+bool RunMixKernelTests()
+{
+    if (!TestScalarKernelsAccumulate())
+    {
+        return false;
+    }
+
+    if (!TestMixBusLayout())
+    {
+        return false;
+    }
+
+    if (!TestKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestSelectedKernelsMatchDetectedLevel())
+    {
+        return false;
+    }
+
+    if (!TestScalarResampleInterpolatesLinearly())
+    {
+        return false;
+    }
+
+    if (!TestResampleKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestWidenKernelsScaleExactly())
+    {
+        return false;
+    }
+
+    if (!TestBiquadKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestScalarBiquadFollowsDirectForm())
+    {
+        return false;
+    }
+
+    if (!TestBiquadDesignsShapeTheSpectrum())
+    {
+        return false;
+    }
+
+    if (!TestBiquadFlushesDecayedHistory())
+    {
+        return false;
+    }
+
+    if (!TestSpectrumMacKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestFramePeakKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestRealFftMatchesDftAndInverts())
+    {
+        return false;
+    }
+
+    if (!TestConvolutionReverbMatchesDirectConvolution())
+    {
+        return false;
+    }
+
+    if (!TestConvolutionReverbPlaysOnlyTheHeadWhenTailsAreLate())
+    {
+        return false;
+    }
+
+    if (!TestConvolutionReverbGoesIdleAfterSilence())
+    {
+        return false;
+    }
+
+    if (!TestSpatialKernelsMatchScalarReference())
+    {
+        return false;
+    }
+
+    if (!TestSpatialKernelFollowsConstantPowerLaw())
+    {
+        return false;
+    }
+
+    if (!TestSpatialKernelInterpolatesAttenuationCurve())
+    {
+        return false;
+    }
+
+    std::cout << "MixKernel tests passed (" << decl_audio::SimdLevelName(decl_audio::DetectSimdLevel()) << ")\n";
+    return true;
+}
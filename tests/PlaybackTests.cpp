@@ -2,19 +2,28 @@
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "../src/assets/AssetBank.hpp"
+#include "../src/assets/AssetStream.hpp"
+#include "../src/assets/SampleCodec.hpp"
 #include "../src/backends/StubBackend.hpp"
+#include "../src/playback/RenderAheadStream.hpp"
 #include "../src/compiler/Compiler.hpp"
 #include "../src/playback/AudioRuntime.hpp"
+#include "../src/playback/MasterLimiter.hpp"
 #include "../src/runtime/BehaviorResolver.hpp"
+#include "../src/runtime/BusRegistry.hpp"
 #include "../src/runtime/ControlRuntime.hpp"
 
 #if defined(__unix__) || defined(__APPLE__)
@@ -99,11 +108,74 @@ namespace
         float right = 1.0f;
     };
 
+    struct StreamingConfig final
+    {
+        std::uint32_t voice_count = 0;
+        std::uint32_t prefetch_frames = 0;
+    };
+
+    struct BusConfig final
+    {
+        std::uint32_t max_bus_count = 0;
+        std::uint32_t render_worker_count = 0;
+        std::uint32_t gain_ramp_frames = 0;
+        std::uint32_t max_reverb_bus_count = 0;
+        std::uint32_t reverb_partition_frames = decl_audio::playback::kDefaultReverbPartitionFrames;
+        std::uint32_t max_impulse_frames = 0;
+        std::uint32_t reverb_head_partitions = 1;
+        std::uint32_t out_channel_count = OutputChannelCount;
+    };
+
+    struct LimiterConfig final
+    {
+        std::uint32_t lookahead_frames = 0;
+        std::uint32_t release_frames = 0;
+        float ceiling = 1.0f;
+    };
+
     struct PlaybackTestRig final
     {
+        PlaybackTestRig() = default;
+        explicit PlaybackTestRig(const std::uint32_t render_worker_count,
+                                 const std::uint32_t gain_ramp_frames = 0,
+                                 const std::uint32_t render_quantum_frames = 0,
+                                 const std::uint32_t out_channel_count = OutputChannelCount)
+            : audio_runtime(0xC0FFEEULL, 256, 4096, out_channel_count, 1024, 256, 64, 64, render_worker_count, gain_ramp_frames,
+                            decl_audio::playback::StealPolicy::None, render_quantum_frames)
+        {
+        }
+        PlaybackTestRig(const std::size_t max_instances, const decl_audio::playback::StealPolicy steal_policy)
+            : audio_runtime(0xC0FFEEULL, max_instances, 4096, OutputChannelCount, 1024, 256, 64, 64, 0, 0, steal_policy)
+        {
+        }
+        // Streamed assets load with a head as long as the prefetch, as the
+        // engine loads them.
+        explicit PlaybackTestRig(const StreamingConfig &streaming)
+            : stream_head_frames(streaming.prefetch_frames),
+              audio_runtime(0xC0FFEEULL, 256, 4096, OutputChannelCount, 1024, 256, 64, 64, 0, 0,
+                            decl_audio::playback::StealPolicy::None, 0, streaming.voice_count, streaming.prefetch_frames)
+        {
+        }
+        explicit PlaybackTestRig(const BusConfig &buses)
+            : bus_registry(buses.max_bus_count, buses.max_reverb_bus_count, buses.reverb_partition_frames, buses.max_impulse_frames),
+              audio_runtime(0xC0FFEEULL, 256, 4096, buses.out_channel_count, 1024, 256, 64, 64, buses.render_worker_count, buses.gain_ramp_frames,
+                            decl_audio::playback::StealPolicy::None, 0, 0, decl_audio::assets::kDefaultStreamHeadFrames, buses.max_bus_count,
+                            decl_audio::assets::kDefaultSampleRate, buses.max_reverb_bus_count, buses.reverb_partition_frames, buses.max_impulse_frames,
+                            buses.reverb_head_partitions)
+        {
+        }
+        explicit PlaybackTestRig(const LimiterConfig &limiter)
+            : audio_runtime(0xC0FFEEULL, 256, 4096, OutputChannelCount, 1024, 256, 64, 64, 0, 0, decl_audio::playback::StealPolicy::None, 0, 0,
+                            decl_audio::assets::kDefaultStreamHeadFrames, 0, decl_audio::assets::kDefaultSampleRate, 0,
+                            decl_audio::playback::kDefaultReverbPartitionFrames, 0, 1, limiter.lookahead_frames, limiter.release_frames, limiter.ceiling)
+        {
+        }
+
+        std::uint32_t stream_head_frames = decl_audio::assets::kDefaultStreamHeadFrames;
         decl_audio::compiler::CompiledBank compiled_bank;
         decl_audio::assets::AssetBank asset_bank;
         decl_audio::runtime::VocabularyRegistry vocabulary;
+        decl_audio::runtime::BusRegistry bus_registry;
         decl_audio::runtime::ControlRuntime control_runtime{vocabulary};
         decl_audio::runtime::BehaviorResolver behavior_resolver;
         decl_audio::playback::AudioRuntime audio_runtime;
@@ -117,7 +189,8 @@ namespace
             if (!Expect(!compile_result.HasErrors(), compile_message))
                 return false;
 
-            const decl_audio::assets::LoadResult asset_result = decl_audio::assets::LoadAssetBank(compile_result.bank, fixture_path);
+            const decl_audio::assets::LoadResult asset_result =
+                decl_audio::assets::LoadAssetBank(compile_result.bank, fixture_path, decl_audio::assets::kDefaultSampleRate, nullptr, stream_head_frames);
             if (!Expect(!asset_result.HasErrors(), load_message))
                 return false;
 
@@ -125,13 +198,22 @@ namespace
             asset_bank = asset_result.bank;
             behavior_resolver.Reset();
             vocabulary.MergeBank(compiled_bank); // intern + remap vocabulary to global ids
+            if (!Expect(bus_registry.CheckBank(compiled_bank, asset_bank).empty(), "fixture buses should fit the rig's bus registry"))
+                return false;
+            for (decl_audio::compiler::BusId bus = bus_registry.MergeBank(compiled_bank, asset_bank); bus < bus_registry.BusCount(); ++bus)
+            {
+                const decl_audio::compiler::CompiledFilter *filter = bus_registry.Filter(bus);
+                audio_runtime.Submit(decl_audio::playback::AddBusCommand{bus, bus_registry.Parent(bus), bus_registry.Gain(bus), filter != nullptr,
+                                                                         filter != nullptr ? *filter : decl_audio::compiler::CompiledFilter{},
+                                                                         bus_registry.Impulse(bus), bus_registry.Duck(bus)});
+            }
             audio_runtime.InstallBank(decl_audio::BankId{0u, 0u}, &compiled_bank, &asset_bank);
             return true;
         }
 
-        void SubmitAudioCommand(const decl_audio::playback::AudioCommand &command)
+        void SubmitAudioCommand(const decl_audio::playback::AudioCommand &command, const std::uint64_t at_frame = 0)
         {
-            audio_runtime.Submit(command);
+            audio_runtime.Submit(command, at_frame);
         }
 
         void SetTag(const char *entity_id, const char *tag)
@@ -177,6 +259,13 @@ namespace
                 Vec3{x, y, z}});
         }
 
+        void SetListenerTransform(const Vec3 &position, const Quat &orientation)
+        {
+            control_runtime.Submit(decl_audio::runtime::SetListenerTransformCommand{
+                position,
+                orientation});
+        }
+
         void DestroyEntity(const char *entity_id)
         {
             control_runtime.Submit(decl_audio::runtime::DestroyEntityCommand{
@@ -194,6 +283,13 @@ namespace
                     listener_position});
             }
 
+            Quat listener_orientation;
+            if (control_runtime.ListenerOrientationChanged(listener_orientation))
+            {
+                audio_runtime.Submit(decl_audio::playback::SetListenerOrientationCommand{
+                    listener_orientation});
+            }
+
             const decl_audio::runtime::ResolverBankView view{decl_audio::BankId{0u, 0u}, &compiled_bank, false};
             behavior_resolver.Resolve(
                 control_runtime.GetWorldState(),
@@ -344,6 +440,62 @@ namespace
         return true;
     }
 
+    bool TestGainRampInterpolatesVolumeChangeAcrossBlocks()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        constexpr std::uint32_t kRampFrames = 8;
+        PlaybackTestRig rig(0, kRampFrames);
+        if (!rig.LoadFixture(fixture_path, "gain ramp fixture should compile", "gain ramp fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("playback.loop");
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        constexpr std::uint32_t kWarmupFrames = 16;
+        constexpr std::uint32_t kFirstBlockFrames = 5; // the ramp straddles the block boundary
+        constexpr std::uint32_t kSecondBlockFrames = 11;
+        if (!Expect(buffer.frame_count > kWarmupFrames + kFirstBlockFrames + kSecondBlockFrames, "loop playback fixture should contain enough frames for the gain ramp test"))
+            return false;
+
+        constexpr decl_audio::playback::InstanceId kInstanceId = 2003;
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kInstanceId,
+            program_id,
+            Vec3{},
+            1.0f});
+
+        // A new instance starts at its target gain - ramps only smooth changes.
+        std::vector<float> warmup_output(static_cast<std::size_t>(kWarmupFrames) * OutputChannelCount);
+        rig.Render(warmup_output.data(), kWarmupFrames);
+        if (!ExpectNear(warmup_output[0], buffer.samples[0] * 0.75f, 1e-6f, "a new voice should not ramp in from silence"))
+            return false;
+
+        rig.SubmitAudioCommand(decl_audio::playback::SetVolumeCommand{
+            kInstanceId,
+            0.5f});
+
+        std::vector<float> output(static_cast<std::size_t>(kFirstBlockFrames + kSecondBlockFrames) * OutputChannelCount);
+        rig.Render(output.data(), kFirstBlockFrames);
+        rig.Render(output.data() + static_cast<std::size_t>(kFirstBlockFrames) * OutputChannelCount, kSecondBlockFrames);
+
+        constexpr float kStartGain = 0.75f;
+        constexpr float kTargetGain = 0.75f * 0.5f;
+        for (std::uint32_t frame_index = 0; frame_index < kFirstBlockFrames + kSecondBlockFrames; ++frame_index)
+        {
+            const float gain = frame_index < kRampFrames
+                                   ? kStartGain + (kTargetGain - kStartGain) * static_cast<float>(frame_index) / static_cast<float>(kRampFrames)
+                                   : kTargetGain;
+            const float expected = buffer.samples[kWarmupFrames + frame_index] * gain;
+            const std::size_t sample_index = static_cast<std::size_t>(frame_index) * OutputChannelCount;
+            if (!ExpectNear(output[sample_index + 0], expected, 1e-6f, "volume change should ramp linearly over the configured frames"))
+                return false;
+            if (!ExpectNear(output[sample_index + 1], expected, 1e-6f, "volume ramp should apply to both stereo channels"))
+                return false;
+        }
+
+        return true;
+    }
+
     bool TestRequestStopRetiresLoopAfterCurrentPass()
     {
         const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
@@ -399,6 +551,239 @@ namespace
         return true;
     }
 
+    bool TestSequenceStepsToNextChildOnTheFrameItsVoiceEnds()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "sequence fixture should compile", "sequence fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("playback.sequence");
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            5005,
+            program_id,
+            Vec3{},
+            1.0f});
+
+        // Blocks that do not divide the asset length, so each child hands over
+        // mid-block and the last one ends mid-block.
+        constexpr std::uint32_t kBlockFrames = 1000;
+        constexpr float kChildGains[] = {1.0f, 0.5f, 0.25f};
+        const std::uint64_t total_frames = buffer.frame_count * std::size(kChildGains);
+        const std::uint64_t rendered_frames = ((total_frames / kBlockFrames) + 2) * kBlockFrames;
+        std::vector<float> output(static_cast<std::size_t>(rendered_frames) * OutputChannelCount);
+        for (std::uint64_t rendered = 0; rendered < rendered_frames; rendered += kBlockFrames)
+        {
+            rig.Render(output.data() + (rendered * OutputChannelCount), kBlockFrames);
+        }
+
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 0, "sequence should retire once its last child ends"))
+            return false;
+
+        for (std::uint64_t frame_index = 0; frame_index < rendered_frames; ++frame_index)
+        {
+            float expected = 0.0f;
+            if (frame_index < total_frames)
+            {
+                expected = buffer.samples[frame_index % buffer.frame_count] * kChildGains[frame_index / buffer.frame_count];
+            }
+
+            const std::size_t sample_index = static_cast<std::size_t>(frame_index) * OutputChannelCount;
+            if (!ExpectNear(output[sample_index + 0], expected, 1e-6f, "sequence children should play back to back on the left channel"))
+                return false;
+            if (!ExpectNear(output[sample_index + 1], expected, 1e-6f, "sequence children should play back to back on the right channel"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestTimedCommandsLandOnTheirAudioClockFrame()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "timed command fixture should compile", "timed command fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("playback.oneshot");
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+
+        constexpr std::uint32_t kLeadFrames = 10;
+        std::vector<float> lead_output(static_cast<std::size_t>(kLeadFrames) * OutputChannelCount);
+        rig.Render(lead_output.data(), kLeadFrames);
+        if (!Expect(rig.audio_runtime.GetAudioClock() == kLeadFrames, "audio clock should count rendered frames"))
+            return false;
+
+        // Start and re-gain the instance mid-block; both land on their exact frame.
+        constexpr decl_audio::playback::InstanceId kInstanceId = 6006;
+        constexpr std::uint32_t kStartOffset = 37;
+        constexpr std::uint32_t kVolumeOffset = 57;
+        constexpr std::uint32_t kBlockFrames = 64;
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{kInstanceId, program_id, Vec3{}, 1.0f},
+                               kLeadFrames + kStartOffset);
+        rig.SubmitAudioCommand(decl_audio::playback::SetVolumeCommand{kInstanceId, 0.5f},
+                               kLeadFrames + kVolumeOffset);
+
+        std::vector<float> output(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+        rig.Render(output.data(), kBlockFrames);
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 1, "timed create should have started within the block"))
+            return false;
+
+        for (std::uint32_t frame_index = 0; frame_index < kBlockFrames; ++frame_index)
+        {
+            float expected = 0.0f;
+            if (frame_index >= kVolumeOffset)
+            {
+                expected = buffer.samples[frame_index - kStartOffset] * 0.5f * 0.5f;
+            }
+            else if (frame_index >= kStartOffset)
+            {
+                expected = buffer.samples[frame_index - kStartOffset] * 0.5f;
+            }
+
+            const std::size_t sample_index = static_cast<std::size_t>(frame_index) * OutputChannelCount;
+            if (!ExpectNear(output[sample_index + 0], expected, 1e-6f, "timed commands should apply on their frame (left)"))
+                return false;
+            if (!ExpectNear(output[sample_index + 1], expected, 1e-6f, "timed commands should apply on their frame (right)"))
+                return false;
+        }
+
+        // A frame already rendered applies at the start of the next block.
+        rig.SubmitAudioCommand(decl_audio::playback::SetVolumeCommand{kInstanceId, 1.0f}, 3);
+        constexpr std::uint32_t kLateFrames = 8;
+        std::vector<float> late_output(static_cast<std::size_t>(kLateFrames) * OutputChannelCount);
+        rig.Render(late_output.data(), kLateFrames);
+        for (std::uint32_t frame_index = 0; frame_index < kLateFrames; ++frame_index)
+        {
+            const float expected = buffer.samples[kBlockFrames - kStartOffset + frame_index] * 0.5f;
+            if (!ExpectNear(late_output[static_cast<std::size_t>(frame_index) * OutputChannelCount], expected, 1e-6f, "late command should apply at the next block start"))
+                return false;
+        }
+
+        return Expect(rig.audio_runtime.GetAudioClock() == kLeadFrames + kBlockFrames + kLateFrames, "audio clock should advance by every rendered block");
+    }
+
+    bool TestRenderQuantumServesIrregularCallbacksSeamlessly()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        constexpr std::uint32_t kQuantumFrames = 64;
+        PlaybackTestRig reference_rig;
+        PlaybackTestRig quantum_rig(0, 0, kQuantumFrames);
+        if (!reference_rig.LoadFixture(fixture_path, "quantum fixture should compile", "quantum fixture should load"))
+            return false;
+        if (!quantum_rig.LoadFixture(fixture_path, "quantum fixture should compile", "quantum fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = reference_rig.compiled_bank.GetProgramId("playback.oneshot");
+        const decl_audio::playback::CreateInstanceCommand create{7007, program_id, Vec3{}, 1.0f};
+        reference_rig.SubmitAudioCommand(create);
+        quantum_rig.SubmitAudioCommand(create);
+
+        // Callbacks that straddle quanta, plus one longer than max_block_frames.
+        constexpr std::uint32_t kCallbackFrames[] = {1, 100, 37, 5000, 229};
+        constexpr std::uint32_t kTotalFrames = 1 + 100 + 37 + 5000 + 229;
+
+        std::vector<float> reference_output(static_cast<std::size_t>(kTotalFrames) * OutputChannelCount);
+        reference_rig.Render(reference_output.data(), kTotalFrames);
+
+        std::vector<float> quantum_output(static_cast<std::size_t>(kTotalFrames) * OutputChannelCount);
+        std::uint32_t rendered = 0;
+        for (const std::uint32_t callback_frames : kCallbackFrames)
+        {
+            quantum_rig.Render(quantum_output.data() + (static_cast<std::size_t>(rendered) * OutputChannelCount), callback_frames);
+            rendered += callback_frames;
+
+            const std::uint64_t clock = quantum_rig.audio_runtime.GetAudioClock();
+            if (!Expect(clock % kQuantumFrames == 0 && clock >= rendered && clock - rendered < kQuantumFrames,
+                        "render quantum should mix whole quanta and carry at most one partial quantum"))
+                return false;
+        }
+
+        if (!Expect(quantum_rig.audio_runtime.ActiveInstanceCount() == 0, "oneshot should have finished within the rendered frames"))
+            return false;
+
+        return Expect(std::memcmp(reference_output.data(), quantum_output.data(), reference_output.size() * sizeof(float)) == 0,
+                      "quantized rendering should reproduce the unquantized stream exactly");
+    }
+
+    bool TestRenderAheadStreamReproducesTheMixAndCountsUnderruns()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig reference_rig;
+        PlaybackTestRig ahead_rig;
+        if (!reference_rig.LoadFixture(fixture_path, "render-ahead fixture should compile", "render-ahead fixture should load"))
+            return false;
+        if (!ahead_rig.LoadFixture(fixture_path, "render-ahead fixture should compile", "render-ahead fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = reference_rig.compiled_bank.GetProgramId("playback.loop");
+        const decl_audio::playback::CreateInstanceCommand create{8008, program_id, Vec3{}, 1.0f};
+        reference_rig.SubmitAudioCommand(create);
+        ahead_rig.SubmitAudioCommand(create);
+
+        constexpr std::uint32_t kBlockFrames = 64;
+        constexpr std::uint32_t kTargetFrames = 256;
+        constexpr std::uint32_t kCallbackFrames = 100;
+        constexpr std::uint32_t kCallbackCount = 40;
+
+        std::vector<float> reference_output(static_cast<std::size_t>(kCallbackFrames) * kCallbackCount * OutputChannelCount);
+        reference_rig.Render(reference_output.data(), kCallbackFrames * kCallbackCount);
+
+        std::vector<float> ahead_output(reference_output.size());
+        {
+            decl_audio::playback::RenderAheadStream stream(ahead_rig.audio_runtime, OutputChannelCount, kBlockFrames, kTargetFrames, kBlockFrames);
+            if (!Expect(stream.QueuedFrames() >= kTargetFrames, "render-ahead stream should be primed to its target on construction"))
+                return false;
+
+            for (std::uint32_t callback = 0; callback < kCallbackCount; ++callback)
+            {
+                // Stand in for a device that never outruns the render thread.
+                while (stream.QueuedFrames() < kCallbackFrames)
+                {
+                    std::this_thread::yield();
+                }
+
+                stream.Read(ahead_output.data() + static_cast<std::size_t>(callback) * kCallbackFrames * OutputChannelCount, kCallbackFrames);
+            }
+
+            if (!Expect(stream.UnderrunCount() == 0, "a device that waits for the queue should see no underruns"))
+                return false;
+        }
+
+        if (!Expect(std::memcmp(reference_output.data(), ahead_output.data(), reference_output.size() * sizeof(float)) == 0,
+                    "render-ahead output should match mixing in the callback"))
+            return false;
+
+        // A callback larger than the whole queue must come up short: what was
+        // queued, then silence, counted once.
+        PlaybackTestRig starved_rig;
+        if (!starved_rig.LoadFixture(fixture_path, "render-ahead fixture should compile", "render-ahead fixture should load"))
+            return false;
+        starved_rig.SubmitAudioCommand(create);
+
+        decl_audio::playback::RenderAheadStream starved(starved_rig.audio_runtime, OutputChannelCount, kBlockFrames, kTargetFrames, kBlockFrames);
+        constexpr std::uint32_t kOversizedFrames = 4 * kTargetFrames;
+        std::vector<float> starved_output(static_cast<std::size_t>(kOversizedFrames) * OutputChannelCount, 1.0f);
+        starved.Read(starved_output.data(), kOversizedFrames);
+        if (!Expect(starved.UnderrunCount() == 1, "a short read should count one underrun"))
+            return false;
+        if (!Expect(std::memcmp(starved_output.data(), reference_output.data(), static_cast<std::size_t>(kTargetFrames) * OutputChannelCount * sizeof(float)) == 0,
+                    "a short read should still deliver the queued frames"))
+            return false;
+
+        for (std::size_t sample = static_cast<std::size_t>(kTargetFrames) * OutputChannelCount; sample < starved_output.size(); ++sample)
+        {
+            if (!Expect(starved_output[sample] == 0.0f, "frames the queue could not cover should be silent"))
+                return false;
+        }
+
+        return true;
+    }
+
     bool TestStubBackendPumpsPlaybackWithoutOutputBuffer()
     {
         const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
@@ -647,209 +1032,1323 @@ namespace
         return true;
     }
 
-    bool TestSelectChoiceIsDeterministicAndOnlyEntersChosenSubtree()
+    bool TestPitchParameterResamplesLeafPlayback()
     {
         const std::filesystem::path fixture_path = GetFixturePath("NestedBehaviorBank.json");
         PlaybackTestRig rig;
-        if (!rig.LoadFixture(fixture_path, "phase 10 select fixture should compile", "phase 10 select fixture should load"))
+        if (!rig.LoadFixture(fixture_path, "pitch fixture should compile", "pitch fixture should load"))
             return false;
 
-        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("nested.select_blend_or_loop");
-        constexpr decl_audio::playback::InstanceId kInstanceId = 8101;
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("nested.pitched_oneshot");
+        const decl_audio::compiler::ParameterId pitch_parameter_id = rig.compiled_bank.GetParameterId("pitch");
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        if (!Expect(buffer.frame_count > 16, "pitch fixture should contain enough frames"))
+            return false;
+
+        // An octave up reads every other source frame and ends in half the time.
+        constexpr decl_audio::playback::InstanceId kOctaveUpId = 8201;
         rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
-            kInstanceId,
+            kOctaveUpId,
             program_id,
             Vec3{},
             1.0f});
+        rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
+            kOctaveUpId,
+            pitch_parameter_id,
+            12.0f});
 
-        std::vector<float> output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(output.data(), 1);
-
-        decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
-        if (!Expect(snapshot.active_instance_count == 1, "select test should create one instance"))
-            return false;
-        if (!Expect(snapshot.instances[0].nodes.size() == 6, "select instance should expose root, select, blend subtree, and alternate loop"))
-            return false;
+        const std::uint32_t pitched_frames = static_cast<std::uint32_t>((buffer.frame_count + 1) / 2);
+        std::vector<float> output(static_cast<std::size_t>(pitched_frames + 8) * OutputChannelCount);
+        rig.Render(output.data(), pitched_frames + 8);
 
-        const decl_audio::playback::InstanceDebugSnapshot &instance = snapshot.instances[0];
-        const std::int32_t chosen_child = instance.nodes[1].chosen_child;
-        if (!Expect(chosen_child == 0 || chosen_child == 1, "select should latch one authored child on entry"))
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 0, "an octave-up one-shot should end after half its source frames"))
             return false;
 
-        if (chosen_child == 0)
+        for (std::uint32_t frame_index = 0; frame_index < pitched_frames; ++frame_index)
         {
-            if (!Expect(instance.active_voice_count == 2, "selecting the blend branch should activate both blend loops"))
-                return false;
-            if (!Expect(instance.nodes[2].entered, "blend node should enter when selected"))
-                return false;
-            if (!Expect(instance.nodes[3].entered && instance.nodes[4].entered, "selected blend children should enter"))
-                return false;
-            if (!Expect(!instance.nodes[5].entered, "alternate loop should stay inactive when blend is selected"))
+            const std::size_t sample_index = static_cast<std::size_t>(frame_index) * OutputChannelCount;
+            if (!ExpectNear(output[sample_index], buffer.samples[frame_index * 2], 1e-6f, "an octave up should play every other source frame"))
                 return false;
         }
-        else
+
+        for (std::size_t sample_index = static_cast<std::size_t>(pitched_frames) * OutputChannelCount; sample_index < output.size(); ++sample_index)
         {
-            if (!Expect(instance.active_voice_count == 1, "selecting the alternate loop should activate one voice"))
-                return false;
-            if (!Expect(!instance.nodes[2].entered && !instance.nodes[3].entered && !instance.nodes[4].entered, "unselected blend subtree should remain inactive"))
-                return false;
-            if (!Expect(instance.nodes[5].entered, "selected alternate loop should enter"))
+            if (!ExpectNear(output[sample_index], 0.0f, 1e-6f, "a finished pitched voice should leave trailing samples silent"))
                 return false;
         }
 
-        rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
-            kInstanceId,
-            rig.compiled_bank.GetParameterId("mix"),
-            0.9f});
-        rig.Render(output.data(), 1);
-
-        snapshot = rig.audio_runtime.GetDebugSnapshot();
-        if (!Expect(snapshot.instances[0].nodes[1].chosen_child == chosen_child, "select should not switch branches after entry"))
-            return false;
-
-        PlaybackTestRig rig_repeat;
-        if (!rig_repeat.LoadFixture(fixture_path, "phase 10 repeated select fixture should compile", "phase 10 repeated select fixture should load"))
-            return false;
-
-        rig_repeat.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
-            kInstanceId,
+        // An octave down lands halfway between source frames on odd output frames.
+        constexpr decl_audio::playback::InstanceId kOctaveDownId = 8202;
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kOctaveDownId,
             program_id,
             Vec3{},
             1.0f});
-        rig_repeat.Render(output.data(), 1);
-        const decl_audio::playback::DebugSnapshot repeat_snapshot = rig_repeat.audio_runtime.GetDebugSnapshot();
-        if (!Expect(repeat_snapshot.instances[0].nodes[1].chosen_child == chosen_child, "select choice should be deterministic for a stable seed"))
-            return false;
+        rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
+            kOctaveDownId,
+            pitch_parameter_id,
+            -12.0f});
 
-        return true;
+        constexpr std::uint32_t kDownFrames = 8;
+        rig.Render(output.data(), kDownFrames);
+        for (std::uint32_t frame_index = 0; frame_index < kDownFrames; ++frame_index)
+        {
+            const float a = buffer.samples[frame_index / 2];
+            const float b = buffer.samples[frame_index / 2 + 1];
+            const float expected = frame_index % 2 == 0 ? a : a + (b - a) * 0.5f;
+            if (!ExpectNear(output[static_cast<std::size_t>(frame_index) * OutputChannelCount], expected, 1e-6f,
+                            "an octave down should interpolate between neighbouring source frames"))
+                return false;
+        }
+
+        const decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
+        return Expect(snapshot.instances[0].voices[0].sample_position == kDownFrames / 2, "an octave down should advance half a source frame per output frame");
     }
 
-    bool TestResolverForwardsDeclaredBlendParameter()
+    bool TestCompactFormatsDecodeWhileMixing()
     {
-        const std::filesystem::path fixture_path = GetFixturePath("NestedBehaviorBank.json");
-        PlaybackTestRig rig;
-        if (!rig.LoadFixture(fixture_path, "phase 10 resolver blend fixture should compile", "phase 10 resolver blend fixture should load"))
+        const std::filesystem::path fixture_path = GetFixturePath("CompactFormatBehaviorBank.json");
+        PlaybackTestRig compact_rig;
+        if (!compact_rig.LoadFixture(fixture_path, "compact format fixture should compile", "compact format fixture should load"))
             return false;
 
-        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
-        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
-        if (!Expect(buffer.frame_count > 2, "resolver blend fixture should contain enough frames"))
+        using decl_audio::compiler::SampleFormat;
+        const decl_audio::assets::DecodedBuffer &pcm16 = compact_rig.asset_bank.GetBuffer(compact_rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav"));
+        const decl_audio::assets::DecodedBuffer &adpcm = compact_rig.asset_bank.GetBuffer(compact_rig.compiled_bank.GetAssetId("audio/test_48_24_2ch.wav"));
+        if (!Expect(pcm16.format == SampleFormat::S16 && pcm16.samples.empty(), "assetFormats should keep the mono asset as S16") ||
+            !Expect(adpcm.format == SampleFormat::ImaAdpcm && adpcm.samples.empty(), "assetFormats should keep the stereo asset as ADPCM"))
             return false;
 
-        rig.SetValue("player", "mix", 0.0f);
-        rig.SetTag("player", "nested.active");
-        rig.Update();
+        // The same bank with every buffer decoded up front: decoding while
+        // mixing must reproduce it exactly, through the direct and the
+        // resampling paths alike.
+        PlaybackTestRig decoded_rig;
+        decoded_rig.compiled_bank = compact_rig.compiled_bank;
+        for (const std::shared_ptr<const decl_audio::assets::DecodedBuffer> &buffer : compact_rig.asset_bank.buffers)
+        {
+            decoded_rig.asset_bank.buffers.push_back(std::make_shared<const decl_audio::assets::DecodedBuffer>(decl_audio::assets::DecodeBuffer(*buffer)));
+        }
+        decoded_rig.audio_runtime.InstallBank(decl_audio::BankId{0u, 0u}, &decoded_rig.compiled_bank, &decoded_rig.asset_bank);
 
-        std::vector<float> startup_output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(startup_output.data(), 1);
+        const decl_audio::compiler::ParameterId pitch_parameter_id = compact_rig.compiled_bank.GetParameterId("pitch");
+        decl_audio::playback::InstanceId instance_id = 8301;
+        for (const char *program_name : {"compact.pcm16", "compact.adpcm"})
+        {
+            const decl_audio::compiler::ProgramId program_id = compact_rig.compiled_bank.GetProgramId(program_name);
+            for (const float pitch : {0.0f, 7.0f, -12.0f})
+            {
+                for (PlaybackTestRig *rig : {&compact_rig, &decoded_rig})
+                {
+                    rig->SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+                        instance_id,
+                        program_id,
+                        Vec3{},
+                        1.0f});
+                    rig->SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
+                        instance_id,
+                        pitch_parameter_id,
+                        pitch});
+                }
+                ++instance_id;
+
+                // Long enough for an octave down to play the stereo asset out.
+                constexpr std::uint32_t kFramesToRender = 49152;
+                std::vector<float> compact_output(static_cast<std::size_t>(kFramesToRender) * OutputChannelCount);
+                std::vector<float> decoded_output(compact_output.size());
+                compact_rig.Render(compact_output.data(), kFramesToRender);
+                decoded_rig.Render(decoded_output.data(), kFramesToRender);
+
+                if (!Expect(compact_rig.audio_runtime.ActiveInstanceCount() == 0, "a compact one-shot should play out") ||
+                    !Expect(compact_output == decoded_output, "decoding while mixing should match the buffer decoded at load"))
+                {
+                    std::cerr << "  program=" << program_name << " pitch=" << pitch << '\n';
+                    return false;
+                }
+            }
+        }
 
-        if (!ExpectNear(startup_output[0], buffer.samples[0], 1e-6f, "resolver should seed the initial blend parameter onto the first render block"))
+        return true;
+    }
+
+    // Polls until the rig's I/O thread has filled every ring it can.
+    bool WaitForStreamsToSettle(const PlaybackTestRig &rig)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!rig.audio_runtime.AreStreamsSettledForTesting())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        return true;
+    }
+
+    bool TestStreamedVoicesMatchResidentPlayback()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("StreamedBehaviorBank.json");
+        constexpr std::uint32_t kPrefetchFrames = 2048;
+        PlaybackTestRig streamed_rig(StreamingConfig{4, kPrefetchFrames});
+        if (!streamed_rig.LoadFixture(fixture_path, "streamed fixture should compile", "streamed fixture should load"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer &streamed = streamed_rig.asset_bank.GetBuffer(streamed_rig.compiled_bank.GetAssetId("audio/test_48_24_2ch.wav"));
+        if (!Expect(streamed.IsStreamed() && streamed.HeadFrameCount() == kPrefetchFrames && streamed.frame_count == 24000,
+                    "a streamed asset should keep only a prefetch-long head resident"))
+            return false;
+
+        // The reference plays the whole file from memory.
+        PlaybackTestRig resident_rig;
+        resident_rig.compiled_bank = streamed_rig.compiled_bank;
+        decl_audio::assets::DecodedBuffer resident;
+        if (!Expect(decl_audio::assets::LoadStreamedAsset(streamed.stream_path, streamed.sample_rate, UINT32_MAX, resident).empty() && !resident.IsStreamed(),
+                    "the streamed asset should read whole with an unbounded head"))
+            return false;
+        resident_rig.asset_bank.buffers.push_back(std::make_shared<const decl_audio::assets::DecodedBuffer>(std::move(resident)));
+        resident_rig.audio_runtime.InstallBank(decl_audio::BankId{0u, 0u}, &resident_rig.compiled_bank, &resident_rig.asset_bank);
+
+        // Slow storage: the ring fills a chunk at a time behind the voice, and
+        // each block waits for it so the comparison is exact rather than racy.
+        streamed_rig.audio_runtime.SetStreamReadDelayForTesting(std::chrono::microseconds(500));
+
+        const decl_audio::compiler::ParameterId pitch_parameter_id = streamed_rig.compiled_bank.GetParameterId("pitch");
+        decl_audio::playback::InstanceId instance_id = 8401;
+        for (const char *program_name : {"streamed.oneshot", "streamed.loop"})
+        {
+            const decl_audio::compiler::ProgramId program_id = streamed_rig.compiled_bank.GetProgramId(program_name);
+            for (const float pitch : {0.0f, -5.0f})
+            {
+                for (PlaybackTestRig *rig : {&streamed_rig, &resident_rig})
+                {
+                    rig->SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+                        instance_id,
+                        program_id,
+                        Vec3{},
+                        1.0f});
+                    rig->SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
+                        instance_id,
+                        pitch_parameter_id,
+                        pitch});
+                }
+                ++instance_id;
+
+                // Three passes of the loop at 3/4 speed, in device-sized blocks.
+                constexpr std::uint32_t kBlockFrames = 512;
+                constexpr std::uint32_t kBlockCount = 200;
+                std::vector<float> streamed_output(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+                std::vector<float> resident_output(streamed_output.size());
+                for (std::uint32_t block = 0; block < kBlockCount; ++block)
+                {
+                    if (!Expect(WaitForStreamsToSettle(streamed_rig), "the I/O thread should fill the stream ring"))
+                        return false;
+
+                    streamed_rig.Render(streamed_output.data(), kBlockFrames);
+                    resident_rig.Render(resident_output.data(), kBlockFrames);
+                    if (!Expect(streamed_output == resident_output, "a streamed voice should play exactly what the resident asset plays"))
+                    {
+                        std::cerr << "  program=" << program_name << " pitch=" << pitch << " block=" << block << '\n';
+                        return false;
+                    }
+                }
+
+                if (!Expect(streamed_rig.audio_runtime.ActiveInstanceCount() == 0, "a streamed voice should play out"))
+                    return false;
+            }
+        }
+
+        return Expect(streamed_rig.audio_runtime.GetMetrics().stream_underrun_count == 0, "a ring kept filled should never underrun");
+    }
+
+    bool TestStreamUnderrunsPlaySilenceWithoutBlocking()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("StreamedBehaviorBank.json");
+        constexpr std::uint32_t kPrefetchFrames = 1024;
+        PlaybackTestRig rig(StreamingConfig{1, kPrefetchFrames});
+        if (!rig.LoadFixture(fixture_path, "streamed fixture should compile", "streamed fixture should load"))
+            return false;
+
+        // Storage far slower than playback: nothing past the head arrives
+        // while the asset plays.
+        constexpr auto kReadDelay = std::chrono::milliseconds(250);
+        rig.audio_runtime.SetStreamReadDelayForTesting(kReadDelay);
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("streamed.oneshot");
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            8501,
+            program_id,
+            Vec3{},
+            1.0f});
+
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(rig.compiled_bank.GetAssetId("audio/test_48_24_2ch.wav"));
+        const std::uint32_t frame_count = static_cast<std::uint32_t>(buffer.frame_count);
+        std::vector<float> output(static_cast<std::size_t>(frame_count) * OutputChannelCount);
+        const auto render_start = std::chrono::steady_clock::now();
+        for (std::uint32_t frame = 0; frame < frame_count; frame += 1000)
+        {
+            rig.Render(output.data() + static_cast<std::size_t>(frame) * OutputChannelCount, std::min(1000u, frame_count - frame));
+            if (frame + 1000 < frame_count && !Expect(rig.audio_runtime.ActiveInstanceCount() == 1, "an underrunning voice should keep playing"))
+                return false;
+        }
+        const auto render_time = std::chrono::steady_clock::now() - render_start;
+
+        if (!Expect(render_time < kReadDelay, "rendering should not wait on the I/O thread") ||
+            !Expect(rig.audio_runtime.ActiveInstanceCount() == 0, "an underrunning voice should still end on schedule") ||
+            !Expect(rig.audio_runtime.GetMetrics().stream_underrun_count > 0, "reads past the ring should be counted as underruns"))
+            return false;
+
+        for (std::uint32_t frame = 0; frame < kPrefetchFrames; ++frame)
+        {
+            if (!ExpectNear(output[static_cast<std::size_t>(frame) * OutputChannelCount], buffer.samples[static_cast<std::size_t>(frame) * 2], 1e-6f,
+                            "the resident head should play while the stream is still empty"))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool TestSelectChoiceIsDeterministicAndOnlyEntersChosenSubtree()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("NestedBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "phase 10 select fixture should compile", "phase 10 select fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("nested.select_blend_or_loop");
+        constexpr decl_audio::playback::InstanceId kInstanceId = 8101;
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kInstanceId,
+            program_id,
+            Vec3{},
+            1.0f});
+
+        std::vector<float> output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(output.data(), 1);
+
+        decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
+        if (!Expect(snapshot.active_instance_count == 1, "select test should create one instance"))
+            return false;
+        if (!Expect(snapshot.instances[0].nodes.size() == 6, "select instance should expose root, select, blend subtree, and alternate loop"))
+            return false;
+
+        const decl_audio::playback::InstanceDebugSnapshot &instance = snapshot.instances[0];
+        const std::int32_t chosen_child = instance.nodes[1].chosen_child;
+        if (!Expect(chosen_child == 0 || chosen_child == 1, "select should latch one authored child on entry"))
+            return false;
+
+        if (chosen_child == 0)
+        {
+            if (!Expect(instance.active_voice_count == 2, "selecting the blend branch should activate both blend loops"))
+                return false;
+            if (!Expect(instance.nodes[2].entered, "blend node should enter when selected"))
+                return false;
+            if (!Expect(instance.nodes[3].entered && instance.nodes[4].entered, "selected blend children should enter"))
+                return false;
+            if (!Expect(!instance.nodes[5].entered, "alternate loop should stay inactive when blend is selected"))
+                return false;
+        }
+        else
+        {
+            if (!Expect(instance.active_voice_count == 1, "selecting the alternate loop should activate one voice"))
+                return false;
+            if (!Expect(!instance.nodes[2].entered && !instance.nodes[3].entered && !instance.nodes[4].entered, "unselected blend subtree should remain inactive"))
+                return false;
+            if (!Expect(instance.nodes[5].entered, "selected alternate loop should enter"))
+                return false;
+        }
+
+        rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{
+            kInstanceId,
+            rig.compiled_bank.GetParameterId("mix"),
+            0.9f});
+        rig.Render(output.data(), 1);
+
+        snapshot = rig.audio_runtime.GetDebugSnapshot();
+        if (!Expect(snapshot.instances[0].nodes[1].chosen_child == chosen_child, "select should not switch branches after entry"))
+            return false;
+
+        PlaybackTestRig rig_repeat;
+        if (!rig_repeat.LoadFixture(fixture_path, "phase 10 repeated select fixture should compile", "phase 10 repeated select fixture should load"))
+            return false;
+
+        rig_repeat.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kInstanceId,
+            program_id,
+            Vec3{},
+            1.0f});
+        rig_repeat.Render(output.data(), 1);
+        const decl_audio::playback::DebugSnapshot repeat_snapshot = rig_repeat.audio_runtime.GetDebugSnapshot();
+        if (!Expect(repeat_snapshot.instances[0].nodes[1].chosen_child == chosen_child, "select choice should be deterministic for a stable seed"))
+            return false;
+
+        return true;
+    }
+
+    bool TestResolverForwardsDeclaredBlendParameter()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("NestedBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "phase 10 resolver blend fixture should compile", "phase 10 resolver blend fixture should load"))
+            return false;
+
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        if (!Expect(buffer.frame_count > 2, "resolver blend fixture should contain enough frames"))
+            return false;
+
+        rig.SetValue("player", "mix", 0.0f);
+        rig.SetTag("player", "nested.active");
+        rig.Update();
+
+        std::vector<float> startup_output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(startup_output.data(), 1);
+
+        if (!ExpectNear(startup_output[0], buffer.samples[0], 1e-6f, "resolver should seed the initial blend parameter onto the first render block"))
+            return false;
+        if (!ExpectNear(startup_output[1], buffer.samples[0], 1e-6f, "resolver-seeded blend parameter should affect both channels"))
+            return false;
+
+        decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
+        if (!Expect(snapshot.instances[0].active_voice_count == 2, "resolver-driven blend should keep both loops active"))
+            return false;
+
+        rig.SetValue("player", "mix", 1.0f);
+        rig.Update();
+
+        std::vector<float> updated_output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(updated_output.data(), 1);
+
+        const float expected_updated = buffer.samples[1] * 0.25f;
+        if (!ExpectNear(updated_output[0], expected_updated, 1e-6f, "resolver should forward declared parameters through SetParameter on the next block"))
+            return false;
+        if (!ExpectNear(updated_output[1], expected_updated, 1e-6f, "resolver-forwarded blend updates should affect both channels"))
+            return false;
+
+        return true;
+    }
+
+    bool TestSpatializedMonoRespondsToEntityAndListenerMovement()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "phase 7.5 mono spatialization fixture should compile", "phase 7.5 mono spatialization fixture should load"))
+            return false;
+
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        if (!Expect(buffer.frame_count > 2, "phase 7.5 mono fixture should contain enough frames"))
+            return false;
+
+        rig.SetListenerPosition(0.0f, 0.0f, 0.0f);
+        rig.SetPosition("player", 3.0f, 0.0f, 0.0f);
+        rig.SetTag("player", "spatial.mono");
+        rig.Update();
+
+        std::vector<float> startup_output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(startup_output.data(), 1);
+
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 1, "phase 7.5 mono match should create one bound instance"))
+            return false;
+        if (!Expect(rig.audio_runtime.GetListenerPositionForTesting() == Vec3{0.0f, 0.0f, 0.0f}, "listener position should forward through the control and audio chain"))
+            return false;
+
+        const StereoMixGains startup_gains = ComputeExpectedSpatialMix(Vec3{3.0f, 0.0f, 0.0f}, Vec3{0.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
+        const float startup_sample = buffer.samples[0];
+        if (!ExpectNear(startup_output[0], startup_sample * startup_gains.left, 1e-6f, "spatialized mono should pan and attenuate on the left channel"))
+            return false;
+        if (!ExpectNear(startup_output[1], startup_sample * startup_gains.right, 1e-6f, "spatialized mono should pan and attenuate on the right channel"))
+            return false;
+
+        rig.SetListenerPosition(4.0f, 0.0f, 0.0f);
+        rig.Update();
+
+        std::vector<float> updated_output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(updated_output.data(), 1);
+
+        if (!Expect(rig.audio_runtime.GetListenerPositionForTesting() == Vec3{4.0f, 0.0f, 0.0f}, "listener movement should stick on the audio thread"))
+            return false;
+
+        const StereoMixGains updated_gains = ComputeExpectedSpatialMix(Vec3{3.0f, 0.0f, 0.0f}, Vec3{4.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
+        const float updated_sample = buffer.samples[1];
+        if (!ExpectNear(updated_output[0], updated_sample * updated_gains.left, 1e-6f, "listener movement should update mono spatialization on the left channel"))
+            return false;
+        if (!ExpectNear(updated_output[1], updated_sample * updated_gains.right, 1e-6f, "listener movement should update mono spatialization on the right channel"))
+            return false;
+
+        return true;
+    }
+
+    bool TestSpatializedStereoAppliesBalanceAndAttenuation()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "phase 7.5 stereo spatialization fixture should compile", "phase 7.5 stereo spatialization fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("spatial.stereo");
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_2ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        if (!Expect(buffer.frame_count > 1, "phase 7.5 stereo fixture should contain enough frames"))
+            return false;
+
+        constexpr decl_audio::playback::InstanceId kInstanceId = 7007;
+        const Vec3 source_position{1.0f, 0.0f, 1.7320508f};
+        rig.SubmitAudioCommand(decl_audio::playback::SetListenerPositionCommand{Vec3{0.0f, 0.0f, 0.0f}});
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kInstanceId,
+            program_id,
+            source_position,
+            1.0f});
+
+        std::vector<float> output(static_cast<std::size_t>(1) * OutputChannelCount);
+        rig.Render(output.data(), 1);
+
+        const StereoMixGains gains = ComputeExpectedSpatialMix(source_position, Vec3{0.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
+        if (!ExpectNear(output[0], buffer.samples[0] * gains.left, 1e-6f, "spatialized stereo should apply balance and attenuation to the left channel"))
+            return false;
+        if (!ExpectNear(output[1], buffer.samples[1] * gains.right, 1e-6f, "spatialized stereo should apply balance and attenuation to the right channel"))
+            return false;
+
+        return true;
+    }
+
+    // Plays the looping spatial.mono program with the listener at `listener_path`
+    // positions in turn, rendering `block_frames[i]` frames at each. Records the
+    // metrics after every block, the last block's output and the voice's final
+    // sample position.
+    struct VirtualVoiceRun final
+    {
+        std::vector<float> last_block;
+        std::vector<decl_audio::playback::RuntimeMetrics> metrics;
+        std::uint64_t final_sample_position = 0;
+    };
+
+    bool RunVirtualVoiceScene(const std::vector<Vec3> &listener_path, const std::vector<std::uint32_t> &block_frames, VirtualVoiceRun &run)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "virtual voice fixture should compile", "virtual voice fixture should load"))
+            return false;
+
+        constexpr decl_audio::playback::InstanceId kInstanceId = 7008;
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+            kInstanceId,
+            rig.compiled_bank.GetProgramId("spatial.mono"),
+            Vec3{3.0f, 0.0f, 0.0f},
+            1.0f});
+
+        for (std::size_t block = 0; block < block_frames.size(); ++block)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::SetListenerPositionCommand{listener_path[block]});
+            run.last_block.assign(static_cast<std::size_t>(block_frames[block]) * OutputChannelCount, 0.0f);
+            rig.Render(run.last_block.data(), block_frames[block]);
+            run.metrics.push_back(rig.audio_runtime.GetMetrics());
+        }
+
+        const decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
+        if (!Expect(snapshot.instances.size() == 1 && snapshot.instances[0].voices.size() == 1, "virtual voice scene should keep its one looping voice"))
+            return false;
+
+        run.final_sample_position = snapshot.instances[0].voices[0].sample_position;
+        return true;
+    }
+
+    bool TestAttenuationCurveShapesSpatializedGain()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "attenuation curve fixture should compile", "attenuation curve fixture should load"))
+            return false;
+
+        const decl_audio::assets::AssetBank &assets = rig.asset_bank;
+        const decl_audio::assets::DecodedBuffer &buffer = assets.GetBuffer(rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav"));
+
+        // Hard right at d = 3 over 1..5: the tapered inverse law gives
+        // (1/3 - 1/5) / (1 - 1/5) = 1/6, against the linear law's 1/2.
+        rig.SetListenerPosition(0.0f, 0.0f, 0.0f);
+        rig.SetPosition("player", 3.0f, 0.0f, 0.0f);
+        rig.SetTag("player", "spatial.inverse");
+        rig.Update();
+
+        std::vector<float> output(OutputChannelCount);
+        rig.Render(output.data(), 1);
+        if (!ExpectNear(output[0], 0.0f, 1e-6f, "a hard-right source should leave the left channel silent"))
+            return false;
+
+        return ExpectNear(output[1], buffer.samples[0] / 6.0f, 1e-6f, "an inverse curve should attenuate by its baked LUT value");
+    }
+
+    bool TestListenerOrientationTurnsThePanField()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig;
+        if (!rig.LoadFixture(fixture_path, "orientation fixture should compile", "orientation fixture should load"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav"));
+
+        // A quarter turn to the right about +y: the listener faces +x, so +z
+        // (straight ahead before the turn) is now hard left.
+        const float half_turn_component = std::sqrt(0.5f);
+        rig.SetListenerTransform(Vec3{0.0f, 0.0f, 0.0f}, Quat{half_turn_component, 0.0f, half_turn_component, 0.0f});
+        rig.SetPosition("player", 3.0f, 0.0f, 0.0f);
+        rig.SetTag("player", "spatial.mono");
+        rig.Update();
+
+        std::vector<float> ahead(OutputChannelCount);
+        rig.Render(ahead.data(), 1);
+        if (!Expect(rig.audio_runtime.GetListenerOrientationForTesting() != Quat{}, "listener orientation should forward through the control and audio chain"))
+            return false;
+
+        // Three units out: attenuation 0.5 with the fixture's 1..5 linear range.
+        const float centered = buffer.samples[0] * 0.5f * std::sqrt(0.5f);
+        if (!ExpectNear(ahead[0], centered, 1e-5f, "a source the listener turned to face should sit centered on the left channel"))
+            return false;
+        if (!ExpectNear(ahead[1], centered, 1e-5f, "a source the listener turned to face should sit centered on the right channel"))
+            return false;
+
+        rig.SetPosition("player", 0.0f, 0.0f, 3.0f);
+        rig.Update();
+
+        std::vector<float> beside(OutputChannelCount);
+        rig.Render(beside.data(), 1);
+        if (!ExpectNear(beside[0], buffer.samples[1] * 0.5f, 1e-5f, "a source off the listener's left shoulder should pan hard left"))
+            return false;
+
+        return ExpectNear(beside[1], 0.0f, 1e-5f, "a source off the listener's left shoulder should leave the right channel silent");
+    }
+
+    bool TestSurroundOutputPansBetweenNeighbouringSpeakers()
+    {
+        // 5.1: FL FR FC LFE SL SR, with the ring at -110/-30/0/30/110 degrees.
+        constexpr std::uint32_t kChannels = 6;
+        constexpr std::uint32_t kFrontLeft = 0, kFrontRight = 1, kCenter = 2, kLfe = 3, kSurroundLeft = 4, kSurroundRight = 5;
+        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
+        PlaybackTestRig rig(0, 0, 0, kChannels);
+        if (!rig.LoadFixture(fixture_path, "surround fixture should compile", "surround fixture should load"))
+            return false;
+
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav"));
+        auto render_frame = [&](const float x, const float z)
+        {
+            rig.SetPosition("player", x, 0.0f, z);
+            rig.Update();
+            std::vector<float> frame(kChannels);
+            rig.Render(frame.data(), 1);
+            return frame;
+        };
+
+        // Three units out: attenuation 0.5 with the fixture's 1..5 linear range.
+        rig.SetListenerPosition(0.0f, 0.0f, 0.0f);
+        rig.SetTag("player", "spatial.mono");
+        const std::vector<float> ahead = render_frame(0.0f, 3.0f);
+        const float ahead_sample = buffer.samples[0] * 0.5f;
+        if (!ExpectNear(ahead[kCenter], ahead_sample, 1e-6f, "a source straight ahead should play from the center speaker alone"))
+            return false;
+        if (!Expect(ahead[kFrontLeft] == 0.0f && ahead[kFrontRight] == 0.0f && ahead[kLfe] == 0.0f && ahead[kSurroundLeft] == 0.0f && ahead[kSurroundRight] == 0.0f,
+                    "a source on a speaker should leave every other channel silent"))
+            return false;
+
+        // Due right (90 degrees) sits between FR (30) and SR (110).
+        const std::vector<float> right = render_frame(3.0f, 0.0f);
+        const float right_sample = buffer.samples[1] * 0.5f;
+        const float degrees = 3.14159265f / 180.0f;
+        const float front_share = std::sin(20.0f * degrees);
+        const float surround_share = std::sin(60.0f * degrees);
+        const float norm = std::sqrt(front_share * front_share + surround_share * surround_share);
+        if (!ExpectNear(right[kFrontRight], right_sample * front_share / norm, 1e-5f, "a source to the right should feed the front right speaker by VBAP"))
+            return false;
+        if (!ExpectNear(right[kSurroundRight], right_sample * surround_share / norm, 1e-5f, "a source to the right should feed the surround right speaker by VBAP"))
+            return false;
+        if (!Expect(right[kFrontLeft] == 0.0f && right[kCenter] == 0.0f && right[kLfe] == 0.0f && right[kSurroundLeft] == 0.0f,
+                    "only the enclosing speaker pair should carry a panned source"))
+            return false;
+
+        // Behind and to the left pans across the rear pair, which wraps the ring.
+        const std::vector<float> behind_left = render_frame(-3.0f, -3.0f);
+        if (!Expect(std::fabs(behind_left[kSurroundLeft]) > std::fabs(behind_left[kSurroundRight]) && behind_left[kSurroundRight] != 0.0f,
+                    "a source behind-left should favour the surround left speaker of the rear pair"))
+            return false;
+
+        return Expect(behind_left[kFrontLeft] == 0.0f && behind_left[kFrontRight] == 0.0f && behind_left[kCenter] == 0.0f && behind_left[kLfe] == 0.0f,
+                      "the LFE and front speakers should stay silent for a rear source");
+    }
+
+    bool TestOutOfRangeInstanceVirtualizesAndResumesInPlace()
+    {
+        // Block sizes chosen so the virtual stretch wraps the loop several times
+        // and ends mid-buffer.
+        const std::vector<std::uint32_t> block_frames = {16, 4000, 3, 4000, 1500, 16};
+        const Vec3 near_listener{0.0f, 0.0f, 0.0f};
+        const Vec3 far_listener{100.0f, 0.0f, 0.0f};
+
+        VirtualVoiceRun virtualized;
+        if (!RunVirtualVoiceScene({near_listener, far_listener, far_listener, far_listener, far_listener, near_listener}, block_frames, virtualized))
+            return false;
+
+        VirtualVoiceRun audible;
+        if (!RunVirtualVoiceScene(std::vector<Vec3>(block_frames.size(), near_listener), block_frames, audible))
+            return false;
+
+        if (!Expect(virtualized.metrics[0].virtual_instance_count == 0, "an in-range instance should mix normally"))
+            return false;
+        const std::size_t last_block = block_frames.size() - 1;
+        for (std::size_t block = 1; block < last_block; ++block)
+        {
+            if (!Expect(virtualized.metrics[block].active_instance_count == 1 && virtualized.metrics[block].virtual_instance_count == 1,
+                        "an out-of-range instance should stay alive but be reported virtual"))
+                return false;
+        }
+        if (!Expect(virtualized.metrics[last_block].virtual_instance_count == 0, "the instance should leave virtual mode when back in range"))
+            return false;
+        if (!Expect(audible.metrics[2].virtual_instance_count == 0, "an instance in range should never be virtual"))
+            return false;
+
+        if (!Expect(virtualized.final_sample_position == audible.final_sample_position, "a virtual voice should advance its timeline exactly like a mixed one"))
+            return false;
+
+        return Expect(std::memcmp(virtualized.last_block.data(), audible.last_block.data(), virtualized.last_block.size() * sizeof(float)) == 0,
+                      "mixing should resume at the same sample position a never-virtual instance plays");
+    }
+
+    // Renders `scene` (a bool(render_worker_count, rendered) callable that
+    // appends its output to `rendered`) serially and with one and three render
+    // workers, and expects every run to match the serial one bit for bit.
+    template <typename Scene>
+    bool ExpectBitIdenticalAcrossRenderWorkers(const Scene &scene, const char *message)
+    {
+        std::vector<float> serial;
+        if (!scene(0u, serial))
+            return false;
+
+        for (const std::uint32_t worker_count : {1u, 3u})
+        {
+            std::vector<float> threaded;
+            if (!scene(worker_count, threaded))
+                return false;
+
+            if (!Expect(threaded.size() == serial.size() &&
+                            std::memcmp(threaded.data(), serial.data(), serial.size() * sizeof(float)) == 0,
+                        message))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Renders a scene spanning several instance chunks, with staggered stops so
+    // instances retire mid-run, and returns the concatenated output.
+    bool RenderMultiChunkScene(const std::uint32_t render_worker_count, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig rig(render_worker_count);
+        if (!rig.LoadFixture(fixture_path, "worker determinism fixture should compile", "worker determinism fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId programs[] = {
+            rig.compiled_bank.GetProgramId("playback.loop"),
+            rig.compiled_bank.GetProgramId("playback.oneshot"),
+            rig.compiled_bank.GetProgramId("playback.random")};
+
+        constexpr decl_audio::playback::InstanceId kInstanceCount = 70;
+        for (decl_audio::playback::InstanceId id = 1; id <= kInstanceCount; ++id)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+                id,
+                programs[id % 3],
+                Vec3{static_cast<float>(id % 7) - 3.0f, 0.0f, 1.0f},
+                0.05f + 0.01f * static_cast<float>(id % 11)});
+        }
+
+        constexpr std::uint32_t kBlockFrames = 256;
+        std::vector<float> block(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+        for (std::uint32_t block_index = 0; block_index < 24; ++block_index)
+        {
+            if (block_index % 4 == 1)
+            {
+                for (decl_audio::playback::InstanceId id = block_index; id <= kInstanceCount; id += 9)
+                {
+                    rig.SubmitAudioCommand(decl_audio::playback::RequestStopCommand{id});
+                }
+            }
+
+            rig.Render(block.data(), kBlockFrames);
+            rendered.insert(rendered.end(), block.begin(), block.end());
+        }
+
+        return Expect(rig.audio_runtime.ActiveInstanceCount() < kInstanceCount, "worker determinism scene should retire instances mid-run");
+    }
+
+    bool TestRenderWorkersProduceBitIdenticalOutput()
+    {
+        return ExpectBitIdenticalAcrossRenderWorkers(RenderMultiChunkScene, "render output should be bit-identical for every render worker count");
+    }
+
+    bool TestBusGainsScaleTheProgramsRoutedThroughThem()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("BusBehaviorBank.json");
+        PlaybackTestRig rig(BusConfig{8});
+        if (!rig.LoadFixture(fixture_path, "bus fixture should compile", "bus fixture should load"))
+            return false;
+
+        if (!Expect(rig.bus_registry.BusCount() == 3, "the bus fixture should declare three buses"))
+            return false;
+
+        decl_audio::compiler::BusId sfx = 0;
+        if (!Expect(rig.bus_registry.SetHostVolume("sfx", 0.0f, sfx), "sfx should be a declared bus"))
+            return false;
+        if (!Expect(rig.bus_registry.Parent(rig.compiled_bank.GetBusId("sfx.weapons")) == sfx, "sfx.weapons should hang off sfx"))
+            return false;
+
+        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
+        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
+        constexpr std::uint32_t kFrames = 16;
+        std::vector<float> output(static_cast<std::size_t>(kFrames) * OutputChannelCount);
+
+        // sfx.weapons (0.5) under sfx (0.8) plays at 0.4 of the program's own
+        // gain; each bus applies its volume once, on the way to its parent.
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, rig.compiled_bank.GetProgramId("bus.weapons"), Vec3{}, 1.0f});
+        rig.Render(output.data(), kFrames);
+        for (std::uint32_t frame = 0; frame < kFrames; ++frame)
+        {
+            if (!ExpectNear(output[static_cast<std::size_t>(frame) * OutputChannelCount], buffer.samples[frame] * 0.5f * 0.4f, 1e-6f,
+                            "a nested bus should scale by its own and its parent's volume"))
+                return false;
+        }
+
+        // Silencing the parent silences everything under it; music is a
+        // sibling tree and is unaffected.
+        rig.SubmitAudioCommand(decl_audio::playback::SetBusGainCommand{sfx, rig.bus_registry.Gain(sfx)});
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{2, rig.compiled_bank.GetProgramId("bus.music"), Vec3{}, 1.0f});
+        rig.Render(output.data(), kFrames);
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 2, "a silenced bus should keep its instances playing"))
             return false;
-        if (!ExpectNear(startup_output[1], buffer.samples[0], 1e-6f, "resolver-seeded blend parameter should affect both channels"))
+
+        for (std::uint32_t frame = 0; frame < kFrames; ++frame)
+        {
+            if (!ExpectNear(output[static_cast<std::size_t>(frame) * OutputChannelCount], buffer.samples[frame] * 0.5f * 0.5f, 1e-6f,
+                            "only the music bus should be heard once sfx is silenced"))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Like RenderMultiChunkScene, but over three buses (one nested) whose
+    // gains ramp mid-run, so chunks are grouped per bus and the bus fold runs.
+    bool RenderMultiChunkBusScene(const std::uint32_t render_worker_count, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("BusBehaviorBank.json");
+        PlaybackTestRig rig(BusConfig{8, render_worker_count, 96});
+        if (!rig.LoadFixture(fixture_path, "bus determinism fixture should compile", "bus determinism fixture should load"))
             return false;
 
-        decl_audio::playback::DebugSnapshot snapshot = rig.audio_runtime.GetDebugSnapshot();
-        if (!Expect(snapshot.instances[0].active_voice_count == 2, "resolver-driven blend should keep both loops active"))
+        const decl_audio::compiler::ProgramId programs[] = {
+            rig.compiled_bank.GetProgramId("bus.master"),
+            rig.compiled_bank.GetProgramId("bus.music"),
+            rig.compiled_bank.GetProgramId("bus.weapons")};
+
+        constexpr decl_audio::playback::InstanceId kInstanceCount = 70;
+        for (decl_audio::playback::InstanceId id = 1; id <= kInstanceCount; ++id)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
+                id,
+                programs[id % 3],
+                Vec3{},
+                0.05f + 0.01f * static_cast<float>(id % 11)});
+        }
+
+        constexpr std::uint32_t kBlockFrames = 256;
+        std::vector<float> block(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+        for (std::uint32_t block_index = 0; block_index < 24; ++block_index)
+        {
+            if (block_index % 4 == 1)
+            {
+                for (decl_audio::playback::InstanceId id = block_index; id <= kInstanceCount; id += 9)
+                {
+                    rig.SubmitAudioCommand(decl_audio::playback::RequestStopCommand{id});
+                }
+            }
+            if (block_index % 6 == 2)
+            {
+                rig.SubmitAudioCommand(decl_audio::playback::SetBusGainCommand{
+                    static_cast<decl_audio::compiler::BusId>(block_index % 3),
+                    0.2f + 0.1f * static_cast<float>(block_index % 5)});
+            }
+
+            rig.Render(block.data(), kBlockFrames);
+            rendered.insert(rendered.end(), block.begin(), block.end());
+        }
+
+        return Expect(rig.audio_runtime.ActiveInstanceCount() < kInstanceCount, "bus determinism scene should retire instances mid-run");
+    }
+
+    bool TestBusRoutingIsBitIdenticalAcrossRenderWorkers()
+    {
+        return ExpectBitIdenticalAcrossRenderWorkers(RenderMultiChunkBusScene, "bus-routed output should be bit-identical for every render worker count");
+    }
+
+    // Energy of the left channel over the back half of 4096 frames of
+    // `program_name` playing alone from FilterBehaviorBank, with its occlusion
+    // parameter set first when `occlusion` is not negative.
+    bool RenderFilteredEnergy(const char *program_name, const float occlusion, double &energy)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("FilterBehaviorBank.json");
+        PlaybackTestRig rig(BusConfig{8});
+        if (!rig.LoadFixture(fixture_path, "filter fixture should compile", "filter fixture should load"))
             return false;
 
-        rig.SetValue("player", "mix", 1.0f);
-        rig.Update();
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, rig.compiled_bank.GetProgramId(program_name), Vec3{}, 1.0f});
+        if (occlusion >= 0.0f)
+            rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{1, rig.compiled_bank.GetParameterId("occlusion"), occlusion});
 
-        std::vector<float> updated_output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(updated_output.data(), 1);
+        constexpr std::uint32_t kFrames = 4096;
+        std::vector<float> output(static_cast<std::size_t>(kFrames) * OutputChannelCount);
+        rig.Render(output.data(), kFrames);
+        energy = 0.0;
+        for (std::uint32_t frame = kFrames / 2; frame < kFrames; ++frame)
+        {
+            const double sample = output[static_cast<std::size_t>(frame) * OutputChannelCount];
+            energy += sample * sample;
+        }
 
-        const float expected_updated = buffer.samples[1] * 0.25f;
-        if (!ExpectNear(updated_output[0], expected_updated, 1e-6f, "resolver should forward declared parameters through SetParameter on the next block"))
+        return true;
+    }
+
+    bool TestFiltersFollowTheirCutoff()
+    {
+        // The fixture's asset is a 523 Hz tone. Unoccluded, the program's
+        // low-pass sits at 20 kHz and passes it; fully occluded it sweeps down
+        // to 100 Hz, as the muffled bus's fixed filter does.
+        double dry = 0.0;
+        double open = 0.0;
+        double occluded = 0.0;
+        double muffled = 0.0;
+        if (!RenderFilteredEnergy("filter.dry", -1.0f, dry) || !RenderFilteredEnergy("filter.occluded", -1.0f, open) ||
+            !RenderFilteredEnergy("filter.occluded", 1.0f, occluded) || !RenderFilteredEnergy("filter.bus", -1.0f, muffled))
             return false;
-        if (!ExpectNear(updated_output[1], expected_updated, 1e-6f, "resolver-forwarded blend updates should affect both channels"))
+
+        if (!Expect(dry > 0.0 && std::abs(open / dry - 1.0) < 0.02, "an open low-pass should pass the tone"))
+            return false;
+        if (!Expect(occluded < dry * 0.01, "raising the cutoff parameter should sweep the low-pass down over the tone"))
+            return false;
+        return Expect(muffled < dry * 0.01, "a bus filter should low-pass everything routed through the bus");
+    }
+
+    // Filtered programs and a filtered bus across render chunks, with the
+    // cutoff parameter moving mid-run.
+    bool RenderMultiChunkFilterScene(const std::uint32_t render_worker_count, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("FilterBehaviorBank.json");
+        PlaybackTestRig rig(BusConfig{8, render_worker_count, 96});
+        if (!rig.LoadFixture(fixture_path, "filter determinism fixture should compile", "filter determinism fixture should load"))
             return false;
 
+        const decl_audio::compiler::ProgramId programs[] = {
+            rig.compiled_bank.GetProgramId("filter.dry"),
+            rig.compiled_bank.GetProgramId("filter.occluded"),
+            rig.compiled_bank.GetProgramId("filter.bus")};
+        const decl_audio::compiler::ParameterId occlusion = rig.compiled_bank.GetParameterId("occlusion");
+
+        constexpr decl_audio::playback::InstanceId kInstanceCount = 60;
+        for (decl_audio::playback::InstanceId id = 1; id <= kInstanceCount; ++id)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{id, programs[id % 3], Vec3{}, 0.05f + 0.01f * static_cast<float>(id % 11)});
+        }
+
+        constexpr std::uint32_t kBlockFrames = 250;
+        std::vector<float> block(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+        for (std::uint32_t block_index = 0; block_index < 16; ++block_index)
+        {
+            for (decl_audio::playback::InstanceId id = 1 + block_index % 3; id <= kInstanceCount; id += 3)
+            {
+                if (id % 3 == 1)
+                    rig.SubmitAudioCommand(decl_audio::playback::SetParameterCommand{id, occlusion, static_cast<float>(block_index % 5) * 0.25f});
+            }
+
+            rig.Render(block.data(), kBlockFrames);
+            rendered.insert(rendered.end(), block.begin(), block.end());
+        }
+
         return true;
     }
 
-    bool TestSpatializedMonoRespondsToEntityAndListenerMovement()
+    bool TestFilteringIsBitIdenticalAcrossRenderWorkers()
     {
-        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
-        PlaybackTestRig rig;
-        if (!rig.LoadFixture(fixture_path, "phase 7.5 mono spatialization fixture should compile", "phase 7.5 mono spatialization fixture should load"))
-            return false;
+        return ExpectBitIdenticalAcrossRenderWorkers(RenderMultiChunkFilterScene, "filtered output should be bit-identical for every render worker count");
+    }
 
-        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_1ch.wav");
-        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
-        if (!Expect(buffer.frame_count > 2, "phase 7.5 mono fixture should contain enough frames"))
+    // One reverb bus with 64-frame partitions, room for the fixture's
+    // impulse response, and a head of `head_partitions`.
+    BusConfig MakeReverbBusConfig(const std::uint32_t render_worker_count, const std::uint32_t head_partitions)
+    {
+        return BusConfig{8, render_worker_count, 96, 1, 64, 8192, head_partitions};
+    }
+
+    // `frames` frames of `program_name` playing alone from ReverbBehaviorBank,
+    // in 256-frame blocks, stopped after `stop_after` frames. The stop is
+    // immediate, so the block it lands in is the program's last.
+    bool RenderReverbProgram(const char *program_name, const std::uint32_t stop_after, const std::uint32_t frames, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("ReverbBehaviorBank.json");
+        PlaybackTestRig rig(MakeReverbBusConfig(0, 2));
+        if (!rig.LoadFixture(fixture_path, "reverb fixture should compile", "reverb fixture should load"))
             return false;
 
-        rig.SetListenerPosition(0.0f, 0.0f, 0.0f);
-        rig.SetPosition("player", 3.0f, 0.0f, 0.0f);
-        rig.SetTag("player", "spatial.mono");
-        rig.Update();
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, rig.compiled_bank.GetProgramId(program_name), Vec3{}, 1.0f});
+        rendered.assign(static_cast<std::size_t>(frames) * OutputChannelCount, 0.0f);
+        for (std::uint32_t frame = 0; frame < frames; frame += 256)
+        {
+            if (frame == stop_after)
+                rig.SubmitAudioCommand(decl_audio::playback::RequestStopCommand{1});
+            rig.Render(rendered.data() + static_cast<std::size_t>(frame) * OutputChannelCount, 256);
+        }
+        return Expect(rig.audio_runtime.ActiveInstanceCount() == 0, "the stopped reverb program should retire");
+    }
 
-        std::vector<float> startup_output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(startup_output.data(), 1);
+    bool TestReverbSendAddsALatePersistentWetSignal()
+    {
+        // The wet signal lags a partition, so until then a sending program
+        // sounds exactly like a dry one. Past it the reverb adds its tail,
+        // which rings on after the program has gone and then falls silent.
+        constexpr std::uint32_t kPartition = 64;
+        constexpr std::uint32_t kStopAfter = 2048;
+        constexpr std::uint32_t kFrames = 16384;
+        std::vector<float> dry;
+        std::vector<float> wet;
+        if (!RenderReverbProgram("reverb.dry", kStopAfter, kFrames, dry) || !RenderReverbProgram("reverb.wet", kStopAfter, kFrames, wet))
+            return false;
 
-        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 1, "phase 7.5 mono match should create one bound instance"))
+        const std::size_t latency_samples = static_cast<std::size_t>(kPartition) * OutputChannelCount;
+        if (!Expect(std::memcmp(dry.data(), wet.data(), latency_samples * sizeof(float)) == 0, "a send should add nothing for the first partition"))
             return false;
-        if (!Expect(rig.audio_runtime.GetListenerPositionForTesting() == Vec3{0.0f, 0.0f, 0.0f}, "listener position should forward through the control and audio chain"))
+        if (!Expect(std::memcmp(dry.data() + latency_samples, wet.data() + latency_samples, latency_samples * sizeof(float)) != 0,
+                    "a send should add the wet signal once a partition has passed"))
             return false;
 
-        const StereoMixGains startup_gains = ComputeExpectedSpatialMix(Vec3{3.0f, 0.0f, 0.0f}, Vec3{0.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
-        const float startup_sample = buffer.samples[0];
-        if (!ExpectNear(startup_output[0], startup_sample * startup_gains.left, 1e-6f, "spatialized mono should pan and attenuate on the left channel"))
+        // The fixture's 4036-frame impulse response spans 64 partitions.
+        const auto silent = [](const float sample) { return sample == 0.0f; };
+        const std::size_t stop_sample = (static_cast<std::size_t>(kStopAfter) + 256) * OutputChannelCount;
+        const std::size_t tail_end = stop_sample + static_cast<std::size_t>(kPartition) * 66 * OutputChannelCount;
+        if (!Expect(std::all_of(dry.begin() + stop_sample, dry.end(), silent), "a dry program should stop dead"))
             return false;
-        if (!ExpectNear(startup_output[1], startup_sample * startup_gains.right, 1e-6f, "spatialized mono should pan and attenuate on the right channel"))
+        if (!Expect(!std::all_of(wet.begin() + stop_sample, wet.begin() + stop_sample + 1024, silent), "the reverb should ring on after its source stops"))
             return false;
+        return Expect(std::all_of(wet.begin() + tail_end, wet.end(), silent), "the reverb should fall silent once its tail has played out");
+    }
 
-        rig.SetListenerPosition(4.0f, 0.0f, 0.0f);
-        rig.Update();
+    // Sending, dry and stopping programs across render chunks, with a
+    // render quantum that spans several partitions.
+    bool RenderMultiChunkReverbScene(const std::uint32_t render_worker_count, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("ReverbBehaviorBank.json");
+        PlaybackTestRig rig(MakeReverbBusConfig(render_worker_count, 5));
+        if (!rig.LoadFixture(fixture_path, "reverb determinism fixture should compile", "reverb determinism fixture should load"))
+            return false;
+        rig.audio_runtime.SetReverbWaitForTailsForTesting(true);
 
-        std::vector<float> updated_output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(updated_output.data(), 1);
+        const decl_audio::compiler::ProgramId programs[] = {
+            rig.compiled_bank.GetProgramId("reverb.dry"),
+            rig.compiled_bank.GetProgramId("reverb.wet")};
 
-        if (!Expect(rig.audio_runtime.GetListenerPositionForTesting() == Vec3{4.0f, 0.0f, 0.0f}, "listener movement should stick on the audio thread"))
+        constexpr decl_audio::playback::InstanceId kInstanceCount = 60;
+        for (decl_audio::playback::InstanceId id = 1; id <= kInstanceCount; ++id)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{id, programs[id % 3 == 0 ? 0 : 1], Vec3{}, 0.05f + 0.01f * static_cast<float>(id % 11)});
+        }
+
+        constexpr std::uint32_t kBlockFrames = 250;
+        std::vector<float> block(static_cast<std::size_t>(kBlockFrames) * OutputChannelCount);
+        for (std::uint32_t block_index = 0; block_index < 40; ++block_index)
+        {
+            if (block_index == 12)
+            {
+                for (decl_audio::playback::InstanceId id = 1; id <= kInstanceCount; ++id)
+                    rig.SubmitAudioCommand(decl_audio::playback::RequestStopCommand{id});
+            }
+
+            rig.Render(block.data(), kBlockFrames);
+            rendered.insert(rendered.end(), block.begin(), block.end());
+        }
+
+        return true;
+    }
+
+    bool TestReverbIsBitIdenticalAcrossRenderWorkers()
+    {
+        return ExpectBitIdenticalAcrossRenderWorkers(RenderMultiChunkReverbScene, "reverb output should be bit-identical for every render worker count");
+    }
+
+    // `frames` frames of DuckBehaviorBank in 256-frame blocks: music from the
+    // start when `music`, and dialogue over [dialogue_from, dialogue_to) when
+    // `dialogue`, both on timed commands.
+    bool RenderDuckScene(const bool music, const bool dialogue, const std::uint32_t dialogue_from, const std::uint32_t dialogue_to,
+                         const std::uint32_t frames, std::vector<float> &rendered)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("DuckBehaviorBank.json");
+        PlaybackTestRig rig(BusConfig{8});
+        if (!rig.LoadFixture(fixture_path, "duck fixture should compile", "duck fixture should load"))
             return false;
 
-        const StereoMixGains updated_gains = ComputeExpectedSpatialMix(Vec3{3.0f, 0.0f, 0.0f}, Vec3{4.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
-        const float updated_sample = buffer.samples[1];
-        if (!ExpectNear(updated_output[0], updated_sample * updated_gains.left, 1e-6f, "listener movement should update mono spatialization on the left channel"))
+        if (music)
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, rig.compiled_bank.GetProgramId("duck.music"), Vec3{}, 1.0f});
+        if (dialogue)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{2, rig.compiled_bank.GetProgramId("duck.dialogue"), Vec3{}, 1.0f}, dialogue_from);
+            rig.SubmitAudioCommand(decl_audio::playback::RequestStopCommand{2}, dialogue_to);
+        }
+
+        rendered.assign(static_cast<std::size_t>(frames) * OutputChannelCount, 0.0f);
+        for (std::uint32_t frame = 0; frame < frames; frame += 256)
+        {
+            rig.Render(rendered.data() + static_cast<std::size_t>(frame) * OutputChannelCount, 256);
+        }
+        return true;
+    }
+
+    bool TestDuckingFollowsTheTriggerSampleAccurately()
+    {
+        // Music is ducked by dialogue at -12 dB from a -40 dB threshold, with
+        // an instant attack and a 50 ms release. The dialogue bus folds before
+        // the music bus, so the mix minus the dialogue alone is the ducked
+        // music.
+        constexpr std::uint32_t kDialogueFrom = 1000;
+        constexpr std::uint32_t kDialogueTo = 3000;
+        constexpr std::uint32_t kFrames = 24576;
+        std::vector<float> music;
+        std::vector<float> dialogue;
+        std::vector<float> mix;
+        if (!RenderDuckScene(true, false, kDialogueFrom, kDialogueTo, kFrames, music) ||
+            !RenderDuckScene(false, true, kDialogueFrom, kDialogueTo, kFrames, dialogue) ||
+            !RenderDuckScene(true, true, kDialogueFrom, kDialogueTo, kFrames, mix))
+            return false;
+
+        const auto sample = [](const std::vector<float> &samples, const std::uint32_t frame)
+        {
+            return samples[static_cast<std::size_t>(frame) * OutputChannelCount];
+        };
+        const std::size_t lead_samples = static_cast<std::size_t>(kDialogueFrom) * OutputChannelCount;
+        if (!Expect(std::memcmp(music.data(), mix.data(), lead_samples * sizeof(float)) == 0, "music should play untouched until the dialogue starts"))
             return false;
-        if (!ExpectNear(updated_output[1], updated_sample * updated_gains.right, 1e-6f, "listener movement should update mono spatialization on the right channel"))
+        if (!Expect(std::fabs(sample(mix, kDialogueFrom) - sample(dialogue, kDialogueFrom)) < 0.9f * std::fabs(sample(music, kDialogueFrom)),
+                    "the duck should start on the dialogue's first frame"))
             return false;
 
+        // A few frames in the dialogue is over the threshold and holds it.
+        std::uint32_t dialogue_end = kFrames;
+        while (dialogue_end > 0 && sample(dialogue, dialogue_end - 1) == 0.0f)
+            --dialogue_end;
+        const float depth = std::pow(10.0f, -12.0f / 20.0f);
+        for (std::uint32_t frame = kDialogueFrom + 4; frame < dialogue_end + 1000; ++frame)
+        {
+            if (!ExpectNear(sample(mix, frame) - sample(dialogue, frame), sample(music, frame) * depth, 1e-5f,
+                            "music should sit at the duck depth while the dialogue is over the threshold"))
+                return false;
+        }
+
+        // Released: 400 ms on, at a 50 ms time constant, the envelope is far
+        // under the threshold and the music back to within 0.2% of its level.
+        for (std::uint32_t frame = kFrames - 256; frame < kFrames; ++frame)
+        {
+            if (!ExpectNear(sample(mix, frame), sample(music, frame), 2e-4f, "music should recover once the dialogue has released"))
+                return false;
+        }
+
         return true;
     }
 
-    bool TestSpatializedStereoAppliesBalanceAndAttenuation()
+    // Runs `input` (planar stereo, `frames` long) through a limiter in calls
+    // cycling through `call_frames`, returning the lowest gain any call
+    // reported.
+    float RunMasterLimiter(const std::vector<float> &input, const std::uint32_t frames, const std::span<const std::uint32_t> call_frames,
+                           std::vector<float> &output)
     {
-        const std::filesystem::path fixture_path = GetFixturePath("SpatializationBehaviorBank.json");
-        PlaybackTestRig rig;
-        if (!rig.LoadFixture(fixture_path, "phase 7.5 stereo spatialization fixture should compile", "phase 7.5 stereo spatialization fixture should load"))
+        decl_audio::playback::MasterLimiter limiter(decl_audio::playback::GetMixKernels(), 2, 4096, 240, 2400, 0.9f);
+        output = input;
+        float lowest_gain = 1.0f;
+        std::size_t call = 0;
+        for (std::uint32_t frame = 0; frame < frames;)
+        {
+            const std::uint32_t run = std::min(call_frames[call++ % call_frames.size()], frames - frame);
+            float *const channels[2] = {output.data() + frame, output.data() + frames + frame};
+            lowest_gain = std::min(lowest_gain, limiter.Process(channels, run));
+            frame += run;
+        }
+        return lowest_gain;
+    }
+
+    bool TestMasterLimiterHoldsTheCeilingAhead()
+    {
+        // A quiet sine, then a burst six times as loud on the left and a lone
+        // spike on the right, against a 0.9 ceiling with 240 frames of
+        // lookahead and a 50 ms release.
+        constexpr std::uint32_t kFrames = 48000;
+        constexpr std::uint32_t kLookahead = 240;
+        constexpr std::uint32_t kBurstFrom = 20000;
+        constexpr std::uint32_t kBurstTo = 24000;
+        constexpr std::uint32_t kSpike = 26000;
+        std::vector<float> input(static_cast<std::size_t>(kFrames) * 2);
+        for (std::uint32_t frame = 0; frame < kFrames; ++frame)
+        {
+            const float level = frame >= kBurstFrom && frame < kBurstTo ? 3.0f : 0.5f;
+            input[frame] = level * std::sin(static_cast<float>(frame) * 0.0575f);
+            input[kFrames + frame] = 0.5f * std::cos(static_cast<float>(frame) * 0.0575f);
+        }
+        input[kFrames + kSpike] = -8.0f;
+
+        constexpr std::uint32_t kWholeBlocks[] = {4096};
+        constexpr std::uint32_t kRaggedCalls[] = {1, 7, 256, 1000, 4096, 33};
+        std::vector<float> whole;
+        std::vector<float> ragged;
+        const float lowest_gain = RunMasterLimiter(input, kFrames, kWholeBlocks, whole);
+        (void)RunMasterLimiter(input, kFrames, kRaggedCalls, ragged);
+        if (!Expect(whole == ragged, "the limiter's output should not depend on how the signal is cut into calls"))
+            return false;
+        if (!ExpectNear(lowest_gain, 0.9f / 8.0f, 1e-6f, "the limiter should report the gain that brought the spike down to the ceiling"))
             return false;
 
-        const decl_audio::compiler::ProgramId program_id = rig.compiled_bank.GetProgramId("spatial.stereo");
-        const decl_audio::compiler::AssetId asset_id = rig.compiled_bank.GetAssetId("audio/test_48_24_2ch.wav");
-        const decl_audio::assets::DecodedBuffer &buffer = rig.asset_bank.GetBuffer(asset_id);
-        if (!Expect(buffer.frame_count > 1, "phase 7.5 stereo fixture should contain enough frames"))
+        for (const float sample : whole)
+        {
+            if (!Expect(std::fabs(sample) <= 0.9f * (1.0f + 1e-6f), "no limited sample should exceed the ceiling"))
+                return false;
+        }
+
+        const auto delayed = [&](const std::uint32_t channel, const std::uint32_t frame)
+        {
+            return frame >= kLookahead ? input[static_cast<std::size_t>(channel) * kFrames + frame - kLookahead] : 0.0f;
+        };
+        // Until the burst enters the lookahead window the signal is only
+        // delayed; once it passes, the gain recovers.
+        for (std::uint32_t frame = 0; frame < kBurstFrom; ++frame)
+        {
+            if (!Expect(whole[frame] == delayed(0, frame) && whole[kFrames + frame] == delayed(1, frame), "below the ceiling the limiter should only delay"))
+                return false;
+        }
+        if (!ExpectNear(whole[kFrames + kSpike + kLookahead], -0.9f, 1e-5f, "the spike should come out of the lookahead exactly at the ceiling"))
             return false;
+        for (std::uint32_t frame = kFrames - 1000; frame < kFrames; ++frame)
+        {
+            if (!ExpectNear(whole[frame], delayed(0, frame), 1e-4f, "the limiter should release once the peaks have passed"))
+                return false;
+        }
 
-        constexpr decl_audio::playback::InstanceId kInstanceId = 7007;
-        const Vec3 source_position{1.0f, 0.0f, 1.7320508f};
-        rig.SubmitAudioCommand(decl_audio::playback::SetListenerPositionCommand{Vec3{0.0f, 0.0f, 0.0f}});
-        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{
-            kInstanceId,
-            program_id,
-            source_position,
-            1.0f});
+        return true;
+    }
 
-        std::vector<float> output(static_cast<std::size_t>(1) * OutputChannelCount);
-        rig.Render(output.data(), 1);
+    bool TestMasterLimiterKeepsAHotMixUnderTheCeiling()
+    {
+        // The loop at 8x master gain clips well past 0.5 on its own.
+        constexpr std::uint32_t kFrames = 8192;
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig plain_rig(LimiterConfig{});
+        PlaybackTestRig limited_rig(LimiterConfig{240, 2400, 0.5f});
+        std::vector<float> plain(static_cast<std::size_t>(kFrames) * OutputChannelCount);
+        std::vector<float> limited(plain.size());
+        for (auto [rig, output] : {std::pair{&plain_rig, &plain}, std::pair{&limited_rig, &limited}})
+        {
+            if (!rig->LoadFixture(fixture_path, "limiter fixture should compile", "limiter fixture should load"))
+                return false;
+            rig->SubmitAudioCommand(decl_audio::playback::SetMasterGainCommand{8.0f});
+            rig->SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, rig->compiled_bank.GetProgramId("playback.loop"), Vec3{}, 1.0f});
+            for (std::uint32_t frame = 0; frame < kFrames; frame += 512)
+            {
+                rig->Render(output->data() + static_cast<std::size_t>(frame) * OutputChannelCount, 512);
+            }
+        }
 
-        const StereoMixGains gains = ComputeExpectedSpatialMix(source_position, Vec3{0.0f, 0.0f, 0.0f}, 1.0f, 5.0f);
-        if (!ExpectNear(output[0], buffer.samples[0] * gains.left, 1e-6f, "spatialized stereo should apply balance and attenuation to the left channel"))
+        const auto peak = [](const std::vector<float> &samples)
+        {
+            float level = 0.0f;
+            for (const float sample : samples)
+                level = std::max(level, std::fabs(sample));
+            return level;
+        };
+        if (!Expect(peak(plain) > 1.0f, "the unlimited mix should run over full scale"))
             return false;
-        if (!ExpectNear(output[1], buffer.samples[1] * gains.right, 1e-6f, "spatialized stereo should apply balance and attenuation to the right channel"))
+        if (!Expect(peak(limited) <= 0.5f * (1.0f + 1e-6f) && peak(limited) > 0.45f, "the limited mix should sit just under the ceiling"))
             return false;
+        if (!Expect(plain_rig.audio_runtime.GetMetrics().limiter_gain_reduction_db == 0.0f, "without a limiter no gain reduction should be reported"))
+            return false;
+        return Expect(limited_rig.audio_runtime.GetMetrics().limiter_gain_reduction_db > 6.0f, "the limiter should report its gain reduction");
+    }
 
-        return true;
+    // Fills a 3-instance runtime with an old high-priority oneshot (1), a loud
+    // loop (2) and a quiet loop (3), then starts a fourth instance and checks
+    // that `expected_victim` alone fades out and retires.
+    bool ExpectStealVictim(const decl_audio::playback::StealPolicy policy, const decl_audio::playback::InstanceId expected_victim, const char *message)
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        PlaybackTestRig rig(3, policy);
+        if (!rig.LoadFixture(fixture_path, "steal fixture should compile", "steal fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId oneshot = rig.compiled_bank.GetProgramId("playback.oneshot");
+        const decl_audio::compiler::ProgramId loop = rig.compiled_bank.GetProgramId("playback.loop");
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{1, oneshot, Vec3{}, 1.0f});
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{2, loop, Vec3{}, 1.0f});
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{3, loop, Vec3{}, 0.25f});
+
+        std::vector<float> output(static_cast<std::size_t>(256) * OutputChannelCount);
+        rig.Render(output.data(), 16);
+        rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{4, loop, Vec3{}, 1.0f});
+        rig.Render(output.data(), 16);
+
+        if (!Expect(rig.audio_runtime.GetMetrics().instance_steal_count == 1, "a create at capacity should count one steal"))
+            return false;
+        if (!Expect(rig.audio_runtime.ActiveInstanceCount() == 4, "a stolen instance should keep playing while it fades out"))
+            return false;
+
+        for (decl_audio::playback::InstanceId id = 1; id <= 4; ++id)
+        {
+            decl_audio::playback::InstanceSnapshot snapshot;
+            if (!Expect(rig.audio_runtime.TryGetInstanceSnapshot(id, snapshot), "every instance should be alive during the steal fade"))
+                return false;
+            if (!Expect(snapshot.stop_requested == (id == expected_victim), message))
+                return false;
+        }
+
+        // The steal fade is 240 frames; 16 have been rendered.
+        rig.Render(output.data(), 224);
+        decl_audio::playback::InstanceSnapshot snapshot;
+        if (!Expect(!rig.audio_runtime.TryGetInstanceSnapshot(expected_victim, snapshot), "the victim should retire once the steal fade completes"))
+            return false;
+
+        return Expect(rig.audio_runtime.ActiveInstanceCount() == 3, "only the victim should retire");
+    }
+
+    bool TestStealPoliciesPickTheirVictim()
+    {
+        return ExpectStealVictim(decl_audio::playback::StealPolicy::Oldest, 1, "Oldest should steal the first instance created") &&
+               ExpectStealVictim(decl_audio::playback::StealPolicy::Quietest, 3, "Quietest should steal the lowest-volume instance") &&
+               ExpectStealVictim(decl_audio::playback::StealPolicy::Priority, 2, "Priority should steal the oldest of the lowest-priority instances");
+    }
+
+    bool TestStealRetiresImmediatelyWhenFadeHeadroomIsFull()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("PlaybackBehaviorBank.json");
+        // Two instances leave room for one fading victim.
+        PlaybackTestRig rig(2, decl_audio::playback::StealPolicy::Oldest);
+        if (!rig.LoadFixture(fixture_path, "steal headroom fixture should compile", "steal headroom fixture should load"))
+            return false;
+
+        const decl_audio::compiler::ProgramId loop = rig.compiled_bank.GetProgramId("playback.loop");
+        for (decl_audio::playback::InstanceId id = 1; id <= 4; ++id)
+        {
+            rig.SubmitAudioCommand(decl_audio::playback::CreateInstanceCommand{id, loop, Vec3{}, 1.0f});
+        }
+
+        std::vector<float> output(static_cast<std::size_t>(16) * OutputChannelCount);
+        rig.Render(output.data(), 16);
+
+        decl_audio::playback::InstanceSnapshot snapshot;
+        if (!Expect(rig.audio_runtime.GetMetrics().instance_steal_count == 2, "both overflowing creates should steal"))
+            return false;
+        if (!Expect(rig.audio_runtime.TryGetInstanceSnapshot(1, snapshot) && snapshot.stop_requested, "the first victim should fade in the headroom slice"))
+            return false;
+        if (!Expect(!rig.audio_runtime.TryGetInstanceSnapshot(2, snapshot), "with the headroom full the second victim should retire at once"))
+            return false;
+
+        return Expect(rig.audio_runtime.ActiveInstanceCount() == 3, "the newest two instances plus one fading victim should remain");
     }
 
     bool TestCreateInstanceTerminatesOnCapacityExhaustion()
@@ -967,9 +2466,19 @@ bool RunPlaybackTests()
 
     if (!TestSetVolumeAndPositionCommandsApplyOnNextBlock())
         return false;
+    if (!TestGainRampInterpolatesVolumeChangeAcrossBlocks())
+        return false;
 
     if (!TestRequestStopRetiresLoopAfterCurrentPass())
         return false;
+    if (!TestSequenceStepsToNextChildOnTheFrameItsVoiceEnds())
+        return false;
+    if (!TestTimedCommandsLandOnTheirAudioClockFrame())
+        return false;
+    if (!TestRenderQuantumServesIrregularCallbacksSeamlessly())
+        return false;
+    if (!TestRenderAheadStreamReproducesTheMixAndCountsUnderruns())
+        return false;
 
     if (!TestStubBackendPumpsPlaybackWithoutOutputBuffer())
         return false;
@@ -986,6 +2495,18 @@ bool RunPlaybackTests()
     if (!TestBlendLoopsStayInSyncAndRespondToParameterUpdates())
         return false;
 
+    if (!TestPitchParameterResamplesLeafPlayback())
+        return false;
+
+    if (!TestCompactFormatsDecodeWhileMixing())
+        return false;
+
+    if (!TestStreamedVoicesMatchResidentPlayback())
+        return false;
+
+    if (!TestStreamUnderrunsPlaySilenceWithoutBlocking())
+        return false;
+
     if (!TestSelectChoiceIsDeterministicAndOnlyEntersChosenSubtree())
         return false;
 
@@ -997,6 +2518,39 @@ bool RunPlaybackTests()
 
     if (!TestSpatializedStereoAppliesBalanceAndAttenuation())
         return false;
+    if (!TestAttenuationCurveShapesSpatializedGain())
+        return false;
+    if (!TestListenerOrientationTurnsThePanField())
+        return false;
+    if (!TestSurroundOutputPansBetweenNeighbouringSpeakers())
+        return false;
+    if (!TestOutOfRangeInstanceVirtualizesAndResumesInPlace())
+        return false;
+    if (!TestBusGainsScaleTheProgramsRoutedThroughThem())
+        return false;
+    if (!TestBusRoutingIsBitIdenticalAcrossRenderWorkers())
+        return false;
+    if (!TestFiltersFollowTheirCutoff())
+        return false;
+    if (!TestFilteringIsBitIdenticalAcrossRenderWorkers())
+        return false;
+    if (!TestReverbSendAddsALatePersistentWetSignal())
+        return false;
+    if (!TestReverbIsBitIdenticalAcrossRenderWorkers())
+        return false;
+    if (!TestDuckingFollowsTheTriggerSampleAccurately())
+        return false;
+    if (!TestMasterLimiterHoldsTheCeilingAhead())
+        return false;
+    if (!TestMasterLimiterKeepsAHotMixUnderTheCeiling())
+        return false;
+    if (!TestStealPoliciesPickTheirVictim())
+        return false;
+    if (!TestStealRetiresImmediatelyWhenFadeHeadroomIsFull())
+        return false;
+
+    if (!TestRenderWorkersProduceBitIdenticalOutput())
+        return false;
 
     if (!TestCreateInstanceTerminatesOnCapacityExhaustion())
         return false;
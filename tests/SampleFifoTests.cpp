@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../src/playback/SampleFifo.hpp"
+
+namespace
+{
+    bool Expect(bool condition, const char *message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    bool TestPartialWritesAndReadsWrapAround()
+    {
+        constexpr std::uint32_t kChannels = 2;
+        decl_audio::playback::SampleFifo fifo(kChannels, 5);
+
+        // Frame f carries samples (f, -f) so order and channel placement show up.
+        auto make_frames = [](const std::uint32_t first, const std::uint32_t count)
+        {
+            std::vector<float> frames;
+            for (std::uint32_t f = first; f < first + count; ++f)
+            {
+                frames.push_back(static_cast<float>(f));
+                frames.push_back(-static_cast<float>(f));
+            }
+            return frames;
+        };
+
+        if (!Expect(fifo.Write(make_frames(0, 3).data(), 3) == 3, "write should accept frames that fit"))
+            return false;
+
+        std::vector<float> output(static_cast<std::size_t>(kChannels) * 5, 99.0f);
+        if (!Expect(fifo.Read(output.data(), 2) == 2, "read should return the frames asked for when available"))
+            return false;
+        if (!Expect(output[0] == 0.0f && output[1] == -0.0f && output[2] == 1.0f && output[3] == -1.0f, "read should return frames in order"))
+            return false;
+
+        // Positions now sit at 2/3; six more frames only fit four, wrapping.
+        if (!Expect(fifo.Write(make_frames(3, 6).data(), 6) == 4, "write should stop at capacity"))
+            return false;
+        if (!Expect(fifo.ReadableFrames() == 5 && fifo.WritableFrames() == 0, "fifo should report itself full"))
+            return false;
+
+        if (!Expect(fifo.Read(output.data(), 7) == 5, "read should return only what is queued"))
+            return false;
+        for (std::uint32_t f = 0; f < 5; ++f)
+        {
+            if (!Expect(output[2 * f] == static_cast<float>(f + 2) && output[2 * f + 1] == -static_cast<float>(f + 2),
+                        "wrapped frames should come back in write order"))
+                return false;
+        }
+
+        return Expect(fifo.ReadableFrames() == 0, "fifo should be empty after draining");
+    }
+
+    bool TestConcurrentTransfer()
+    {
+        constexpr std::uint32_t kChannels = 2;
+        constexpr std::uint32_t kTotalFrames = 100000;
+        decl_audio::playback::SampleFifo fifo(kChannels, 257);
+        std::atomic<bool> failed{false};
+
+        std::thread producer([&]()
+                             {
+        std::uint32_t next = 0;
+        std::vector<float> block(static_cast<std::size_t>(kChannels) * 61);
+        while (next < kTotalFrames)
+        {
+            const std::uint32_t count = std::min<std::uint32_t>(61, kTotalFrames - next);
+            for (std::uint32_t f = 0; f < count; ++f)
+            {
+                block[2 * f] = static_cast<float>(next + f);
+                block[2 * f + 1] = -static_cast<float>(next + f);
+            }
+
+            std::uint32_t written = 0;
+            while (written < count && !failed.load(std::memory_order_acquire))
+            {
+                written += fifo.Write(block.data() + static_cast<std::size_t>(written) * kChannels, count - written);
+                std::this_thread::yield();
+            }
+
+            next += count;
+        } });
+
+        std::thread consumer([&]()
+                             {
+        std::uint32_t expected = 0;
+        std::vector<float> block(static_cast<std::size_t>(kChannels) * 97);
+        while (expected < kTotalFrames)
+        {
+            const std::uint32_t read = fifo.Read(block.data(), 97);
+            for (std::uint32_t f = 0; f < read; ++f)
+            {
+                if (block[2 * f] != static_cast<float>(expected) || block[2 * f + 1] != -static_cast<float>(expected))
+                {
+                    failed.store(true, std::memory_order_release);
+                    return;
+                }
+
+                ++expected;
+            }
+
+            if (read == 0)
+            {
+                std::this_thread::yield();
+            }
+        } });
+
+        producer.join();
+        consumer.join();
+
+        if (!Expect(!failed.load(std::memory_order_acquire), "concurrent transfer should preserve frame order"))
+            return false;
+
+        return Expect(fifo.ReadableFrames() == 0, "fifo should be empty after producer/consumer completion");
+    }
+} // namespace
+
+bool RunSampleFifoTests()
+{
+    if (!TestPartialWritesAndReadsWrapAround())
+        return false;
+
+    if (!TestConcurrentTransfer())
+        return false;
+
+    std::cout << "SampleFifo tests passed\n";
+    return true;
+}
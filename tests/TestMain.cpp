@@ -5,9 +5,13 @@ bool RunCompilerTests();
 bool RunAssetBankTests();
 bool RunPlaybackTests();
 bool RunRingBufferTests();
+bool RunSampleFifoTests();
 bool RunWorldStateTests();
 bool RunHostLogTests();
 bool RunBankSerializerTests();
+bool RunMixKernelTests();
+bool RunInstanceSlotMapTests();
+bool RunIndexedMinHeapTests();
 int RunAudioCapacityOverflowDeathTestChild(const char *started_flag_path);
 
 namespace
@@ -32,6 +36,18 @@ int main(int argc, char **argv)
     if (!RunRingBufferTests())
         return 1;
 
+    if (!RunSampleFifoTests())
+        return 1;
+
+    if (!RunMixKernelTests())
+        return 1;
+
+    if (!RunInstanceSlotMapTests())
+        return 1;
+
+    if (!RunIndexedMinHeapTests())
+        return 1;
+
     if (!RunCompilerTests())
         return 1;
 
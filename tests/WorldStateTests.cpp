@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "../include/Decl_Audio/Decl_Audio.h"
@@ -32,6 +34,9 @@ namespace
     {
         EngineConfig config = GetDefaultConfig();
         config.backend = DECL_AUDIO_BACKEND_SILENT;
+        // These tests step the resolver one rendered frame at a time; a render
+        // quantum would carry most of each block over to later renders.
+        config.render_quantum_frames = 0;
         return config;
     }
 
@@ -370,6 +375,37 @@ namespace
         return true;
     }
 
+    bool TestTransformCommandsDrainIntoWorldState()
+    {
+        const std::filesystem::path fixture_path = GetFixturePath("ParameterForwardingBehaviorBank.json");
+
+        auto config = GetTestConfig();
+
+        decl_audio::Engine engine(config);
+        if (!Expect(engine.LoadBehaviors(fixture_path.string().c_str()), "phase 7 fixture should load"))
+        {
+            return false;
+        }
+
+        engine.SetTransform("player", Vec3{1.0f, 2.0f, 3.0f}, Quat{0.0f, 0.0f, 2.0f, 0.0f});
+        engine.SetQuatValue("player", "aim", Quat{0.5f, 0.5f, 0.5f, 0.5f});
+        engine.Update();
+
+        const decl_audio::runtime::EntityState &entity = engine.GetWorldState().GetEntity("player");
+        if (!Expect(entity.HasPosition() && entity.GetPosition() == Vec3{1.0f, 2.0f, 3.0f}, "SetTransform should apply the position"))
+        {
+            return false;
+        }
+
+        if (!Expect(entity.HasOrientation() && entity.GetOrientation() == Quat{0.0f, 0.0f, 1.0f, 0.0f}, "SetTransform should apply the orientation normalized"))
+        {
+            return false;
+        }
+
+        return Expect(entity.quat_values.size() == 1 && entity.quat_values.begin()->second == Quat{0.5f, 0.5f, 0.5f, 0.5f},
+                      "SetQuatValue should store the quaternion under its key");
+    }
+
     bool TestResolverChangesApplyOnNextRenderBlock()
     {
         const std::filesystem::path fixture_path = GetFixturePath("ParameterForwardingBehaviorBank.json");
@@ -549,6 +585,122 @@ namespace
         return true;
     }
 
+    bool TestBusesMergeAcrossBanksAndTakeHostVolume()
+    {
+        // A host volume set (and drained by an Update) before any bank
+        // declares the bus applies once one does. A later bank may share the bus, but not redeclare it
+        // differently: that bank is rejected whole.
+        const std::string bus_bank = GetFixturePath("BusBehaviorBank.json").string();
+        const std::string conflict_bank = GetFixturePath("BusConflictBank.json").string();
+
+        auto config = GetTestConfig();
+        decl_audio::Engine engine(config);
+        engine.SetBusVolume("music", 0.0f);
+        engine.Update();
+        if (!Expect(engine.LoadBehaviors(bus_bank.c_str()), "bus bank should load"))
+            return false;
+        if (!Expect(!engine.LoadBehaviors(conflict_bank.c_str()), "a bank redeclaring a bus differently should be rejected"))
+            return false;
+
+        engine.SetTag("player", "bus.music");
+        engine.Update();
+
+        constexpr std::uint32_t kFrames = 64;
+        std::vector<float> output(static_cast<std::size_t>(kFrames) * OutputChannelCount);
+        engine.RenderAudioForTesting(output.data(), kFrames);
+        if (!Expect(engine.GetDebugSnapshot().active_instance_count == 1, "the music behavior should play"))
+            return false;
+        if (!Expect(std::all_of(output.begin(), output.end(), [](const float sample) { return sample == 0.0f; }),
+                    "a bus muted before it was declared should stay silent"))
+            return false;
+
+        engine.SetBusVolume("music", 1.0f);
+        engine.Update();
+        engine.RenderAudioForTesting(output.data(), kFrames);
+        return Expect(std::any_of(output.begin(), output.end(), [](const float sample) { return sample != 0.0f; }),
+                      "raising the bus volume should make it audible");
+    }
+
+    bool TestScheduledUpdateDoesNotHoldBackLaterUpdates()
+    {
+        const std::string bus_bank = GetFixturePath("BusBehaviorBank.json").string();
+        auto config = GetTestConfig();
+        decl_audio::Engine engine(config);
+        if (!Expect(engine.LoadBehaviors(bus_bank.c_str()), "bus bank should load"))
+            return false;
+        RenderAudioForTesting(engine, 1);
+
+        constexpr std::uint64_t kLeadFrames = 4800;
+        engine.SetTag("player", "bus.music");
+        engine.UpdateAt(engine.GetAudioClock() + kLeadFrames);
+        engine.SetTag("enemy", "bus.weapons");
+        engine.Update();
+        RenderAudioForTesting(engine, 64);
+        if (!Expect(engine.GetDebugSnapshot().active_instance_count == 1, "an update after a scheduled one should apply at the next block"))
+            return false;
+
+        // Stopping the scheduled instance must wait for its start rather
+        // than overtake it.
+        engine.RemoveTag("player", "bus.music");
+        engine.Update();
+        RenderAudioForTesting(engine, 64);
+        if (!Expect(engine.GetDebugSnapshot().active_instance_count == 1, "the scheduled instance should not start early"))
+            return false;
+
+        RenderAudioForTesting(engine, static_cast<std::uint32_t>(kLeadFrames) + config.sample_rate);
+        return Expect(engine.GetDebugSnapshot().active_instance_count == 1, "a stop made after a scheduled start should land after it");
+    }
+
+    bool TestFarScheduledUpdateNeitherOverflowsNorStalls()
+    {
+        // A tiny command ring and as many scheduled updates as it has room
+        // for, one of them ten seconds out: that frame is pulled in to the
+        // one-second horizon, and updates queued once the audio side's
+        // schedule is full wait on the control side instead of overflowing
+        // the ring.
+        const std::string bus_bank = GetFixturePath("BusBehaviorBank.json").string();
+        auto config = GetTestConfig();
+        config.command_queue_capacity = 4;
+        decl_audio::Engine engine(config);
+        if (!Expect(engine.LoadBehaviors(bus_bank.c_str()), "bus bank should load"))
+            return false;
+        RenderAudioForTesting(engine, 1);
+
+        engine.SetMasterGain(0.5f);
+        engine.UpdateAt(engine.GetAudioClock() + static_cast<std::uint64_t>(config.sample_rate) * 10);
+        bool warned = false;
+        std::string message;
+        while (engine.TryDequeueLog(message))
+            warned = warned || message.find("[warning] UpdateAt") != std::string::npos;
+        if (!Expect(warned, "a frame past the horizon should be reported"))
+            return false;
+
+        for (std::uint64_t update = 0; update < 32; ++update)
+        {
+            engine.SetMasterGain(update % 2 == 0 ? 0.25f : 1.0f);
+            engine.UpdateAt(engine.GetAudioClock() + config.sample_rate / 2 + update);
+        }
+        engine.SetTag("player", "bus.music");
+        engine.Update();
+
+        constexpr std::uint32_t kFrames = 64;
+        std::vector<float> output(static_cast<std::size_t>(kFrames) * OutputChannelCount);
+        engine.RenderAudioForTesting(output.data(), kFrames);
+        if (!Expect(engine.GetDebugSnapshot().active_instance_count == 0, "updates behind a full schedule should wait for room"))
+            return false;
+
+        // Each Update moves on what the ring has room for.
+        RenderAudioForTesting(engine, config.sample_rate);
+        for (int update = 0; update < 16; ++update)
+        {
+            engine.Update();
+            engine.RenderAudioForTesting(output.data(), kFrames);
+        }
+        if (!Expect(engine.GetDebugSnapshot().active_instance_count == 1, "the waiting updates should flow once the scheduled frames pass"))
+            return false;
+        return Expect(std::any_of(output.begin(), output.end(), [](const float sample) { return sample != 0.0f; }), "the waiting updates should play");
+    }
+
     bool TestUnloadIsPerBankAndFreesTheSlot()
     {
         // Load two banks and play both. Unloading one must stop only its instance and
@@ -647,6 +799,11 @@ bool RunWorldStateTests()
         return false;
     }
 
+    if (!TestTransformCommandsDrainIntoWorldState())
+    {
+        return false;
+    }
+
     if (!TestResolverChangesApplyOnNextRenderBlock())
     {
         return false;
@@ -662,6 +819,21 @@ bool RunWorldStateTests()
         return false;
     }
 
+    if (!TestBusesMergeAcrossBanksAndTakeHostVolume())
+    {
+        return false;
+    }
+
+    if (!TestScheduledUpdateDoesNotHoldBackLaterUpdates())
+    {
+        return false;
+    }
+
+    if (!TestFarScheduledUpdateNeitherOverflowsNorStalls())
+    {
+        return false;
+    }
+
     if (!TestUnloadIsPerBankAndFreesTheSlot())
     {
         return false;